@@ -15,6 +15,32 @@ public:
     
     virtual Gleam::Guid TypeGuid() const = 0;
 
+    // assets this one references, recorded in the project dependency graph
+    virtual Gleam::TArray<Gleam::AssetReference> Dependencies() const { return {}; }
+
+    // heavy binary payload baked as "<guid>.bin" next to the asset
+    virtual bool HasSidecar() const { return false; }
+
+    virtual void BakeSidecar(Gleam::FileStream& stream) const {}
+
+    // fingerprint of the source files, settings and importer version the baker was created from
+    void SetInput(const Gleam::Filesystem::Path& source, uint64_t inputHash)
+    {
+        mSource = source;
+        mInputHash = inputHash;
+    }
+
+    const Gleam::Filesystem::Path& GetSource() const { return mSource; }
+
+    // zero always rebakes
+    uint64_t GetInputHash() const { return mInputHash; }
+
+private:
+
+    Gleam::Filesystem::Path mSource;
+
+    uint64_t mInputHash = 0;
+
 };
 
 } // namespace GEditor
@@ -0,0 +1,211 @@
+#include "Gleam.h"
+#include "AssetCooker.h"
+
+using namespace GEditor;
+
+AssetCooker::AssetCooker(const Gleam::Filesystem::Path& assetDirectory, uint64_t maxArchiveSize)
+    : mAssetDirectory(assetDirectory), mMaxArchiveSize(maxArchiveSize)
+{
+
+}
+
+bool AssetCooker::Cook(const Gleam::Filesystem::Path& outputDirectory, Gleam::ThreadPool& threads, AssetCookStats& stats) const
+{
+    // sorted, so that an asset and its sidecar end up next to each other and the archives are reproducible
+    Gleam::TArray<Gleam::Filesystem::Path> files;
+    Gleam::Filesystem::ForEach(mAssetDirectory, [&, this](const auto& path)
+    {
+        if (IsCooked(path))
+        {
+            files.push_back(path);
+        }
+    }, true);
+    std::sort(files.begin(), files.end());
+
+    std::error_code error;
+    std::filesystem::create_directories(outputDirectory, error);
+    for (const auto& entry : std::filesystem::directory_iterator(outputDirectory, error))
+    {
+        if (entry.path().extension() == Gleam::PakArchive::Extension())
+        {
+            Gleam::Filesystem::Remove(entry.path());
+        }
+    }
+
+    auto stagingDirectory = outputDirectory / "Staging";
+    std::filesystem::remove_all(stagingDirectory, error);
+    auto sources = Stage(files, stagingDirectory, threads);
+
+    Gleam::TArray<Gleam::PakWriter> writers(1);
+    for (uint32_t i = 0; i < files.size(); i++)
+    {
+        uint64_t size = Gleam::Filesystem::FileSize(sources[i]);
+        if (writers.back().GetFileCount() > 0 && writers.back().GetSize() + size > mMaxArchiveSize)
+        {
+            writers.emplace_back();
+        }
+        writers.back().Add(sources[i], Gleam::Filesystem::Relative(files[i], mAssetDirectory));
+    }
+
+    stats = AssetCookStats();
+    for (uint32_t i = 0; i < writers.size(); i++)
+    {
+        auto archivePath = outputDirectory / (Gleam::TString(ArchiveName()) + "_" + std::to_string(i) + Gleam::PakArchive::Extension().data());
+        if (writers[i].Write(archivePath, threads) == false)
+        {
+            GLEAM_ERROR("Archive could not be written: {0}", archivePath.string());
+            std::filesystem::remove_all(stagingDirectory, error);
+            return false;
+        }
+
+        stats.archives++;
+        stats.files += writers[i].GetFileCount();
+        stats.size += writers[i].GetSize();
+        stats.archiveSize += Gleam::Filesystem::FileSize(archivePath);
+    }
+    std::filesystem::remove_all(stagingDirectory, error);
+    GLEAM_INFO("Cooked {0} files into {1} archives: {2} MB to {3} MB", stats.files, stats.archives, stats.size / (1024 * 1024), stats.archiveSize / (1024 * 1024));
+    return true;
+}
+
+Gleam::TArray<Gleam::Filesystem::Path> AssetCooker::Stage(const Gleam::TArray<Gleam::Filesystem::Path>& files, const Gleam::Filesystem::Path& stagingDirectory, Gleam::ThreadPool& threads) const
+{
+    Gleam::TArray<Gleam::Filesystem::Path> sources = files;
+    Gleam::TArray<uint64_t> hashes(files.size(), 0);
+
+    std::error_code error;
+    for (const auto& file : files)
+    {
+        if (file.extension() == Gleam::Asset::extension() || file.extension() == Gleam::World::Extension())
+        {
+            std::filesystem::create_directories(stagingDirectory / Gleam::Filesystem::Relative(file, mAssetDirectory).parent_path(), error);
+        }
+    }
+
+    // worlds create their systems and subsystems, they are converted one at a time on this thread
+    for (uint32_t i = 0; i < files.size(); i++)
+    {
+        auto staged = stagingDirectory / Gleam::Filesystem::Relative(files[i], mAssetDirectory);
+        if (files[i].extension() == Gleam::World::Extension() && StageWorld(files[i], staged))
+        {
+            sources[i] = staged;
+        }
+    }
+
+    auto assetManager = Gleam::Globals::GameInstance->GetSubsystem<Gleam::AssetManager>();
+    threads.ParallelFor(static_cast<uint32_t>(files.size()), [&](uint32_t i)
+    {
+        Gleam::TArray<uint8_t> data;
+        if (files[i].extension() != Gleam::Asset::extension() || assetManager->EncodeBinary(files[i], data) == false)
+        {
+            return;
+        }
+
+        auto staged = stagingDirectory / Gleam::Filesystem::Relative(files[i], mAssetDirectory);
+        std::ofstream stream(staged, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+        stream.close();
+        if (stream.fail())
+        {
+            GLEAM_WARN("Asset could not be staged, it is cooked as JSON: {0}", files[i].string());
+            return;
+        }
+
+        // the index validates entries by modification time and size, the time is kept from the source
+        std::error_code error;
+        std::filesystem::last_write_time(staged, std::filesystem::last_write_time(files[i], error), error);
+        hashes[i] = Gleam::Hash64(data.data(), data.size());
+        sources[i] = staged;
+    });
+
+    auto indexPath = mAssetDirectory / Gleam::AssetIndex::Filename();
+    auto index = std::find(files.begin(), files.end(), indexPath);
+    if (index == files.end())
+    {
+        return sources;
+    }
+
+    Gleam::AssetIndexTable table;
+    {
+        auto accessor = Gleam::Filesystem::ReadAccessor(indexPath);
+        auto mapped = Gleam::Filesystem::Map(indexPath);
+        if (Gleam::BinarySerializer::Deserialize(mapped.GetData(), mapped.GetSize(), Gleam::Reflection::GetClass<Gleam::AssetIndexTable>(), &table) == false)
+        {
+            return sources;
+        }
+    }
+
+    // entries of the re-encoded assets describe the staged files, so the cooked index is valid without a reparse
+    Gleam::HashMap<Gleam::Filesystem::Path, uint32_t> staged;
+    for (uint32_t i = 0; i < files.size(); i++)
+    {
+        if (sources[i] != files[i])
+        {
+            staged.emplace(Gleam::Filesystem::Relative(files[i], mAssetDirectory), i);
+        }
+    }
+
+    for (auto& entry : table.entries)
+    {
+        auto it = staged.find(entry.path);
+        if (it != staged.end())
+        {
+            entry.size = Gleam::Filesystem::FileSize(sources[it->second]);
+            entry.contentHash = hashes[it->second];
+        }
+    }
+
+    Gleam::BinaryWriter writer;
+    writer.Write(&table, Gleam::Reflection::GetClass<Gleam::AssetIndexTable>());
+
+    Gleam::TArray<uint8_t> data;
+    writer.Finish(data);
+
+    auto stagedIndex = stagingDirectory / Gleam::AssetIndex::Filename();
+    std::ofstream stream(stagedIndex, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+    stream.close();
+    if (stream.fail() == false)
+    {
+        sources[index - files.begin()] = stagedIndex;
+    }
+    return sources;
+}
+
+bool AssetCooker::StageWorld(const Gleam::Filesystem::Path& file, const Gleam::Filesystem::Path& staged) const
+{
+    Gleam::World world;
+    {
+        auto accessor = Gleam::Filesystem::ReadAccessor(file);
+        auto mapped = Gleam::Filesystem::Map(file);
+        if (Gleam::World::IsBinary(mapped.GetData(), mapped.GetSize()))
+        {
+            return false;
+        }
+        world.Deserialize(mapped);
+    }
+
+    Gleam::FileStream stream(staged, std::ios::out | std::ios::binary | std::ios::trunc);
+    world.SerializeBinary(stream);
+    stream.close();
+    if (stream.fail())
+    {
+        GLEAM_WARN("World could not be staged, it is cooked as JSON: {0}", file.string());
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::last_write_time(staged, std::filesystem::last_write_time(file, error), error);
+    return true;
+}
+
+bool AssetCooker::IsCooked(const Gleam::Filesystem::Path& path) const
+{
+    auto extension = path.extension();
+    auto filename = path.filename();
+    return extension == Gleam::Asset::extension() ||
+           extension == Gleam::Asset::sidecarExtension() ||
+           extension == Gleam::World::Extension() ||
+           filename == Gleam::AssetIndex::Filename() ||
+           filename == Gleam::AssetDependencyGraph::Filename();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Gleam.h"
+
+namespace GEditor {
+
+struct AssetCookStats
+{
+    uint32_t archives = 0;
+    uint32_t files = 0;
+    uint64_t size = 0; // of the cooked files before compression
+    uint64_t archiveSize = 0;
+};
+
+/*
+* Packs the baked assets of a project into archives the runtime mounts over its content directory
+* Sources and editor records are left out, the asset index and dependency graph go in with the assets
+* JSON assets of registered types are re-encoded as binary blobs and JSON worlds are converted to binary worlds on the way in
+*/
+class AssetCooker final
+{
+public:
+
+    static constexpr uint64_t DefaultArchiveSize = 1024ull * 1024 * 1024;
+
+    AssetCooker(const Gleam::Filesystem::Path& assetDirectory, uint64_t maxArchiveSize = DefaultArchiveSize);
+
+    // Replaces the archives in outputDirectory, a new archive is started whenever one would grow past the maximum size
+    bool Cook(const Gleam::Filesystem::Path& outputDirectory, Gleam::ThreadPool& threads, AssetCookStats& stats) const;
+
+    static constexpr Gleam::TStringView ArchiveName()
+    {
+        return "Content";
+    }
+
+private:
+
+    bool IsCooked(const Gleam::Filesystem::Path& path) const;
+
+    // Writes binary copies of the JSON assets and worlds and an index describing them, returns the file to pack for every file
+    Gleam::TArray<Gleam::Filesystem::Path> Stage(const Gleam::TArray<Gleam::Filesystem::Path>& files, const Gleam::Filesystem::Path& stagingDirectory, Gleam::ThreadPool& threads) const;
+
+    // Loads a JSON world into a temporary world and writes it in the binary format, false if it is kept as it is
+    bool StageWorld(const Gleam::Filesystem::Path& file, const Gleam::Filesystem::Path& staged) const;
+
+    Gleam::Filesystem::Path mAssetDirectory;
+
+    uint64_t mMaxArchiveSize;
+
+};
+
+} // namespace GEditor
@@ -18,6 +18,31 @@ struct AssetPackage
 	}
 
 	virtual ~AssetPackage() = default;
+
+	// assets of the source found up to date by the registry, reported without being baked again
+	uint32_t upToDate = 0;
+
+	// Combines the contents of every file an import reads with its settings and the importer version
+	static uint64_t HashInputs(const Gleam::TArray<Gleam::Filesystem::Path>& sources, uint64_t settingsHash, uint32_t importerVersion)
+	{
+		uint64_t hash = Gleam::Hash64(&importerVersion, sizeof(importerVersion));
+		hash = Gleam::Hash64(&settingsHash, sizeof(settingsHash), hash);
+		for (const auto& source : sources)
+		{
+			// a missing file still changes the hash so that it is noticed once it appears
+			if (Gleam::Filesystem::Exists(source) == false)
+			{
+				hash = Gleam::Hash64(nullptr, 0, ~hash);
+				continue;
+			}
+
+			Gleam::MappedFile mapped(source);
+			uint64_t size = mapped.GetSize();
+			hash = Gleam::Hash64(&size, sizeof(size), hash);
+			hash = Gleam::Hash64(mapped.GetData(), mapped.GetSize(), hash);
+		}
+		return hash;
+	}
 };
 
 #define AssetPackageType(type) type(AssetRegistry* registry) : AssetPackage(registry) {}
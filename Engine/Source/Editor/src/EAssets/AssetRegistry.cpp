@@ -5,47 +5,6 @@
 
 using namespace GEditor;
 
-static Gleam::JSONHeader ParseAssetHeader(const Gleam::Filesystem::Path& asset)
-{
-	auto file = Gleam::Filesystem::Open(asset, Gleam::FileType::Text);
-	auto accessor = Gleam::Filesystem::ReadAccessor(asset);
-	auto serializer = Gleam::JSONSerializer(file.GetStream());
-	return serializer.ParseHeader();
-}
-
-static Gleam::TString ParseAssetName(const Gleam::Filesystem::Path& asset, const Gleam::Guid& typeGuid)
-{
-	auto file = Gleam::Filesystem::Open(asset, Gleam::FileType::Text);
-	auto accessor = Gleam::Filesystem::ReadAccessor(asset);
-	auto serializer = Gleam::JSONSerializer(file.GetStream());
-
-    if (typeGuid == Gleam::Reflection::GetClass<Gleam::MeshDescriptor>().Guid())
-    {
-        auto descriptor = serializer.Deserialize<Gleam::MeshDescriptor>();
-        return descriptor.name;
-    }
-    
-    if (typeGuid == Gleam::Reflection::GetClass<Gleam::TextureDescriptor>().Guid())
-    {
-        auto descriptor = serializer.Deserialize<Gleam::TextureDescriptor>();
-        return descriptor.name;
-    }
-    
-    if (typeGuid == Gleam::Reflection::GetClass<Gleam::MaterialDescriptor>().Guid())
-    {
-        auto descriptor = serializer.Deserialize<Gleam::MaterialDescriptor>();
-        return descriptor.name;
-    }
-    
-    if (typeGuid == Gleam::Reflection::GetClass<Gleam::MaterialInstanceDescriptor>().Guid())
-    {
-        auto descriptor = serializer.Deserialize<Gleam::MaterialInstanceDescriptor>();
-        return descriptor.name;
-    }
-    
-    return "";
-}
-
 AssetRegistry::AssetRegistry(const Gleam::Filesystem::Path& directory)
 	: mAssetDirectory(directory)
 {
@@ -54,69 +13,283 @@ AssetRegistry::AssetRegistry(const Gleam::Filesystem::Path& directory)
 
 void AssetRegistry::Initialize(Gleam::World* world)
 {
-    Gleam::Filesystem::ForEach(mAssetDirectory, [this](const auto& entry)
+    // created up front, the editor and the import jobs both use the workers
+    mImportThreads = Gleam::CreateScope<Gleam::ThreadPool>();
+    mImportJobs = Gleam::CreateScope<Gleam::ThreadPool>(1);
+
+    mDependencyGraph.Load(mAssetDirectory / Gleam::AssetDependencyGraph::Filename());
+    LoadImportRecords();
+
+    // the runtime keeps the metadata of every asset in a persistent index, nothing is parsed here
+    auto assetManager = Gleam::Globals::GameInstance->GetSubsystem<Gleam::AssetManager>();
+    for (const auto& entry : assetManager->GetIndexedAssets())
     {
-        if (entry.extension() == ".asset")
-        {
-            auto header = ParseAssetHeader(entry);
-            
-            auto guid = Gleam::Guid(entry.stem().string());
-            auto asset = Gleam::AssetReference{ .guid = guid };
-            auto name = ParseAssetName(entry, header.guid);
-            auto item = AssetItem{
-                .reference = asset,
-                .type = header.guid,
-                .name = name
-            };
-            auto relPath = Gleam::Filesystem::Relative(entry.parent_path(), mAssetDirectory);
-            relPath /= name;
-			auto& items = mAssetCache[relPath];
-			items.push_back(item);
-        }
-    }, true);
+        auto item = AssetItem{
+            .reference = entry.asset,
+            .type = entry.type,
+            .name = entry.name
+        };
+        auto relPath = entry.path.parent_path() / entry.name;
+        auto& items = mAssetCache[relPath];
+        items.push_back(item);
+    }
     
-    // TODO: materials should only compile and imported when first seen by the registry
-    // existing materials should not change guid
-    // it should only reimport if material/shader source changed since last compile
-    Gleam::Filesystem::ForEach(mAssetDirectory, [this](const auto& entry)
+    // materials are compiled when first seen or when the .mat or its shader changed since the last compile,
+    // RegisterAsset keeps the guid of a recompiled material, queued first so that later imports find them compiled
+    ImportAsync("Materials", [this]()
     {
-        if (entry.extension() == ".mat")
+        AssetImportStats materialStats;
+        Gleam::Filesystem::ForEach(mAssetDirectory, [&, this](const auto& entry)
         {
-            auto path = entry.parent_path()/entry.stem();
-            auto relPath = Gleam::Filesystem::Relative(path, mAssetDirectory);
-            if (mAssetCache.find(relPath) == mAssetCache.end())
+            if (entry.extension() == ".mat")
             {
-                auto materialSource = MaterialSource(this);
                 auto settings = MaterialSource::ImportSettings();
-                materialSource.Import(entry, settings);
-                Import(mAssetDirectory/"Materials", materialSource);
+                if (auto upToDate = FindUpToDate(entry, MaterialSource::HashInputs(entry, settings)); upToDate > 0)
+                {
+                    materialStats.skipped += upToDate;
+                    return;
+                }
+
+                auto materialSource = MaterialSource(this);
+                if (materialSource.Import(entry, settings))
+                {
+                    auto stats = Import(mAssetDirectory/"Materials", materialSource);
+                    materialStats.rebuilt += stats.rebuilt;
+                    materialStats.skipped += stats.skipped;
+                }
             }
-        }
-    }, true);
+        }, true);
+        GLEAM_INFO("Materials: {0} rebuilt, {1} skipped", materialStats.rebuilt, materialStats.skipped);
+    });
 }
 
 void AssetRegistry::Shutdown()
 {
+	// queued imports are dropped, the running one finishes before the workers it uses go away
+	mImportJobs.reset();
+	mImportThreads.reset();
 	mAssetCache.clear();
+	mImportRecords.clear();
+	mDependencyGraph = Gleam::AssetDependencyGraph();
+}
+
+// An asset is only up to date while everything its baker wrote is still on disk
+static bool IsBakeComplete(const Gleam::Filesystem::Path& assetPath, bool sidecar)
+{
+	if (Gleam::Filesystem::Exists(assetPath) == false)
+	{
+		return false;
+	}
+
+	auto sidecarPath = assetPath;
+	return sidecar == false || Gleam::Filesystem::Exists(sidecarPath.replace_extension(Gleam::Asset::sidecarExtension()));
 }
 
-void AssetRegistry::Import(const Gleam::Filesystem::Path& directory, const AssetPackage& package)
+AssetImportStats AssetRegistry::Import(const Gleam::Filesystem::Path& directory, const AssetPackage& package)
 {
+	struct PendingBake
+	{
+		const AssetBaker* baker;
+		Gleam::AssetReference asset;
+		Gleam::Filesystem::Path source;
+		Gleam::TString guid;
+	};
+
+	// guids are assigned and up to date assets are skipped on this thread, in package order
+	AssetImportStats stats = { .skipped = package.upToDate };
+	Gleam::HashSet<Gleam::AssetReference> imported;
+	Gleam::HashSet<Gleam::Filesystem::Path> sources;
+	Gleam::TArray<PendingBake> pending;
 	for (const auto& baker : package.bakers)
 	{
 		auto path = directory / baker->Filename();
-		const auto& asset = RegisterAsset(path, baker->TypeGuid());
+		auto asset = RegisterAsset(path, baker->TypeGuid()).reference;
+		imported.insert(asset);
+
+		Gleam::Filesystem::Path source;
+		if (baker->GetSource().empty() == false)
+		{
+			source = Gleam::Filesystem::Relative(baker->GetSource(), mAssetDirectory);
+			sources.insert(source);
+		}
+
+		auto guid = asset.guid.ToString();
+		auto record = mImportRecords.find(asset);
+		if (baker->GetInputHash() != 0 && record != mImportRecords.end() &&
+			record->second.inputHash == baker->GetInputHash() &&
+			IsBakeComplete(directory / (guid + Gleam::Asset::extension().data()), baker->HasSidecar()))
+		{
+			stats.skipped++;
+			continue;
+		}
+		pending.push_back({ .baker = baker.get(), .asset = asset, .source = source, .guid = guid });
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mImportProgress.baked = 0;
+		mImportProgress.total = static_cast<uint32_t>(pending.size());
+	}
+
+	// every baker writes its own files
+	GetImportThreads().ParallelFor(static_cast<uint32_t>(pending.size()), [&](uint32_t i)
+	{
+		const auto& bake = pending[i];
+		auto assetPath = directory / (bake.guid + Gleam::Asset::extension().data());
+		{
+			auto accessor = Gleam::Filesystem::WriteAccessor(assetPath);
+			auto file = Gleam::Filesystem::Create(assetPath, Gleam::FileType::Text);
+			bake.baker->Bake(file.GetStream());
+		}
+
+		if (bake.baker->HasSidecar())
+		{
+			auto sidecarPath = directory / (bake.guid + Gleam::Asset::sidecarExtension().data());
+			auto sidecarAccessor = Gleam::Filesystem::WriteAccessor(sidecarPath);
+			auto sidecar = Gleam::Filesystem::Create(sidecarPath, Gleam::FileType::Binary);
+			bake.baker->BakeSidecar(sidecar.GetStream());
+		}
 
-		auto filename = asset.reference.guid.ToString() + Gleam::Asset::extension().data();
-		auto file = Gleam::Filesystem::Create(directory / filename, Gleam::FileType::Text);
-		auto accessor = Gleam::Filesystem::WriteAccessor(directory / filename);
-		baker->Bake(file.GetStream());
+		std::lock_guard<std::mutex> lock(mMutex);
+		mImportProgress.baked++;
+	});
+
+	// registry, dependency graph and index are updated once everything is on disk
+	auto assetManager = Gleam::Globals::GameInstance->GetSubsystem<Gleam::AssetManager>();
+	for (const auto& bake : pending)
+	{
+		auto assetPath = directory / (bake.guid + Gleam::Asset::extension().data());
+
+		// the runtime invalidates dependents of a reimported asset through this graph
+		mDependencyGraph.SetDependencies(bake.asset, bake.baker->TypeGuid(), bake.baker->Dependencies());
+		assetManager->Reindex(assetPath);
+
+		mImportRecords[bake.asset] = AssetImportRecord{
+			.asset = bake.asset,
+			.path = Gleam::Filesystem::Relative(assetPath, mAssetDirectory),
+			.source = bake.source,
+			.inputHash = bake.baker->GetInputHash(),
+			.sidecar = bake.baker->HasSidecar()
+		};
+		stats.rebuilt++;
+	}
+
+	// assets a source no longer produces would otherwise keep it looking out of date
+	uint32_t dropped = 0;
+	for (auto it = mImportRecords.begin(); it != mImportRecords.end();)
+	{
+		if (sources.contains(it->second.source) && imported.contains(it->first) == false)
+		{
+			it = mImportRecords.erase(it);
+			dropped++;
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	if (stats.rebuilt > 0 || dropped > 0)
+	{
+		mDependencyGraph.Save(mAssetDirectory / Gleam::AssetDependencyGraph::Filename());
+		SaveImportRecords();
+	}
+	GLEAM_INFO("Imported to {0}: {1} rebuilt, {2} skipped", directory.string(), stats.rebuilt, stats.skipped);
+	return stats;
+}
+
+void AssetRegistry::ImportAsync(const Gleam::TString& source, std::function<void()>&& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mImportProgress.queued++;
+	}
+
+	mImportJobs->Submit([this, source, job = std::move(job)]()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mImportProgress.queued--;
+			mImportProgress.source = source;
+			mImportProgress.baked = 0;
+			mImportProgress.total = 0;
+		}
+
+		job();
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mImportProgress.source.clear();
+	});
+}
+
+AssetImportProgress AssetRegistry::GetImportProgress() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mImportProgress;
+}
+
+Gleam::ThreadPool& AssetRegistry::GetImportThreads()
+{
+	return *mImportThreads;
+}
+
+uint32_t AssetRegistry::FindUpToDate(const Gleam::Filesystem::Path& source, uint64_t inputHash) const
+{
+	auto relSource = Gleam::Filesystem::Relative(source, mAssetDirectory);
+	uint32_t count = 0;
+	for (const auto& [asset, record] : mImportRecords)
+	{
+		if (record.source != relSource)
+			continue;
+
+		if (record.inputHash != inputHash || IsBakeComplete(mAssetDirectory / record.path, record.sidecar) == false)
+			return 0;
+
+		count++;
 	}
+	return count;
 }
 
-const AssetItem& AssetRegistry::RegisterAsset(const Gleam::Filesystem::Path& path, const Gleam::Guid& type)
+void AssetRegistry::LoadImportRecords()
+{
+	mImportRecords.clear();
+	auto path = mAssetDirectory / ImportRecordsFilename();
+	if (Gleam::Filesystem::Exists(path) == false)
+	{
+		return;
+	}
+
+	auto accessor = Gleam::Filesystem::ReadAccessor(path);
+	auto file = Gleam::Filesystem::Map(path);
+	auto serializer = Gleam::JSONSerializer(file);
+	auto table = serializer.Deserialize<AssetImportTable>();
+	for (const auto& record : table.records)
+	{
+		mImportRecords[record.asset] = record;
+	}
+}
+
+void AssetRegistry::SaveImportRecords() const
+{
+	AssetImportTable table;
+	table.records.reserve(mImportRecords.size());
+	for (const auto& [asset, record] : mImportRecords)
+	{
+		table.records.push_back(record);
+	}
+
+	auto path = mAssetDirectory / ImportRecordsFilename();
+	auto accessor = Gleam::Filesystem::WriteAccessor(path);
+	auto file = Gleam::Filesystem::Create(path, Gleam::FileType::Text);
+	auto serializer = Gleam::JSONSerializer(file.GetStream());
+	serializer.Serialize(table);
+}
+
+AssetItem AssetRegistry::RegisterAsset(const Gleam::Filesystem::Path& path, const Gleam::Guid& type)
 {
 	auto relPath = path.is_relative() ? path : Gleam::Filesystem::Relative(path, mAssetDirectory);
+
+	std::lock_guard<std::mutex> lock(mMutex);
 	auto& items = mAssetCache[relPath];
 	for (const auto& item : items)
 	{
@@ -136,8 +309,9 @@ const AssetItem& AssetRegistry::RegisterAsset(const Gleam::Filesystem::Path& pat
 	return items.emplace_back(item);
 }
 
-const AssetItem& AssetRegistry::GetAsset(const Gleam::Guid& guid) const
+AssetItem AssetRegistry::GetAsset(const Gleam::Guid& guid) const
 {
+	std::lock_guard<std::mutex> lock(mMutex);
 	for (const auto& [path, items] : mAssetCache)
 	{
 		for (const auto& item : items)
@@ -151,6 +325,5 @@ const AssetItem& AssetRegistry::GetAsset(const Gleam::Guid& guid) const
 
 	GLEAM_CORE_ERROR("Asset could not located for GUID: {0}", guid.ToString());
 	GLEAM_ASSERT(false);
-	static AssetItem invalidAsset;
-	return invalidAsset;
+	return AssetItem();
 }
@@ -11,6 +11,34 @@ struct AssetItem
     Gleam::TString name;
 };
 
+struct AssetImportRecord
+{
+    Gleam::AssetReference asset;
+    Gleam::Filesystem::Path path; // baked asset, relative to the asset directory
+    Gleam::Filesystem::Path source; // relative to the asset directory
+    uint64_t inputHash = 0;
+    bool sidecar = false; // a "<guid>.bin" sidecar was baked next to the asset
+};
+
+struct AssetImportTable
+{
+    Gleam::TArray<AssetImportRecord> records;
+};
+
+struct AssetImportStats
+{
+    uint32_t rebuilt = 0;
+    uint32_t skipped = 0;
+};
+
+struct AssetImportProgress
+{
+    Gleam::TString source; // empty while no import is running
+    uint32_t queued = 0; // imports waiting behind the running one
+    uint32_t baked = 0;
+    uint32_t total = 0;
+};
+
 class AssetRegistry final : public Gleam::WorldSubsystem
 {
 public:
@@ -21,20 +49,40 @@ public:
 
 	virtual void Shutdown() override;
 
-	void Import(const Gleam::Filesystem::Path& directory, const AssetPackage& package);
+	static constexpr Gleam::TStringView ImportRecordsFilename()
+	{
+		return "AssetImports.records";
+	}
+
+	// Bakers whose inputs match the last import of their asset are skipped
+	AssetImportStats Import(const Gleam::Filesystem::Path& directory, const AssetPackage& package);
 
+	// Queues an import job, jobs run one after another on a background thread so that the editor keeps drawing
+	void ImportAsync(const Gleam::TString& source, std::function<void()>&& job);
+
+	AssetImportProgress GetImportProgress() const;
+
+	// Workers shared by the importers, bakers of a package are serialized on them in parallel
+	Gleam::ThreadPool& GetImportThreads();
+
+	// Number of assets last imported from the source with the same inputs, zero if the source has to be imported again
+	uint32_t FindUpToDate(const Gleam::Filesystem::Path& source, uint64_t inputHash) const;
+
+	// Items are returned by value, import jobs register assets while the editor is reading them
 	template<typename T>
-	const AssetItem& RegisterAsset(const Gleam::Filesystem::Path& path)
+	AssetItem RegisterAsset(const Gleam::Filesystem::Path& path)
 	{
 		const auto& type = Gleam::Reflection::GetClass<T>().Guid();
 		return RegisterAsset(path, type);
 	}
 
 	template<typename T>
-	const AssetItem& GetAsset(const Gleam::Filesystem::Path& path) const
+	AssetItem GetAsset(const Gleam::Filesystem::Path& path) const
 	{
 		const auto& type = Gleam::Reflection::GetClass<T>().Guid();
 		auto relPath = path.is_relative() ? path : Gleam::Filesystem::Relative(path, mAssetDirectory);
+
+		std::lock_guard<std::mutex> lock(mMutex);
 		auto it = mAssetCache.find(relPath);
 		if (it != mAssetCache.end())
 		{
@@ -49,20 +97,49 @@ public:
 
 		GLEAM_ERROR("Asset could not located for path: {0}", relPath.string());
 		GLEAM_ASSERT(false);
-		static AssetItem invalidAsset;
-		return invalidAsset;
+		return AssetItem();
 	}
 
-	const AssetItem& GetAsset(const Gleam::Guid& guid) const;
+	AssetItem GetAsset(const Gleam::Guid& guid) const;
 
 private:
 
-	const AssetItem& RegisterAsset(const Gleam::Filesystem::Path& path, const Gleam::Guid& type);
+	AssetItem RegisterAsset(const Gleam::Filesystem::Path& path, const Gleam::Guid& type);
 
 	Gleam::Filesystem::Path mAssetDirectory;
+
+	void LoadImportRecords();
+
+	void SaveImportRecords() const;
+
+	Gleam::AssetDependencyGraph mDependencyGraph;
+
+	Gleam::HashMap<Gleam::AssetReference, AssetImportRecord> mImportRecords;
+
+	Gleam::Scope<Gleam::ThreadPool> mImportThreads;
+
+	// a single thread, imports write the same records and graph and run in the order they were queued
+	Gleam::Scope<Gleam::ThreadPool> mImportJobs;
+
+	// guards the asset cache and the progress, the rest is only touched by the running import
+	mutable std::mutex mMutex;
+
+	AssetImportProgress mImportProgress;
     
     Gleam::HashMap<Gleam::Filesystem::Path, Gleam::TArray<AssetItem>> mAssetCache;
 
 };
 
 } // namespace GEditor
+
+GLEAM_TYPE(GEditor::AssetImportRecord, Guid("9B4E2F61-3C8A-4D17-A5E9-6F0D8C2B7A34"))
+	GLEAM_FIELD(asset, Serializable())
+	GLEAM_FIELD(path, Serializable())
+	GLEAM_FIELD(source, Serializable())
+	GLEAM_FIELD(inputHash, Serializable())
+	GLEAM_FIELD(sidecar, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(GEditor::AssetImportTable, Guid("E6D3A95C-8F21-4B7E-9C40-2A5B1E8F6D93"))
+	GLEAM_FIELD(records, Serializable())
+GLEAM_END
@@ -2,6 +2,18 @@
 
 using namespace GEditor;
 
+// texture references live in the property value union, so they are not visible to reflection
+static void CollectTextureDependencies(const Gleam::TArray<Gleam::MaterialProperty>& properties, Gleam::TArray<Gleam::AssetReference>& dependencies)
+{
+	for (const auto& property : properties)
+	{
+		if (property.type == Gleam::MaterialPropertyType::Texture2D && property.value.texture.guid != Gleam::Guid::InvalidGuid())
+		{
+			dependencies.push_back(property.value.texture);
+		}
+	}
+}
+
 // MaterialBaker
 MaterialBaker::MaterialBaker(const Gleam::MaterialDescriptor& descriptor)
 	: mDescriptor(descriptor)
@@ -25,6 +37,13 @@ Gleam::Guid MaterialBaker::TypeGuid() const
     return Gleam::Reflection::GetClass<decltype(mDescriptor)>().Guid();
 }
 
+Gleam::TArray<Gleam::AssetReference> MaterialBaker::Dependencies() const
+{
+	Gleam::TArray<Gleam::AssetReference> dependencies;
+	CollectTextureDependencies(mDescriptor.properties, dependencies);
+	return dependencies;
+}
+
 // MaterialInstanceBaker
 MaterialInstanceBaker::MaterialInstanceBaker(const Gleam::MaterialInstanceDescriptor& descriptor)
 	: mDescriptor(descriptor)
@@ -47,3 +66,10 @@ Gleam::Guid MaterialInstanceBaker::TypeGuid() const
 {
     return Gleam::Reflection::GetClass<decltype(mDescriptor)>().Guid();
 }
+
+Gleam::TArray<Gleam::AssetReference> MaterialInstanceBaker::Dependencies() const
+{
+	Gleam::TArray<Gleam::AssetReference> dependencies = { mDescriptor.material };
+	CollectTextureDependencies(mDescriptor.properties, dependencies);
+	return dependencies;
+}
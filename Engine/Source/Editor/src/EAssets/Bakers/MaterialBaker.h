@@ -15,6 +15,8 @@ public:
     
     virtual Gleam::Guid TypeGuid() const override;
 
+    virtual Gleam::TArray<Gleam::AssetReference> Dependencies() const override;
+
 private:
 
 	Gleam::MaterialDescriptor mDescriptor;
@@ -33,6 +35,8 @@ public:
     
     virtual Gleam::Guid TypeGuid() const override;
 
+    virtual Gleam::TArray<Gleam::AssetReference> Dependencies() const override;
+
 private:
 
 	Gleam::MaterialInstanceDescriptor mDescriptor;
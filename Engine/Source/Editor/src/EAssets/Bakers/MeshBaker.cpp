@@ -2,16 +2,66 @@
 
 using namespace GEditor;
 
+// streams are aligned so that the mapped sidecar can be handed to the GPU upload as is
+static constexpr size_t SidecarAlignment = 16;
+
+template<typename T>
+static Gleam::MeshBufferView AppendBufferView(const Gleam::TArray<T>& stream, uint32_t stride, size_t& size)
+{
+	Gleam::MeshBufferView view;
+	view.offset = Gleam::Utils::AlignUp(size, SidecarAlignment);
+	view.length = stream.size() * sizeof(T);
+	view.stride = stride;
+	size = view.offset + view.length;
+	return view;
+}
+
+template<typename T>
+static void CopyBufferView(const Gleam::TArray<T>& stream, const Gleam::MeshBufferView& view, Gleam::TArray<uint8_t>& sidecar)
+{
+	memcpy(sidecar.data() + view.offset, stream.data(), view.length);
+}
+
 MeshBaker::MeshBaker(const Gleam::MeshDescriptor& descriptor)
-	: mDescriptor(descriptor)
+	: mDescriptor(descriptor), mIndices(descriptor.PackIndices())
 {
-	
+	uint32_t indexStride = static_cast<uint32_t>(Gleam::SizeOfIndexType(descriptor.indexType));
+	mBufferViews.indices = AppendBufferView(mIndices, indexStride, mSidecarSize);
+	mBufferViews.positions = AppendBufferView(descriptor.positions, sizeof(Gleam::Float3), mSidecarSize);
+	mBufferViews.interleavedVertices = AppendBufferView(descriptor.interleavedVertices, sizeof(Gleam::InterleavedMeshVertex), mSidecarSize);
+	mBufferViews.meshletVertices = AppendBufferView(descriptor.meshletVertices, sizeof(uint32_t), mSidecarSize);
+	mBufferViews.meshletTriangles = AppendBufferView(descriptor.meshletTriangles, 3, mSidecarSize);
 }
 
 void MeshBaker::Bake(Gleam::FileStream& stream) const
 {
+	// the asset keeps the metadata, vertex and index streams only as buffer views into the sidecar
+	Gleam::MeshDescriptor metadata;
+	metadata.name = mDescriptor.name;
+	metadata.indexType = mDescriptor.indexType;
+	metadata.submeshes = mDescriptor.submeshes;
+	metadata.lods = mDescriptor.lods;
+	metadata.meshlets = mDescriptor.meshlets;
+	metadata.buffers = mBufferViews;
+
 	auto serializer = Gleam::JSONSerializer(stream);
-	serializer.Serialize(mDescriptor);
+	serializer.SerializeStreaming(metadata);
+}
+
+bool MeshBaker::HasSidecar() const
+{
+	return true;
+}
+
+void MeshBaker::BakeSidecar(Gleam::FileStream& stream) const
+{
+	Gleam::TArray<uint8_t> sidecar(mSidecarSize);
+	CopyBufferView(mIndices, mBufferViews.indices, sidecar);
+	CopyBufferView(mDescriptor.positions, mBufferViews.positions, sidecar);
+	CopyBufferView(mDescriptor.interleavedVertices, mBufferViews.interleavedVertices, sidecar);
+	CopyBufferView(mDescriptor.meshletVertices, mBufferViews.meshletVertices, sidecar);
+	CopyBufferView(mDescriptor.meshletTriangles, mBufferViews.meshletTriangles, sidecar);
+	stream.write(reinterpret_cast<const char*>(sidecar.data()), sidecar.size());
 }
 
 Gleam::TString MeshBaker::Filename() const
@@ -15,10 +15,21 @@ public:
     
     virtual Gleam::Guid TypeGuid() const override;
 
+    virtual bool HasSidecar() const override;
+
+    virtual void BakeSidecar(Gleam::FileStream& stream) const override;
+
 private:
 
 	Gleam::MeshDescriptor mDescriptor;
 
+	// indices narrowed to the descriptor's indexType
+	Gleam::TArray<uint8_t> mIndices;
+
+	Gleam::MeshBufferViews mBufferViews;
+
+	size_t mSidecarSize = 0;
+
 };
 
 } // namespace GEditor
@@ -2,16 +2,49 @@
 
 using namespace GEditor;
 
+// levels are aligned so that the mapped sidecar can be handed to the GPU upload as is
+static constexpr size_t SidecarAlignment = 16;
+
 TextureBaker::TextureBaker(const Gleam::TextureDescriptor& descriptor)
 	: mDescriptor(descriptor)
 {
 	
 }
 
+TextureBaker::TextureBaker(const Gleam::TextureDescriptor& descriptor, Gleam::TArray<Gleam::TArray<uint8_t>>&& mips)
+	: mDescriptor(descriptor), mMips(std::move(mips))
+{
+	mDescriptor.pixels.clear();
+	mDescriptor.mips.clear();
+	for (const auto& mip : mMips)
+	{
+		Gleam::TextureMipView view;
+		view.offset = Gleam::Utils::AlignUp(mSidecarSize, SidecarAlignment);
+		view.length = mip.size();
+		mSidecarSize = view.offset + view.length;
+		mDescriptor.mips.push_back(view);
+	}
+}
+
 void TextureBaker::Bake(Gleam::FileStream& stream) const
 {
 	auto serializer = Gleam::JSONSerializer(stream);
-	serializer.Serialize(mDescriptor);
+	serializer.SerializeStreaming(mDescriptor);
+}
+
+bool TextureBaker::HasSidecar() const
+{
+	return mMips.empty() == false;
+}
+
+void TextureBaker::BakeSidecar(Gleam::FileStream& stream) const
+{
+	Gleam::TArray<uint8_t> sidecar(mSidecarSize);
+	for (uint32_t i = 0; i < mMips.size(); ++i)
+	{
+		memcpy(sidecar.data() + mDescriptor.mips[i].offset, mMips[i].data(), mMips[i].size());
+	}
+	stream.write(reinterpret_cast<const char*>(sidecar.data()), sidecar.size());
 }
 
 Gleam::TString TextureBaker::Filename() const
@@ -9,16 +9,27 @@ public:
 
 	TextureBaker(const Gleam::TextureDescriptor& descriptor);
 
+	// Levels are written to the sidecar, the asset only keeps their views
+	TextureBaker(const Gleam::TextureDescriptor& descriptor, Gleam::TArray<Gleam::TArray<uint8_t>>&& mips);
+
 	virtual void Bake(Gleam::FileStream& stream) const override;
     
     virtual Gleam::TString Filename() const override;
     
     virtual Gleam::Guid TypeGuid() const override;
 
+    virtual bool HasSidecar() const override;
+
+    virtual void BakeSidecar(Gleam::FileStream& stream) const override;
+
 private:
 
 	Gleam::TextureDescriptor mDescriptor;
 
+	Gleam::TArray<Gleam::TArray<uint8_t>> mMips;
+
+	size_t mSidecarSize = 0;
+
 };
 
 } // namespace GEditor
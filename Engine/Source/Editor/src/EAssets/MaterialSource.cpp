@@ -56,6 +56,34 @@ static Gleam::BlendMode BlendModeFromObject(const rapidjson::Value& object)
 	}
 }
 
+static Gleam::Filesystem::Path SurfaceShaderPath(const Gleam::Filesystem::Path& path, const rapidjson::Document& document)
+{
+    auto shaderPath = path;
+    shaderPath.remove_filename();
+    shaderPath /= document["SurfaceShader"].GetString();
+    if (shaderPath.has_extension() == false)
+    {
+        shaderPath += ".shader";
+    }
+    return shaderPath;
+}
+
+uint64_t MaterialSource::HashInputs(const Gleam::Filesystem::Path& path, const ImportSettings& settings)
+{
+    Gleam::TArray<Gleam::Filesystem::Path> sources = { path };
+    {
+        auto file = Gleam::Filesystem::Open(path, Gleam::FileType::Text);
+        rapidjson::IStreamWrapper ss(file.GetStream());
+        rapidjson::Document document;
+        document.ParseStream(ss);
+        if (document.IsObject() && document.HasMember("SurfaceShader"))
+        {
+            sources.push_back(SurfaceShaderPath(path, document));
+        }
+    }
+    return AssetPackage::HashInputs(sources, settings.Hash(), ImporterVersion);
+}
+
 bool MaterialSource::Import(const Gleam::Filesystem::Path& path, const ImportSettings& settings)
 {
     auto file = Gleam::Filesystem::Open(path, Gleam::FileType::Text);
@@ -130,16 +158,9 @@ bool MaterialSource::Import(const Gleam::Filesystem::Path& path, const ImportSet
     
     if (document.HasMember("SurfaceShader"))
     {
-        auto shaderPath = path;
-        shaderPath.remove_filename();
-        shaderPath /= document["SurfaceShader"].GetString();
+        auto shaderPath = SurfaceShaderPath(path, document);
         descriptor.surfaceShader = shaderPath.stem().string();
         
-        if (shaderPath.has_extension() == false)
-        {
-            shaderPath += ".shader";
-        }
-        
         auto generatedPath = shaderPath;
         generatedPath.concat(".gen.hlsl");
         {
@@ -301,6 +322,8 @@ bool MaterialSource::Import(const Gleam::Filesystem::Path& path, const ImportSet
 		}
 	}
     
-    bakers.emplace_back(Gleam::CreateRef<MaterialBaker>(descriptor));
+    auto baker = Gleam::CreateRef<MaterialBaker>(descriptor);
+    baker->SetInput(path, HashInputs(path, settings));
+    bakers.emplace_back(baker);
     return true;
 }
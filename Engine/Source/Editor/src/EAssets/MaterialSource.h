@@ -8,12 +8,18 @@ struct MaterialSource : AssetPackage
 {
 	AssetPackageType(MaterialSource);
 
+	// bumped whenever the generated shader or descriptor changes so that every material recompiles
+	static constexpr uint32_t ImporterVersion = 1;
+
 	struct ImportSettings
 	{
-		
+		uint64_t Hash() const { return 0; }
 	};
 
 	bool Import(const Gleam::Filesystem::Path& path, const ImportSettings& settings);
+
+	// Hash of the .mat file, its surface shader, the settings and the importer version
+	static uint64_t HashInputs(const Gleam::Filesystem::Path& path, const ImportSettings& settings);
 };
 
 } // namespace GEditor
@@ -0,0 +1,804 @@
+#include "Gleam.h"
+#include "MeshOptimizer.h"
+
+using namespace GEditor;
+
+namespace {
+
+struct VertexKey
+{
+    Gleam::Float3 position;
+    Gleam::Float3 normal;
+    Gleam::Float2 texCoord;
+
+    bool operator==(const VertexKey& other) const
+    {
+        return memcmp(this, &other, sizeof(VertexKey)) == 0;
+    }
+};
+
+struct VertexKeyHash
+{
+    size_t operator()(const VertexKey& key) const
+    {
+        size_t hash = 0;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            Gleam::hash_combine(hash, key.position[i]);
+            Gleam::hash_combine(hash, key.normal[i]);
+        }
+        Gleam::hash_combine(hash, key.texCoord.x);
+        Gleam::hash_combine(hash, key.texCoord.y);
+        return hash;
+    }
+};
+
+struct PositionHash
+{
+    size_t operator()(const Gleam::Float3& position) const
+    {
+        size_t hash = 0;
+        Gleam::hash_combine(hash, position.x);
+        Gleam::hash_combine(hash, position.y);
+        Gleam::hash_combine(hash, position.z);
+        return hash;
+    }
+};
+
+struct Quadric
+{
+    double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double weight = 0.0;
+
+    static Quadric FromPlane(const Gleam::Float3& normal, float distance, float weight)
+    {
+        Quadric q;
+        q.weight = weight;
+        q.a00 = weight * normal.x * normal.x;
+        q.a01 = weight * normal.x * normal.y;
+        q.a02 = weight * normal.x * normal.z;
+        q.a11 = weight * normal.y * normal.y;
+        q.a12 = weight * normal.y * normal.z;
+        q.a22 = weight * normal.z * normal.z;
+        q.b0 = weight * normal.x * distance;
+        q.b1 = weight * normal.y * distance;
+        q.b2 = weight * normal.z * distance;
+        q.c = weight * distance * distance;
+        return q;
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a00 += other.a00; a01 += other.a01; a02 += other.a02;
+        a11 += other.a11; a12 += other.a12; a22 += other.a22;
+        b0 += other.b0; b1 += other.b1; b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    double Error(const Gleam::Float3& v) const
+    {
+        double x = v.x, y = v.y, z = v.z;
+        return a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z
+             + a11 * y * y + 2.0 * a12 * y * z + a22 * z * z
+             + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+    }
+
+    // planes are area weighted, dividing by the total area gives a squared distance
+    double Distance(const Gleam::Float3& v) const
+    {
+        return weight > 0.0 ? std::sqrt(std::max(Error(v), 0.0) / weight) : 0.0;
+    }
+};
+
+struct TriangleAdjacency
+{
+    Gleam::TArray<uint32_t> offsets;
+    Gleam::TArray<uint32_t> counts;
+    Gleam::TArray<uint32_t> triangles;
+
+    TriangleAdjacency(const Gleam::TArray<uint32_t>& indices, uint32_t vertexCount)
+        : offsets(vertexCount, 0), counts(vertexCount, 0), triangles(indices.size())
+    {
+        for (auto index : indices)
+        {
+            counts[index]++;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            offsets[i] = offset;
+            offset += counts[i];
+        }
+
+        Gleam::TArray<uint32_t> fill(offsets);
+        for (uint32_t i = 0; i < indices.size(); ++i)
+        {
+            triangles[fill[indices[i]]++] = i / 3;
+        }
+    }
+};
+
+} // namespace
+
+void MeshOptimizer::WeldVertices(RawMesh& mesh)
+{
+    uint32_t vertexCount = static_cast<uint32_t>(mesh.positions.size());
+
+    Gleam::HashMap<VertexKey, uint32_t, VertexKeyHash> uniqueVertices;
+    uniqueVertices.reserve(vertexCount);
+
+    Gleam::TArray<uint32_t> remap(vertexCount);
+    RawMesh welded;
+    welded.positions.reserve(vertexCount);
+    welded.normals.reserve(vertexCount);
+    welded.texCoords.reserve(vertexCount);
+
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        VertexKey key{ mesh.positions[i], mesh.normals[i], mesh.texCoords[i] };
+        auto [it, inserted] = uniqueVertices.try_emplace(key, static_cast<uint32_t>(welded.positions.size()));
+        if (inserted)
+        {
+            welded.positions.push_back(mesh.positions[i]);
+            welded.normals.push_back(mesh.normals[i]);
+            welded.texCoords.push_back(mesh.texCoords[i]);
+        }
+        remap[i] = it->second;
+    }
+
+    for (auto& index : mesh.indices)
+    {
+        index = remap[index];
+    }
+    mesh.positions = std::move(welded.positions);
+    mesh.normals = std::move(welded.normals);
+    mesh.texCoords = std::move(welded.texCoords);
+}
+
+Gleam::TArray<uint32_t> MeshOptimizer::OptimizeVertexCache(const Gleam::TArray<uint32_t>& indices, uint32_t vertexCount, Gleam::TArray<uint32_t>& clusters, uint32_t cacheSize)
+{
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    TriangleAdjacency adjacency(indices, vertexCount);
+
+    Gleam::TArray<uint32_t> liveTriangles(adjacency.counts);
+    Gleam::TArray<uint32_t> cacheTimestamps(vertexCount, 0);
+    Gleam::TArray<bool> emitted(triangleCount, false);
+    Gleam::TArray<uint32_t> deadEnds;
+    deadEnds.reserve(indices.size());
+
+    Gleam::TArray<uint32_t> result;
+    result.reserve(indices.size());
+
+    uint32_t timestamp = cacheSize + 1;
+    uint32_t cursor = 0;
+
+    auto skipDeadEnd = [&]() -> int32_t
+    {
+        while (!deadEnds.empty())
+        {
+            uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[vertex] > 0)
+                return static_cast<int32_t>(vertex);
+        }
+
+        for (; cursor < vertexCount; ++cursor)
+        {
+            if (liveTriangles[cursor] > 0)
+                return static_cast<int32_t>(cursor);
+        }
+        return -1;
+    };
+
+    int32_t fanningVertex = skipDeadEnd();
+    while (fanningVertex >= 0)
+    {
+        uint32_t candidateStart = static_cast<uint32_t>(deadEnds.size());
+
+        uint32_t offset = adjacency.offsets[fanningVertex];
+        uint32_t count = adjacency.counts[fanningVertex];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t triangle = adjacency.triangles[offset + i];
+            if (emitted[triangle])
+                continue;
+
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                uint32_t vertex = indices[triangle * 3 + k];
+                result.push_back(vertex);
+                deadEnds.push_back(vertex);
+                liveTriangles[vertex]--;
+
+                if (timestamp - cacheTimestamps[vertex] > cacheSize)
+                {
+                    cacheTimestamps[vertex] = timestamp++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // pick the candidate that will still be in cache after its remaining triangles are emitted
+        int32_t nextVertex = -1;
+        int32_t bestPriority = -1;
+        for (uint32_t i = candidateStart; i < deadEnds.size(); ++i)
+        {
+            uint32_t vertex = deadEnds[i];
+            if (liveTriangles[vertex] == 0)
+                continue;
+
+            int32_t priority = 0;
+            if (timestamp - cacheTimestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+            {
+                priority = static_cast<int32_t>(timestamp - cacheTimestamps[vertex]);
+            }
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                nextVertex = static_cast<int32_t>(vertex);
+            }
+        }
+
+        if (nextVertex < 0)
+        {
+            clusters.push_back(static_cast<uint32_t>(result.size() / 3));
+            nextVertex = skipDeadEnd();
+        }
+        fanningVertex = nextVertex;
+    }
+
+    // the cluster list holds start triangles, the first cluster always starts at 0
+    if (!clusters.empty())
+    {
+        clusters.pop_back();
+    }
+    clusters.insert(clusters.begin(), 0);
+    return result;
+}
+
+Gleam::TArray<uint32_t> MeshOptimizer::OptimizeOverdraw(const Gleam::TArray<uint32_t>& indices, const Gleam::TArray<Gleam::Float3>& positions, const Gleam::TArray<uint32_t>& clusters)
+{
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (clusters.size() < 2)
+        return indices;
+
+    Gleam::Float3 meshCentroid = Gleam::Float3::zero;
+    float meshArea = 0.0f;
+
+    struct ClusterSortData
+    {
+        uint32_t cluster;
+        float key;
+    };
+    Gleam::TArray<ClusterSortData> sortData(clusters.size());
+    Gleam::TArray<Gleam::Float3> clusterCentroids(clusters.size(), Gleam::Float3::zero);
+    Gleam::TArray<Gleam::Float3> clusterNormals(clusters.size(), Gleam::Float3::zero);
+
+    for (uint32_t c = 0; c < clusters.size(); ++c)
+    {
+        uint32_t begin = clusters[c];
+        uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+        float clusterArea = 0.0f;
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            const auto& p0 = positions[indices[t * 3 + 0]];
+            const auto& p1 = positions[indices[t * 3 + 1]];
+            const auto& p2 = positions[indices[t * 3 + 2]];
+
+            // cross product length is twice the area, area weighted normals fall out for free
+            auto normal = Gleam::Math::Cross(p1 - p0, p2 - p0);
+            float area = Gleam::Math::Length(normal);
+
+            clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+            clusterNormals[c] += normal;
+            clusterArea += area;
+        }
+
+        meshCentroid += clusterCentroids[c];
+        meshArea += clusterArea;
+
+        clusterCentroids[c] = clusterArea > 0.0f ? clusterCentroids[c] / clusterArea : positions[indices[begin * 3]];
+        float normalLength = Gleam::Math::Length(clusterNormals[c]);
+        clusterNormals[c] = normalLength > 0.0f ? clusterNormals[c] / normalLength : Gleam::Float3::zero;
+    }
+    meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : Gleam::Float3::zero;
+
+    for (uint32_t c = 0; c < clusters.size(); ++c)
+    {
+        sortData[c].cluster = c;
+        sortData[c].key = Gleam::Math::Dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]);
+    }
+
+    std::stable_sort(sortData.begin(), sortData.end(), [](const ClusterSortData& a, const ClusterSortData& b)
+    {
+        return a.key > b.key;
+    });
+
+    Gleam::TArray<uint32_t> result;
+    result.reserve(indices.size());
+    for (const auto& data : sortData)
+    {
+        uint32_t begin = clusters[data.cluster];
+        uint32_t end = data.cluster + 1 < clusters.size() ? clusters[data.cluster + 1] : triangleCount;
+        result.insert(result.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+    }
+    return result;
+}
+
+void MeshOptimizer::OptimizeVertexFetch(RawMesh& mesh)
+{
+    constexpr uint32_t InvalidIndex = ~0u;
+    Gleam::TArray<uint32_t> remap(mesh.positions.size(), InvalidIndex);
+
+    uint32_t vertexCount = 0;
+    for (auto& index : mesh.indices)
+    {
+        if (remap[index] == InvalidIndex)
+        {
+            remap[index] = vertexCount++;
+        }
+        index = remap[index];
+    }
+
+    Gleam::TArray<Gleam::Float3> positions(vertexCount);
+    Gleam::TArray<Gleam::Float3> normals(vertexCount);
+    Gleam::TArray<Gleam::Float2> texCoords(vertexCount);
+    for (uint32_t i = 0; i < remap.size(); ++i)
+    {
+        if (remap[i] == InvalidIndex)
+            continue;
+
+        positions[remap[i]] = mesh.positions[i];
+        normals[remap[i]] = mesh.normals[i];
+        texCoords[remap[i]] = mesh.texCoords[i];
+    }
+    mesh.positions = std::move(positions);
+    mesh.normals = std::move(normals);
+    mesh.texCoords = std::move(texCoords);
+}
+
+void MeshOptimizer::BuildMeshlets(Gleam::MeshDescriptor& mesh)
+{
+    constexpr uint32_t InvalidIndex = ~0u;
+    auto indices = mesh.GetIndices();
+
+    mesh.meshlets.clear();
+    mesh.meshletVertices.clear();
+    mesh.meshletTriangles.clear();
+
+    for (auto& submesh : mesh.submeshes)
+    {
+        submesh.firstMeshlet = static_cast<uint32_t>(mesh.meshlets.size());
+
+        uint32_t submeshVertexCount = 0;
+        for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i)
+        {
+            submeshVertexCount = Gleam::Math::Max(submeshVertexCount, indices[i] + 1);
+        }
+        Gleam::TArray<uint32_t> owners(submeshVertexCount, InvalidIndex);
+        Gleam::TArray<uint8_t> localIds(submeshVertexCount, 0);
+
+        Gleam::MeshletDescriptor meshlet;
+        auto beginMeshlet = [&](uint32_t firstIndex)
+        {
+            meshlet = Gleam::MeshletDescriptor();
+            meshlet.firstIndex = firstIndex;
+            meshlet.vertexOffset = static_cast<uint32_t>(mesh.meshletVertices.size());
+            meshlet.triangleOffset = static_cast<uint32_t>(mesh.meshletTriangles.size());
+        };
+
+        auto finishMeshlet = [&]()
+        {
+            if (meshlet.triangleCount == 0)
+                return;
+
+            auto position = [&](uint32_t localId)
+            {
+                return mesh.positions[submesh.baseVertex + mesh.meshletVertices[meshlet.vertexOffset + localId]];
+            };
+
+            Gleam::BoundingBox bounds(Gleam::Math::Infinity, Gleam::Math::NegativeInfinity);
+            for (uint32_t v = 0; v < meshlet.vertexCount; ++v)
+            {
+                bounds.min = Gleam::Math::Min(bounds.min, position(v));
+                bounds.max = Gleam::Math::Max(bounds.max, position(v));
+            }
+            meshlet.bounds.center = (bounds.min + bounds.max) * 0.5f;
+            for (uint32_t v = 0; v < meshlet.vertexCount; ++v)
+            {
+                meshlet.bounds.radius = Gleam::Math::Max(meshlet.bounds.radius, Gleam::Math::Length(position(v) - meshlet.bounds.center));
+            }
+
+            Gleam::TArray<Gleam::Float3> normals;
+            normals.reserve(meshlet.triangleCount);
+            Gleam::Float3 axis = Gleam::Float3::zero;
+            for (uint32_t t = 0; t < meshlet.triangleCount; ++t)
+            {
+                const auto* triangle = &mesh.meshletTriangles[meshlet.triangleOffset + t * 3];
+                auto p0 = position(triangle[0]);
+                auto normal = Gleam::Math::Cross(position(triangle[1]) - p0, position(triangle[2]) - p0);
+                float length = Gleam::Math::Length(normal);
+                if (length <= 0.0f)
+                    continue;
+
+                normals.push_back(normal / length);
+                axis += normals.back();
+            }
+
+            // cones wider than ~84 degrees can not be culled reliably, keep the cutoff at 1 so they never are
+            float axisLength = Gleam::Math::Length(axis);
+            if (axisLength > 0.0f)
+            {
+                axis = axis / axisLength;
+                float minDot = 1.0f;
+                for (const auto& normal : normals)
+                {
+                    minDot = Gleam::Math::Min(minDot, Gleam::Math::Dot(normal, axis));
+                }
+
+                meshlet.coneAxis = axis;
+                meshlet.coneCutoff = minDot > 0.1f ? Gleam::Math::Sqrt(1.0f - minDot * minDot) : 1.0f;
+            }
+
+            mesh.meshlets.push_back(meshlet);
+        };
+
+        beginMeshlet(submesh.firstIndex);
+        for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i += 3)
+        {
+            uint32_t meshletIndex = static_cast<uint32_t>(mesh.meshlets.size());
+
+            uint32_t newVertexCount = 0;
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                newVertexCount += owners[indices[i + k]] != meshletIndex;
+            }
+            // a triangle may repeat a vertex, overestimating here only splits a little early
+            if (meshlet.vertexCount + newVertexCount > Gleam::MeshletDescriptor::MaxVertexCount ||
+                meshlet.triangleCount + 1 > Gleam::MeshletDescriptor::MaxTriangleCount)
+            {
+                finishMeshlet();
+                beginMeshlet(i);
+                meshletIndex = static_cast<uint32_t>(mesh.meshlets.size());
+            }
+
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                uint32_t vertex = indices[i + k];
+                if (owners[vertex] != meshletIndex)
+                {
+                    owners[vertex] = meshletIndex;
+                    localIds[vertex] = static_cast<uint8_t>(meshlet.vertexCount++);
+                    mesh.meshletVertices.push_back(vertex);
+                }
+                mesh.meshletTriangles.push_back(localIds[vertex]);
+            }
+            meshlet.triangleCount++;
+            meshlet.indexCount += 3;
+        }
+        finishMeshlet();
+
+        submesh.meshletCount = static_cast<uint32_t>(mesh.meshlets.size()) - submesh.firstMeshlet;
+    }
+}
+
+Gleam::TArray<uint32_t> MeshOptimizer::Simplify(const Gleam::TArray<uint32_t>& indices, const Gleam::TArray<Gleam::Float3>& positions, const Gleam::TArray<Gleam::InterleavedMeshVertex>& attributes, uint32_t targetIndexCount, float* resultError)
+{
+    uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+    bool hasAttributes = attributes.size() == positions.size();
+
+    // vertices sharing a position with different attributes are seams, collapsing them would tear the surface
+    // exact duplicates are not, they are simplified as the first of them
+    Gleam::TArray<bool> locked(vertexCount, false);
+    Gleam::TArray<uint32_t> canonical(vertexCount);
+    std::iota(canonical.begin(), canonical.end(), 0);
+    {
+        Gleam::HashMap<Gleam::Float3, uint32_t, PositionHash> uniquePositions;
+        uniquePositions.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            auto [it, inserted] = uniquePositions.try_emplace(positions[v], v);
+            if (inserted)
+                continue;
+
+            uint32_t first = it->second;
+            if (hasAttributes && attributes[v].normal == attributes[first].normal && attributes[v].texCoord == attributes[first].texCoord)
+            {
+                canonical[v] = first;
+            }
+            else
+            {
+                locked[v] = locked[first] = true;
+            }
+        }
+    }
+
+    Gleam::TArray<uint32_t> result(indices.size());
+    for (uint32_t i = 0; i < indices.size(); ++i)
+    {
+        result[i] = canonical[indices[i]];
+    }
+
+    // edges referenced by a single triangle are open borders
+    {
+        Gleam::HashMap<uint64_t, uint32_t> edges;
+        edges.reserve(result.size());
+        for (uint32_t i = 0; i < result.size(); i += 3)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                uint64_t a = result[i + k];
+                uint64_t b = result[i + (k + 1) % 3];
+                edges[a < b ? (a << 32) | b : (b << 32) | a]++;
+            }
+        }
+
+        for (const auto& [edge, count] : edges)
+        {
+            if (count == 1)
+            {
+                locked[static_cast<uint32_t>(edge >> 32)] = true;
+                locked[static_cast<uint32_t>(edge & 0xFFFFFFFF)] = true;
+            }
+        }
+    }
+
+    Gleam::TArray<Quadric> quadrics(vertexCount);
+    for (uint32_t i = 0; i < result.size(); i += 3)
+    {
+        const auto& p0 = positions[result[i + 0]];
+        const auto& p1 = positions[result[i + 1]];
+        const auto& p2 = positions[result[i + 2]];
+
+        auto normal = Gleam::Math::Cross(p1 - p0, p2 - p0);
+        float length = Gleam::Math::Length(normal);
+        if (length <= 0.0f)
+            continue;
+
+        normal = normal / length;
+        auto quadric = Quadric::FromPlane(normal, -Gleam::Math::Dot(normal, p0), length * 0.5f);
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            quadrics[result[i + k]] += quadric;
+        }
+    }
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+    float maxError = 0.0f;
+    Gleam::TArray<uint32_t> remap(vertexCount);
+    Gleam::TArray<bool> touched(vertexCount);
+    Gleam::TArray<Collapse> collapses;
+    while (result.size() > targetIndexCount)
+    {
+        collapses.clear();
+        for (uint32_t i = 0; i < result.size(); i += 3)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                uint32_t from = result[i + k];
+                uint32_t to = result[i + (k + 1) % 3];
+                if (!locked[from])
+                {
+                    collapses.push_back({ from, to, quadrics[from].Error(positions[to]) + quadrics[to].Error(positions[to]) });
+                }
+                if (!locked[to])
+                {
+                    collapses.push_back({ to, from, quadrics[from].Error(positions[from]) + quadrics[to].Error(positions[from]) });
+                }
+            }
+        }
+
+        if (collapses.empty())
+            break;
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b)
+        {
+            return a.cost < b.cost;
+        });
+
+        TriangleAdjacency adjacency(result, vertexCount);
+        std::iota(remap.begin(), remap.end(), 0);
+        std::fill(touched.begin(), touched.end(), false);
+
+        uint32_t trianglesToRemove = static_cast<uint32_t>(result.size() - targetIndexCount) / 3;
+        uint32_t removedTriangles = 0;
+        for (const auto& collapse : collapses)
+        {
+            if (removedTriangles >= trianglesToRemove)
+                break;
+
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+
+            uint32_t offset = adjacency.offsets[collapse.from];
+            uint32_t count = adjacency.counts[collapse.from];
+
+            // reject collapses that would flip a triangle around the removed vertex
+            bool flipped = false;
+            uint32_t collapsedTriangles = 0;
+            for (uint32_t t = 0; t < count && !flipped; ++t)
+            {
+                const auto* triangle = &result[adjacency.triangles[offset + t] * 3];
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                {
+                    collapsedTriangles++;
+                    continue;
+                }
+
+                Gleam::TArray<Gleam::Float3, 3> before = { positions[triangle[0]], positions[triangle[1]], positions[triangle[2]] };
+                Gleam::TArray<Gleam::Float3, 3> after = before;
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    if (triangle[k] == collapse.from)
+                    {
+                        after[k] = positions[collapse.to];
+                    }
+                }
+
+                auto normalBefore = Gleam::Math::Cross(before[1] - before[0], before[2] - before[0]);
+                auto normalAfter = Gleam::Math::Cross(after[1] - after[0], after[2] - after[0]);
+                flipped = Gleam::Math::Dot(normalBefore, normalAfter) <= 0.0f;
+            }
+
+            if (flipped || collapsedTriangles == 0)
+                continue;
+
+            for (uint32_t t = 0; t < count; ++t)
+            {
+                const auto* triangle = &result[adjacency.triangles[offset + t] * 3];
+                touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+            }
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            maxError = Gleam::Math::Max(maxError, static_cast<float>(quadrics[collapse.to].Distance(positions[collapse.to])));
+            removedTriangles += collapsedTriangles;
+        }
+
+        if (removedTriangles == 0)
+            break;
+
+        uint32_t writeIndex = 0;
+        for (uint32_t i = 0; i < result.size(); i += 3)
+        {
+            uint32_t v0 = remap[result[i + 0]];
+            uint32_t v1 = remap[result[i + 1]];
+            uint32_t v2 = remap[result[i + 2]];
+            if (v0 == v1 || v1 == v2 || v2 == v0)
+                continue;
+
+            result[writeIndex++] = v0;
+            result[writeIndex++] = v1;
+            result[writeIndex++] = v2;
+        }
+        result.resize(writeIndex);
+    }
+
+    if (resultError)
+    {
+        *resultError = maxError;
+    }
+    return result;
+}
+
+void MeshOptimizer::GenerateLods(Gleam::MeshDescriptor& mesh, uint32_t lodCount, float lodRatio, float maxScreenError)
+{
+    auto indices = mesh.GetIndices();
+    mesh.lods.clear();
+
+    Gleam::TArray<uint32_t> lodIndices;
+    for (auto& submesh : mesh.submeshes)
+    {
+        submesh.firstLod = static_cast<uint32_t>(mesh.lods.size());
+        submesh.lodCount = 0;
+
+        Gleam::TArray<uint32_t> source(indices.begin() + submesh.firstIndex, indices.begin() + submesh.firstIndex + submesh.indexCount);
+        if (source.empty())
+            continue;
+
+        uint32_t vertexCount = *std::max_element(source.begin(), source.end()) + 1;
+        Gleam::TArray<Gleam::Float3> positions(mesh.positions.begin() + submesh.baseVertex, mesh.positions.begin() + submesh.baseVertex + vertexCount);
+        Gleam::TArray<Gleam::InterleavedMeshVertex> attributes;
+        if (mesh.interleavedVertices.size() >= submesh.baseVertex + vertexCount)
+        {
+            attributes.assign(mesh.interleavedVertices.begin() + submesh.baseVertex, mesh.interleavedVertices.begin() + submesh.baseVertex + vertexCount);
+        }
+
+        float diameter = Gleam::Math::Length(submesh.bounds.max - submesh.bounds.min);
+        float error = 0.0f;
+        float screenSize = 1.0f;
+        for (uint32_t level = 0; level < lodCount; ++level)
+        {
+            uint32_t targetIndexCount = static_cast<uint32_t>(source.size() / 3 * lodRatio) * 3;
+            float levelError = 0.0f;
+            auto simplified = Simplify(source, positions, attributes, targetIndexCount, &levelError);
+
+            // stop the chain once the mesh no longer gets meaningfully simpler
+            if (simplified.empty() || simplified.size() > source.size() * 0.9f)
+                break;
+
+            Gleam::TArray<uint32_t> clusters;
+            simplified = OptimizeVertexCache(simplified, vertexCount, clusters);
+
+            // every level simplifies the previous one, so their errors add up
+            // the level is used once that error projects to at most maxScreenError of the screen height
+            error += levelError;
+            if (error > 0.0f)
+            {
+                screenSize = Gleam::Math::Min(screenSize, maxScreenError * diameter / error);
+            }
+
+            Gleam::MeshLodDescriptor lod;
+            lod.firstIndex = static_cast<uint32_t>(indices.size() + lodIndices.size());
+            lod.indexCount = static_cast<uint32_t>(simplified.size());
+            lod.screenSize = screenSize;
+            mesh.lods.push_back(lod);
+            submesh.lodCount++;
+
+            lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.end());
+            source = std::move(simplified);
+        }
+    }
+
+    indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+    mesh.SetIndices(indices);
+}
+
+VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const Gleam::TArray<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    VertexCacheStatistics stats;
+    if (indices.empty() || vertexCount == 0)
+        return stats;
+
+    // FIFO cache simulation, a vertex is a hit if it was transformed within the last cacheSize misses
+    Gleam::TArray<uint32_t> cacheTimestamps(vertexCount, 0);
+    uint32_t timestamp = cacheSize + 1;
+    uint32_t misses = 0;
+    for (auto index : indices)
+    {
+        if (timestamp - cacheTimestamps[index] > cacheSize)
+        {
+            cacheTimestamps[index] = timestamp++;
+            misses++;
+        }
+    }
+
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(vertexCount);
+    return stats;
+}
+
+void MeshOptimizer::Optimize(RawMesh& mesh)
+{
+    if (mesh.indices.empty())
+        return;
+
+    auto sourceVertexCount = static_cast<uint32_t>(mesh.positions.size());
+    auto before = AnalyzeVertexCache(mesh.indices, sourceVertexCount);
+
+    WeldVertices(mesh);
+
+    Gleam::TArray<uint32_t> clusters;
+    auto vertexCount = static_cast<uint32_t>(mesh.positions.size());
+    mesh.indices = OptimizeVertexCache(mesh.indices, vertexCount, clusters);
+    mesh.indices = OptimizeOverdraw(mesh.indices, mesh.positions, clusters);
+
+    OptimizeVertexFetch(mesh);
+
+    vertexCount = static_cast<uint32_t>(mesh.positions.size());
+    auto after = AnalyzeVertexCache(mesh.indices, vertexCount);
+    GLEAM_INFO("Mesh optimized: {0} Vertices: {1} -> {2} ACMR: {3:.3f} -> {4:.3f} ATVR: {5:.3f} -> {6:.3f}", mesh.name, sourceVertexCount, vertexCount, before.acmr, after.acmr, before.atvr, after.atvr);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "MeshSource.h"
+
+namespace GEditor {
+
+struct VertexCacheStatistics
+{
+    float acmr = 0.0f; // average cache miss ratio: transformed vertices per triangle
+    float atvr = 0.0f; // average transform to vertex ratio: transformed vertices per unique vertex
+};
+
+namespace MeshOptimizer {
+
+static constexpr uint32_t VertexCacheSize = 16;
+
+/*
+* Merges vertices whose position, normal and texCoord are bitwise identical
+* and remaps the index buffer to the unique set
+*/
+void WeldVertices(RawMesh& mesh);
+
+/*
+* Tipsify (Sander et al. 2007) vertex cache reordering
+* Appends the first triangle of every cluster (cache break) to clusters
+*/
+Gleam::TArray<uint32_t> OptimizeVertexCache(const Gleam::TArray<uint32_t>& indices, uint32_t vertexCount, Gleam::TArray<uint32_t>& clusters, uint32_t cacheSize = VertexCacheSize);
+
+/*
+* Sorts the clusters produced by OptimizeVertexCache so that outward facing
+* clusters far from the mesh centroid are drawn first
+*/
+Gleam::TArray<uint32_t> OptimizeOverdraw(const Gleam::TArray<uint32_t>& indices, const Gleam::TArray<Gleam::Float3>& positions, const Gleam::TArray<uint32_t>& clusters);
+
+/*
+* Reorders vertex streams in the order they are first referenced by the index buffer
+* Unreferenced vertices are dropped
+*/
+void OptimizeVertexFetch(RawMesh& mesh);
+
+/*
+* Splits every submesh into meshlets in index buffer order so that each meshlet
+* stays a contiguous index range, computes their bounding spheres and normal cones
+*/
+void BuildMeshlets(Gleam::MeshDescriptor& mesh);
+
+// One pixel at 1080p, LODs switch once their simplification error projects below it
+static constexpr float LodScreenError = 1.0f / 1080.0f;
+
+/*
+* Quadric error metric edge collapse (Garland & Heckbert 1997) towards targetIndexCount
+* Vertices are only collapsed onto existing ones, border vertices and attribute seams are locked
+* A seam is a position shared by vertices with different attributes, without attributes every shared position is one
+* resultError receives the largest distance of a collapsed vertex from its original surface
+*/
+Gleam::TArray<uint32_t> Simplify(const Gleam::TArray<uint32_t>& indices, const Gleam::TArray<Gleam::Float3>& positions, const Gleam::TArray<Gleam::InterleavedMeshVertex>& attributes, uint32_t targetIndexCount, float* resultError = nullptr);
+
+/*
+* Appends a LOD chain for every submesh to the end of the index buffer,
+* each level targets lodRatio of the triangles of the previous one
+* Screen size thresholds come from the accumulated simplification error relative to the submesh bounds
+*/
+void GenerateLods(Gleam::MeshDescriptor& mesh, uint32_t lodCount, float lodRatio = 0.5f, float maxScreenError = LodScreenError);
+
+VertexCacheStatistics AnalyzeVertexCache(const Gleam::TArray<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = VertexCacheSize);
+
+// Runs every stage in order and logs the vertex cache statistics before and after
+void Optimize(RawMesh& mesh);
+
+} // namespace MeshOptimizer
+
+} // namespace GEditor
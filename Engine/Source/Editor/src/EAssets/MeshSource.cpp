@@ -1,5 +1,6 @@
 #include "Gleam.h"
 #include "MeshSource.h"
+#include "MeshOptimizer.h"
 #include "TextureSource.h"
 #include "MaterialSource.h"
 #include "AssetRegistry.h"
@@ -32,6 +33,30 @@ bool MeshSource::Import(const Gleam::Filesystem::Path& path, const ImportSetting
 		return false;
 	}
 
+	// the glTF, its external buffers and images are the inputs, nothing is unpacked when none of them changed
+	Gleam::TArray<Gleam::Filesystem::Path> sources = { path };
+	for (uint32_t i = 0; i < data->buffers_count; ++i)
+	{
+		if (auto uri = data->buffers[i].uri; uri && strncmp(uri, "data:", 5) != 0)
+		{
+			sources.push_back(path.parent_path() / uri);
+		}
+	}
+	for (uint32_t i = 0; i < data->images_count; ++i)
+	{
+		if (auto uri = data->images[i].uri; uri && strncmp(uri, "data:", 5) != 0)
+		{
+			sources.push_back(path.parent_path() / uri);
+		}
+	}
+
+	auto inputHash = AssetPackage::HashInputs(sources, settings.Hash(), ImporterVersion);
+	if (upToDate = registry->FindUpToDate(path, inputHash); upToDate > 0)
+	{
+		cgltf_free(data);
+		return true;
+	}
+
 	result = cgltf_load_buffers(&options, data, gltfPath.c_str());
 	if (result != cgltf_result_success)
 	{
@@ -41,23 +66,30 @@ bool MeshSource::Import(const Gleam::Filesystem::Path& path, const ImportSetting
     
     auto filename = path.stem().string();
 
-	Gleam::TArray<RawMesh> meshes;
+    // materials are deduplicated in primitive order, the primitives themselves are unpacked on every core
+    struct Primitive
+    {
+        const cgltf_primitive* primitive;
+        Gleam::TString name;
+        Gleam::TString material;
+    };
+    Gleam::TArray<Primitive> primitives;
     Gleam::TArray<RawMaterial> materials;
     for(uint32_t i = 0; i < data->meshes_count; ++i)
     {
         const auto& mesh = data->meshes[i];
         for(uint32_t meshIdx = 0; meshIdx < mesh.primitives_count; ++meshIdx)
         {
-            auto rawMesh = ProcessAttributes(mesh.primitives[meshIdx], settings);
+            Primitive primitive = { .primitive = &mesh.primitives[meshIdx] };
 			if (mesh.name)
 			{
-				rawMesh.name = mesh.name;
+				primitive.name = mesh.name;
 			}
             else
             {
                 Gleam::TStringStream ss;
                 ss << filename << "_mesh" << i * data->meshes_count + meshIdx;
-                rawMesh.name = ss.str();
+                primitive.name = ss.str();
             }
             
 			RawMaterial material;
@@ -80,31 +112,56 @@ bool MeshSource::Import(const Gleam::Filesystem::Path& path, const ImportSetting
             auto materialIt = std::find(materials.begin(), materials.end(), material);
             if (materialIt == materials.end())
             {
-                uint32_t materialIdx = static_cast<uint32_t>(materials.size());
                 materials.push_back(material);
-				rawMesh.material = material.name;
+				primitive.material = material.name;
             }
             else
             {
-                rawMesh.material = materialIt->name;
+                primitive.material = materialIt->name;
             }
-            meshes.push_back(rawMesh);
+            primitives.push_back(primitive);
         }
     }
+
+    auto& threadPool = registry->GetImportThreads();
+	Gleam::TArray<RawMesh> meshes(primitives.size());
+    threadPool.ParallelFor(static_cast<uint32_t>(primitives.size()), [&](uint32_t i)
+    {
+        auto& rawMesh = meshes[i];
+        rawMesh = ProcessAttributes(*primitives[i].primitive, settings);
+        rawMesh.name = primitives[i].name;
+        rawMesh.material = primitives[i].material;
+        if (settings.optimizeMeshes)
+        {
+            MeshOptimizer::Optimize(rawMesh);
+        }
+    });
     
     if (settings.combineMeshes)
     {
         auto combined = CombineMeshes(meshes);
         combined.name = filename;
-        bakers.emplace_back(Gleam::CreateRef<MeshBaker>(combined));
+        if (settings.lodCount > 0)
+        {
+            MeshOptimizer::GenerateLods(combined, settings.lodCount);
+        }
+        if (settings.generateMeshlets)
+        {
+            MeshOptimizer::BuildMeshlets(combined);
+        }
+        auto baker = Gleam::CreateRef<MeshBaker>(combined);
+        baker->SetInput(path, inputHash);
+        bakers.emplace_back(baker);
     }
     else
     {
-        for (const auto& mesh : meshes)
+        Gleam::TArray<Gleam::RefCounted<MeshBaker>> meshBakers(meshes.size());
+        threadPool.ParallelFor(static_cast<uint32_t>(meshes.size()), [&](uint32_t i)
         {
+            const auto& mesh = meshes[i];
             Gleam::MeshDescriptor descriptor;
             descriptor.name = mesh.name;
-            descriptor.indices = mesh.indices;
+            descriptor.SetIndices(mesh.indices);
             descriptor.positions = mesh.positions;
             descriptor.interleavedVertices = InterleaveMeshVertices(mesh);
             
@@ -112,10 +169,25 @@ bool MeshSource::Import(const Gleam::Filesystem::Path& path, const ImportSetting
             submesh.bounds = CalculateBounds(mesh.positions);
             submesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
             descriptor.submeshes.push_back(submesh);
+            if (settings.lodCount > 0)
+            {
+                MeshOptimizer::GenerateLods(descriptor, settings.lodCount);
+            }
+            if (settings.generateMeshlets)
+            {
+                MeshOptimizer::BuildMeshlets(descriptor);
+            }
 
-			auto meshPath = path.parent_path() / mesh.name;
+            meshBakers[i] = Gleam::CreateRef<MeshBaker>(descriptor);
+            meshBakers[i]->SetInput(path, inputHash);
+        });
+
+        // the registry is only touched from this thread, in primitive order
+        for (uint32_t i = 0; i < meshes.size(); ++i)
+        {
+			auto meshPath = path.parent_path() / meshes[i].name;
 			registry->RegisterAsset<Gleam::MeshDescriptor>(meshPath);
-            bakers.emplace_back(Gleam::CreateRef<MeshBaker>(descriptor));
+            bakers.emplace_back(meshBakers[i]);
         }
     }
 
@@ -123,8 +195,36 @@ bool MeshSource::Import(const Gleam::Filesystem::Path& path, const ImportSetting
 	auto transparentLitMaterialAsset = registry->GetAsset<Gleam::MaterialDescriptor>("Materials/TransparentLit").reference;
 
 	auto assetManager = Gleam::Globals::GameInstance->GetSubsystem<Gleam::AssetManager>();
-	auto opaqueLitMaterial = assetManager->Get<Gleam::MaterialDescriptor>(opaqueLitMaterialAsset);
-	auto transparentLitMaterial = assetManager->Get<Gleam::MaterialDescriptor>(transparentLitMaterialAsset);
+	auto opaqueLitMaterial = assetManager->Load<Gleam::MaterialDescriptor>(opaqueLitMaterialAsset);
+	auto transparentLitMaterial = assetManager->Load<Gleam::MaterialDescriptor>(transparentLitMaterialAsset);
+
+	// materials share their textures, every image is imported once with the settings of the first slot using it
+	Gleam::HashMap<Gleam::Filesystem::Path, Gleam::AssetReference> textures;
+	auto importTexture = [&](const Gleam::Filesystem::Path& texture, const TextureSource::ImportSettings& textureSettings)
+	{
+		if (texture.empty())
+		{
+			return Gleam::AssetReference();
+		}
+
+		auto texturePath = path.parent_path() / texture;
+		if (auto it = textures.find(texturePath); it != textures.end())
+		{
+			return it->second;
+		}
+
+		auto reference = Gleam::AssetReference();
+		auto textureSource = TextureSource(registry);
+		if (textureSource.Import(texturePath, textureSettings))
+		{
+			reference = registry->GetAsset<Gleam::TextureDescriptor>(texturePath.parent_path() / texturePath.stem()).reference;
+			bakers.insert(bakers.end(), textureSource.bakers.begin(), textureSource.bakers.end());
+			upToDate += textureSource.upToDate;
+		}
+		textures.emplace(texturePath, reference);
+		return reference;
+	};
+
     for (const auto& material : materials)
 	{
 		Gleam::MaterialInstanceDescriptor descriptor;
@@ -133,72 +233,25 @@ bool MeshSource::Import(const Gleam::Filesystem::Path& path, const ImportSetting
 		if (material.alphaBlend)
 		{
 			descriptor.material = transparentLitMaterialAsset;
-			descriptor.properties = transparentLitMaterial.properties;
+			descriptor.properties = transparentLitMaterial->properties;
 		}
 		else
 		{
 			descriptor.material = opaqueLitMaterialAsset;
-			descriptor.properties = opaqueLitMaterial.properties;
+			descriptor.properties = opaqueLitMaterial->properties;
 		}
 		
 		descriptor["BaseColor"] = material.albedoColor;
 		descriptor["Emission"] = material.emissiveColor;
 		descriptor["Metallic"] = material.metallicFactor;
 		descriptor["Roughness"] = material.roughnessFactor;
-		descriptor["BaseColorTexture"] = Gleam::AssetReference();
-		descriptor["NormalTexture"] = Gleam::AssetReference();
-		descriptor["MetallicRoughnessTexture"] = Gleam::AssetReference();
-		descriptor["EmissiveTexture"] = Gleam::AssetReference();
-
-		if (const auto& texture = material.textures[PBRTexture::Albedo]; texture.empty() == false)
-		{
-			auto texturePath = path.parent_path() / texture;
-			auto textureSource = TextureSource(registry);
-			auto textureSettings = TextureSource::ImportSettings();
-			if (textureSource.Import(texturePath, textureSettings))
-			{
-				descriptor["BaseColorTexture"] = registry->GetAsset<Gleam::TextureDescriptor>(texturePath).reference;
-				bakers.emplace_back(textureSource.bakers[0]);
-			}
-		}
-
-		if (const auto& texture = material.textures[PBRTexture::Normal]; texture.empty() == false)
-		{
-			auto texturePath = path.parent_path() / texture;
-			auto textureSource = TextureSource(registry);
-			auto textureSettings = TextureSource::ImportSettings();
-			if (textureSource.Import(texturePath, textureSettings))
-			{
-				descriptor["NormalTexture"] = registry->GetAsset<Gleam::TextureDescriptor>(texturePath).reference;
-				bakers.emplace_back(textureSource.bakers[0]);
-			}
-		}
-
-		if (const auto& texture = material.textures[PBRTexture::MetallicRoughness]; texture.empty() == false)
-		{
-			auto texturePath = path.parent_path() / texture;
-			auto textureSource = TextureSource(registry);
-			auto textureSettings = TextureSource::ImportSettings();
-			if (textureSource.Import(texturePath, textureSettings))
-			{
-				descriptor["MetallicRoughnessTexture"] = registry->GetAsset<Gleam::TextureDescriptor>(texturePath).reference;
-				bakers.emplace_back(textureSource.bakers[0]);
-			}
-		}
-
-		if (const auto& texture = material.textures[PBRTexture::Emissive]; texture.empty() == false)
-		{
-			auto texturePath = path.parent_path() / texture;
-			auto textureSource = TextureSource(registry);
-			auto textureSettings = TextureSource::ImportSettings();
-			if (textureSource.Import(texturePath, textureSettings))
-			{
-				descriptor["EmissiveTexture"] = registry->GetAsset<Gleam::TextureDescriptor>(texturePath).reference;
-				bakers.emplace_back(textureSource.bakers[0]);
-			}
-		}
+		descriptor["BaseColorTexture"] = importTexture(material.textures[PBRTexture::Albedo], { .compression = TextureCompression::BC7, .sRGB = true });
+		descriptor["NormalTexture"] = importTexture(material.textures[PBRTexture::Normal], { .compression = TextureCompression::BC5, .sRGB = false, .normalMap = true });
+		descriptor["MetallicRoughnessTexture"] = importTexture(material.textures[PBRTexture::MetallicRoughness], { .compression = TextureCompression::BC7, .sRGB = false });
+		descriptor["EmissiveTexture"] = importTexture(material.textures[PBRTexture::Emissive], { .compression = TextureCompression::BC1, .sRGB = true });
 
 		auto materialBaker = Gleam::CreateRef<MaterialInstanceBaker>(descriptor);
+		materialBaker->SetInput(path, inputHash);
 		bakers.emplace_back(materialBaker);
     }
 
@@ -351,6 +404,8 @@ Gleam::MeshDescriptor CombineMeshes(const Gleam::TArray<RawMesh>& meshes)
 {
     Gleam::MeshDescriptor combined;
     combined.submeshes.resize(meshes.size());
+
+    Gleam::TArray<uint32_t> indices;
     
     Gleam::SubmeshDescriptor submesh;
     for (uint32_t i = 0; i < meshes.size(); ++i)
@@ -361,13 +416,14 @@ Gleam::MeshDescriptor CombineMeshes(const Gleam::TArray<RawMesh>& meshes)
         combined.submeshes[i] = submesh;
         
         auto interleaved = InterleaveMeshVertices(mesh);
-        combined.indices.insert(combined.indices.end(), mesh.indices.begin(), mesh.indices.end());
+        indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
         combined.positions.insert(combined.positions.end(), mesh.positions.begin(), mesh.positions.end());
         combined.interleavedVertices.insert(combined.interleavedVertices.end(), interleaved.begin(), interleaved.end());
         
         submesh.baseVertex += static_cast<uint32_t>(mesh.positions.size());
         submesh.firstIndex += static_cast<uint32_t>(mesh.indices.size());
     }
+    combined.SetIndices(indices);
 	return combined;
 }
 
@@ -63,9 +63,21 @@ struct MeshSource : AssetPackage
 {
 	AssetPackageType(MeshSource);
 
+    // bumped whenever the baked mesh layout changes so that every glTF is reimported
+    static constexpr uint32_t ImporterVersion = 1;
+
     struct ImportSettings
     {
         bool combineMeshes = false;
+        bool optimizeMeshes = true;
+        bool generateMeshlets = true;
+        uint32_t lodCount = 3;
+
+        uint64_t Hash() const
+        {
+            uint64_t flags = uint64_t(combineMeshes) | uint64_t(optimizeMeshes) << 1 | uint64_t(generateMeshlets) << 2 | uint64_t(lodCount) << 32;
+            return Gleam::Hash64(&flags, sizeof(flags));
+        }
     };
     
 	/*
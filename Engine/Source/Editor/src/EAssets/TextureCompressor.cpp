@@ -0,0 +1,656 @@
+#include "Gleam.h"
+#include "TextureCompressor.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace GEditor;
+
+namespace {
+
+static constexpr uint32_t BlockPixelCount = 16;
+
+// pixels of a block stored per channel, so that a palette lookup covers 8 pixels at once
+struct BlockPixels
+{
+    alignas(32) int32_t channels[4][BlockPixelCount];
+};
+
+struct BlockPalette
+{
+    int32_t channels[4][BlockPixelCount] = {};
+    uint32_t size = 0;
+};
+
+// contributions of the source texels covered by one destination texel along an axis
+struct FilterTap
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+    float weights[4] = {};
+};
+
+class BitWriter
+{
+public:
+
+    BitWriter(uint8_t* output, size_t size)
+        : mOutput(output)
+    {
+        memset(output, 0, size);
+    }
+
+    void Write(uint32_t value, uint32_t bitCount)
+    {
+        for (uint32_t i = 0; i < bitCount; ++i, ++mPosition)
+        {
+            mOutput[mPosition >> 3] |= static_cast<uint8_t>(((value >> i) & 1) << (mPosition & 7));
+        }
+    }
+
+private:
+
+    uint8_t* mOutput;
+
+    uint32_t mPosition = 0;
+
+};
+
+} // namespace
+
+static BlockPixels LoadBlock(const uint8_t* block)
+{
+    BlockPixels pixels;
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            pixels.channels[c][i] = block[i * 4 + c];
+        }
+    }
+    return pixels;
+}
+
+// Nearest palette entry of every pixel by squared distance over the first channelCount channels
+static void SelectIndices(const BlockPixels& pixels, const BlockPalette& palette, uint32_t channelCount, uint8_t* indices)
+{
+#if defined(__AVX2__)
+    for (uint32_t half = 0; half < BlockPixelCount; half += 8)
+    {
+        __m256i channels[4];
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            channels[c] = _mm256_load_si256(reinterpret_cast<const __m256i*>(pixels.channels[c] + half));
+        }
+
+        __m256i bestDistance = _mm256_set1_epi32(std::numeric_limits<int32_t>::max());
+        __m256i bestIndex = _mm256_setzero_si256();
+        for (uint32_t entry = 0; entry < palette.size; ++entry)
+        {
+            __m256i distance = _mm256_setzero_si256();
+            for (uint32_t c = 0; c < channelCount; ++c)
+            {
+                __m256i delta = _mm256_sub_epi32(channels[c], _mm256_set1_epi32(palette.channels[c][entry]));
+                distance = _mm256_add_epi32(distance, _mm256_mullo_epi32(delta, delta));
+            }
+            __m256i closer = _mm256_cmpgt_epi32(bestDistance, distance);
+            bestDistance = _mm256_blendv_epi8(bestDistance, distance, closer);
+            bestIndex = _mm256_blendv_epi8(bestIndex, _mm256_set1_epi32(static_cast<int32_t>(entry)), closer);
+        }
+
+        alignas(32) int32_t result[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(result), bestIndex);
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            indices[half + i] = static_cast<uint8_t>(result[i]);
+        }
+    }
+#else
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        int32_t bestDistance = std::numeric_limits<int32_t>::max();
+        for (uint32_t entry = 0; entry < palette.size; ++entry)
+        {
+            int32_t distance = 0;
+            for (uint32_t c = 0; c < channelCount; ++c)
+            {
+                int32_t delta = pixels.channels[c][i] - palette.channels[c][entry];
+                distance += delta * delta;
+            }
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                indices[i] = static_cast<uint8_t>(entry);
+            }
+        }
+    }
+#endif
+}
+
+static int64_t PaletteError(const BlockPixels& pixels, const BlockPalette& palette, uint32_t channelCount, const uint8_t* indices)
+{
+    int64_t error = 0;
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            int64_t delta = pixels.channels[c][i] - palette.channels[c][indices[i]];
+            error += delta * delta;
+        }
+    }
+    return error;
+}
+
+// Endpoints at the extremes of the block along its principal axis
+static void FitEndpoints(const BlockPixels& pixels, uint32_t channelCount, float (&low)[4], float (&high)[4])
+{
+    float mean[4] = {};
+    for (uint32_t c = 0; c < channelCount; ++c)
+    {
+        for (uint32_t i = 0; i < BlockPixelCount; ++i)
+        {
+            mean[c] += static_cast<float>(pixels.channels[c][i]);
+        }
+        mean[c] /= BlockPixelCount;
+    }
+
+    float covariance[4][4] = {};
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        for (uint32_t a = 0; a < channelCount; ++a)
+        {
+            for (uint32_t b = a; b < channelCount; ++b)
+            {
+                covariance[a][b] += (pixels.channels[a][i] - mean[a]) * (pixels.channels[b][i] - mean[b]);
+            }
+        }
+    }
+    for (uint32_t a = 0; a < channelCount; ++a)
+    {
+        for (uint32_t b = 0; b < a; ++b)
+        {
+            covariance[a][b] = covariance[b][a];
+        }
+    }
+
+    // power iteration converges to the dominant eigenvector in a few steps for 4x4 matrices
+    float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (uint32_t iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = {};
+        float length = 0.0f;
+        for (uint32_t a = 0; a < channelCount; ++a)
+        {
+            for (uint32_t b = 0; b < channelCount; ++b)
+            {
+                next[a] += covariance[a][b] * axis[b];
+            }
+            length = std::max(length, std::abs(next[a]));
+        }
+
+        if (length < 1e-6f)
+        {
+            break;
+        }
+
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    float minProjection = std::numeric_limits<float>::max();
+    float maxProjection = std::numeric_limits<float>::lowest();
+    float axisLengthSquared = 0.0f;
+    for (uint32_t c = 0; c < channelCount; ++c)
+    {
+        axisLengthSquared += axis[c] * axis[c];
+    }
+
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        float projection = 0.0f;
+        for (uint32_t c = 0; c < channelCount; ++c)
+        {
+            projection += (pixels.channels[c][i] - mean[c]) * axis[c];
+        }
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+
+    for (uint32_t c = 0; c < channelCount; ++c)
+    {
+        float scale = axis[c] / axisLengthSquared;
+        low[c] = std::clamp(mean[c] + minProjection * scale, 0.0f, 255.0f);
+        high[c] = std::clamp(mean[c] + maxProjection * scale, 0.0f, 255.0f);
+    }
+}
+
+static uint16_t PackRGB565(const float (&color)[4])
+{
+    uint32_t r = static_cast<uint32_t>(color[0] * 31.0f / 255.0f + 0.5f);
+    uint32_t g = static_cast<uint32_t>(color[1] * 63.0f / 255.0f + 0.5f);
+    uint32_t b = static_cast<uint32_t>(color[2] * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(uint16_t packed, int32_t (&color)[3])
+{
+    int32_t r = (packed >> 11) & 31;
+    int32_t g = (packed >> 5) & 63;
+    int32_t b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+static BlockPalette BC1Palette(uint16_t color0, uint16_t color1)
+{
+    int32_t endpoint0[3], endpoint1[3];
+    UnpackRGB565(color0, endpoint0);
+    UnpackRGB565(color1, endpoint1);
+
+    BlockPalette palette;
+    palette.size = 4;
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        palette.channels[c][0] = endpoint0[c];
+        palette.channels[c][1] = endpoint1[c];
+        palette.channels[c][2] = (2 * endpoint0[c] + endpoint1[c]) / 3;
+        palette.channels[c][3] = (endpoint0[c] + 2 * endpoint1[c]) / 3;
+    }
+    return palette;
+}
+
+// Least squares endpoints for the chosen indices, the palette weights of BC1 are 1, 0, 2/3 and 1/3
+static bool RefineBC1Endpoints(const BlockPixels& pixels, const uint8_t* indices, float (&high)[4], float (&low)[4])
+{
+    static constexpr float Weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    float ax[3] = {}, bx[3] = {};
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        float a = Weights[indices[i]];
+        float b = 1.0f - a;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            ax[c] += a * pixels.channels[c][i];
+            bx[c] += b * pixels.channels[c][i];
+        }
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f)
+    {
+        return false;
+    }
+
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        high[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+        low[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// Encodes in four color mode, color0 is kept above color1 so that BC3 decodes it the same way
+static int64_t EncodeBC1Endpoints(const BlockPixels& pixels, const float (&high)[4], const float (&low)[4], uint16_t& color0, uint16_t& color1, uint8_t* indices)
+{
+    color0 = PackRGB565(high);
+    color1 = PackRGB565(low);
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    if (color0 == color1)
+    {
+        memset(indices, 0, BlockPixelCount);
+        return PaletteError(pixels, BC1Palette(color0, color1), 3, indices);
+    }
+
+    auto palette = BC1Palette(color0, color1);
+    SelectIndices(pixels, palette, 3, indices);
+    return PaletteError(pixels, palette, 3, indices);
+}
+
+static void WriteBC1Block(uint16_t color0, uint16_t color1, const uint8_t* indices, uint8_t* output)
+{
+    uint32_t packedIndices = 0;
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        packedIndices |= static_cast<uint32_t>(indices[i]) << (i * 2);
+    }
+    memcpy(output, &color0, sizeof(uint16_t));
+    memcpy(output + 2, &color1, sizeof(uint16_t));
+    memcpy(output + 4, &packedIndices, sizeof(uint32_t));
+}
+
+static float SRGBToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSRGB(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static Gleam::TArray<FilterTap> CreateFilterTaps(uint32_t sourceSize, uint32_t targetSize)
+{
+    // every target texel averages the source area it covers, odd sizes split the middle texel between neighbours
+    Gleam::TArray<FilterTap> taps(targetSize);
+    float scale = static_cast<float>(sourceSize) / static_cast<float>(targetSize);
+    for (uint32_t i = 0; i < targetSize; ++i)
+    {
+        float begin = i * scale;
+        float end = begin + scale;
+        auto& tap = taps[i];
+        tap.first = static_cast<uint32_t>(begin);
+        for (uint32_t source = tap.first; source < end && tap.count < 4; ++source)
+        {
+            float coverage = std::min(end, source + 1.0f) - std::max(begin, static_cast<float>(source));
+            tap.weights[tap.count++] = coverage / scale;
+        }
+    }
+    return taps;
+}
+
+Gleam::TArray<TextureImage> TextureCompressor::GenerateMips(const TextureImage& image, bool sRGB, bool normalMap, Gleam::ThreadPool& threadPool)
+{
+    Gleam::TArray<TextureImage> mips;
+    mips.push_back(image);
+
+    // levels are filtered from the previous level kept in float, so rounding does not accumulate down the chain
+    uint32_t width = image.width;
+    uint32_t height = image.height;
+    Gleam::TArray<float> source(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        float value = image.pixels[i] / 255.0f;
+        source[i] = sRGB && (i % 4) != 3 ? SRGBToLinear(value) : value;
+    }
+
+    while (width > 1 || height > 1)
+    {
+        uint32_t targetWidth = std::max(width / 2, 1u);
+        uint32_t targetHeight = std::max(height / 2, 1u);
+        auto tapsX = CreateFilterTaps(width, targetWidth);
+        auto tapsY = CreateFilterTaps(height, targetHeight);
+
+        Gleam::TArray<float> target(static_cast<size_t>(targetWidth) * targetHeight * 4);
+        TextureImage& mip = mips.emplace_back();
+        mip.width = targetWidth;
+        mip.height = targetHeight;
+        mip.pixels.resize(target.size());
+
+        threadPool.ParallelFor(targetHeight, [&](uint32_t y)
+        {
+            const auto& tapY = tapsY[y];
+            for (uint32_t x = 0; x < targetWidth; ++x)
+            {
+                const auto& tapX = tapsX[x];
+                float texel[4] = {};
+                for (uint32_t j = 0; j < tapY.count; ++j)
+                {
+                    const float* row = source.data() + static_cast<size_t>(tapY.first + j) * width * 4;
+                    for (uint32_t i = 0; i < tapX.count; ++i)
+                    {
+                        float weight = tapY.weights[j] * tapX.weights[i];
+                        const float* sample = row + static_cast<size_t>(tapX.first + i) * 4;
+                        for (uint32_t c = 0; c < 4; ++c)
+                        {
+                            texel[c] += sample[c] * weight;
+                        }
+                    }
+                }
+
+                if (normalMap)
+                {
+                    float normal[3] = { texel[0] * 2.0f - 1.0f, texel[1] * 2.0f - 1.0f, texel[2] * 2.0f - 1.0f };
+                    float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+                    if (length > 1e-6f)
+                    {
+                        for (uint32_t c = 0; c < 3; ++c)
+                        {
+                            texel[c] = normal[c] / length * 0.5f + 0.5f;
+                        }
+                    }
+                }
+
+                size_t offset = (static_cast<size_t>(y) * targetWidth + x) * 4;
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    target[offset + c] = texel[c];
+                    float encoded = sRGB && c != 3 ? LinearToSRGB(texel[c]) : texel[c];
+                    mip.pixels[offset + c] = static_cast<uint8_t>(std::clamp(encoded, 0.0f, 1.0f) * 255.0f + 0.5f);
+                }
+            }
+        });
+
+        source = std::move(target);
+        width = targetWidth;
+        height = targetHeight;
+    }
+    return mips;
+}
+
+Gleam::TArray<uint8_t> TextureCompressor::Compress(const TextureImage& image, TextureCompression compression, Gleam::ThreadPool& threadPool)
+{
+    if (compression == TextureCompression::None)
+    {
+        return image.pixels;
+    }
+
+    using EncodeFn = void(*)(const uint8_t*, uint8_t*);
+    EncodeFn encode = nullptr;
+    size_t blockSize = 16;
+    switch (compression)
+    {
+        case TextureCompression::BC1: encode = EncodeBC1Block; blockSize = 8; break;
+        case TextureCompression::BC3: encode = EncodeBC3Block; break;
+        case TextureCompression::BC5: encode = EncodeBC5Block; break;
+        case TextureCompression::BC7: encode = EncodeBC7Block; break;
+        default: break;
+    }
+
+    uint32_t blocksX = (image.width + 3) / 4;
+    uint32_t blocksY = (image.height + 3) / 4;
+    Gleam::TArray<uint8_t> compressed(static_cast<size_t>(blocksX) * blocksY * blockSize);
+    threadPool.ParallelFor(blocksY, [&](uint32_t blockY)
+    {
+        uint8_t block[BlockPixelCount * 4];
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+        {
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                uint32_t sourceY = std::min(blockY * 4 + y, image.height - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    uint32_t sourceX = std::min(blockX * 4 + x, image.width - 1);
+                    memcpy(block + (y * 4 + x) * 4, image.pixels.data() + (static_cast<size_t>(sourceY) * image.width + sourceX) * 4, 4);
+                }
+            }
+            encode(block, compressed.data() + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize);
+        }
+    });
+    return compressed;
+}
+
+size_t TextureCompressor::GetCompressedSize(uint32_t width, uint32_t height, TextureCompression compression)
+{
+    size_t blockCount = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+    switch (compression)
+    {
+        case TextureCompression::BC1: return blockCount * 8;
+        case TextureCompression::BC3:
+        case TextureCompression::BC5:
+        case TextureCompression::BC7: return blockCount * 16;
+        default: return static_cast<size_t>(width) * height * 4;
+    }
+}
+
+Gleam::TextureFormat TextureCompressor::GetTextureFormat(TextureCompression compression, bool sRGB)
+{
+    switch (compression)
+    {
+        case TextureCompression::BC1: return sRGB ? Gleam::TextureFormat::BC1_RGBA_SRGB : Gleam::TextureFormat::BC1_RGBA_UNorm;
+        case TextureCompression::BC3: return sRGB ? Gleam::TextureFormat::BC3_RGBA_SRGB : Gleam::TextureFormat::BC3_RGBA_UNorm;
+        case TextureCompression::BC5: return Gleam::TextureFormat::BC5_RG_UNorm;
+        case TextureCompression::BC7: return sRGB ? Gleam::TextureFormat::BC7_RGBA_SRGB : Gleam::TextureFormat::BC7_RGBA_UNorm;
+        default: return sRGB ? Gleam::TextureFormat::R8G8B8A8_SRGB : Gleam::TextureFormat::R8G8B8A8_UNorm;
+    }
+}
+
+void TextureCompressor::EncodeBC1Block(const uint8_t* block, uint8_t* output)
+{
+    auto pixels = LoadBlock(block);
+
+    float high[4], low[4];
+    FitEndpoints(pixels, 3, low, high);
+
+    uint16_t color0, color1;
+    uint8_t indices[BlockPixelCount];
+    int64_t error = EncodeBC1Endpoints(pixels, high, low, color0, color1, indices);
+
+    // one least squares pass over the chosen indices recovers most of the quantization loss
+    if (error > 0 && color0 != color1 && RefineBC1Endpoints(pixels, indices, high, low))
+    {
+        uint16_t refined0, refined1;
+        uint8_t refinedIndices[BlockPixelCount];
+        if (EncodeBC1Endpoints(pixels, high, low, refined0, refined1, refinedIndices) < error)
+        {
+            color0 = refined0;
+            color1 = refined1;
+            memcpy(indices, refinedIndices, BlockPixelCount);
+        }
+    }
+    WriteBC1Block(color0, color1, indices, output);
+}
+
+void TextureCompressor::EncodeBC3Block(const uint8_t* block, uint8_t* output)
+{
+    EncodeBC4Block(block, 3, output);
+    EncodeBC1Block(block, output + 8);
+}
+
+void TextureCompressor::EncodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* output)
+{
+    uint8_t minValue = 255, maxValue = 0;
+    for (uint32_t i = 0; i < BlockPixelCount; ++i)
+    {
+        minValue = std::min(minValue, block[i * 4 + channel]);
+        maxValue = std::max(maxValue, block[i * 4 + channel]);
+    }
+
+    // eight value mode, index 0 is the maximum, 1 the minimum and 2-7 interpolate from the maximum down
+    uint64_t packedIndices = 0;
+    if (maxValue > minValue)
+    {
+        float scale = 7.0f / (maxValue - minValue);
+        for (uint32_t i = 0; i < BlockPixelCount; ++i)
+        {
+            uint32_t step = static_cast<uint32_t>((block[i * 4 + channel] - minValue) * scale + 0.5f);
+            uint64_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+            packedIndices |= index << (i * 3);
+        }
+    }
+
+    output[0] = maxValue;
+    output[1] = minValue;
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        output[2 + i] = static_cast<uint8_t>(packedIndices >> (i * 8));
+    }
+}
+
+void TextureCompressor::EncodeBC5Block(const uint8_t* block, uint8_t* output)
+{
+    EncodeBC4Block(block, 0, output);
+    EncodeBC4Block(block, 1, output + 8);
+}
+
+void TextureCompressor::EncodeBC7Block(const uint8_t* block, uint8_t* output)
+{
+    static constexpr int32_t Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    auto pixels = LoadBlock(block);
+
+    float endpoints[2][4];
+    FitEndpoints(pixels, 4, endpoints[0], endpoints[1]);
+
+    // mode 6 stores 7 bits per channel and one shared low bit per endpoint
+    uint32_t quantized[2][4];
+    uint32_t pbits[2];
+    int32_t expanded[2][4];
+    for (uint32_t e = 0; e < 2; ++e)
+    {
+        float bestError = std::numeric_limits<float>::max();
+        for (uint32_t pbit = 0; pbit < 2; ++pbit)
+        {
+            float error = 0.0f;
+            uint32_t candidate[4];
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                candidate[c] = static_cast<uint32_t>(std::clamp((endpoints[e][c] - pbit) / 2.0f + 0.5f, 0.0f, 127.0f));
+                float delta = static_cast<float>((candidate[c] << 1) | pbit) - endpoints[e][c];
+                error += delta * delta;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                pbits[e] = pbit;
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    quantized[e][c] = candidate[c];
+                    expanded[e][c] = static_cast<int32_t>((candidate[c] << 1) | pbit);
+                }
+            }
+        }
+    }
+
+    BlockPalette palette;
+    palette.size = 16;
+    for (uint32_t i = 0; i < palette.size; ++i)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            palette.channels[c][i] = ((64 - Weights[i]) * expanded[0][c] + Weights[i] * expanded[1][c] + 32) >> 6;
+        }
+    }
+
+    uint8_t indices[BlockPixelCount];
+    SelectIndices(pixels, palette, 4, indices);
+
+    // the anchor index is stored without its high bit, so the first pixel has to sit in the lower half
+    if (indices[0] >= 8)
+    {
+        std::swap(quantized[0], quantized[1]);
+        std::swap(pbits[0], pbits[1]);
+        for (auto& index : indices)
+        {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    BitWriter writer(output, 16);
+    writer.Write(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        writer.Write(quantized[0][c], 7);
+        writer.Write(quantized[1][c], 7);
+    }
+    writer.Write(pbits[0], 1);
+    writer.Write(pbits[1], 1);
+    writer.Write(indices[0], 3);
+    for (uint32_t i = 1; i < BlockPixelCount; ++i)
+    {
+        writer.Write(indices[i], 4);
+    }
+}
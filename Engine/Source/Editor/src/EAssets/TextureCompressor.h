@@ -0,0 +1,58 @@
+#pragma once
+#include "Gleam.h"
+
+namespace GEditor {
+
+enum class TextureCompression
+{
+    None,
+    BC1, // RGB, 4 bits per pixel
+    BC3, // RGBA with interpolated alpha, 8 bits per pixel
+    BC5, // two independent channels for normal maps, 8 bits per pixel
+    BC7  // RGBA mode 6, 8 bits per pixel
+};
+
+// 8 bit RGBA pixels, rows are tightly packed
+struct TextureImage
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    Gleam::TArray<uint8_t> pixels;
+};
+
+namespace TextureCompressor {
+
+/*
+* Box filtered mip chain from the image down to 1x1, the image itself is the first level
+* Color channels of sRGB images are averaged in linear space, alpha is always linear
+* Normal maps are renormalized after every level
+*/
+Gleam::TArray<TextureImage> GenerateMips(const TextureImage& image, bool sRGB, bool normalMap, Gleam::ThreadPool& threadPool);
+
+/*
+* Encodes the image in 4x4 blocks, edge blocks of sizes that are not a multiple of 4 repeat the last row and column
+* Rows of blocks are spread over the thread pool
+*/
+Gleam::TArray<uint8_t> Compress(const TextureImage& image, TextureCompression compression, Gleam::ThreadPool& threadPool);
+
+size_t GetCompressedSize(uint32_t width, uint32_t height, TextureCompression compression);
+
+Gleam::TextureFormat GetTextureFormat(TextureCompression compression, bool sRGB);
+
+// Block encoders take the 16 RGBA pixels of a block in row order
+void EncodeBC1Block(const uint8_t* block, uint8_t* output);
+
+void EncodeBC3Block(const uint8_t* block, uint8_t* output);
+
+// Single channel encoder, channel selects the component of every pixel
+void EncodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* output);
+
+void EncodeBC5Block(const uint8_t* block, uint8_t* output);
+
+// Only mode 6 is emitted: a single subset with 7 bit RGBA endpoints, a p-bit per endpoint and 4 bit indices.
+// Blocks with several distinct colors lose quality compared to an encoder that searches all eight modes
+void EncodeBC7Block(const uint8_t* block, uint8_t* output);
+
+} // namespace TextureCompressor
+
+} // namespace GEditor
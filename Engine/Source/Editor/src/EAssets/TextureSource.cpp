@@ -1,9 +1,65 @@
 #include "Gleam.h"
 #include "TextureSource.h"
+#include "AssetRegistry.h"
+
+#include "Bakers/TextureBaker.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
 
 using namespace GEditor;
 
 bool TextureSource::Import(const Gleam::Filesystem::Path& path, const ImportSettings& settings)
 {
-	return false;
+	if (Gleam::Filesystem::Exists(path) == false)
+	{
+		GLEAM_ERROR("Texture could not be found: {0}", path.string());
+		return false;
+	}
+
+	auto inputHash = AssetPackage::HashInputs({ path }, settings.Hash(), ImporterVersion);
+	if (upToDate = registry->FindUpToDate(path, inputHash); upToDate > 0)
+	{
+		return true;
+	}
+
+	// every image is expanded to RGBA8, the encoders and the mip filter only deal with that layout
+	TextureImage image;
+	{
+		Gleam::MappedFile mapped(path);
+		int width = 0, height = 0, channels = 0;
+		stbi_uc* pixels = stbi_load_from_memory(mapped.GetData(), static_cast<int>(mapped.GetSize()), &width, &height, &channels, STBI_rgb_alpha);
+		if (pixels == nullptr)
+		{
+			GLEAM_ERROR("Texture {0} could not be decoded: {1}", path.string(), stbi_failure_reason());
+			return false;
+		}
+
+		image.width = static_cast<uint32_t>(width);
+		image.height = static_cast<uint32_t>(height);
+		image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		stbi_image_free(pixels);
+	}
+
+	auto& threadPool = registry->GetImportThreads();
+	auto levels = settings.generateMips ? TextureCompressor::GenerateMips(image, settings.sRGB, settings.normalMap, threadPool) : Gleam::TArray<TextureImage>{ std::move(image) };
+
+	// levels are encoded one after another, each one spreads its block rows over the import threads
+	Gleam::TArray<Gleam::TArray<uint8_t>> mips(levels.size());
+	for (uint32_t i = 0; i < levels.size(); ++i)
+	{
+		mips[i] = TextureCompressor::Compress(levels[i], settings.compression, threadPool);
+	}
+
+	Gleam::TextureDescriptor descriptor;
+	descriptor.name = path.stem().string();
+	descriptor.size = Gleam::Size(static_cast<float>(levels[0].width), static_cast<float>(levels[0].height));
+	descriptor.format = TextureCompressor::GetTextureFormat(settings.compression, settings.sRGB);
+	descriptor.useMipMap = settings.generateMips;
+
+	registry->RegisterAsset<Gleam::TextureDescriptor>(path.parent_path() / descriptor.name);
+	auto baker = Gleam::CreateRef<TextureBaker>(descriptor, std::move(mips));
+	baker->SetInput(path, inputHash);
+	bakers.emplace_back(baker);
+	return true;
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "Gleam.h"
 #include "AssetPackage.h"
+#include "TextureCompressor.h"
 
 namespace GEditor {
 
@@ -8,11 +9,27 @@ struct TextureSource : AssetPackage
 {
 	AssetPackageType(TextureSource);
 
+	// bumped whenever the mip filter or a block encoder changes so that every texture is reimported
+	static constexpr uint32_t ImporterVersion = 1;
+
 	struct ImportSettings
 	{
-		
+		TextureCompression compression = TextureCompression::BC7;
+		bool sRGB = true; // color textures, data textures such as normal or metallic roughness maps are linear
+		bool normalMap = false;
+		bool generateMips = true;
+
+		uint64_t Hash() const
+		{
+			uint64_t flags = uint64_t(compression) | uint64_t(sRGB) << 8 | uint64_t(normalMap) << 9 | uint64_t(generateMips) << 10;
+			return Gleam::Hash64(&flags, sizeof(flags));
+		}
 	};
 
+	/*
+	* Decodes any image stb_image reads, builds the mip chain and block compresses every level
+	* The levels are baked into the texture sidecar
+	*/
 	bool Import(const Gleam::Filesystem::Path& path, const ImportSettings& settings);
 };
 
@@ -49,8 +49,8 @@ Gleam::Application* Gleam::CreateApplicationInstance(const Gleam::CommandLine& c
     Gleam::Project project;
     if (Gleam::Filesystem::Exists(projectFile))
     {
-        auto file = Gleam::Filesystem::Open(projectFile, Gleam::FileType::Text);
-        auto serializer = Gleam::JSONSerializer(file.GetStream());
+        auto file = Gleam::Filesystem::Map(projectFile);
+        auto serializer = Gleam::JSONSerializer(file);
         project = serializer.Deserialize<Gleam::Project>();
     }
     else
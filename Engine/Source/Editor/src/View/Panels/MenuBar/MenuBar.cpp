@@ -7,6 +7,8 @@
 
 #include "MenuBar.h"
 #include "Gleam.h"
+#include "EAssets/AssetCooker.h"
+#include "EAssets/AssetRegistry.h"
 
 #include <imgui.h>
 
@@ -31,6 +33,21 @@ void MenuBar::Render(Gleam::ImGuiRenderer* imgui)
 				worldManager->SaveWorld();
 			}
 
+			// cooked into a build directory, archives in the project itself would be mounted over the editor's own assets
+			if (ImGui::MenuItem("Cook"))
+			{
+				auto assetRegistry = mWorld->GetSubsystem<AssetRegistry>();
+				auto outputDirectory = Gleam::Globals::ProjectDirectory/"Build"/Gleam::AssetManager::ArchiveDirectory();
+
+				AssetCookStats stats;
+				AssetCooker(Gleam::Globals::ProjectContentDirectory).Cook(outputDirectory, assetRegistry->GetImportThreads(), stats);
+			}
+
+			if (ImGui::MenuItem("Capture Profile"))
+			{
+				Gleam::Profiler::Capture(60, Gleam::Globals::ProjectDirectory/"Build"/"Profile.trace.json");
+			}
+
 			if (ImGui::MenuItem("Exit"))
 			{
 				Gleam::EventDispatcher<Gleam::AppCloseEvent>::Publish(Gleam::AppCloseEvent());
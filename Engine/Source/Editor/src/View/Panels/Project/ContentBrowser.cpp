@@ -35,6 +35,15 @@ void ContentBrowser::Render(Gleam::ImGuiRenderer* imgui)
 				ImportAsset(path);
 			}
 		}
+
+		// imports bake in the background, the browser keeps drawing while they run
+		auto progress = mAssetRegistry->GetImportProgress();
+		if (progress.source.empty() == false)
+		{
+			float fraction = progress.total > 0 ? float(progress.baked) / float(progress.total) : 0.0f;
+			auto overlay = progress.queued > 0 ? progress.source + " (" + std::to_string(progress.queued) + " queued)" : progress.source;
+			ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), overlay.c_str());
+		}
         DrawDirectoryTreeView(mAssetDirectory);
 
 		ImGui::End();
@@ -45,13 +54,16 @@ bool ContentBrowser::ImportAsset(const Gleam::Filesystem::Path& path)
 {
 	if (path.extension() == ".gltf")
 	{
-		auto meshSource = MeshSource(mAssetRegistry);
-		auto settings = MeshSource::ImportSettings();
-		if (meshSource.Import(path, settings))
+		mAssetRegistry->ImportAsync(path.filename().string(), [registry = mAssetRegistry, directory = mCurrentDirectory, path]()
 		{
-			mAssetRegistry->Import(mCurrentDirectory, meshSource);
-			return true;
-		}
+			auto meshSource = MeshSource(registry);
+			auto settings = MeshSource::ImportSettings();
+			if (meshSource.Import(path, settings))
+			{
+				registry->Import(directory, meshSource);
+			}
+		});
+		return true;
 	}
 	return false;
 }
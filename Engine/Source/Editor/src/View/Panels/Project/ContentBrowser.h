@@ -22,6 +22,7 @@ public:
     
 private:
 
+	// Queues the import of a source file, false if its type can not be imported
 	bool ImportAsset(const Gleam::Filesystem::Path& path);
     
     void DrawDirectoryTreeView(const Gleam::Filesystem::Path& directory);
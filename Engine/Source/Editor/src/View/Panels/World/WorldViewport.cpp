@@ -57,6 +57,9 @@ void WorldViewport::Update()
     descriptor.size = mViewportSize;
     descriptor.usage = Gleam::TextureUsage_Attachment | Gleam::TextureUsage_Sampled;
     Gleam::Globals::Engine->GetSubsystem<Gleam::RenderSystem>()->SetBackbuffer(descriptor);
+
+    // copied on the main thread, the ImGui view below is recorded later while rendering
+    mOcclusionStatistics = mEditWorld->GetSystem<Gleam::RenderSceneProxy>()->GetOcclusionStatistics();
 }
 
 void WorldViewport::Render(Gleam::ImGuiRenderer* imgui)
@@ -89,11 +92,11 @@ void WorldViewport::Render(Gleam::ImGuiRenderer* imgui)
 				{
 					auto materialSystem = Gleam::Globals::GameInstance->GetSubsystem<Gleam::MaterialSystem>();
 					auto assetManager = Gleam::Globals::GameInstance->GetSubsystem<Gleam::AssetManager>();
-					auto mesh = assetManager->Get<Gleam::MeshDescriptor>(assetItem.reference);
+					auto mesh = assetManager->Load<Gleam::MeshDescriptor>(assetItem.reference);
 
 					Gleam::AssetReference meshRef = assetItem.reference;
 					Gleam::TArray<Gleam::AssetReference> materialRefs;
-					for (uint32_t i = 0; i < mesh.submeshes.size(); ++i)
+					for (uint32_t i = 0; i < mesh->submeshes.size(); ++i)
 					{
 						Gleam::AssetReference material = { .guid = Gleam::Guid("044B0097-7F40-438D-9FD4-3606E73EDFD6") };
 						materialRefs.push_back(material);
@@ -106,6 +109,13 @@ void WorldViewport::Render(Gleam::ImGuiRenderer* imgui)
 			}
 			ImGui::EndDragDropTarget();
 		}
+
+		// occlusion culling results drawn over the top left corner of the image
+		auto contentMin = ImGui::GetWindowContentRegionMin();
+		ImGui::SetCursorPos(ImVec2(contentMin.x + 8.0f, contentMin.y + 8.0f));
+		ImGui::Text("Occluders: %u (%u triangles) %.2f ms", mOcclusionStatistics.occluderCount, mOcclusionStatistics.occluderTriangleCount, mOcclusionStatistics.rasterizationTime);
+		ImGui::SetCursorPosX(contentMin.x + 8.0f);
+		ImGui::Text("Occluded: %u / %u %.2f ms", mOcclusionStatistics.occludedCount, mOcclusionStatistics.testedCount, mOcclusionStatistics.testTime);
 		
 		ImGui::End();
 		ImGui::PopStyleVar();
@@ -43,6 +43,8 @@ private:
 	Gleam::EntityHandle mCamera;
     
     Gleam::Size mViewportSize;
+
+    Gleam::OcclusionCullingStatistics mOcclusionStatistics;
     
     Gleam::World* mEditWorld;
     
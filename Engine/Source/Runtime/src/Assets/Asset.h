@@ -27,6 +27,12 @@ struct Asset
     {
         return ".asset";
     }
+
+    // binary payload baked next to the asset with the same GUID
+    static constexpr TStringView sidecarExtension()
+    {
+        return ".bin";
+    }
 };
 
 } // Gleam
@@ -0,0 +1,211 @@
+#include "gpch.h"
+#include "AssetDependencyGraph.h"
+#include "IO/MappedFile.h"
+#include "Serialization/JSONSerializer.h"
+
+using namespace Gleam;
+
+void AssetDependencyGraph::Load(const Filesystem::Path& path)
+{
+	mNodes.clear();
+	if (Filesystem::Exists(path) == false)
+	{
+		return;
+	}
+
+	auto accessor = Filesystem::ReadAccessor(path);
+	auto file = Filesystem::Map(path);
+	auto serializer = JSONSerializer(file);
+	auto table = serializer.Deserialize<AssetDependencyTable>();
+	for (const auto& node : table.nodes)
+	{
+		SetDependencies(node.asset, node.type, node.dependencies);
+	}
+}
+
+void AssetDependencyGraph::Save(const Filesystem::Path& path) const
+{
+	AssetDependencyTable table;
+	table.nodes.reserve(mNodes.size());
+	for (const auto& [asset, node] : mNodes)
+	{
+		// nodes only known as someone's dependency are rebuilt from their dependents
+		if (node.type == Guid::InvalidGuid() && node.dependencies.empty())
+			continue;
+
+		table.nodes.push_back({ .asset = asset, .type = node.type, .dependencies = node.dependencies });
+	}
+
+	auto accessor = Filesystem::WriteAccessor(path);
+	auto file = Filesystem::Create(path, FileType::Text);
+	auto serializer = JSONSerializer(file.GetStream());
+	serializer.Serialize(table);
+}
+
+void AssetDependencyGraph::SetDependencies(const AssetReference& asset, const Guid& type, const TArray<AssetReference>& dependencies)
+{
+	auto& node = mNodes[asset];
+	for (const auto& dependency : node.dependencies)
+	{
+		auto& dependents = mNodes[dependency].dependents;
+		dependents.erase(std::remove(dependents.begin(), dependents.end(), asset), dependents.end());
+	}
+
+	node.type = type;
+	node.dependencies.clear();
+	for (const auto& dependency : dependencies)
+	{
+		if (dependency.guid == Guid::InvalidGuid() || dependency == asset)
+			continue;
+
+		if (std::find(node.dependencies.begin(), node.dependencies.end(), dependency) != node.dependencies.end())
+			continue;
+
+		node.dependencies.push_back(dependency);
+	}
+
+	for (const auto& dependency : node.dependencies)
+	{
+		mNodes[dependency].dependents.push_back(asset);
+	}
+}
+
+void AssetDependencyGraph::Remove(const AssetReference& asset)
+{
+	auto it = mNodes.find(asset);
+	if (it == mNodes.end())
+	{
+		return;
+	}
+
+	SetDependencies(asset, Guid::InvalidGuid(), {});
+	it = mNodes.find(asset);
+	if (it->second.dependents.empty())
+	{
+		mNodes.erase(it);
+	}
+}
+
+Guid AssetDependencyGraph::GetType(const AssetReference& asset) const
+{
+	auto it = mNodes.find(asset);
+	return it != mNodes.end() ? it->second.type : Guid::InvalidGuid();
+}
+
+const TArray<AssetReference>& AssetDependencyGraph::GetDependencies(const AssetReference& asset) const
+{
+	static const TArray<AssetReference> empty;
+	auto it = mNodes.find(asset);
+	return it != mNodes.end() ? it->second.dependencies : empty;
+}
+
+TArray<AssetReference> AssetDependencyGraph::CollectDependencies(const TArray<AssetReference>& roots) const
+{
+	HashSet<AssetReference> visited(roots.begin(), roots.end());
+	TArray<AssetReference> closure;
+	for (const auto& root : roots)
+	{
+		for (const auto& dependency : GetDependencies(root))
+		{
+			CollectDependencies(dependency, visited, closure);
+		}
+	}
+	return closure;
+}
+
+void AssetDependencyGraph::CollectDependencies(const AssetReference& asset, HashSet<AssetReference>& visited, TArray<AssetReference>& closure) const
+{
+	if (visited.insert(asset).second == false)
+	{
+		return;
+	}
+
+	for (const auto& dependency : GetDependencies(asset))
+	{
+		CollectDependencies(dependency, visited, closure);
+	}
+	closure.push_back(asset);
+}
+
+TArray<AssetReference> AssetDependencyGraph::CollectDependents(const AssetReference& asset) const
+{
+	HashSet<AssetReference> visited = { asset };
+	TArray<AssetReference> dependents;
+	TArray<AssetReference> stack = { asset };
+	while (stack.empty() == false)
+	{
+		auto current = stack.back();
+		stack.pop_back();
+
+		auto it = mNodes.find(current);
+		if (it == mNodes.end())
+			continue;
+
+		for (const auto& dependent : it->second.dependents)
+		{
+			if (visited.insert(dependent).second)
+			{
+				dependents.push_back(dependent);
+				stack.push_back(dependent);
+			}
+		}
+	}
+	return dependents;
+}
+
+void AssetDependencyGraph::CollectReferences(const void* obj, const Reflection::ClassDescription& classDesc, TArray<AssetReference>& references)
+{
+	const auto name = classDesc.ResolveName();
+	if (name == Reflection::GetClass<AssetReference>().ResolveName())
+	{
+		references.push_back(Reflection::Get<AssetReference>(obj));
+		return;
+	}
+
+	if (name == Reflection::GetClass<TString>().ResolveName() ||
+		name == Reflection::GetClass<Filesystem::Path>().ResolveName() ||
+		name == Reflection::GetClass<Guid>().ResolveName())
+	{
+		return;
+	}
+
+	auto collectElements = [&references](const void* data, const Reflection::ArrayDescription& arrayDesc, size_t count)
+	{
+		if (arrayDesc.ElementType() != Reflection::FieldType::Class)
+			return;
+
+		const auto& elementDesc = Reflection::GetClass(arrayDesc.ElementHash());
+		for (size_t i = 0; i < count; i++)
+		{
+			CollectReferences(OffsetPointer(data, i * arrayDesc.GetStride()), elementDesc, references);
+		}
+	};
+
+	if (name == Reflection::GetClass<TArray<uint8_t>>().ResolveName())
+	{
+		const auto& arr = Reflection::Get<TArray<uint8_t>>(obj);
+		const auto& arrayDesc = Reflection::GetArray(classDesc.ContainerHash());
+		collectElements(arr.data(), arrayDesc, arr.size() / arrayDesc.GetStride());
+		return;
+	}
+
+	for (const auto& baseClass : classDesc.ResolveBaseClasses())
+	{
+		CollectReferences(obj, baseClass, references);
+	}
+
+	for (const auto& field : classDesc.ResolveFields())
+	{
+		if (field.GetType() == Reflection::FieldType::Class)
+		{
+			const auto& classField = field.GetField<Reflection::ClassField>();
+			CollectReferences(OffsetPointer(obj, classField.offset), Reflection::GetClass(classField.hash), references);
+		}
+		else if (field.GetType() == Reflection::FieldType::Array)
+		{
+			const auto& arrayField = field.GetField<Reflection::ArrayField>();
+			const auto& arrayDesc = Reflection::GetArray(arrayField.hash);
+			collectElements(OffsetPointer(obj, arrayField.offset), arrayDesc, arrayDesc.GetSize() / arrayDesc.GetStride());
+		}
+	}
+}
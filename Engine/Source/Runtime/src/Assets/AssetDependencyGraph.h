@@ -0,0 +1,76 @@
+#pragma once
+#include "AssetReference.h"
+
+namespace Gleam {
+
+struct AssetDependencyNode
+{
+	AssetReference asset;
+	Guid type = Guid::InvalidGuid();
+	TArray<AssetReference> dependencies;
+};
+
+struct AssetDependencyTable
+{
+	TArray<AssetDependencyNode> nodes;
+};
+
+/*
+* Project wide record of which assets reference which, emitted while baking and saved next to the assets
+*/
+class AssetDependencyGraph
+{
+public:
+
+	static constexpr TStringView Filename()
+	{
+		return "AssetDependencies.graph";
+	}
+
+	void Load(const Filesystem::Path& path);
+
+	void Save(const Filesystem::Path& path) const;
+
+	void SetDependencies(const AssetReference& asset, const Guid& type, const TArray<AssetReference>& dependencies);
+
+	void Remove(const AssetReference& asset);
+
+	Guid GetType(const AssetReference& asset) const;
+
+	const TArray<AssetReference>& GetDependencies(const AssetReference& asset) const;
+
+	// Transitive dependencies of the roots without the roots, dependencies come before their dependents
+	TArray<AssetReference> CollectDependencies(const TArray<AssetReference>& roots) const;
+
+	// Every asset that transitively depends on the given one
+	TArray<AssetReference> CollectDependents(const AssetReference& asset) const;
+
+	// Asset references held by the reflected fields of an object
+	static void CollectReferences(const void* obj, const Reflection::ClassDescription& classDesc, TArray<AssetReference>& references);
+
+private:
+
+	struct Node
+	{
+		Guid type = Guid::InvalidGuid();
+		TArray<AssetReference> dependencies;
+		TArray<AssetReference> dependents;
+	};
+
+	void CollectDependencies(const AssetReference& asset, HashSet<AssetReference>& visited, TArray<AssetReference>& closure) const;
+
+	HashMap<AssetReference, Node> mNodes;
+
+};
+
+} // namespace Gleam
+
+GLEAM_TYPE(Gleam::AssetDependencyNode, Guid("3E8D5A71-94C2-4B0F-A6E3-7F1C2D9B8E40"))
+	GLEAM_FIELD(asset, Serializable())
+	GLEAM_FIELD(type, Serializable())
+	GLEAM_FIELD(dependencies, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(Gleam::AssetDependencyTable, Guid("C4A19F2E-6B7D-4E38-9D05-1A8F3E6C7B92"))
+	GLEAM_FIELD(nodes, Serializable())
+GLEAM_END
@@ -0,0 +1,183 @@
+#include "gpch.h"
+#include "AssetIndex.h"
+#include "Asset.h"
+#include "IO/File.h"
+#include "IO/MappedFile.h"
+#include "Serialization/BinarySerializer.h"
+
+using namespace Gleam;
+
+AssetIndex::AssetIndex(const Filesystem::Path& directory)
+	: mDirectory(directory)
+{
+
+}
+
+void AssetIndex::Refresh(const AssetIndexParser& parser)
+{
+	mEntries.clear();
+
+	HashMap<Filesystem::Path, AssetIndexEntry> saved;
+	auto indexPath = mDirectory / Filename();
+	if (Filesystem::Exists(indexPath))
+	{
+		auto accessor = Filesystem::ReadAccessor(indexPath);
+		auto mapped = Filesystem::Map(indexPath);
+		AssetIndexTable table;
+		if (BinarySerializer::Deserialize(mapped.GetData(), mapped.GetSize(), Reflection::GetClass<AssetIndexTable>(), &table))
+		{
+			for (auto& entry : table.entries)
+			{
+				auto path = entry.path;
+				saved.emplace(std::move(path), std::move(entry));
+			}
+		}
+	}
+
+	// removed assets are dropped by not being visited
+	bool changed = false;
+	uint32_t parsed = 0;
+	Filesystem::ForEach(mDirectory, [&](const Filesystem::Path& path)
+	{
+		if (path.extension() != Asset::extension())
+		{
+			return;
+		}
+
+		auto relPath = Filesystem::Relative(path, mDirectory);
+		auto it = saved.find(relPath);
+		if (it != saved.end() && IsStale(it->second, path) == false)
+		{
+			mEntries[it->second.asset] = std::move(it->second);
+			saved.erase(it);
+			return;
+		}
+
+		AssetIndexEntry entry;
+		Parse(path, parser, entry);
+		if (entry.asset.guid != Guid::InvalidGuid())
+		{
+			mEntries[entry.asset] = std::move(entry);
+		}
+		changed = true;
+		parsed++;
+	}, true);
+	changed |= saved.empty() == false;
+
+	if (changed)
+	{
+		Save();
+	}
+	GLEAM_CORE_INFO("Asset index refreshed: {0} assets, {1} reparsed", mEntries.size(), parsed);
+}
+
+const AssetIndexEntry* AssetIndex::Update(const Filesystem::Path& path, const AssetIndexParser& parser)
+{
+	if (path.extension() != Asset::extension() || Filesystem::Exists(path) == false)
+	{
+		return nullptr;
+	}
+
+	AssetReference ref = { .guid = Guid(path.stem().string()) };
+	auto it = mEntries.find(ref);
+	if (it != mEntries.end() && IsStale(it->second, path) == false)
+	{
+		return &it->second;
+	}
+
+	AssetIndexEntry entry;
+	Parse(path, parser, entry);
+	if (entry.asset.guid == Guid::InvalidGuid())
+	{
+		return nullptr;
+	}
+
+	auto& indexed = mEntries[entry.asset];
+	indexed = std::move(entry);
+	mDirty = true;
+	return &indexed;
+}
+
+void AssetIndex::Remove(const Filesystem::Path& path)
+{
+	AssetReference ref = { .guid = Guid(path.stem().string()) };
+	if (mEntries.erase(ref) > 0)
+	{
+		mDirty = true;
+	}
+}
+
+void AssetIndex::SetDependencies(const std::function<const TArray<AssetReference>&(const AssetReference&)>& dependencies)
+{
+	for (auto& [ref, entry] : mEntries)
+	{
+		const auto& updated = dependencies(ref);
+		if (entry.dependencies != updated)
+		{
+			entry.dependencies = updated;
+			mDirty = true;
+		}
+	}
+}
+
+void AssetIndex::Flush()
+{
+	if (mDirty)
+	{
+		Save();
+	}
+}
+
+void AssetIndex::Save()
+{
+	mDirty = false;
+
+	AssetIndexTable table;
+	table.entries.reserve(mEntries.size());
+	for (const auto& [ref, entry] : mEntries)
+	{
+		table.entries.push_back(entry);
+	}
+
+	BinaryWriter writer;
+	writer.Write(&table, Reflection::GetClass<AssetIndexTable>());
+
+	TArray<uint8_t> data;
+	writer.Finish(data);
+
+	auto indexPath = mDirectory / Filename();
+	auto accessor = Filesystem::WriteAccessor(indexPath);
+	auto file = Filesystem::Create(indexPath, FileType::Binary);
+	file.GetStream().write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+const AssetIndexEntry* AssetIndex::Find(const AssetReference& ref) const
+{
+	auto it = mEntries.find(ref);
+	return it != mEntries.end() ? &it->second : nullptr;
+}
+
+const HashMap<AssetReference, AssetIndexEntry>& AssetIndex::GetEntries() const
+{
+	return mEntries;
+}
+
+bool AssetIndex::IsStale(const AssetIndexEntry& entry, const Filesystem::Path& path) const
+{
+	return entry.modifiedTime != Filesystem::LastWriteTime(path) || entry.size != Filesystem::FileSize(path);
+}
+
+void AssetIndex::Parse(const Filesystem::Path& path, const AssetIndexParser& parser, AssetIndexEntry& entry) const
+{
+	entry.asset = { .guid = Guid(path.stem().string()) };
+	entry.path = Filesystem::Relative(path, mDirectory);
+	entry.name = path.stem().string();
+	entry.modifiedTime = Filesystem::LastWriteTime(path);
+	entry.size = Filesystem::FileSize(path);
+	{
+		auto accessor = Filesystem::ReadAccessor(path);
+		auto mapped = Filesystem::Map(path);
+		entry.contentHash = Hash64(mapped.GetData(), mapped.GetSize());
+	}
+	parser(path, entry);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "AssetReference.h"
+
+namespace Gleam {
+
+struct AssetIndexEntry
+{
+	AssetReference asset;
+	Filesystem::Path path; // relative to the indexed directory
+	Guid type = Guid::InvalidGuid();
+	TString name;
+	uint64_t modifiedTime = 0;
+	uint64_t size = 0;
+	uint64_t contentHash = 0;
+	TArray<AssetReference> dependencies;
+};
+
+struct AssetIndexTable
+{
+	TArray<AssetIndexEntry> entries;
+};
+
+// The name field every descriptor carries, decoded on its own while the rest of the payload is skipped
+struct AssetDisplayName
+{
+	TString name;
+};
+
+// Fills the type, name and dependencies of an entry from the asset file
+using AssetIndexParser = std::function<void(const Filesystem::Path& path, AssetIndexEntry& entry)>;
+
+/*
+* Persistent metadata of every asset in a directory, saved as a binary blob next to the assets
+* Entries are revalidated by modification time and size, so only added or changed assets are opened
+* Updates and removals only mark the index dirty, it is written once per batch by Flush
+*/
+class AssetIndex
+{
+public:
+
+	static constexpr TStringView Filename()
+	{
+		return "Assets.index";
+	}
+
+	AssetIndex() = default;
+
+	AssetIndex(const Filesystem::Path& directory);
+
+	// Loads the saved index, reparses the stale entries and saves it back if anything changed
+	void Refresh(const AssetIndexParser& parser);
+
+	// Reparses a single asset, returns null if the path is not an asset
+	const AssetIndexEntry* Update(const Filesystem::Path& path, const AssetIndexParser& parser);
+
+	void Remove(const Filesystem::Path& path);
+
+	// Replaces the dependencies of every entry, e.g. after the dependency graph was reloaded
+	void SetDependencies(const std::function<const TArray<AssetReference>&(const AssetReference&)>& dependencies);
+
+	// Saves the index if it changed since the last save
+	void Flush();
+
+	void Save();
+
+	const AssetIndexEntry* Find(const AssetReference& ref) const;
+
+	const HashMap<AssetReference, AssetIndexEntry>& GetEntries() const;
+
+private:
+
+	bool IsStale(const AssetIndexEntry& entry, const Filesystem::Path& path) const;
+
+	void Parse(const Filesystem::Path& path, const AssetIndexParser& parser, AssetIndexEntry& entry) const;
+
+	Filesystem::Path mDirectory;
+
+	HashMap<AssetReference, AssetIndexEntry> mEntries;
+
+	bool mDirty = false;
+
+};
+
+} // namespace Gleam
+
+GLEAM_TYPE(Gleam::AssetIndexEntry, Guid("5F2B8C14-7A3E-4D91-B6E0-9C4D1F8A2E73"))
+	GLEAM_FIELD(asset, Serializable())
+	GLEAM_FIELD(path, Serializable())
+	GLEAM_FIELD(type, Serializable())
+	GLEAM_FIELD(name, Serializable())
+	GLEAM_FIELD(modifiedTime, Serializable())
+	GLEAM_FIELD(size, Serializable())
+	GLEAM_FIELD(contentHash, Serializable())
+	GLEAM_FIELD(dependencies, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(Gleam::AssetIndexTable, Guid("A83E6D27-1B9C-4F05-8E4A-2D7C6B9F3A18"))
+	GLEAM_FIELD(entries, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(Gleam::AssetDisplayName, Guid("6B1E9D43-2C7A-4F58-A03D-8E5F1B7C4D26"))
+	GLEAM_FIELD(name, Serializable())
+GLEAM_END
@@ -3,27 +3,128 @@
 #include "Core/Engine.h"
 #include "Core/Globals.h"
 #include "IO/FileWatcher.h"
+#include "IO/PakArchive.h"
+#include "Renderer/MeshDescriptor.h"
+#include "Renderer/TextureDescriptor.h"
+#include "Renderer/Material/MaterialDescriptor.h"
 
 using namespace Gleam;
 
+static size_t EstimateHeapSize(const void* obj, const Reflection::ClassDescription& classDesc);
+
+static size_t EstimateElementsHeapSize(const void* obj, const Reflection::ArrayDescription& arrayDesc, size_t count)
+{
+	if (arrayDesc.ElementType() != Reflection::FieldType::Class)
+	{
+		return 0;
+	}
+
+	size_t size = 0;
+	const auto& elementDesc = Reflection::GetClass(arrayDesc.ElementHash());
+	for (size_t i = 0; i < count; i++)
+	{
+		size += EstimateHeapSize(OffsetPointer(obj, i * arrayDesc.GetStride()), elementDesc);
+	}
+	return size;
+}
+
+// Heap memory owned by the object beyond its own size, used to charge cached assets against the budget
+static size_t EstimateHeapSize(const void* obj, const Reflection::ClassDescription& classDesc)
+{
+	const auto name = classDesc.ResolveName();
+	if (name == Reflection::GetClass<TString>().ResolveName())
+	{
+		return Reflection::Get<TString>(obj).capacity();
+	}
+	if (name == Reflection::GetClass<Filesystem::Path>().ResolveName())
+	{
+		return Reflection::Get<Filesystem::Path>(obj).native().capacity();
+	}
+	if (name == Reflection::GetClass<TArray<uint8_t>>().ResolveName())
+	{
+		const auto& arr = Reflection::Get<TArray<uint8_t>>(obj);
+		const auto& arrayDesc = Reflection::GetArray(classDesc.ContainerHash());
+		return arr.capacity() + EstimateElementsHeapSize(arr.data(), arrayDesc, arr.size() / arrayDesc.GetStride());
+	}
+
+	size_t size = 0;
+	for (const auto& baseClass : classDesc.ResolveBaseClasses())
+	{
+		size += EstimateHeapSize(obj, baseClass);
+	}
+
+	for (const auto& field : classDesc.ResolveFields())
+	{
+		if (field.GetType() == Reflection::FieldType::Class)
+		{
+			const auto& classField = field.GetField<Reflection::ClassField>();
+			size += EstimateHeapSize(OffsetPointer(obj, classField.offset), Reflection::GetClass(classField.hash));
+		}
+		else if (field.GetType() == Reflection::FieldType::Array)
+		{
+			const auto& arrayField = field.GetField<Reflection::ArrayField>();
+			const auto& arrayDesc = Reflection::GetArray(arrayField.hash);
+			size += EstimateElementsHeapSize(OffsetPointer(obj, arrayField.offset), arrayDesc, arrayDesc.GetSize() / arrayDesc.GetStride());
+		}
+	}
+	return size;
+}
+
 void AssetManager::Initialize(Application* app)
 {
-	Filesystem::ForEach(Globals::ProjectContentDirectory, [this](const auto& entry)
+	mLoadThreads = CreateScope<ThreadPool>();
+
+	// a cooked project reads its content from the archives, loose files only fill in what they lack
+	auto archiveDirectory = Globals::ProjectDirectory / ArchiveDirectory();
+	if (Filesystem::IsDirectory(archiveDirectory))
 	{
-		if (entry.extension() == ".asset")
+		Filesystem::ForEach(archiveDirectory, [this](const Filesystem::Path& path)
 		{
-			auto guid = Guid(entry.stem().string());
-			auto relPath = Filesystem::Relative(entry, Globals::ProjectContentDirectory);
+			if (path.extension() == PakArchive::Extension() && Filesystem::Mount(path, Globals::ProjectContentDirectory))
+			{
+				mArchives.push_back(path);
+			}
+		}, false);
+	}
+	mDependencyGraph.Load(Globals::ProjectContentDirectory / AssetDependencyGraph::Filename());
 
-			Asset asset{ .path = relPath };
-			AssetReference assetRef = { .guid = guid };
-			mAssets.emplace(assetRef, asset);
-		}
-	}, true);
+	RegisterType<MeshDescriptor>();
+	RegisterType<TextureDescriptor>();
+	RegisterType<MaterialDescriptor>();
+	RegisterType<MaterialInstanceDescriptor>();
+
+	// only assets changed since the last run are opened, the rest comes from the saved index
+	mIndex = AssetIndex(Globals::ProjectContentDirectory);
+	mIndex.Refresh([this](const Filesystem::Path& path, AssetIndexEntry& entry)
+	{
+		ParseIndexEntry(path, entry);
+	});
+
+	for (const auto& [ref, entry] : mIndex.GetEntries())
+	{
+		mAssets.emplace(ref, Asset{ .path = entry.path });
+	}
+
+	// archives do not change under a running game, and a cooked project may have no content directory to watch
+	if (mArchives.empty() == false)
+	{
+		return;
+	}
 
     auto fileWatcher = Globals::Engine->GetSubsystem<FileWatcher>();
     fileWatcher->AddWatch(Globals::ProjectContentDirectory, [this](const Filesystem::Path& path, FileWatchEvent event)
     {
+        if (path.filename() == AssetDependencyGraph::Filename())
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDependencyGraph.Load(path);
+            mIndex.SetDependencies([this](const AssetReference& ref) -> const TArray<AssetReference>&
+            {
+                return mDependencyGraph.GetDependencies(ref);
+            });
+            return;
+        }
+
         if (path.extension() != Asset::extension())
         {
             return;
@@ -37,6 +138,7 @@ void AssetManager::Initialize(Application* app)
             case FileWatchEvent::Added:
             {
 				TryEmplaceAsset(asset);
+				UpdateIndex(path);
                 break;
             }
             case FileWatchEvent::Removed:
@@ -48,8 +150,10 @@ void AssetManager::Initialize(Application* app)
                 
                 if (it != mAssets.end())
                 {
+                    InvalidateWithDependents(it->first);
                     mAssets.erase(it);
                 }
+                mIndex.Remove(path);
                 break;
             }
 			case FileWatchEvent::Modified:
@@ -63,6 +167,12 @@ void AssetManager::Initialize(Application* app)
 				{
 					TryEmplaceAsset(asset);
 				}
+				else
+				{
+					// a reimported asset also stales everything built on top of it
+					InvalidateWithDependents(it->first);
+				}
+				UpdateIndex(path);
 				break;
 			}
             default: break;
@@ -72,7 +182,392 @@ void AssetManager::Initialize(Application* app)
 
 void AssetManager::Shutdown()
 {
+    // joins the loading threads before the requests they reference go away
+    mLoadThreads.reset();
+    mInFlight.clear();
+    mFinalizeQueue.clear();
+    mCache.clear();
+    mCacheOrder.clear();
     mAssets.clear();
+    mIndex.Flush();
+    mIndex = AssetIndex();
+
+	for (const auto& archive : mArchives)
+	{
+		Filesystem::Unmount(archive);
+	}
+	mArchives.clear();
+}
+
+void AssetManager::Invalidate(const AssetReference& ref)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	EraseCached(ref);
+	mInFlight.erase(ref);
+}
+
+void AssetManager::SetCacheBudget(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCacheStats.budget = bytes;
+	EvictUnreferenced();
+}
+
+void AssetManager::Update()
+{
+	// a burst of file changes within a frame is written as a single save
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIndex.Flush();
+	}
+
+	using Clock = std::chrono::steady_clock;
+	FinalizeRequests(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(mFinalizeBudget)));
+}
+
+void AssetManager::Preload(const TArray<AssetReference>& roots, std::function<void()>&& onLoaded)
+{
+	TArray<Tuple<AssetReference, AssetDecoder>> loads;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (const auto& ref : mDependencyGraph.CollectDependencies(roots))
+		{
+			auto decoder = mDecoders.find(mDependencyGraph.GetType(ref));
+			if (decoder != mDecoders.end())
+			{
+				loads.emplace_back(ref, decoder->second);
+			}
+		}
+	}
+
+	if (loads.empty())
+	{
+		onLoaded();
+		return;
+	}
+
+	struct PreloadState
+	{
+		size_t pending = 0;
+		std::function<void()> onLoaded;
+	};
+	auto state = CreateRef<PreloadState>(PreloadState{ .pending = loads.size(), .onLoaded = std::move(onLoaded) });
+
+	// callbacks run one at a time on the main thread, the last one to arrive completes the preload
+	for (auto& [ref, decoder] : loads)
+	{
+		RequestAsync(ref, *decoder.classDesc, std::move(decoder.decode), [state, count = loads.size()](const RefCounted<const void>&)
+		{
+			if (--state->pending == 0)
+			{
+				GLEAM_CORE_INFO("Preloaded {0} assets", count);
+				state->onLoaded();
+			}
+		}, AssetLoadPriority::High);
+	}
+}
+
+void AssetManager::SetDependencies(const AssetReference& asset, const TArray<AssetReference>& dependencies)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mDependencyGraph.SetDependencies(asset, mDependencyGraph.GetType(asset), dependencies);
+	mDependencyGraph.Save(Globals::ProjectContentDirectory / AssetDependencyGraph::Filename());
+}
+
+void AssetManager::FinalizeRequests(std::chrono::steady_clock::time_point deadline)
+{
+	do
+	{
+		RefCounted<AssetLoadRequest> request;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mFinalizeQueue.empty())
+			{
+				break;
+			}
+			request = mFinalizeQueue.front();
+			mFinalizeQueue.pop_front();
+		}
+
+		// the asset is already cached by the loading thread, what is left is the work callers need the main thread for
+		TArray<AssetLoadCallback> callbacks;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			callbacks.swap(request->callbacks);
+			if (request->state == AssetLoadState::Loading)
+			{
+				request->state = request->asset ? AssetLoadState::Ready : AssetLoadState::Failed;
+			}
+		}
+
+		for (const auto& callback : callbacks)
+		{
+			callback(request->state == AssetLoadState::Ready ? request->asset : nullptr);
+		}
+	} while (std::chrono::steady_clock::now() < deadline);
+}
+
+void AssetManager::Reindex(const Filesystem::Path& path)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (TryEmplaceAsset(Asset{ .path = Filesystem::Relative(path, Globals::ProjectContentDirectory) }))
+	{
+		UpdateIndex(path);
+	}
+}
+
+bool AssetManager::EncodeBinary(const Filesystem::Path& path, TArray<uint8_t>& data) const
+{
+	Guid type;
+	{
+		auto accessor = Filesystem::ReadAccessor(path);
+		auto mapped = Filesystem::Map(path);
+		if (mapped.GetData() == nullptr || BinarySerializer::IsBinary(mapped.GetData(), mapped.GetSize()))
+		{
+			return false;
+		}
+		type = JSONSerializer(mapped).ParseHeader().guid;
+	}
+
+	auto decoder = mDecoders.find(type);
+	if (decoder == mDecoders.end())
+	{
+		return false;
+	}
+
+	auto asset = decoder->second.decode(path);
+	if (asset == nullptr)
+	{
+		return false;
+	}
+
+	BinaryWriter writer;
+	writer.Write(asset.get(), *decoder->second.classDesc);
+	writer.Finish(data);
+	return true;
+}
+
+TArray<AssetIndexEntry> AssetManager::GetIndexedAssets(const Guid& type)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	TArray<AssetIndexEntry> entries;
+	for (const auto& [ref, entry] : mIndex.GetEntries())
+	{
+		if (type == Guid::InvalidGuid() || entry.type == type)
+		{
+			entries.push_back(entry);
+		}
+	}
+	return entries;
+}
+
+void AssetManager::SetFinalizeBudget(double milliseconds)
+{
+	mFinalizeBudget = milliseconds;
+}
+
+RefCounted<AssetLoadRequest> AssetManager::RequestAsync(const AssetReference& ref, const Reflection::ClassDescription& classDesc, AssetDecodeFn&& decode, AssetLoadCallback&& callback, AssetLoadPriority priority)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto request = CreateRef<AssetLoadRequest>();
+	request->ref = ref;
+	request->classDesc = &classDesc;
+	if (callback)
+	{
+		request->callbacks.push_back(std::move(callback));
+	}
+
+	auto cached = mCache.find(ref);
+	if (cached != mCache.end() && cached->second.classDesc == &classDesc)
+	{
+		mCacheStats.hits++;
+		mCacheOrder.splice(mCacheOrder.begin(), mCacheOrder, cached->second.lru);
+
+		// already loaded, the callback still runs on the main thread
+		request->asset = cached->second.asset;
+		request->state = AssetLoadState::Ready;
+		if (request->callbacks.empty() == false)
+		{
+			mFinalizeQueue.push_back(request);
+		}
+		return request;
+	}
+
+	auto inFlight = mInFlight.find(ref);
+	if (inFlight != mInFlight.end() && inFlight->second->classDesc == &classDesc)
+	{
+		auto& pending = inFlight->second;
+		pending->callbacks.insert(pending->callbacks.end(), std::make_move_iterator(request->callbacks.begin()), std::make_move_iterator(request->callbacks.end()));
+		return pending;
+	}
+
+	mCacheStats.misses++;
+	auto asset = mAssets.find(ref);
+	if (asset == mAssets.end())
+	{
+		GLEAM_CORE_ERROR("Asset could not located for GUID: {0}", ref.guid.ToString());
+		mFinalizeQueue.push_back(request);
+		return request;
+	}
+
+	request->decode = std::move(decode);
+	mInFlight[ref] = request;
+
+	auto fullpath = Globals::ProjectContentDirectory / asset->second.path;
+	mLoadThreads->Submit([this, request, fullpath]()
+	{
+		auto decoded = request->decode(fullpath);
+		size_t bytes = decoded ? request->classDesc->GetSize() + EstimateHeapSize(decoded.get(), *request->classDesc) : 0;
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		// an invalidation while decoding detaches the request, what it read may predate the change and is not cached
+		auto it = mInFlight.find(request->ref);
+		bool current = it != mInFlight.end() && it->second == request;
+		if (decoded)
+		{
+			request->asset = current ? InsertCached(request->ref, *request->classDesc, decoded, bytes) : decoded;
+		}
+
+		// requests arriving from now on hit the cache instead of joining this one
+		if (current)
+		{
+			mInFlight.erase(it);
+		}
+		mFinalizeQueue.push_back(request);
+	}, static_cast<int32_t>(priority));
+	return request;
+}
+
+AssetCacheStats AssetManager::GetCacheStats() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mCacheStats;
+}
+
+bool AssetManager::ResolvePath(const AssetReference& ref, Filesystem::Path& path)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mAssets.find(ref);
+	if (it == mAssets.end())
+	{
+		return false;
+	}
+	path = Globals::ProjectContentDirectory / it->second.path;
+	return true;
+}
+
+RefCounted<const void> AssetManager::FindCached(const AssetReference& ref, const Reflection::ClassDescription& classDesc)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mCache.find(ref);
+	if (it == mCache.end() || it->second.classDesc != &classDesc)
+	{
+		mCacheStats.misses++;
+		return nullptr;
+	}
+
+	mCacheStats.hits++;
+	mCacheOrder.splice(mCacheOrder.begin(), mCacheOrder, it->second.lru);
+	return it->second.asset;
+}
+
+RefCounted<const void> AssetManager::AddCached(const AssetReference& ref, const Reflection::ClassDescription& classDesc, const RefCounted<const void>& asset)
+{
+	size_t bytes = classDesc.GetSize() + EstimateHeapSize(asset.get(), classDesc);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	return InsertCached(ref, classDesc, asset, bytes);
+}
+
+RefCounted<const void> AssetManager::InsertCached(const AssetReference& ref, const Reflection::ClassDescription& classDesc, const RefCounted<const void>& asset, size_t bytes)
+{
+	auto it = mCache.find(ref);
+	if (it != mCache.end())
+	{
+		// another thread loaded it in the meantime, share a single instance
+		if (it->second.classDesc == &classDesc)
+		{
+			return it->second.asset;
+		}
+		EraseCached(ref);
+	}
+
+	mCacheOrder.push_front(ref);
+	mCache.emplace(ref, CacheEntry{ .asset = asset, .classDesc = &classDesc, .bytes = bytes, .lru = mCacheOrder.begin() });
+	mCacheStats.bytes += bytes;
+	mCacheStats.entries++;
+
+	EvictUnreferenced();
+	return asset;
+}
+
+void AssetManager::InvalidateWithDependents(const AssetReference& ref)
+{
+	// loads already running are detached too, so that the next request reads the file again
+	EraseCached(ref);
+	mInFlight.erase(ref);
+	for (const auto& dependent : mDependencyGraph.CollectDependents(ref))
+	{
+		EraseCached(dependent);
+		mInFlight.erase(dependent);
+	}
+}
+
+void AssetManager::EraseCached(const AssetReference& ref)
+{
+	auto it = mCache.find(ref);
+	if (it == mCache.end())
+	{
+		return;
+	}
+
+	mCacheStats.bytes -= it->second.bytes;
+	mCacheStats.entries--;
+	mCacheStats.invalidations++;
+	mCacheOrder.erase(it->second.lru);
+	mCache.erase(it);
+}
+
+void AssetManager::EvictUnreferenced()
+{
+	// walk from the least recently used, entries still held outside of the cache can not be evicted
+	auto lru = mCacheOrder.end();
+	while (mCacheStats.bytes > mCacheStats.budget && lru != mCacheOrder.begin())
+	{
+		--lru;
+		auto it = mCache.find(*lru);
+		if (it->second.asset.use_count() > 1)
+		{
+			continue;
+		}
+
+		mCacheStats.bytes -= it->second.bytes;
+		mCacheStats.entries--;
+		mCacheStats.evictions++;
+		lru = mCacheOrder.erase(lru);
+		mCache.erase(it);
+	}
+}
+
+MappedFile AssetManager::MapSidecar(const AssetReference& ref) const
+{
+	// called from streaming threads, only the lookup needs the lock
+	Filesystem::Path fullpath;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto it = mAssets.find(ref);
+		if (it == mAssets.end())
+		{
+			GLEAM_CORE_ERROR("Asset could not located for GUID: {0}", ref.guid.ToString());
+			return MappedFile();
+		}
+		fullpath = Globals::ProjectContentDirectory / it->second.path;
+	}
+
+	fullpath.replace_extension(Asset::sidecarExtension());
+	return Filesystem::Map(fullpath);
 }
 
 bool AssetManager::TryEmplaceAsset(const Asset& asset)
@@ -87,3 +582,52 @@ bool AssetManager::TryEmplaceAsset(const Asset& asset)
 	mAssets[assetRef] = asset;
 	return true;
 }
+
+const AssetIndexEntry* AssetManager::UpdateIndex(const Filesystem::Path& path)
+{
+	return mIndex.Update(path, [this](const Filesystem::Path& path, AssetIndexEntry& entry)
+	{
+		ParseIndexEntry(path, entry);
+	});
+}
+
+void AssetManager::ParseIndexEntry(const Filesystem::Path& path, AssetIndexEntry& entry) const
+{
+	// dependencies are recorded while baking, so nothing but the header and the name has to be read
+	entry.dependencies = mDependencyGraph.GetDependencies(entry.asset);
+
+	auto accessor = Filesystem::ReadAccessor(path);
+	auto mapped = Filesystem::Map(path);
+	if (BinarySerializer::IsBinary(mapped.GetData(), mapped.GetSize()))
+	{
+		BinaryHeader header;
+		memcpy(&header, mapped.GetData(), sizeof(BinaryHeader));
+		entry.type = Guid(header.typeGuid);
+	}
+	else
+	{
+		auto serializer = JSONSerializer(mapped);
+		entry.type = serializer.ParseHeader().guid;
+	}
+
+	// worlds and other assets without a decoder are not read any further
+	if (mDecoders.contains(entry.type) == false)
+	{
+		return;
+	}
+
+	AssetDisplayName displayName;
+	if (BinarySerializer::IsBinary(mapped.GetData(), mapped.GetSize()))
+	{
+		BinarySerializer::Deserialize(mapped.GetData(), mapped.GetSize(), Reflection::GetClass<AssetDisplayName>(), &displayName);
+	}
+	else
+	{
+		displayName = JSONSerializer(mapped).DeserializeStreaming<AssetDisplayName>();
+	}
+
+	if (displayName.name.empty() == false)
+	{
+		entry.name = displayName.name;
+	}
+}
@@ -1,8 +1,13 @@
 #pragma once
 #include "Asset.h"
 #include "AssetReference.h"
+#include "AssetDependencyGraph.h"
+#include "AssetIndex.h"
 #include "Core/Subsystem.h"
+#include "Core/ThreadPool.h"
+#include "IO/MappedFile.h"
 #include "Serialization/JSONSerializer.h"
+#include "Serialization/BinarySerializer.h"
 
 #include <mutex>
 
@@ -10,40 +15,285 @@ namespace Gleam {
 
 struct Asset;
 
+struct AssetCacheStats
+{
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+	uint64_t invalidations = 0;
+	size_t bytes = 0;
+	size_t budget = 256 * 1024 * 1024;
+	uint32_t entries = 0;
+};
+
+enum class AssetLoadPriority : int32_t
+{
+	Low = -1,
+	Normal = 0,
+	High = 1
+};
+
+enum class AssetLoadState
+{
+	Loading,
+	Ready,
+	Failed
+};
+
+using AssetLoadCallback = std::function<void(const RefCounted<const void>&)>;
+
+using AssetDecodeFn = std::function<RefCounted<const void>(const Filesystem::Path&)>;
+
+struct AssetLoadRequest
+{
+	AssetReference ref;
+	const Reflection::ClassDescription* classDesc = nullptr;
+	AssetDecodeFn decode;
+	TArray<AssetLoadCallback> callbacks;
+	RefCounted<const void> asset;
+	std::atomic<AssetLoadState> state = AssetLoadState::Loading;
+};
+
+template<typename T>
+class AssetHandle
+{
+public:
+
+	AssetHandle() = default;
+
+	AssetHandle(const RefCounted<AssetLoadRequest>& request)
+		: mRequest(request)
+	{
+
+	}
+
+	AssetLoadState GetState() const
+	{
+		return mRequest ? mRequest->state.load() : AssetLoadState::Failed;
+	}
+
+	bool IsReady() const
+	{
+		return GetState() == AssetLoadState::Ready;
+	}
+
+	// null until the request is finalized on the main thread
+	RefCounted<const T> Get() const
+	{
+		return IsReady() ? std::static_pointer_cast<const T>(mRequest->asset) : nullptr;
+	}
+
+private:
+
+	RefCounted<AssetLoadRequest> mRequest;
+
+};
+
 class AssetManager final : public GameInstanceSubsystem
 {
 public:
+
+	// Cooked archives under the project directory, mounted over the content directory
+	static constexpr TStringView ArchiveDirectory()
+	{
+		return "Paks";
+	}
     
     virtual void Initialize(Application* app) override;
 
     virtual void Shutdown() override;
 
+	// Shared, cached instance of the asset, kept alive in the cache while it is referenced
 	template<typename T>
-	T Get(const AssetReference& ref) const
+	RefCounted<const T> Load(const AssetReference& ref)
 	{
-		auto it = mAssets.find(ref);
-		if (it != mAssets.end())
+		const auto& classDesc = Reflection::GetClass<T>();
+		if (auto cached = FindCached(ref, classDesc))
+		{
+			return std::static_pointer_cast<const T>(cached);
+		}
+
+		Filesystem::Path fullpath;
+		if (ResolvePath(ref, fullpath) == false)
 		{
-			auto fullpath = Globals::ProjectContentDirectory / it->second.path;
-			auto file = Filesystem::Open(fullpath, FileType::Text);
-			auto serializer = JSONSerializer(file.GetStream());
-			auto asset = serializer.Deserialize<T>();
-			return asset;
+			GLEAM_CORE_ERROR("Asset could not located for GUID: {0}", ref.guid.ToString());
+			GLEAM_ASSERT(false);
+			return CreateRef<const T>();
 		}
 
-		GLEAM_CORE_ERROR("Asset could not located for GUID: {0}", ref.guid.ToString());
-		GLEAM_ASSERT(false);
-		return T();
+		// a failed decode is not cached, the next load reads the file again
+		auto asset = Decode<T>(fullpath);
+		if (asset == nullptr)
+		{
+			return CreateRef<const T>();
+		}
+		return std::static_pointer_cast<const T>(AddCached(ref, classDesc, asset));
 	}
 
+	// Decodes on the loading threads, onLoaded runs on the main thread from Update with null if the load failed
+	template<typename T>
+	AssetHandle<T> LoadAsync(const AssetReference& ref, AssetLoadPriority priority = AssetLoadPriority::Normal, std::function<void(const RefCounted<const T>&)>&& onLoaded = {})
+	{
+		AssetLoadCallback callback;
+		if (onLoaded)
+		{
+			callback = [onLoaded = std::move(onLoaded)](const RefCounted<const void>& asset)
+			{
+				onLoaded(std::static_pointer_cast<const T>(asset));
+			};
+		}
+
+		auto decode = [](const Filesystem::Path& path) -> RefCounted<const void>
+		{
+			return Decode<T>(path);
+		};
+		return AssetHandle<T>(RequestAsync(ref, Reflection::GetClass<T>(), std::move(decode), std::move(callback), priority));
+	}
+
+	// Runs the callbacks of decoded requests on the main thread until the frame budget is spent
+	void Update();
+
+	// Loads the transitive dependencies of the roots in parallel, onLoaded runs on the main thread from Update once all of them are finalized
+	void Preload(const TArray<AssetReference>& roots, std::function<void()>&& onLoaded);
+
+	// Records the assets referenced by a non baked asset such as a world, saved with the project dependency graph
+	void SetDependencies(const AssetReference& asset, const TArray<AssetReference>& dependencies);
+
+	// Types that can be decoded from the dependency graph alone, without the caller naming T
+	template<typename T>
+	void RegisterType()
+	{
+		const auto& classDesc = Reflection::GetClass<T>();
+		mDecoders[classDesc.Guid()] = AssetDecoder{
+			.classDesc = &classDesc,
+			.decode = [](const Filesystem::Path& path) -> RefCounted<const void> { return Decode<T>(path); }
+		};
+	}
+
+	// Refreshes the index entry of an asset written outside of the file watcher, such as by a baker
+	void Reindex(const Filesystem::Path& path);
+
+	// Re-encodes a JSON asset of a registered type as a binary blob, false for other types and assets that are already binary
+	bool EncodeBinary(const Filesystem::Path& path, TArray<uint8_t>& data) const;
+
+	// Metadata of the indexed assets, every asset when the type is invalid
+	TArray<AssetIndexEntry> GetIndexedAssets(const Guid& type = Guid::InvalidGuid());
+
+	template<typename T>
+	TArray<AssetIndexEntry> GetIndexedAssets()
+	{
+		return GetIndexedAssets(Reflection::GetClass<T>().Guid());
+	}
+
+	void SetFinalizeBudget(double milliseconds);
+
+	// Drops the cached instance and detaches a running load from later requests, holders of the asset keep their copy
+	void Invalidate(const AssetReference& ref);
+
+	void SetCacheBudget(size_t bytes);
+
+	AssetCacheStats GetCacheStats() const;
+
+	// Safe to call from any thread, the mapping stays valid after the asset is removed
+	MappedFile MapSidecar(const AssetReference& ref) const;
+
 private:
 
+	struct AssetDecoder
+	{
+		const Reflection::ClassDescription* classDesc = nullptr;
+		AssetDecodeFn decode;
+	};
+
+	struct CacheEntry
+	{
+		RefCounted<const void> asset;
+		const Reflection::ClassDescription* classDesc = nullptr;
+		size_t bytes = 0;
+		List<AssetReference>::iterator lru;
+	};
+
+	// Null if the file is corrupt or truncated
+	template<typename T>
+	static RefCounted<T> Decode(const Filesystem::Path& path)
+	{
+		GLEAM_PROFILE_SCOPE(entt::type_id<T>().name());
+		auto asset = CreateRef<T>();
+
+		// cooked assets are binary blobs, editor assets are still baked as JSON
+		// the accessor keeps a reimport from rewriting the file under the view
+		auto accessor = Filesystem::ReadAccessor(path);
+		auto mapped = Filesystem::Map(path);
+		bool decoded = false;
+		if (BinarySerializer::IsBinary(mapped.GetData(), mapped.GetSize()))
+		{
+			decoded = BinarySerializer::Deserialize(mapped.GetData(), mapped.GetSize(), Reflection::GetClass<T>(), asset.get());
+		}
+		else
+		{
+			auto serializer = JSONSerializer(mapped);
+			decoded = serializer.DeserializeStreaming(Reflection::GetClass<T>(), asset.get());
+		}
+
+		if (decoded == false)
+		{
+			GLEAM_CORE_ERROR("Asset could not be decoded: {0}", path.string());
+			return nullptr;
+		}
+		return asset;
+	}
+
 	bool TryEmplaceAsset(const Asset& asset);
 
-	std::mutex mMutex;
+	const AssetIndexEntry* UpdateIndex(const Filesystem::Path& path);
+
+	void ParseIndexEntry(const Filesystem::Path& path, AssetIndexEntry& entry) const;
+
+	RefCounted<AssetLoadRequest> RequestAsync(const AssetReference& ref, const Reflection::ClassDescription& classDesc, AssetDecodeFn&& decode, AssetLoadCallback&& callback, AssetLoadPriority priority);
+
+	bool ResolvePath(const AssetReference& ref, Filesystem::Path& path);
+
+	RefCounted<const void> FindCached(const AssetReference& ref, const Reflection::ClassDescription& classDesc);
+
+	RefCounted<const void> AddCached(const AssetReference& ref, const Reflection::ClassDescription& classDesc, const RefCounted<const void>& asset);
+
+	void FinalizeRequests(std::chrono::steady_clock::time_point deadline);
+
+	void InvalidateWithDependents(const AssetReference& ref);
+
+	RefCounted<const void> InsertCached(const AssetReference& ref, const Reflection::ClassDescription& classDesc, const RefCounted<const void>& asset, size_t bytes);
+
+	void EraseCached(const AssetReference& ref);
+
+	void EvictUnreferenced();
+
+	mutable std::mutex mMutex;
     
     HashMap<AssetReference, Asset> mAssets;
 
+	HashMap<AssetReference, CacheEntry> mCache;
+
+	// most recently used first
+	List<AssetReference> mCacheOrder;
+
+	AssetCacheStats mCacheStats;
+
+	Scope<ThreadPool> mLoadThreads;
+
+	HashMap<AssetReference, RefCounted<AssetLoadRequest>> mInFlight;
+
+	Deque<RefCounted<AssetLoadRequest>> mFinalizeQueue;
+
+	AssetDependencyGraph mDependencyGraph;
+
+	AssetIndex mIndex;
+
+	TArray<Filesystem::Path> mArchives;
+
+	HashMap<Guid, AssetDecoder> mDecoders;
+
+	double mFinalizeBudget = 2.0;
+
 };
 
 } // namespace Gleam
@@ -0,0 +1,636 @@
+#pragma once
+#include <algorithm>
+
+namespace Gleam {
+
+/*
+* Incremental bounding volume hierarchy over axis aligned boxes
+* Leaves are inserted next to the sibling with the lowest surface area cost (Bittner et al. 2012),
+* ancestors are refit and rotated on the way up to keep the tree balanced (Kensler 2008)
+* Moved leaves keep an enlarged box so small motions do not touch the hierarchy
+*/
+template<typename T>
+class DynamicAABBTree
+{
+public:
+
+    static constexpr int32_t NullNode = -1;
+
+    // enlargement of a leaf box once it starts moving
+    static constexpr float Margin = 0.1f;
+
+    DynamicAABBTree() = default;
+
+    int32_t CreateProxy(const BoundingBox& bounds, const T& userData)
+    {
+        int32_t proxy = AllocateNode();
+        auto& node = mNodes[proxy];
+        node.bounds = bounds;
+        node.leafBounds = bounds;
+        node.userData = userData;
+        node.height = 0;
+        InsertLeaf(proxy);
+        mProxyCount++;
+        return proxy;
+    }
+
+    void DestroyProxy(int32_t proxy)
+    {
+        GLEAM_ASSERT(IsLeaf(proxy), "Proxy is not a leaf!");
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        mProxyCount--;
+    }
+
+    // Refits the leaf, the hierarchy is only updated when the bounds leave the enlarged box
+    bool MoveProxy(int32_t proxy, const BoundingBox& bounds)
+    {
+        GLEAM_ASSERT(IsLeaf(proxy), "Proxy is not a leaf!");
+        auto& node = mNodes[proxy];
+        node.leafBounds = bounds;
+        if (node.bounds.Contains(bounds))
+        {
+            return false;
+        }
+
+        RemoveLeaf(proxy);
+        mNodes[proxy].bounds = BoundingBox(bounds.min - Margin, bounds.max + Margin);
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    // Rebuilds the whole hierarchy top down with binned surface area heuristic, suited for static sets
+    void Rebuild()
+    {
+        if (mRoot == NullNode)
+        {
+            return;
+        }
+
+        TArray<int32_t> leaves;
+        leaves.reserve(mProxyCount);
+        for (int32_t i = 0; i < static_cast<int32_t>(mNodes.size()); i++)
+        {
+            if (mNodes[i].height == 0)
+            {
+                leaves.push_back(i);
+            }
+            else if (mNodes[i].height > 0)
+            {
+                FreeNode(i);
+            }
+        }
+
+        mRoot = BuildRange(leaves.data(), static_cast<int32_t>(leaves.size()));
+        mNodes[mRoot].parent = NullNode;
+    }
+
+    void Clear()
+    {
+        mNodes.clear();
+        mRoot = NullNode;
+        mFreeList = NullNode;
+        mProxyCount = 0;
+    }
+
+    const T& GetUserData(int32_t proxy) const
+    {
+        return mNodes[proxy].userData;
+    }
+
+    const BoundingBox& GetBounds(int32_t proxy) const
+    {
+        return mNodes[proxy].leafBounds;
+    }
+
+    uint32_t GetProxyCount() const
+    {
+        return mProxyCount;
+    }
+
+    int32_t GetHeight() const
+    {
+        return mRoot == NullNode ? 0 : mNodes[mRoot].height;
+    }
+
+    // Sum of internal node surface areas relative to the root, lower is better
+    float GetAreaRatio() const
+    {
+        if (mRoot == NullNode)
+        {
+            return 0.0f;
+        }
+
+        float totalArea = 0.0f;
+        for (const auto& node : mNodes)
+        {
+            if (node.height > 0)
+            {
+                totalArea += node.bounds.SurfaceArea();
+            }
+        }
+        return totalArea / mNodes[mRoot].bounds.SurfaceArea();
+    }
+
+    template<typename Func>
+    void Query(const BoundingBox& bounds, Func&& fn) const
+    {
+        Traverse([&](const BoundingBox& box) { return box.Intersects(bounds); }, fn);
+    }
+
+    template<typename Func>
+    void Query(const BoundingSphere& sphere, Func&& fn) const
+    {
+        Traverse([&](const BoundingBox& box) { return box.Intersects(sphere); }, fn);
+    }
+
+    template<typename Func>
+    void Query(const Frustum& frustum, Func&& fn) const
+    {
+        Traverse([&](const BoundingBox& box) { return frustum.Intersects(box); }, fn);
+    }
+
+    /*
+    * Visits leaves whose box the ray enters before maxDistance, nearer children first
+    * fn(userData, distance) returns the new maxDistance to clip the ray against
+    */
+    template<typename Func>
+    void Raycast(const Float3& origin, const Float3& direction, float maxDistance, Func&& fn) const
+    {
+        if (mRoot == NullNode)
+        {
+            return;
+        }
+
+        Float3 invDirection
+        {
+            direction.x != 0.0f ? 1.0f / direction.x : Math::Infinity,
+            direction.y != 0.0f ? 1.0f / direction.y : Math::Infinity,
+            direction.z != 0.0f ? 1.0f / direction.z : Math::Infinity
+        };
+
+        TArray<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(mRoot);
+        while (!stack.empty())
+        {
+            int32_t index = stack.back();
+            stack.pop_back();
+
+            const auto& node = mNodes[index];
+            if (node.height == 0)
+            {
+                float distance;
+                if (RayIntersects(node.leafBounds, origin, invDirection, maxDistance, distance))
+                {
+                    maxDistance = fn(node.userData, distance);
+                }
+                continue;
+            }
+
+            float distance1, distance2;
+            bool hit1 = RayIntersects(mNodes[node.child1].bounds, origin, invDirection, maxDistance, distance1);
+            bool hit2 = RayIntersects(mNodes[node.child2].bounds, origin, invDirection, maxDistance, distance2);
+            if (hit1 && hit2)
+            {
+                // push the far child first so the near one is visited first
+                bool nearFirst = distance1 <= distance2;
+                stack.push_back(nearFirst ? node.child2 : node.child1);
+                stack.push_back(nearFirst ? node.child1 : node.child2);
+            }
+            else if (hit1)
+            {
+                stack.push_back(node.child1);
+            }
+            else if (hit2)
+            {
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+private:
+
+    struct Node
+    {
+        // enlarged box for leaves, union of the children for internal nodes
+        BoundingBox bounds;
+
+        // exact box of the proxy, only valid for leaves
+        BoundingBox leafBounds;
+
+        T userData{};
+
+        // next free node while in the free list
+        int32_t parent = NullNode;
+        int32_t child1 = NullNode;
+        int32_t child2 = NullNode;
+
+        // 0 for leaves, -1 for free nodes
+        int32_t height = -1;
+    };
+
+    bool IsLeaf(int32_t index) const
+    {
+        return mNodes[index].height == 0;
+    }
+
+    int32_t AllocateNode()
+    {
+        if (mFreeList == NullNode)
+        {
+            mNodes.emplace_back();
+            return static_cast<int32_t>(mNodes.size()) - 1;
+        }
+
+        int32_t index = mFreeList;
+        mFreeList = mNodes[index].parent;
+        mNodes[index] = Node();
+        return index;
+    }
+
+    void FreeNode(int32_t index)
+    {
+        mNodes[index].parent = mFreeList;
+        mNodes[index].height = -1;
+        mFreeList = index;
+    }
+
+    template<typename Overlap, typename Func>
+    void Traverse(Overlap&& overlap, Func&& fn) const
+    {
+        if (mRoot == NullNode)
+        {
+            return;
+        }
+
+        TArray<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(mRoot);
+        while (!stack.empty())
+        {
+            int32_t index = stack.back();
+            stack.pop_back();
+
+            const auto& node = mNodes[index];
+            if (node.height == 0)
+            {
+                if (overlap(node.leafBounds))
+                {
+                    fn(node.userData);
+                }
+            }
+            else if (overlap(node.bounds))
+            {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    /*
+    * Descends towards the child with the lowest cost lower bound, the cost of a sibling is the area of the
+    * new parent plus the area growth it causes on every ancestor
+    */
+    int32_t FindBestSibling(const BoundingBox& bounds) const
+    {
+        float leafArea = bounds.SurfaceArea();
+
+        int32_t index = mRoot;
+        float directCost = mNodes[mRoot].bounds.Merge(bounds).SurfaceArea();
+        float inheritedCost = 0.0f;
+
+        int32_t bestSibling = mRoot;
+        float bestCost = directCost;
+        while (mNodes[index].height > 0)
+        {
+            const auto& node = mNodes[index];
+            float cost = directCost + inheritedCost;
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestSibling = index;
+            }
+            inheritedCost += directCost - node.bounds.SurfaceArea();
+
+            // leaves can only become the sibling, internal nodes bound the cost of their subtree
+            auto evaluate = [&](int32_t child, float& childDirectCost)
+            {
+                const auto& childNode = mNodes[child];
+                childDirectCost = childNode.bounds.Merge(bounds).SurfaceArea();
+                float childCost = childDirectCost + inheritedCost;
+                if (childNode.height == 0)
+                {
+                    if (childCost < bestCost)
+                    {
+                        bestCost = childCost;
+                        bestSibling = child;
+                    }
+                    return Math::Infinity;
+                }
+                return inheritedCost + childDirectCost + Math::Min(leafArea - childNode.bounds.SurfaceArea(), 0.0f);
+            };
+
+            float directCost1, directCost2;
+            float lowerCost1 = evaluate(node.child1, directCost1);
+            float lowerCost2 = evaluate(node.child2, directCost2);
+            if (bestCost <= lowerCost1 && bestCost <= lowerCost2)
+            {
+                break;
+            }
+
+            bool first = lowerCost1 <= lowerCost2;
+            index = first ? node.child1 : node.child2;
+            directCost = first ? directCost1 : directCost2;
+        }
+        return bestSibling;
+    }
+
+    void InsertLeaf(int32_t leaf)
+    {
+        if (mRoot == NullNode)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = NullNode;
+            return;
+        }
+
+        int32_t sibling = FindBestSibling(mNodes[leaf].bounds);
+        int32_t oldParent = mNodes[sibling].parent;
+
+        int32_t newParent = AllocateNode();
+        auto& parent = mNodes[newParent];
+        parent.parent = oldParent;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+        parent.bounds = mNodes[sibling].bounds.Merge(mNodes[leaf].bounds);
+        parent.height = mNodes[sibling].height + 1;
+
+        if (oldParent != NullNode)
+        {
+            auto& grandParent = mNodes[oldParent];
+            (grandParent.child1 == sibling ? grandParent.child1 : grandParent.child2) = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        Refit(oldParent);
+    }
+
+    void RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NullNode;
+            return;
+        }
+
+        int32_t parent = mNodes[leaf].parent;
+        int32_t grandParent = mNodes[parent].parent;
+        int32_t sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        if (grandParent != NullNode)
+        {
+            auto& node = mNodes[grandParent];
+            (node.child1 == parent ? node.child1 : node.child2) = sibling;
+            mNodes[sibling].parent = grandParent;
+        }
+        else
+        {
+            mRoot = sibling;
+            mNodes[sibling].parent = NullNode;
+        }
+        FreeNode(parent);
+
+        Refit(grandParent);
+    }
+
+    // Walks up to the root updating boxes and heights, rotating every ancestor
+    void Refit(int32_t index)
+    {
+        while (index != NullNode)
+        {
+            auto& node = mNodes[index];
+            const auto& child1 = mNodes[node.child1];
+            const auto& child2 = mNodes[node.child2];
+            node.bounds = child1.bounds.Merge(child2.bounds);
+            node.height = 1 + Math::Max(child1.height, child2.height);
+
+            Rotate(index);
+            index = mNodes[index].parent;
+        }
+    }
+
+    /*
+    * Swaps a child of A with a grandchild under its other child when that lowers the area of the
+    * rearranged child, A keeps its box since its leaf set does not change
+    *
+    *         A
+    *       /   \
+    *      B     C
+    *     / \   / \
+    *    D   E F   G
+    */
+    void Rotate(int32_t indexA)
+    {
+        auto& A = mNodes[indexA];
+        if (A.height < 2)
+        {
+            return;
+        }
+
+        int32_t indexB = A.child1;
+        int32_t indexC = A.child2;
+        const auto& B = mNodes[indexB];
+        const auto& C = mNodes[indexC];
+
+        enum class Rotation { None, BF, BG, CD, CE };
+        Rotation bestRotation = Rotation::None;
+        float bestCost = 0.0f;
+
+        if (C.height > 0)
+        {
+            // B swaps with F or G, C becomes the union of B and the remaining grandchild
+            float areaC = C.bounds.SurfaceArea();
+            float costBF = B.bounds.Merge(mNodes[C.child2].bounds).SurfaceArea() - areaC;
+            float costBG = B.bounds.Merge(mNodes[C.child1].bounds).SurfaceArea() - areaC;
+            if (costBF < bestCost) { bestCost = costBF; bestRotation = Rotation::BF; }
+            if (costBG < bestCost) { bestCost = costBG; bestRotation = Rotation::BG; }
+        }
+
+        if (B.height > 0)
+        {
+            float areaB = B.bounds.SurfaceArea();
+            float costCD = C.bounds.Merge(mNodes[B.child2].bounds).SurfaceArea() - areaB;
+            float costCE = C.bounds.Merge(mNodes[B.child1].bounds).SurfaceArea() - areaB;
+            if (costCD < bestCost) { bestCost = costCD; bestRotation = Rotation::CD; }
+            if (costCE < bestCost) { bestCost = costCE; bestRotation = Rotation::CE; }
+        }
+
+        switch (bestRotation)
+        {
+            case Rotation::None: return;
+            case Rotation::BF: Swap(indexA, indexB, indexC, true); break;
+            case Rotation::BG: Swap(indexA, indexB, indexC, false); break;
+            case Rotation::CD: Swap(indexA, indexC, indexB, true); break;
+            case Rotation::CE: Swap(indexA, indexC, indexB, false); break;
+        }
+    }
+
+    // Exchanges child of A with the first or second child of its other child
+    void Swap(int32_t indexA, int32_t child, int32_t other, bool first)
+    {
+        auto& A = mNodes[indexA];
+        auto& O = mNodes[other];
+        int32_t grandChild = first ? O.child1 : O.child2;
+        int32_t remaining = first ? O.child2 : O.child1;
+
+        (A.child1 == child ? A.child1 : A.child2) = grandChild;
+        mNodes[grandChild].parent = indexA;
+
+        (first ? O.child1 : O.child2) = child;
+        mNodes[child].parent = other;
+
+        O.bounds = mNodes[child].bounds.Merge(mNodes[remaining].bounds);
+        O.height = 1 + Math::Max(mNodes[child].height, mNodes[remaining].height);
+        A.height = 1 + Math::Max(mNodes[A.child1].height, mNodes[A.child2].height);
+    }
+
+    int32_t BuildRange(int32_t* leaves, int32_t count)
+    {
+        if (count == 1)
+        {
+            return leaves[0];
+        }
+
+        static constexpr int32_t BinCount = 16;
+
+        BoundingBox centroidBounds(Float3(Math::Infinity), Float3(Math::NegativeInfinity));
+        for (int32_t i = 0; i < count; i++)
+        {
+            const auto& bounds = mNodes[leaves[i]].bounds;
+            Float3 centroid = (bounds.min + bounds.max) * 0.5f;
+            centroidBounds = centroidBounds.Merge(BoundingBox(centroid, centroid));
+        }
+
+        Float3 extent = centroidBounds.max - centroidBounds.min;
+        int32_t axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        float axisMin = centroidBounds.min[axis];
+        float axisExtent = extent[axis];
+
+        int32_t split = count / 2;
+        if (axisExtent > Math::Epsilon)
+        {
+            struct Bin
+            {
+                BoundingBox bounds{ Float3(Math::Infinity), Float3(Math::NegativeInfinity) };
+                int32_t count = 0;
+            };
+            TArray<Bin, BinCount> bins{};
+
+            auto binIndex = [&](int32_t leaf)
+            {
+                const auto& bounds = mNodes[leaf].bounds;
+                float centroid = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+                int32_t bin = static_cast<int32_t>((centroid - axisMin) / axisExtent * BinCount);
+                return Math::Min(bin, BinCount - 1);
+            };
+
+            for (int32_t i = 0; i < count; i++)
+            {
+                auto& bin = bins[binIndex(leaves[i])];
+                bin.bounds = bin.bounds.Merge(mNodes[leaves[i]].bounds);
+                bin.count++;
+            }
+
+            // sweep from the right to get the cost of every right partition
+            TArray<float, BinCount> rightCost{};
+            BoundingBox rightBounds = bins[BinCount - 1].bounds;
+            int32_t rightCount = 0;
+            for (int32_t i = BinCount - 1; i > 0; i--)
+            {
+                rightBounds = rightBounds.Merge(bins[i].bounds);
+                rightCount += bins[i].count;
+                rightCost[i] = rightCount > 0 ? rightBounds.SurfaceArea() * rightCount : 0.0f;
+            }
+
+            float bestCost = Math::Infinity;
+            int32_t bestBin = -1;
+            BoundingBox leftBounds = bins[0].bounds;
+            int32_t leftCount = 0;
+            for (int32_t i = 0; i < BinCount - 1; i++)
+            {
+                leftBounds = leftBounds.Merge(bins[i].bounds);
+                leftCount += bins[i].count;
+                if (leftCount == 0 || leftCount == count)
+                {
+                    continue;
+                }
+
+                float cost = leftBounds.SurfaceArea() * leftCount + rightCost[i + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestBin = i;
+                }
+            }
+
+            if (bestBin >= 0)
+            {
+                auto middle = std::partition(leaves, leaves + count, [&](int32_t leaf) { return binIndex(leaf) <= bestBin; });
+                split = static_cast<int32_t>(middle - leaves);
+            }
+        }
+
+        if (split == 0 || split == count || axisExtent <= Math::Epsilon)
+        {
+            // coincident centroids, fall back to the median
+            split = count / 2;
+            std::nth_element(leaves, leaves + split, leaves + count, [&](int32_t a, int32_t b)
+            {
+                return mNodes[a].bounds.min[axis] + mNodes[a].bounds.max[axis] < mNodes[b].bounds.min[axis] + mNodes[b].bounds.max[axis];
+            });
+        }
+
+        int32_t child1 = BuildRange(leaves, split);
+        int32_t child2 = BuildRange(leaves + split, count - split);
+
+        int32_t index = AllocateNode();
+        auto& node = mNodes[index];
+        node.child1 = child1;
+        node.child2 = child2;
+        node.bounds = mNodes[child1].bounds.Merge(mNodes[child2].bounds);
+        node.height = 1 + Math::Max(mNodes[child1].height, mNodes[child2].height);
+        mNodes[child1].parent = index;
+        mNodes[child2].parent = index;
+        return index;
+    }
+
+    static bool RayIntersects(const BoundingBox& bounds, const Float3& origin, const Float3& invDirection, float maxDistance, float& distance)
+    {
+        Float3 t0 = (bounds.min - origin) * invDirection;
+        Float3 t1 = (bounds.max - origin) * invDirection;
+        Float3 tMin = Math::Min(t0, t1);
+        Float3 tMax = Math::Max(t0, t1);
+
+        float entry = Math::Max(Math::Max(tMin.x, tMin.y), Math::Max(tMin.z, 0.0f));
+        float exit = Math::Min(Math::Min(tMax.x, tMax.y), Math::Min(tMax.z, maxDistance));
+        distance = entry;
+        return entry <= exit;
+    }
+
+    TArray<Node> mNodes;
+
+    int32_t mRoot = NullNode;
+
+    int32_t mFreeList = NullNode;
+
+    uint32_t mProxyCount = 0;
+
+};
+
+} // namespace Gleam
@@ -3,6 +3,7 @@
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <cstring>
 
 namespace Gleam {
 
@@ -24,6 +25,69 @@ constexpr void hash_combine(size_t& seed, const T& value)
     seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+// XXH64, stable across platforms and builds so that it can be stored in files
+inline uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0)
+{
+    constexpr uint64_t Prime1 = 11400714785074694791ull;
+    constexpr uint64_t Prime2 = 14029467366897019727ull;
+    constexpr uint64_t Prime3 = 1609587929392839161ull;
+    constexpr uint64_t Prime4 = 9650029242287828579ull;
+    constexpr uint64_t Prime5 = 2870177450012600261ull;
+
+    auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+    auto round = [&](uint64_t acc, uint64_t input) { return rotl(acc + input * Prime2, 31) * Prime1; };
+    auto merge = [&](uint64_t acc, uint64_t value) { return (acc ^ round(0, value)) * Prime1 + Prime4; };
+    auto read64 = [](const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; };
+    auto read32 = [](const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; };
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+
+    uint64_t h;
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + Prime1 + Prime2;
+        uint64_t v2 = seed + Prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Prime1;
+        for (; p + 32 <= end; p += 32)
+        {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge(merge(merge(merge(h, v1), v2), v3), v4);
+    }
+    else
+    {
+        h = seed + Prime5;
+    }
+
+    h += size;
+    for (; p + 8 <= end; p += 8)
+    {
+        h = rotl(h ^ round(0, read64(p)), 27) * Prime1 + Prime4;
+    }
+    if (p + 4 <= end)
+    {
+        h = rotl(h ^ (read32(p) * Prime1), 23) * Prime2 + Prime3;
+        p += 4;
+    }
+    for (; p < end; p++)
+    {
+        h = rotl(h ^ (*p * Prime5), 11) * Prime1;
+    }
+
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    h *= Prime3;
+    h ^= h >> 32;
+    return h;
+}
+
 struct EnumClassHash
 {
     template <typename T>
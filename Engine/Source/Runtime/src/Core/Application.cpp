@@ -14,6 +14,7 @@
 #include "Renderer/Renderers/WorldRenderer.h"
 #include "Renderer/Renderers/PostProcessStack.h"
 #include "Renderer/Material/MaterialSystem.h"
+#include "Renderer/TextureStreamer.h"
 
 using namespace Gleam;
 
@@ -30,6 +31,7 @@ Application::Application(const Project& project)
     auto assetManager = AddSubsystem<AssetManager>();
 	auto scriptingSystem = AddSubsystem<ScriptingSystem>();
 	auto materialSystem = AddSubsystem<MaterialSystem>();
+	auto textureStreamer = AddSubsystem<TextureStreamer>();
 	auto worldManager = AddSubsystem<WorldManager>();
 	worldManager->Configure(project.worldConfig);
     
@@ -52,16 +54,36 @@ void Application::Run()
     auto inputSystem = Globals::Engine->GetSubsystem<InputSystem>();
     auto renderSystem = Globals::Engine->GetSubsystem<RenderSystem>();
 	auto worldManager = GetSubsystem<WorldManager>();
+	auto assetManager = GetSubsystem<AssetManager>();
+	auto textureStreamer = GetSubsystem<TextureStreamer>();
+	Profiler::SetThreadName("Main");
 
 	while (mRunning)
 	{
-        eventSystem->Update();
-        inputSystem->Update();
+		{
+			GLEAM_PROFILE_SCOPE("Frame");
+			{
+				GLEAM_PROFILE_SCOPE("EventSystem::Update");
+				eventSystem->Update();
+				inputSystem->Update();
+			}
+			{
+				GLEAM_PROFILE_SCOPE("AssetManager::Update");
+				assetManager->Update();
+			}
 
-		auto world = worldManager->GetActiveWorld();
-        world->Update();
-
-        renderSystem->Render(world);
+			auto world = worldManager->GetActiveWorld();
+			world->Update();
+			{
+				GLEAM_PROFILE_SCOPE("TextureStreamer::Update");
+				textureStreamer->Update();
+			}
+			{
+				GLEAM_PROFILE_SCOPE("RenderSystem::Render");
+				renderSystem->Render(world);
+			}
+		}
+		Profiler::EndFrame();
 	}
 }
 
@@ -4,6 +4,7 @@
 #include "EventSystem.h"
 #include "WindowSystem.h"
 #include "IO/FileWatcher.h"
+#include "IO/MappedFile.h"
 #include "Input/InputSystem.h"
 #include "Reflection/Database.h"
 #include "Renderer/RenderSystem.h"
@@ -35,8 +36,8 @@ void Engine::Initialize()
 	auto configFile = Globals::StartupDirectory/"Engine.config";
 	if (Filesystem::Exists(configFile))
 	{
-		auto file = Filesystem::Open(configFile, FileType::Text);
-        auto serializer = JSONSerializer(file.GetStream());
+		auto file = Filesystem::Map(configFile);
+        auto serializer = JSONSerializer(file);
 		mConfig = serializer.Deserialize<EngineConfig>();
 	}
 	
@@ -57,6 +58,7 @@ void Engine::Shutdown()
 		system->Shutdown();
 	}
 	mSubsystems.clear();
+	Logger::Flush();
 }
 
 void Engine::SaveConfigToDisk() const
@@ -0,0 +1,226 @@
+#include "gpch.h"
+#include "Profiler.h"
+
+using namespace Gleam;
+
+namespace {
+
+// Events of one thread, written only by that thread and read once the capture has stopped
+struct ThreadBuffer
+{
+	static constexpr uint32_t ChunkSize = 4096;
+	static constexpr uint32_t MaxChunks = 256; // further events of a capture are dropped
+
+	// chunks are kept for later captures, the owner publishes them through count
+	TArray<Scope<ProfileEvent[]>, MaxChunks> chunks;
+	std::atomic<uint32_t> count = 0;
+	std::atomic<uint32_t> generation = 0;
+	uint32_t threadId = 0;
+	TString name;
+	HashSet<TString> names;
+};
+
+struct CaptureState
+{
+	std::mutex mutex;
+	TArray<Scope<ThreadBuffer>> buffers;
+
+	std::atomic<uint32_t> generation = 0;
+	uint64_t start = 0;
+	uint32_t framesLeft = 0;
+	uint32_t requestedFrames = 0;
+	Filesystem::Path path;
+};
+
+CaptureState& GetState()
+{
+	static CaptureState state;
+	return state;
+}
+
+// Buffers outlive their threads, a capture still shows the work of a thread that has exited
+ThreadBuffer& GetThreadBuffer()
+{
+	thread_local ThreadBuffer* buffer = []()
+	{
+		auto& state = GetState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		auto& buffer = state.buffers.emplace_back(CreateScope<ThreadBuffer>());
+		buffer->threadId = static_cast<uint32_t>(state.buffers.size());
+		buffer->name = "Thread " + std::to_string(buffer->threadId);
+		return buffer.get();
+	}();
+	return *buffer;
+}
+
+void AppendEscaped(TString& json, TStringView str)
+{
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			json += '\\';
+			json += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			fmt::format_to(std::back_inserter(json), "\\u{:04x}", static_cast<uint32_t>(c));
+		}
+		else
+		{
+			json += c;
+		}
+	}
+}
+
+// Called with the state locked, threads that recorded nothing in this capture are left out
+TString FormatTrace(const CaptureState& state, uint32_t& eventCount)
+{
+	uint32_t generation = state.generation.load(std::memory_order_relaxed);
+	TString json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	auto separate = [&]()
+	{
+		json += first ? "\n" : ",\n";
+		first = false;
+	};
+
+	for (const auto& buffer : state.buffers)
+	{
+		if (buffer->generation.load(std::memory_order_acquire) != generation)
+		{
+			continue;
+		}
+
+		separate();
+		fmt::format_to(std::back_inserter(json), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{0},\"args\":{{\"name\":\"", buffer->threadId);
+		AppendEscaped(json, buffer->name);
+		json += "\"}}";
+
+		// scopes that were already open when the capture started are cut off
+		uint32_t count = buffer->count.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const auto& event = buffer->chunks[i / ThreadBuffer::ChunkSize][i % ThreadBuffer::ChunkSize];
+			if (event.start < state.start)
+			{
+				continue;
+			}
+
+			separate();
+			json += "{\"name\":\"";
+			AppendEscaped(json, event.name);
+			fmt::format_to(std::back_inserter(json), "\",\"ph\":\"X\",\"pid\":0,\"tid\":{0},\"ts\":{1:.3f},\"dur\":{2:.3f}}}",
+				buffer->threadId, (event.start - state.start) / 1000.0, (event.end - event.start) / 1000.0);
+			eventCount++;
+		}
+	}
+	json += "\n]}\n";
+	return json;
+}
+
+void WriteTrace(CaptureState& state, uint32_t frameCount)
+{
+	Filesystem::Path path;
+	TString json;
+	uint32_t eventCount = 0;
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+		path = state.path;
+		json = FormatTrace(state, eventCount);
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(path.parent_path(), error);
+
+	auto accessor = Filesystem::WriteAccessor(path);
+	auto file = Filesystem::Create(path, FileType::Text);
+	if (file.GetStream().write(json.data(), json.size()).fail())
+	{
+		GLEAM_CORE_ERROR("Profile could not be written: {0}", path.string());
+		return;
+	}
+	GLEAM_CORE_INFO("Profile of {0} frames written with {1} events: {2}", frameCount, eventCount, path.string());
+}
+
+} // namespace
+
+void Profiler::Capture(uint32_t frameCount, const Filesystem::Path& path)
+{
+	auto& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.requestedFrames = frameCount;
+	state.path = path;
+}
+
+void Profiler::EndFrame()
+{
+	auto& state = GetState();
+	uint32_t frameCount = 0;
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+		if (mCapturing)
+		{
+			if (--state.framesLeft > 0)
+			{
+				return;
+			}
+
+			mCapturing = false;
+			frameCount = state.requestedFrames;
+			state.requestedFrames = 0;
+		}
+		else if (state.requestedFrames > 0)
+		{
+			// buffers left over from the last capture are reset by their threads as they record again
+			state.generation++;
+			state.start = Now();
+			state.framesLeft = state.requestedFrames;
+			mCapturing = true;
+			return;
+		}
+	}
+
+	if (frameCount > 0)
+	{
+		WriteTrace(state, frameCount);
+	}
+}
+
+void Profiler::Record(TStringView name, uint64_t start, uint64_t end)
+{
+	auto& buffer = GetThreadBuffer();
+	uint32_t generation = GetState().generation.load(std::memory_order_relaxed);
+	if (buffer.generation.load(std::memory_order_relaxed) != generation)
+	{
+		buffer.count.store(0, std::memory_order_relaxed);
+		buffer.generation.store(generation, std::memory_order_release);
+	}
+
+	uint32_t index = buffer.count.load(std::memory_order_relaxed);
+	if (index >= ThreadBuffer::ChunkSize * ThreadBuffer::MaxChunks)
+	{
+		return;
+	}
+
+	auto& chunk = buffer.chunks[index / ThreadBuffer::ChunkSize];
+	if (chunk == nullptr)
+	{
+		chunk = CreateScope<ProfileEvent[]>(ThreadBuffer::ChunkSize);
+	}
+	chunk[index % ThreadBuffer::ChunkSize] = ProfileEvent{ .name = name, .start = start, .end = end };
+	buffer.count.store(index + 1, std::memory_order_release);
+}
+
+TStringView Profiler::Intern(const TString& name)
+{
+	auto& names = GetThreadBuffer().names;
+	return *names.insert(name).first;
+}
+
+void Profiler::SetThreadName(const TString& name)
+{
+	auto& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(GetState().mutex);
+	buffer.name = name;
+}
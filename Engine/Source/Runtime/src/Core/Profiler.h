@@ -0,0 +1,108 @@
+#pragma once
+
+// Scopes compile to nothing when disabled, enabled builds only pay for an atomic load outside captures
+#ifndef GLEAM_PROFILE_ENABLED
+	#define GLEAM_PROFILE_ENABLED 1
+#endif
+
+namespace Gleam {
+
+struct ProfileEvent
+{
+	TStringView name;
+	uint64_t start; // nanoseconds
+	uint64_t end;
+};
+
+/*
+* Scoped CPU timings of every thread, recorded only while a capture is running
+* Threads append to buffers of their own, so recording takes no locks
+* A capture spans whole frames and is written as Chrome trace event JSON, for chrome://tracing or Perfetto
+*/
+class Profiler final
+{
+public:
+
+	// Starts at the next frame boundary, the trace is written to path once frameCount frames are recorded
+	static void Capture(uint32_t frameCount, const Filesystem::Path& path);
+
+	// Called by the main loop once a frame, between frames
+	static void EndFrame();
+
+	static bool IsCapturing()
+	{
+		return mCapturing.load(std::memory_order_relaxed);
+	}
+
+	static uint64_t Now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	static void Record(TStringView name, uint64_t start, uint64_t end);
+
+	// Copy of the name that lives as long as the profiler, kept per thread
+	static TStringView Intern(const TString& name);
+
+	// Shown as the name of the calling thread's track
+	static void SetThreadName(const TString& name);
+
+private:
+
+	static inline std::atomic<bool> mCapturing = false;
+
+};
+
+class ProfileScope final
+{
+public:
+
+	GLEAM_NONCOPYABLE(ProfileScope);
+
+	// The name is referenced until the capture is written, string literals and type names outlive it
+	ProfileScope(const char* name)
+		: ProfileScope(TStringView(name))
+	{
+
+	}
+
+	ProfileScope(TStringView name)
+		: mName(name), mStart(Profiler::IsCapturing() ? Profiler::Now() : 0)
+	{
+
+	}
+
+	// Names built at runtime are copied, once per thread
+	ProfileScope(const TString& name)
+		: mStart(Profiler::IsCapturing() ? Profiler::Now() : 0)
+	{
+		if (mStart != 0)
+		{
+			mName = Profiler::Intern(name);
+		}
+	}
+
+	~ProfileScope()
+	{
+		if (mStart != 0)
+		{
+			Profiler::Record(mName, mStart, Profiler::Now());
+		}
+	}
+
+private:
+
+	TStringView mName;
+
+	uint64_t mStart;
+
+};
+
+} // namespace Gleam
+
+#if GLEAM_PROFILE_ENABLED
+	#define GLEAM_PROFILE_SCOPE_NAME(line) GLEAM_CONCAT(gleamProfileScope, line)
+	#define GLEAM_PROFILE_SCOPE(name) ::Gleam::ProfileScope GLEAM_PROFILE_SCOPE_NAME(__LINE__)(name)
+#else
+	#define GLEAM_PROFILE_SCOPE(name)
+#endif
@@ -0,0 +1,106 @@
+#include "gpch.h"
+#include "ThreadPool.h"
+
+using namespace Gleam;
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	threadCount = std::max(threadCount, 1u);
+	mThreads.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		mThreads.emplace_back([this]() { WorkerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mCondition.notify_all();
+
+	for (auto& thread : mThreads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::Submit(ThreadTask&& task, int32_t priority)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTasks.push(Task{ .fn = std::move(task), .priority = priority, .sequence = mSequence++ });
+	}
+	mCondition.notify_one();
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	struct Batch
+	{
+		std::atomic<uint32_t> next = 0;
+		std::atomic<uint32_t> done = 0;
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+	auto batch = CreateRef<Batch>();
+
+	// workers and the caller pull indices from a shared counter, so uneven items balance themselves
+	auto work = [batch, count, &fn]()
+	{
+		uint32_t completed = 0;
+		for (uint32_t i = batch->next++; i < count; i = batch->next++)
+		{
+			fn(i);
+			completed++;
+		}
+
+		if (completed > 0 && batch->done.fetch_add(completed) + completed == count)
+		{
+			std::lock_guard<std::mutex> lock(batch->mutex);
+			batch->condition.notify_all();
+		}
+	};
+
+	uint32_t helperCount = std::min(GetThreadCount(), count - 1);
+	for (uint32_t i = 0; i < helperCount; i++)
+	{
+		Submit(ThreadTask(work), std::numeric_limits<int32_t>::max());
+	}
+	work();
+
+	std::unique_lock<std::mutex> lock(batch->mutex);
+	batch->condition.wait(lock, [&]() { return batch->done == count; });
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+	return static_cast<uint32_t>(mThreads.size());
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		ThreadTask task;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this]() { return mStopping || not mTasks.empty(); });
+			if (mStopping)
+			{
+				return;
+			}
+
+			task = std::move(const_cast<Task&>(mTasks.top()).fn);
+			mTasks.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <thread>
+#include <condition_variable>
+
+namespace Gleam {
+
+using ThreadTask = std::function<void()>;
+
+/*
+* Fixed set of worker threads draining a priority queue, tasks of equal priority run in submission order
+*/
+class ThreadPool final
+{
+public:
+
+	GLEAM_NONCOPYABLE(ThreadPool);
+
+	ThreadPool(uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+	~ThreadPool();
+
+	void Submit(ThreadTask&& task, int32_t priority = 0);
+
+	// Runs fn(i) for every i in [0, count) on the workers and the calling thread, returns when all are done
+	void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& fn);
+
+	uint32_t GetThreadCount() const;
+
+private:
+
+	struct Task
+	{
+		ThreadTask fn;
+		int32_t priority;
+		uint64_t sequence;
+
+		bool operator<(const Task& other) const
+		{
+			if (priority != other.priority)
+				return priority < other.priority;
+			return sequence > other.sequence;
+		}
+	};
+
+	void WorkerLoop();
+
+	TArray<std::thread> mThreads;
+
+	std::priority_queue<Task> mTasks;
+
+	std::mutex mMutex;
+
+	std::condition_variable mCondition;
+
+	uint64_t mSequence = 0;
+
+	bool mStopping = false;
+
+};
+
+} // namespace Gleam
@@ -16,8 +16,13 @@
 
 #include "IO/Log.h"
 #include "IO/File.h"
+#include "IO/MappedFile.h"
+#include "IO/AsyncIO.h"
+#include "IO/PakArchive.h"
 #include "IO/FileDialog.h"
 
+#include "Core/Profiler.h"
+
 #include "Reflection/Attribute.h"
 #include "Reflection/Meta.h"
 #include "Reflection/Reflection.h"
@@ -33,7 +38,9 @@
 #include "Math/Float4x4.h"
 #include "Math/Size.h"
 #include "Math/Rect.h"
+#include "Math/BoundingSphere.h"
 #include "Math/BoundingBox.h"
+#include "Math/Frustum.h"
 
 #include "Core/Events/ApplicationEvent.h"
 #include "Core/Events/RendererEvent.h"
@@ -55,6 +62,8 @@
 
 #include "Assets/AssetReference.h"
 #include "Assets/Asset.h"
+#include "Assets/AssetDependencyGraph.h"
+#include "Assets/AssetIndex.h"
 
 #include "Renderer/Shaders/ShaderInterop.h"
 #include "Renderer/Shaders/ShaderTypes.h"
@@ -69,6 +78,7 @@
 #include "Renderer/CommandBuffer.h"
 #include "Renderer/GraphicsDevice.h"
 #include "Renderer/Material/MaterialSystem.h"
+#include "Renderer/TextureStreamer.h"
 
 #include "Input/InputSystem.h"
 
@@ -76,6 +86,7 @@
 #include "Assets/AssetManager.h"
 #include "World/ScriptingSystem.h"
 #include "World/Systems/RenderSceneProxy.h"
+#include "World/SpatialIndex.h"
 
 #include "Renderer/Renderers/UIRenderer.h"
 #include "Renderer/Renderers/DebugRenderer.h"
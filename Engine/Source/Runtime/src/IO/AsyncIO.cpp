@@ -0,0 +1,606 @@
+#include "gpch.h"
+#include "AsyncIO.h"
+#include "Core/ThreadPool.h"
+
+#ifdef PLATFORM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+using namespace Gleam;
+
+static size_t AlignUp(size_t size, size_t alignment)
+{
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+IOBuffer::IOBuffer(size_t size)
+	: mCapacity(AlignUp(Math::Max(size, size_t(1)), AsyncIO::Alignment))
+{
+	mData = static_cast<uint8_t*>(::operator new(mCapacity, std::align_val_t(AsyncIO::Alignment)));
+}
+
+IOBuffer::IOBuffer(IOBuffer&& other) noexcept
+	: mData(other.mData), mCapacity(other.mCapacity)
+{
+	other.mData = nullptr;
+	other.mCapacity = 0;
+}
+
+IOBuffer& IOBuffer::operator=(IOBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (mData)
+		{
+			::operator delete(mData, std::align_val_t(AsyncIO::Alignment));
+		}
+		mData = other.mData;
+		mCapacity = other.mCapacity;
+		other.mData = nullptr;
+		other.mCapacity = 0;
+	}
+	return *this;
+}
+
+IOBuffer::~IOBuffer()
+{
+	if (mData)
+	{
+		::operator delete(mData, std::align_val_t(AsyncIO::Alignment));
+		mData = nullptr;
+	}
+}
+
+uint8_t* IOBuffer::GetData() const
+{
+	return mData;
+}
+
+size_t IOBuffer::GetCapacity() const
+{
+	return mCapacity;
+}
+
+struct AsyncReadBatch
+{
+	TArray<AsyncReadRequest> requests;
+	AsyncReadCallback callback;
+};
+
+struct AsyncReadTask
+{
+	RefCounted<AsyncReadBatch> batch;
+	uint32_t index = 0;
+};
+
+#ifdef PLATFORM_LINUX
+// Minimal io_uring over the raw syscalls, a single thread submits and reaps so no locking is needed
+struct IOUring
+{
+	int handle = -1;
+
+	void* sqRing = nullptr;
+	size_t sqRingSize = 0;
+	void* cqRing = nullptr;
+	size_t cqRingSize = 0;
+	io_uring_sqe* sqes = nullptr;
+	size_t sqesSize = 0;
+
+	uint32_t* sqHead = nullptr;
+	uint32_t* sqTail = nullptr;
+	uint32_t* sqMask = nullptr;
+	uint32_t* sqArray = nullptr;
+	uint32_t* cqHead = nullptr;
+	uint32_t* cqTail = nullptr;
+	uint32_t* cqMask = nullptr;
+	io_uring_cqe* cqes = nullptr;
+
+	uint32_t unsubmitted = 0;
+
+	bool Initialize(uint32_t entries)
+	{
+		io_uring_params params{};
+		handle = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+		if (handle < 0)
+		{
+			return false;
+		}
+
+		// kernels before 5.6 set up a ring but fail every IORING_OP_READ, those read on the thread pool as well
+		if (SupportsRead() == false)
+		{
+			Destroy();
+			return false;
+		}
+
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+		if (singleMap)
+		{
+			sqRingSize = cqRingSize = Math::Max(sqRingSize, cqRingSize);
+		}
+
+		sqRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_SQ_RING);
+		cqRing = singleMap ? sqRing : ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_CQ_RING);
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqesMemory = ::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_SQES);
+		if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqesMemory == MAP_FAILED)
+		{
+			sqRing = sqRing == MAP_FAILED ? nullptr : sqRing;
+			cqRing = cqRing == MAP_FAILED ? nullptr : cqRing;
+			sqes = nullptr;
+			if (sqesMemory != MAP_FAILED)
+			{
+				::munmap(sqesMemory, sqesSize);
+			}
+			Destroy();
+			return false;
+		}
+		sqes = static_cast<io_uring_sqe*>(sqesMemory);
+
+		auto* sq = static_cast<uint8_t*>(sqRing);
+		sqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+		sqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+		sqMask = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+		sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+		auto* cq = static_cast<uint8_t*>(cqRing);
+		cqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+		cqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+		cqMask = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		return true;
+	}
+
+	bool SupportsRead() const
+	{
+		TArray<uint8_t> memory(sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op));
+		auto* probe = reinterpret_cast<io_uring_probe*>(memory.data());
+		if (::syscall(__NR_io_uring_register, handle, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0)
+		{
+			return false;
+		}
+		return probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+	}
+
+	void Destroy()
+	{
+		if (sqes)
+		{
+			::munmap(sqes, sqesSize);
+		}
+		if (cqRing && cqRing != sqRing)
+		{
+			::munmap(cqRing, cqRingSize);
+		}
+		if (sqRing)
+		{
+			::munmap(sqRing, sqRingSize);
+		}
+		if (handle >= 0)
+		{
+			::close(handle);
+		}
+		*this = IOUring();
+	}
+
+	void PushRead(int file, uint8_t* buffer, uint32_t size, uint64_t offset, uint64_t userData)
+	{
+		uint32_t tail = *sqTail + unsubmitted;
+		uint32_t slot = tail & *sqMask;
+
+		io_uring_sqe& sqe = sqes[slot];
+		memset(&sqe, 0, sizeof(io_uring_sqe));
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = file;
+		sqe.addr = reinterpret_cast<uint64_t>(buffer);
+		sqe.len = size;
+		sqe.off = offset;
+		sqe.user_data = userData;
+		sqArray[slot] = slot;
+		unsubmitted++;
+	}
+
+	// Publishes the pushed reads and, when wait is set, blocks until at least one completes
+	bool Submit(bool wait)
+	{
+		__atomic_store_n(sqTail, *sqTail + unsubmitted, __ATOMIC_RELEASE);
+		uint32_t count = unsubmitted;
+		unsubmitted = 0;
+
+		while (true)
+		{
+			int result = static_cast<int>(::syscall(__NR_io_uring_enter, handle, count, wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+			if (result >= 0)
+			{
+				return true;
+			}
+
+			if (errno == EINTR)
+			{
+				// the kernel consumed the entries before the wait got interrupted
+				count = 0;
+				continue;
+			}
+			return false;
+		}
+	}
+
+	template<typename Fn>
+	void Reap(Fn&& fn)
+	{
+		uint32_t head = *cqHead;
+		uint32_t tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; ++head)
+		{
+			const io_uring_cqe& cqe = cqes[head & *cqMask];
+			fn(cqe.user_data, cqe.res);
+		}
+		__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+	}
+};
+#endif
+
+struct AsyncIO::Impl
+{
+	// a single read is capped so that the length fits a submission entry, larger ranges continue where the last one stopped
+	static constexpr size_t MaxReadSize = 64 * 1024 * 1024;
+
+	// files are opened on the IO thread, small rounds get the first reads going before the rest of a large batch is opened
+	static constexpr size_t MaxSubmitCount = 32;
+
+	struct ReadOperation
+	{
+		AsyncReadTask task;
+		IOBuffer buffer;
+		uint64_t fileOffset = 0; // aligned down for unbuffered reads
+		size_t lead = 0; // bytes between fileOffset and the requested offset
+		size_t size = 0;
+		size_t readSize = 0; // whole blocks for unbuffered reads
+		size_t transferred = 0;
+		int file = -1;
+	};
+
+	uint32_t queueDepth;
+	bool directIO;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::condition_variable idleCondition;
+	Deque<AsyncReadTask> pendingTasks;
+	uint64_t outstanding = 0;
+	bool stopping = false;
+
+	Scope<ThreadPool> threadPool;
+
+#ifdef PLATFORM_LINUX
+	IOUring ring;
+	std::thread ioThread;
+	TArray<ReadOperation> operations;
+	TArray<uint32_t> freeOperations;
+	uint32_t inflight = 0;
+#endif
+
+	Impl(uint32_t queueDepth, bool directIO)
+		: queueDepth(Math::Max(queueDepth, 1u)), directIO(directIO)
+	{
+#ifdef PLATFORM_LINUX
+		if (ring.Initialize(this->queueDepth))
+		{
+			operations.resize(this->queueDepth);
+			freeOperations.reserve(this->queueDepth);
+			for (uint32_t i = this->queueDepth; i > 0; --i)
+			{
+				freeOperations.push_back(i - 1);
+			}
+			ioThread = std::thread([this]() { RingLoop(); });
+			return;
+		}
+		GLEAM_CORE_WARN("AsyncIO: io_uring is not available, reads fall back to the thread pool");
+#endif
+		threadPool = CreateScope<ThreadPool>();
+	}
+
+	~Impl()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		condition.notify_all();
+
+#ifdef PLATFORM_LINUX
+		if (ioThread.joinable())
+		{
+			ioThread.join();
+		}
+		ring.Destroy();
+#endif
+		// joins the workers after the queued reads
+		threadPool.reset();
+	}
+
+	void Push(const RefCounted<AsyncReadBatch>& batch)
+	{
+		uint32_t count = static_cast<uint32_t>(batch->requests.size());
+		if (count == 0)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			outstanding += count;
+			if (threadPool == nullptr)
+			{
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					pendingTasks.push_back({ .batch = batch, .index = i });
+				}
+			}
+		}
+
+		if (threadPool)
+		{
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				threadPool->Submit([this, task = AsyncReadTask{ .batch = batch, .index = i }]() mutable
+				{
+					Complete(task, ReadBlocking(task.batch->requests[task.index]));
+				});
+			}
+		}
+		else
+		{
+			condition.notify_one();
+		}
+	}
+
+	void Complete(AsyncReadTask& task, AsyncReadResult&& result)
+	{
+		result.index = task.index;
+		task.batch->callback(std::move(result));
+		task.batch.reset();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--outstanding == 0)
+		{
+			idleCondition.notify_all();
+		}
+	}
+
+	void Wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		idleCondition.wait(lock, [this]() { return outstanding == 0; });
+	}
+
+	static AsyncReadResult ReadBlocking(const AsyncReadRequest& request)
+	{
+		AsyncReadResult result;
+		std::ifstream stream(request.path, std::ios::in | std::ios::binary);
+		if (!stream)
+		{
+			GLEAM_CORE_ERROR("AsyncIO could not open: {0}", request.path.string());
+			return result;
+		}
+
+		uint64_t fileSize = Filesystem::FileSize(request.path);
+		uint64_t available = request.offset < fileSize ? fileSize - request.offset : 0;
+		size_t size = static_cast<size_t>(request.size ? Math::Min(request.size, available) : available);
+
+		result.buffer = IOBuffer(size);
+		stream.seekg(static_cast<std::streamoff>(request.offset));
+		stream.read(reinterpret_cast<char*>(result.buffer.GetData()), static_cast<std::streamsize>(size));
+		result.data = result.buffer.GetData();
+		result.size = static_cast<size_t>(stream.gcount());
+		result.success = result.size == size;
+		return result;
+	}
+
+#ifdef PLATFORM_LINUX
+	bool Open(const AsyncReadRequest& request, ReadOperation& operation) const
+	{
+		int flags = O_RDONLY | O_CLOEXEC;
+		operation.file = directIO ? ::open(request.path.c_str(), flags | O_DIRECT) : -1;
+		bool direct = operation.file >= 0;
+		if (direct == false)
+		{
+			// tmpfs and a few others refuse O_DIRECT
+			operation.file = ::open(request.path.c_str(), flags);
+		}
+
+		struct stat status;
+		if (operation.file < 0 || ::fstat(operation.file, &status) != 0)
+		{
+			GLEAM_CORE_ERROR("AsyncIO could not open: {0}", request.path.string());
+			return false;
+		}
+
+		uint64_t fileSize = static_cast<uint64_t>(status.st_size);
+		uint64_t available = request.offset < fileSize ? fileSize - request.offset : 0;
+		operation.size = static_cast<size_t>(request.size ? Math::Min(request.size, available) : available);
+		operation.fileOffset = direct ? request.offset & ~uint64_t(Alignment - 1) : request.offset;
+		operation.lead = static_cast<size_t>(request.offset - operation.fileOffset);
+		operation.transferred = 0;
+		operation.buffer = IOBuffer(operation.lead + operation.size);
+		operation.readSize = direct ? operation.buffer.GetCapacity() : operation.size;
+		return true;
+	}
+
+	void PushRead(uint32_t slot)
+	{
+		auto& operation = operations[slot];
+		size_t remaining = operation.readSize - operation.transferred;
+		auto length = static_cast<uint32_t>(Math::Min(remaining, MaxReadSize));
+		ring.PushRead(operation.file, operation.buffer.GetData() + operation.transferred, length, operation.fileOffset + operation.transferred, slot);
+	}
+
+	void Finish(uint32_t slot, bool success)
+	{
+		auto& operation = operations[slot];
+		if (operation.file >= 0)
+		{
+			::close(operation.file);
+			operation.file = -1;
+		}
+
+		AsyncReadResult result;
+		result.success = success;
+		result.size = success ? operation.size : 0;
+		result.data = operation.buffer.GetData() ? operation.buffer.GetData() + operation.lead : nullptr;
+		result.buffer = std::move(operation.buffer);
+
+		auto task = std::move(operation.task);
+		operation = ReadOperation();
+		freeOperations.push_back(slot);
+		inflight--;
+
+		Complete(task, std::move(result));
+	}
+
+	void RingLoop()
+	{
+		TArray<AsyncReadTask> tasks;
+		while (true)
+		{
+			tasks.clear();
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [this]()
+				{
+					return stopping || pendingTasks.empty() == false || inflight > 0;
+				});
+
+				if (stopping && pendingTasks.empty() && inflight == 0)
+				{
+					break;
+				}
+
+				while (pendingTasks.empty() == false && inflight + tasks.size() < queueDepth && tasks.size() < MaxSubmitCount)
+				{
+					tasks.push_back(std::move(pendingTasks.front()));
+					pendingTasks.pop_front();
+				}
+			}
+
+			// opening is synchronous, the reads behind it are what the ring overlaps
+			for (auto& task : tasks)
+			{
+				uint32_t slot = freeOperations.back();
+				freeOperations.pop_back();
+				inflight++;
+
+				auto& operation = operations[slot];
+				operation.task = std::move(task);
+				if (Open(operation.task.batch->requests[operation.task.index], operation) == false)
+				{
+					Finish(slot, false);
+				}
+				else if (operation.size == 0)
+				{
+					Finish(slot, true);
+				}
+				else
+				{
+					PushRead(slot);
+				}
+			}
+
+			if (inflight == 0)
+			{
+				continue;
+			}
+
+			if (ring.Submit(true) == false)
+			{
+				GLEAM_CORE_ERROR("AsyncIO: io_uring submission failed, {0} reads are dropped", inflight);
+				for (uint32_t slot = 0; slot < operations.size(); ++slot)
+				{
+					if (operations[slot].task.batch)
+					{
+						Finish(slot, false);
+					}
+				}
+				continue;
+			}
+
+			ring.Reap([this](uint64_t userData, int32_t result)
+			{
+				auto slot = static_cast<uint32_t>(userData);
+				auto& operation = operations[slot];
+				if (result == -EAGAIN || result == -EINTR)
+				{
+					PushRead(slot);
+					return;
+				}
+
+				if (result < 0)
+				{
+					GLEAM_CORE_ERROR("AsyncIO read failed: {0} ({1})", operation.task.batch->requests[operation.task.index].path.string(), strerror(-result));
+					Finish(slot, false);
+					return;
+				}
+
+				// unbuffered reads run in whole blocks, the end of the file cuts the last one short
+				operation.transferred += static_cast<size_t>(result);
+				size_t end = operation.lead + operation.size;
+				if (operation.transferred >= end)
+				{
+					Finish(slot, true);
+				}
+				else if (result == 0)
+				{
+					// the file shrank since it was opened
+					Finish(slot, false);
+				}
+				else
+				{
+					PushRead(slot);
+				}
+			});
+		}
+	}
+#endif
+};
+
+AsyncIO::AsyncIO(uint32_t queueDepth, bool directIO)
+	: mHandle(new Impl(queueDepth, directIO))
+{
+
+}
+
+AsyncIO::~AsyncIO()
+{
+	Wait();
+	delete mHandle;
+}
+
+void AsyncIO::Read(TArray<AsyncReadRequest>&& requests, AsyncReadCallback&& callback)
+{
+	auto batch = CreateRef<AsyncReadBatch>();
+	batch->requests = std::move(requests);
+	batch->callback = std::move(callback);
+	mHandle->Push(batch);
+}
+
+void AsyncIO::Wait()
+{
+	mHandle->Wait();
+}
+
+bool AsyncIO::IsKernelBacked() const
+{
+	return mHandle->threadPool == nullptr;
+}
+
+uint32_t AsyncIO::GetQueueDepth() const
+{
+	return mHandle->queueDepth;
+}
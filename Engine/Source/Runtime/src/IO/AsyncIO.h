@@ -0,0 +1,98 @@
+#pragma once
+#include <thread>
+#include <condition_variable>
+
+namespace Gleam {
+
+/*
+* Heap block aligned and padded to AsyncIO::Alignment, so that it can be the target of unbuffered reads
+*/
+class IOBuffer final
+{
+public:
+
+	IOBuffer() = default;
+
+	IOBuffer(size_t size);
+
+	IOBuffer(IOBuffer&& other) noexcept;
+
+	IOBuffer& operator=(IOBuffer&& other) noexcept;
+
+	IOBuffer(const IOBuffer&) = delete;
+
+	IOBuffer& operator=(const IOBuffer&) = delete;
+
+	~IOBuffer();
+
+	uint8_t* GetData() const;
+
+	size_t GetCapacity() const;
+
+private:
+
+	uint8_t* mData = nullptr;
+
+	size_t mCapacity = 0;
+
+};
+
+struct AsyncReadRequest
+{
+	Filesystem::Path path;
+	uint64_t offset = 0;
+	uint64_t size = 0; // 0 reads from the offset to the end of the file
+};
+
+struct AsyncReadResult
+{
+	uint32_t index = 0; // position of the request in its batch
+	IOBuffer buffer;
+	const uint8_t* data = nullptr; // start of the requested range, may be past the start of the buffer for unbuffered reads
+	size_t size = 0;
+	bool success = false;
+};
+
+using AsyncReadCallback = std::function<void(AsyncReadResult&& result)>;
+
+/*
+* Reads batches of files or file ranges without blocking the caller
+* Linux submits them to an io_uring owned by a single IO thread, which keeps up to queueDepth reads in flight
+* Other platforms, or kernels without io_uring, read on a thread pool instead
+* Callbacks run on the IO threads, once per request, in completion order
+* Nothing in the engine reads through it yet, assets, sidecars and archives are memory mapped
+*/
+class AsyncIO final
+{
+public:
+
+	GLEAM_NONCOPYABLE(AsyncIO);
+
+	static constexpr size_t Alignment = 4096;
+
+	static constexpr uint32_t DefaultQueueDepth = 256;
+
+	// directIO bypasses the page cache where the filesystem allows it, buffered reads are used otherwise
+	AsyncIO(uint32_t queueDepth = DefaultQueueDepth, bool directIO = false);
+
+	// Waits for the reads in flight, their callbacks still run
+	~AsyncIO();
+
+	void Read(TArray<AsyncReadRequest>&& requests, AsyncReadCallback&& callback);
+
+	// Blocks until every read submitted so far has run its callback
+	void Wait();
+
+	// True when reads go through io_uring rather than the thread pool fallback
+	bool IsKernelBacked() const;
+
+	uint32_t GetQueueDepth() const;
+
+private:
+
+	struct Impl;
+	Impl* mHandle = nullptr;
+
+};
+
+} // namespace Gleam
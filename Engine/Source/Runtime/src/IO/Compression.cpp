@@ -0,0 +1,228 @@
+#include "gpch.h"
+#include "Compression.h"
+
+using namespace Gleam;
+
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+static constexpr size_t MinMatch = 4;
+static constexpr size_t LastLiterals = 5; // the block always ends with this many literals
+static constexpr size_t MatchFindLimit = 12; // and its last match starts at least this far from the end
+static constexpr size_t MaxOffset = 65535;
+static constexpr size_t MaxInputSize = 0x7E000000;
+
+static constexpr uint32_t HashLog = 12;
+static constexpr uint32_t SkipTrigger = 6;
+
+static uint32_t Read32(const uint8_t* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(uint32_t));
+	return value;
+}
+
+static uint32_t HashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HashLog);
+}
+
+static void WriteLength(uint8_t*& op, size_t length)
+{
+	for (; length >= 255; length -= 255)
+	{
+		*op++ = 255;
+	}
+	*op++ = static_cast<uint8_t>(length);
+}
+
+static bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+{
+	uint8_t byte;
+	do
+	{
+		if (ip >= end)
+		{
+			return false;
+		}
+		byte = *ip++;
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+// Token, literal run and, unless it is the last sequence, the match that follows it
+static bool WriteSequence(uint8_t*& op, const uint8_t* end, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength, bool last)
+{
+	size_t required = 1 + literalLength + literalLength / 255 + 1;
+	if (last == false)
+	{
+		required += 2 + matchLength / 255 + 1;
+	}
+	if (required > static_cast<size_t>(end - op))
+	{
+		return false;
+	}
+
+	uint8_t* token = op++;
+	*token = static_cast<uint8_t>(Math::Min(literalLength, size_t(15)) << 4);
+	if (literalLength >= 15)
+	{
+		WriteLength(op, literalLength - 15);
+	}
+	std::copy_n(literals, literalLength, op);
+	op += literalLength;
+
+	if (last)
+	{
+		return true;
+	}
+
+	*op++ = static_cast<uint8_t>(offset);
+	*op++ = static_cast<uint8_t>(offset >> 8);
+	*token |= static_cast<uint8_t>(Math::Min(matchLength, size_t(15)));
+	if (matchLength >= 15)
+	{
+		WriteLength(op, matchLength - 15);
+	}
+	return true;
+}
+
+size_t LZ4::CompressBound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t LZ4::Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t capacity)
+{
+	if (srcSize > MaxInputSize)
+	{
+		return 0;
+	}
+
+	const uint8_t* ip = src;
+	const uint8_t* anchor = src;
+	const uint8_t* end = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* opEnd = dst + capacity;
+
+	if (srcSize > MatchFindLimit)
+	{
+		// positions are offsets from src, a stale or empty slot is caught by comparing the bytes
+		uint32_t table[1 << HashLog] = {};
+		const uint8_t* matchLimit = end - LastLiterals;
+		const uint8_t* searchLimit = end - MatchFindLimit;
+
+		// the step grows while nothing matches, so incompressible data is skimmed instead of searched
+		uint32_t attempts = 1 << SkipTrigger;
+		while (ip <= searchLimit)
+		{
+			uint32_t sequence = Read32(ip);
+			uint32_t& slot = table[HashSequence(sequence)];
+			const uint8_t* match = src + slot;
+			slot = static_cast<uint32_t>(ip - src);
+
+			if (match >= ip || static_cast<size_t>(ip - match) > MaxOffset || Read32(match) != sequence)
+			{
+				ip += attempts++ >> SkipTrigger;
+				continue;
+			}
+			attempts = 1 << SkipTrigger;
+
+			while (ip > anchor && match > src && ip[-1] == match[-1])
+			{
+				ip--;
+				match--;
+			}
+
+			const uint8_t* matchEnd = ip + MinMatch;
+			for (const uint8_t* ref = match + MinMatch; matchEnd < matchLimit && *matchEnd == *ref; ref++)
+			{
+				matchEnd++;
+			}
+
+			if (WriteSequence(op, opEnd, anchor, ip - anchor, ip - match, matchEnd - ip - MinMatch, false) == false)
+			{
+				return 0;
+			}
+
+			ip = matchEnd;
+			anchor = ip;
+			table[HashSequence(Read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+		}
+	}
+
+	if (WriteSequence(op, opEnd, anchor, end - anchor, 0, 0, true) == false)
+	{
+		return 0;
+	}
+	return static_cast<size_t>(op - dst);
+}
+
+bool LZ4::Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+	const uint8_t* ip = src;
+	const uint8_t* ipEnd = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* opEnd = dst + dstSize;
+
+	while (ip < ipEnd)
+	{
+		uint8_t token = *ip++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && ReadLength(ip, ipEnd, literalLength) == false)
+		{
+			return false;
+		}
+		if (literalLength > static_cast<size_t>(ipEnd - ip) || literalLength > static_cast<size_t>(opEnd - op))
+		{
+			return false;
+		}
+		std::copy_n(ip, literalLength, op);
+		ip += literalLength;
+		op += literalLength;
+
+		// the last sequence has no match
+		if (ip == ipEnd)
+		{
+			break;
+		}
+
+		if (ipEnd - ip < 2)
+		{
+			return false;
+		}
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > static_cast<size_t>(op - dst))
+		{
+			return false;
+		}
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && ReadLength(ip, ipEnd, matchLength) == false)
+		{
+			return false;
+		}
+		matchLength += MinMatch;
+		if (matchLength > static_cast<size_t>(opEnd - op))
+		{
+			return false;
+		}
+
+		// a match closer than its length repeats the bytes it is producing, so those are copied one at a time
+		const uint8_t* match = op - offset;
+		if (offset >= matchLength)
+		{
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				*op++ = *match++;
+			}
+		}
+	}
+	return op == opEnd;
+}
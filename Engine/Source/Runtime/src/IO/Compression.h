@@ -0,0 +1,24 @@
+#pragma once
+
+namespace Gleam {
+
+/*
+* LZ4 block format codec, blocks are independent so they can be compressed and decompressed in parallel
+* Favors decode speed over ratio, every block decodes with a single pass of copies
+*/
+class LZ4 final
+{
+public:
+
+	// Largest output a block of the given size can compress to
+	static size_t CompressBound(size_t size);
+
+	// Returns the compressed size, or 0 if the output does not fit into capacity
+	static size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t capacity);
+
+	// Decodes exactly dstSize bytes, fails on malformed or truncated input instead of reading past it
+	static bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+};
+
+} // namespace Gleam
@@ -22,7 +22,10 @@ TString File::Read() const
 
 	FileAccessor::Read accessor(mAccessor);
 
-	size_t size = GetSize();
+	// GetSize takes the accessor on its own, the stream is measured here instead
+	mHandle.seekg(0, std::ios::end);
+	size_t size = mHandle.tellg();
+	mHandle.seekg(0, std::ios::beg);
     TString contents;
 	contents.resize(size);
 	mHandle.read(contents.data(), size);
@@ -1,24 +1,155 @@
 #include "gpch.h"
 #include "Filesystem.h"
 #include "File.h"
+#include "MappedFile.h"
+#include "PakArchive.h"
 
 using namespace Gleam;
 
-void Filesystem::ForEach(const Path& path, const DirectoryFn& fn, bool recursive)
+// Path of a file inside a mount, false if it is not under the mount point
+static bool MountRelative(const Filesystem::Path& path, const Filesystem::Path& mountPoint, Filesystem::Path& relative)
+{
+	relative = path.lexically_normal().lexically_relative(mountPoint);
+	return relative.empty() == false && *relative.begin() != "..";
+}
+
+// Directories only exist in an archive as a prefix of the files in them
+static bool IsArchiveDirectory(const PakArchive& archive, const Filesystem::Path& relative)
+{
+	return archive.FindDirectory(relative.generic_string()) != nullptr;
+}
+
+// key is the generic path of the directory relative to the mount point, path where it is mounted
+static void ForEachInArchive(const PakArchive& archive, const TString& key, const Filesystem::Path& path, const Filesystem::DirectoryFn& fn, bool recursive, HashSet<Filesystem::Path>& visited)
+{
+	const auto* directory = archive.FindDirectory(key);
+	if (directory == nullptr)
+	{
+		return;
+	}
+
+	for (uint32_t index : directory->files)
+	{
+		auto file = archive.GetPath(archive.GetEntry(index));
+		auto node = path / file.substr(key.empty() ? 0 : key.size() + 1);
+		if (visited.insert(node).second)
+		{
+			fn(node);
+		}
+	}
+
+	// without recursion, a subdirectory stands for the files in it
+	for (const auto& name : directory->directories)
+	{
+		if (recursive)
+		{
+			ForEachInArchive(archive, key.empty() ? name : key + "/" + name, path / name, fn, recursive, visited);
+		}
+		else if (auto node = path / name; visited.insert(node).second)
+		{
+			fn(node);
+		}
+	}
+}
+
+static void ForEachOnDisk(const Filesystem::Path& path, const Filesystem::DirectoryFn& fn, bool recursive, const HashSet<Filesystem::Path>& visited)
 {
     for (auto& node : std::filesystem::directory_iterator(path))
     {
-        if (recursive && IsDirectory(node))
+        if (recursive && node.is_directory())
         {
-            ForEach(node, fn, recursive);
+            ForEachOnDisk(node, fn, recursive, visited);
         }
-        else
+        else if (visited.find(node.path()) == visited.end())
         {
             fn(node);
         }
     }
 }
 
+void Filesystem::ForEach(const Path& path, const DirectoryFn& fn, bool recursive)
+{
+	TArray<MountedArchive> mounts;
+	{
+		std::shared_lock<std::shared_mutex> lock(mMountMutex);
+		mounts = mMounts;
+	}
+
+	// archived files shadow loose files of the same path, which are then skipped on disk
+	HashSet<Path> visited;
+	bool mounted = false;
+	for (auto mount = mounts.rbegin(); mount != mounts.rend(); ++mount)
+	{
+		Path relative;
+		if (MountRelative(path, mount->mountPoint, relative) == false)
+		{
+			continue;
+		}
+		mounted = true;
+
+		auto key = relative == "." ? TString() : relative.generic_string();
+		ForEachInArchive(*mount->archive, key, path, fn, recursive, visited);
+	}
+
+	if (mounted == false || std::filesystem::is_directory(path))
+	{
+		ForEachOnDisk(path, fn, recursive, visited);
+	}
+}
+
+bool Filesystem::Mount(const Path& archivePath, const Path& mountPoint)
+{
+	auto archive = CreateRef<PakArchive>(archivePath);
+	if (archive->IsValid() == false)
+	{
+		return false;
+	}
+
+	auto point = mountPoint.lexically_normal();
+	if (point.has_filename() == false)
+	{
+		point = point.parent_path();
+	}
+
+	Unmount(archivePath);
+	{
+		std::unique_lock<std::shared_mutex> lock(mMountMutex);
+		mMounts.push_back({ .mountPoint = point, .archive = archive });
+	}
+	GLEAM_CORE_INFO("Mounted {0} files of {1} onto {2}", archive->GetEntryCount(), archivePath.string(), point.string());
+	return true;
+}
+
+void Filesystem::Unmount(const Path& archivePath)
+{
+	// views of the archive files keep it mapped until they are gone
+	std::unique_lock<std::shared_mutex> lock(mMountMutex);
+	std::erase_if(mMounts, [&](const MountedArchive& mount)
+	{
+		return mount.archive->GetArchivePath() == archivePath;
+	});
+}
+
+const PakEntry* Filesystem::FindMounted(const Path& path, RefCounted<PakArchive>& archive)
+{
+	std::shared_lock<std::shared_mutex> lock(mMountMutex);
+	for (auto mount = mMounts.rbegin(); mount != mMounts.rend(); ++mount)
+	{
+		Path relative;
+		if (MountRelative(path, mount->mountPoint, relative) == false)
+		{
+			continue;
+		}
+
+		if (const auto* entry = mount->archive->Find(relative))
+		{
+			archive = mount->archive;
+			return entry;
+		}
+	}
+	return nullptr;
+}
+
 File Filesystem::Create(const Filesystem::Path& path, FileType type)
 {
     auto flags = std::ios::out | std::ios::in | std::ios::trunc;
@@ -28,18 +159,7 @@ File Filesystem::Create(const Filesystem::Path& path, FileType type)
     }
     FileStream handle(path, flags);
     handle.unsetf(std::ios::skipws);
-    
-    std::lock_guard<std::mutex> lock(mFileCreateMutex);
-    if (auto it = mFileAccessors.find(path); it != mFileAccessors.end())
-    {
-        return File(std::move(handle), path, it->second);
-    }
-    
-    auto it = mFileAccessors.emplace_hint(mFileAccessors.end(),
-                                          std::piecewise_construct,
-                                          std::forward_as_tuple(path),
-                                          std::forward_as_tuple());
-	return File(std::move(handle), path, it->second);
+	return File(std::move(handle), path, Accessor(path));
 }
 
 File Filesystem::Open(const Filesystem::Path& path, FileType type)
@@ -51,9 +171,17 @@ File Filesystem::Open(const Filesystem::Path& path, FileType type)
 	}
 	FileStream handle(path, flags);
 	handle.unsetf(std::ios::skipws);
-    
-    std::lock_guard<std::mutex> lock(mFileCreateMutex);
-	return File(std::move(handle), path, mFileAccessors[path]);
+	return File(std::move(handle), path, Accessor(path));
+}
+
+MappedFile Filesystem::Map(const Filesystem::Path& path)
+{
+	RefCounted<PakArchive> archive;
+	if (const auto* entry = FindMounted(path, archive))
+	{
+		return archive->Map(*entry);
+	}
+	return MappedFile(path);
 }
 
 bool Filesystem::Remove(const Filesystem::Path& path)
@@ -63,7 +191,19 @@ bool Filesystem::Remove(const Filesystem::Path& path)
 
 FileAccessor& Filesystem::Accessor(const Filesystem::Path& path)
 {
-	return mFileAccessors[path];
+	// accessors are never removed and stay put on rehash, so references outlive the shard lock
+	auto& shard = mAccessorShards[std::hash<Filesystem::Path>()(path) % AccessorShardCount];
+	{
+		std::shared_lock<std::shared_mutex> lock(shard.mutex);
+		if (auto it = shard.accessors.find(path); it != shard.accessors.end())
+		{
+			return it->second;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> lock(shard.mutex);
+	auto [it, inserted] = shard.accessors.try_emplace(path);
+	return it->second;
 }
 
 FileAccessor::Read Filesystem::ReadAccessor(const Filesystem::Path& path)
@@ -88,53 +228,66 @@ Filesystem::Path Filesystem::Relative(const Filesystem::Path& path, const Filesy
 
 bool Filesystem::Exists(const Filesystem::Path& path)
 {
-	return std::filesystem::exists(path);
+	RefCounted<PakArchive> archive;
+	if (FindMounted(path, archive))
+	{
+		return true;
+	}
+	return std::filesystem::exists(path) || IsDirectory(path);
 }
 
 bool Filesystem::IsDirectory(const Filesystem::Path& path)
 {
+	{
+		std::shared_lock<std::shared_mutex> lock(mMountMutex);
+		for (const auto& mount : mMounts)
+		{
+			Path relative;
+			if (MountRelative(path, mount.mountPoint, relative) && IsArchiveDirectory(*mount.archive, relative))
+			{
+				return true;
+			}
+		}
+	}
 	return std::filesystem::is_directory(path);
 }
 
-// File::Accessors
-
-FileAccessor::Write::Write(FileAccessor& accessor)
-	: mAccessor(accessor)
+uint64_t Filesystem::LastWriteTime(const Filesystem::Path& path)
 {
-	std::unique_lock<std::mutex> lock(mAccessor.mutex);
-	mAccessor.condition.wait(lock, [this]
+	RefCounted<PakArchive> archive;
+	if (const auto* entry = FindMounted(path, archive))
 	{
-		return mAccessor.status == FileStatus::Available;
-	});
-	mAccessor.status = Gleam::FileStatus::Writing;
+		return entry->modifiedTime;
+	}
+
+	std::error_code error;
+	auto time = std::filesystem::last_write_time(path, error);
+	return error ? 0 : static_cast<uint64_t>(time.time_since_epoch().count());
 }
 
-FileAccessor::Write::~Write()
+uint64_t Filesystem::FileSize(const Filesystem::Path& path)
 {
-	mAccessor.status = Gleam::FileStatus::Available;
-	mAccessor.condition.notify_all();
+	RefCounted<PakArchive> archive;
+	if (const auto* entry = FindMounted(path, archive))
+	{
+		return entry->size;
+	}
+
+	std::error_code error;
+	auto size = std::filesystem::file_size(path, error);
+	return error ? 0 : static_cast<uint64_t>(size);
 }
 
-FileAccessor::Read::Read(FileAccessor& accessor)
-	: mAccessor(accessor)
-	, mLock(accessor.mutex)
+// File::Accessors
+
+FileAccessor::Write::Write(FileAccessor& accessor)
+	: mLock(accessor.mutex)
 {
-	mAccessor.condition.wait(mLock, [this]
-	{
-		return mAccessor.status != FileStatus::Writing;
-	});
 
-	++mAccessor.concurrentReaders;
-	mAccessor.status = FileStatus::Reading;
-	mLock.unlock();
 }
 
-FileAccessor::Read::~Read()
+FileAccessor::Read::Read(FileAccessor& accessor)
+	: mLock(accessor.mutex)
 {
-	mLock.lock();
-	if (--mAccessor.concurrentReaders == 0)
-	{
-		mAccessor.status = FileStatus::Available;
-		mAccessor.condition.notify_all();
-	}
+
 }
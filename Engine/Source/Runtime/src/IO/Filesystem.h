@@ -1,5 +1,7 @@
 #pragma once
+#include <array>
 #include <mutex>
+#include <shared_mutex>
 #include <fstream>
 #include <functional>
 #include <filesystem>
@@ -22,41 +24,39 @@ struct hash<filesystem::path>
 namespace Gleam {
 
 class File;
+class MappedFile;
+class PakArchive;
+struct PakEntry;
 enum class FileType;
 using FileStream = std::fstream;
 
-enum class FileStatus
-{
-    Available,
-    Writing,
-    Reading
-};
-
+/*
+* Reader/writer lock of a single file, any number of readers or one writer at a time
+* Neither side is reentrant, a thread holding an accessor must not take another one for the same file
+*/
 struct FileAccessor
 {
-    std::mutex mutex;
-    std::condition_variable condition;
-    std::atomic<uint32_t> concurrentReaders = 0;
-    FileStatus status = FileStatus::Available;
+	std::shared_mutex mutex;
 
 	struct Write
 	{
-		FileAccessor& mAccessor;
+		std::unique_lock<std::shared_mutex> mLock;
 
 		Write(FileAccessor& accessor);
-		~Write();
 	};
 
 	struct Read
 	{
-		FileAccessor& mAccessor;
-		std::unique_lock<std::mutex> mLock;
+		std::shared_lock<std::shared_mutex> mLock;
 
 		Read(FileAccessor& accessor);
-		~Read();
 	};
 };
 
+/*
+* Archives mounted onto a directory take precedence over the loose files in it
+* Map, Exists, IsDirectory, LastWriteTime, FileSize and ForEach see both, writes only ever go to disk
+*/
 class Filesystem
 {
 public:
@@ -64,10 +64,19 @@ public:
     using DirectoryFn = std::function<void(const Path& node)>;
     
     static void ForEach(const Path& path, const DirectoryFn& fn, bool recursive);
+
+	// Files of the archive appear under mountPoint, returns false if it is not a valid archive
+	static bool Mount(const Path& archivePath, const Path& mountPoint);
+
+	static void Unmount(const Path& archivePath);
     
 	static File Create(const Filesystem::Path& path, FileType type);
 
 	static File Open(const Filesystem::Path& path, FileType type);
+
+	// Read only view of the whole file, nothing is copied until the pages are touched
+	// Hold a ReadAccessor while the view is in use if the file can be rewritten concurrently
+	static MappedFile Map(const Filesystem::Path& path);
     
     static bool Remove(const Filesystem::Path& path);
 
@@ -84,12 +93,36 @@ public:
 	static bool Exists(const Path& path);
 
 	static bool IsDirectory(const Path& path);
+
+	static uint64_t LastWriteTime(const Path& path);
+
+	static uint64_t FileSize(const Path& path);
     
 private:
-    
-    static inline std::mutex mFileCreateMutex;
-    
-    static inline HashMap<Filesystem::Path, FileAccessor> mFileAccessors;
+
+	// accessors are spread over shards by path hash, so loaders working on different files rarely meet on a lock
+	static constexpr size_t AccessorShardCount = 64;
+
+	struct alignas(64) AccessorShard
+	{
+		std::shared_mutex mutex;
+		HashMap<Filesystem::Path, FileAccessor> accessors;
+	};
+
+	static inline std::array<AccessorShard, AccessorShardCount> mAccessorShards;
+
+	struct MountedArchive
+	{
+		Path mountPoint;
+		RefCounted<PakArchive> archive;
+	};
+
+	// Finds the archive entry a path resolves to, the most recently mounted archive wins
+	static const PakEntry* FindMounted(const Path& path, RefCounted<PakArchive>& archive);
+
+	static inline std::shared_mutex mMountMutex;
+
+	static inline TArray<MountedArchive> mMounts;
 
 };
 
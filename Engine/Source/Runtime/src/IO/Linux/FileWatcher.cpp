@@ -0,0 +1,406 @@
+#include "gpch.h"
+
+#ifdef PLATFORM_LINUX
+#include "IO/FileWatcher.h"
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+using namespace Gleam;
+
+struct FileWatcher::Watcher
+{
+	// an editor save fires a burst of events, a path is reported once it has been quiet for this long
+	static constexpr auto DebounceInterval = std::chrono::milliseconds(100);
+
+	// the halves of a move usually share a read, but a full buffer can split them
+	static constexpr auto MovePairInterval = std::chrono::milliseconds(20);
+
+	static constexpr uint32_t WatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+										  IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+
+	using Clock = std::chrono::steady_clock;
+
+	struct PendingEvent
+	{
+		FileWatchEvent event;
+		Clock::time_point deadline;
+	};
+
+	struct PendingMove
+	{
+		Filesystem::Path path;
+		bool directory;
+		Clock::time_point deadline;
+	};
+
+	Filesystem::Path path;
+	FileWatchHandler handler;
+
+	int inotifyHandle;
+	int wakeHandle;
+	std::thread watchThread;
+	std::atomic<bool> running;
+
+	// only touched on the watch thread
+	HashMap<int, Filesystem::Path> directories;
+	HashMap<Filesystem::Path, PendingEvent> pendingEvents;
+	HashMap<uint32_t, PendingMove> pendingMoves;
+
+	Watcher(const Filesystem::Path& path, FileWatchHandler&& handler, int inotifyHandle, int wakeHandle)
+		: path(path), handler(std::move(handler)), inotifyHandle(inotifyHandle), wakeHandle(wakeHandle), running(true)
+	{
+		AddDirectory(path, false);
+		watchThread = std::thread([this]()
+		{
+			Run();
+		});
+	}
+
+	~Watcher()
+	{
+		running = false;
+		uint64_t value = 1;
+		ssize_t written;
+		do
+		{
+			written = ::write(wakeHandle, &value, sizeof(value));
+		} while (written < 0 && errno == EINTR);
+
+		if (written != sizeof(value))
+		{
+			// removing the root watch queues an IN_IGNORED event, which wakes the thread as well
+			GLEAM_CORE_ERROR("FileWatcher could not wake its thread: {0}", path.string());
+			int wd = ::inotify_add_watch(inotifyHandle, path.c_str(), WatchMask);
+			if (wd >= 0)
+			{
+				::inotify_rm_watch(inotifyHandle, wd);
+			}
+		}
+
+		if (watchThread.joinable())
+		{
+			watchThread.join();
+		}
+		::close(inotifyHandle);
+		::close(wakeHandle);
+	}
+
+	void Run()
+	{
+		alignas(inotify_event) char buffer[8192];
+		while (running)
+		{
+			pollfd handles[2] = {
+				{ .fd = inotifyHandle, .events = POLLIN },
+				{ .fd = wakeHandle, .events = POLLIN }
+			};
+			if (::poll(handles, 2, GetTimeout()) < 0 && errno != EINTR)
+			{
+				GLEAM_CORE_ERROR("FileWatcher poll failed: {0}", path.string());
+				break;
+			}
+
+			if (handles[1].revents & POLLIN)
+			{
+				break;
+			}
+
+			if (handles[0].revents & POLLIN)
+			{
+				ssize_t length = ::read(inotifyHandle, buffer, sizeof(buffer));
+				for (ssize_t offset = 0; offset < length;)
+				{
+					const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+					ProcessEvent(*event);
+					offset += sizeof(inotify_event) + event->len;
+				}
+			}
+
+			ExpireMoves();
+			Flush();
+		}
+	}
+
+	// reportContents is set for directories that appear while watching, their contents may predate the watch
+	void AddDirectory(const Filesystem::Path& dir, bool reportContents)
+	{
+		int wd = ::inotify_add_watch(inotifyHandle, dir.c_str(), WatchMask);
+		if (wd < 0)
+		{
+			GLEAM_CORE_ERROR("FileWatcher inotify watch failed: {0}", dir.string());
+			return;
+		}
+		directories[wd] = dir;
+
+		// inotify is not recursive, every subdirectory needs a watch of its own
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(dir, error))
+		{
+			if (reportContents)
+			{
+				Push(entry.path(), FileWatchEvent::Added);
+			}
+
+			if (entry.is_directory(error) && entry.is_symlink(error) == false)
+			{
+				AddDirectory(entry.path(), reportContents);
+			}
+		}
+	}
+
+	void ProcessEvent(const inotify_event& event)
+	{
+		if (event.mask & IN_Q_OVERFLOW)
+		{
+			GLEAM_CORE_ERROR("FileWatcher inotify queue overflowed, events are lost: {0}", path.string());
+			return;
+		}
+
+		auto it = directories.find(event.wd);
+		if (it == directories.end())
+		{
+			return;
+		}
+
+		if (event.mask & IN_IGNORED)
+		{
+			directories.erase(it);
+			return;
+		}
+
+		// a removed subdirectory is reported by its parent, only the root is handled here
+		if (event.mask & IN_DELETE_SELF)
+		{
+			if (it->second == path)
+			{
+				Push(path, FileWatchEvent::Removed);
+			}
+			return;
+		}
+
+		Filesystem::Path filepath = event.len > 0 ? it->second / event.name : it->second;
+		bool directory = event.mask & IN_ISDIR;
+		if (event.mask & IN_MOVED_FROM)
+		{
+			pendingMoves[event.cookie] = { .path = filepath, .directory = directory, .deadline = Clock::now() + MovePairInterval };
+		}
+		else if (event.mask & IN_MOVED_TO)
+		{
+			auto move = pendingMoves.find(event.cookie);
+			if (move != pendingMoves.end())
+			{
+				if (directory)
+				{
+					RenameDirectory(move->second.path, filepath);
+				}
+				Push(move->second.path, FileWatchEvent::Renamed);
+				Push(filepath, FileWatchEvent::Renamed);
+				pendingMoves.erase(move);
+			}
+			else
+			{
+				Push(filepath, FileWatchEvent::Added);
+				if (directory)
+				{
+					AddDirectory(filepath, true);
+				}
+			}
+		}
+		else if (event.mask & IN_CREATE)
+		{
+			Push(filepath, FileWatchEvent::Added);
+			if (directory)
+			{
+				AddDirectory(filepath, true);
+			}
+		}
+		else if (event.mask & IN_DELETE)
+		{
+			Push(filepath, FileWatchEvent::Removed);
+		}
+		else if (event.mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))
+		{
+			if (directory == false)
+			{
+				Push(filepath, FileWatchEvent::Modified);
+			}
+		}
+	}
+
+	static bool IsUnder(const Filesystem::Path& dir, const Filesystem::Path& parent)
+	{
+		auto [parentEnd, dirIt] = std::mismatch(parent.begin(), parent.end(), dir.begin(), dir.end());
+		return parentEnd == parent.end();
+	}
+
+	void RenameDirectory(const Filesystem::Path& from, const Filesystem::Path& to)
+	{
+		// watches follow the inode, so a directory moved inside the tree keeps them and only their paths change
+		for (auto& [wd, dir] : directories)
+		{
+			if (IsUnder(dir, from))
+			{
+				dir = to / Filesystem::Relative(dir, from);
+				dir = dir.lexically_normal();
+			}
+		}
+	}
+
+	void RemoveDirectory(const Filesystem::Path& dir)
+	{
+		// moved out of the tree, the kernel keeps reporting it until the watches are removed
+		for (const auto& [wd, watchedDir] : directories)
+		{
+			if (IsUnder(watchedDir, dir))
+			{
+				::inotify_rm_watch(inotifyHandle, wd);
+			}
+		}
+	}
+
+	void ExpireMoves()
+	{
+		// a half that found no pair in time crossed the boundary of the watched tree
+		auto now = Clock::now();
+		for (auto it = pendingMoves.begin(); it != pendingMoves.end();)
+		{
+			if (it->second.deadline > now)
+			{
+				++it;
+				continue;
+			}
+
+			if (it->second.directory)
+			{
+				RemoveDirectory(it->second.path);
+			}
+			Push(it->second.path, FileWatchEvent::Removed);
+			it = pendingMoves.erase(it);
+		}
+	}
+
+	void Push(const Filesystem::Path& filepath, FileWatchEvent event)
+	{
+		auto deadline = Clock::now() + DebounceInterval;
+		auto [it, inserted] = pendingEvents.try_emplace(filepath, PendingEvent{ .event = event, .deadline = deadline });
+		if (inserted)
+		{
+			return;
+		}
+
+		// a burst on a path collapses into the event that describes it best
+		auto& pending = it->second;
+		pending.deadline = deadline;
+		if (pending.event == FileWatchEvent::Added && event == FileWatchEvent::Modified)
+		{
+			return;
+		}
+		if (pending.event == FileWatchEvent::Removed && event == FileWatchEvent::Added)
+		{
+			// replaced by an atomic save
+			pending.event = FileWatchEvent::Modified;
+			return;
+		}
+		pending.event = event;
+	}
+
+	void Flush()
+	{
+		auto now = Clock::now();
+		for (auto it = pendingEvents.begin(); it != pendingEvents.end();)
+		{
+			if (it->second.deadline > now)
+			{
+				++it;
+				continue;
+			}
+
+			handler(it->first, it->second.event);
+			it = pendingEvents.erase(it);
+		}
+	}
+
+	int GetTimeout() const
+	{
+		if (pendingEvents.empty() && pendingMoves.empty())
+		{
+			return -1;
+		}
+
+		auto deadline = Clock::time_point::max();
+		for (const auto& [filepath, pending] : pendingEvents)
+		{
+			deadline = std::min(deadline, pending.deadline);
+		}
+		for (const auto& [cookie, move] : pendingMoves)
+		{
+			deadline = std::min(deadline, move.deadline);
+		}
+		auto timeout = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+		return static_cast<int>(std::max(timeout.count(), int64_t(0)));
+	}
+};
+
+void FileWatcher::Initialize(Engine* engine)
+{
+
+}
+
+void FileWatcher::Shutdown()
+{
+	for (auto& [_, watcher] : mWatchers)
+	{
+		delete watcher;
+	}
+	mWatchers.clear();
+}
+
+void FileWatcher::AddWatch(const Filesystem::Path& dir, FileWatchHandler&& handler)
+{
+	if (Filesystem::IsDirectory(dir) == false)
+	{
+		GLEAM_CORE_ERROR("FileWatcher requires directory: {0}", dir.string());
+		return;
+	}
+
+	if (mWatchers.find(dir) != mWatchers.end())
+	{
+		RemoveWatch(dir);
+	}
+
+	int inotifyHandle = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyHandle < 0)
+	{
+		GLEAM_CORE_ERROR("FileWatcher inotify creation failed: {0}", dir.string());
+		return;
+	}
+
+	int wakeHandle = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (wakeHandle < 0)
+	{
+		GLEAM_CORE_ERROR("FileWatcher eventfd creation failed: {0}", dir.string());
+		::close(inotifyHandle);
+		return;
+	}
+
+	Watcher* watcher = new Watcher(dir, std::forward<FileWatchHandler>(handler), inotifyHandle, wakeHandle);
+	mWatchers[dir] = watcher;
+}
+
+void FileWatcher::RemoveWatch(const Filesystem::Path& dir)
+{
+	auto it = mWatchers.find(dir);
+	if (it == mWatchers.end())
+	{
+		return;
+	}
+
+	Watcher* watcher = it->second;
+	mWatchers.erase(it);
+	delete watcher;
+}
+
+#endif
@@ -2,27 +2,388 @@
 #include "Log.h"
 #include "Core/Globals.h"
 
+#include <csignal>
+#include <condition_variable>
+
+#ifdef PLATFORM_WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace Gleam;
 
+/*
+* Bounded multi producer, single consumer ring, every slot carries a sequence number that tells
+* producers whether it is free and the consumer whether it has been written
+*/
+class LogQueue final
+{
+public:
+
+	static constexpr uint64_t Capacity = 4096;
+
+	// an idle writer still looks for records this often, log calls never wake it themselves
+	static constexpr auto FlushInterval = std::chrono::milliseconds(10);
+
+	// a crashing thread may have claimed a slot it never finishes, flushes give up on it after this long
+	static constexpr auto FlushTimeout = std::chrono::seconds(2);
+
+	static LogQueue& Get()
+	{
+		static LogQueue queue;
+		return queue;
+	}
+
+	LogRecord& Claim()
+	{
+		uint64_t position = mWriteIndex.load(std::memory_order_relaxed);
+		while (true)
+		{
+			auto& slot = mSlots[position % Capacity];
+			uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+			if (sequence == position)
+			{
+				if (mWriteIndex.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					return slot.record;
+				}
+			}
+			else if (sequence < position)
+			{
+				// full, the writer frees a whole batch of slots at a time
+				std::this_thread::yield();
+				position = mWriteIndex.load(std::memory_order_relaxed);
+			}
+			else
+			{
+				position = mWriteIndex.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void Commit(LogRecord& record)
+	{
+		auto index = (reinterpret_cast<uintptr_t>(&record) - reinterpret_cast<uintptr_t>(&mSlots[0].record)) / sizeof(Slot);
+		auto& slot = mSlots[index];
+		slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	void Flush()
+	{
+		if (std::this_thread::get_id() == mWriterThread.get_id())
+		{
+			return;
+		}
+
+		uint64_t target = mWriteIndex.load(std::memory_order_acquire);
+		std::unique_lock<std::mutex> lock(mMutex);
+		mFlushRequested = true;
+		mCondition.notify_one();
+		mFlushedCondition.wait_for(lock, FlushTimeout, [&]() { return mWritten.load(std::memory_order_relaxed) >= target; });
+	}
+
+	// Only async signal safe calls, the crashing thread may hold the queue mutex or be inside the allocator
+	void FlushFromSignal()
+	{
+		if (mCrashed.exchange(true))
+		{
+			return;
+		}
+		uint64_t target = mWriteIndex.load(std::memory_order_acquire);
+
+		// the writer is left to finish unless the crash is on it, it stops at a slot the crashing thread never ended
+		if (std::this_thread::get_id() != mWriterThread.get_id())
+		{
+			auto deadline = std::chrono::steady_clock::now() + FlushTimeout;
+			while (mWritten.load(std::memory_order_acquire) < target && std::chrono::steady_clock::now() < deadline)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		// what the writer did not get to is written from here, skipping unfinished slots instead of stopping at them
+		for (uint64_t position = mWritten.load(std::memory_order_acquire); position < target; position++)
+		{
+			auto& slot = mSlots[position % Capacity];
+			if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+			{
+				continue;
+			}
+
+			// localtime is not safe in a handler, the time is left out
+			char line[LogRecord::MaxLength + 128];
+			size_t length = 0;
+			auto append = [&](const char* data, size_t size)
+			{
+				size = std::min(size, sizeof(line) - length);
+				memcpy(line + length, data, size);
+				length += size;
+			};
+			const auto& record = slot.record;
+			auto level = Logger::LogLevelToString(static_cast<Logger::Level>(record.level));
+			append("[--:--:--] ", 11);
+			append(level.data(), level.size());
+			append(record.logger->GetName().data(), record.logger->GetName().size());
+			append(record.message, record.length);
+			append("\n", 1);
+			WriteToFile(line, length);
+		}
+	}
+
+private:
+
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t> sequence;
+		LogRecord record;
+	};
+
+	static constexpr int CrashSignals[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+
+	LogQueue()
+		: mSlots(new Slot[Capacity])
+	{
+		// a plain descriptor, so that a signal handler can write to it as well
+#ifdef PLATFORM_WINDOWS
+		mFile = _open("Gleam.log", _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		mFile = ::open("Gleam.log", O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+
+		for (uint64_t i = 0; i < Capacity; i++)
+		{
+			mSlots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		mWriterThread = std::thread([this]() { WriterLoop(); });
+
+		// the records of a crash are the ones that matter most, they are written before the handler installed earlier runs
+		for (int signal : CrashSignals)
+		{
+#ifdef PLATFORM_WINDOWS
+			mPreviousHandlers[signal] = std::signal(signal, OnCrash);
+#else
+			struct sigaction action = {};
+			action.sa_sigaction = OnCrash;
+			action.sa_flags = SA_SIGINFO;
+			sigemptyset(&action.sa_mask);
+			sigaction(signal, &action, &mPreviousActions[signal]);
+#endif
+		}
+	}
+
+	~LogQueue()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStopping = true;
+		}
+		mCondition.notify_one();
+		mWriterThread.join();
+
+		for (int signal : CrashSignals)
+		{
+#ifdef PLATFORM_WINDOWS
+			std::signal(signal, mPreviousHandlers[signal]);
+#else
+			sigaction(signal, &mPreviousActions[signal], nullptr);
+#endif
+		}
+
+		if (mFile != -1)
+		{
+#ifdef PLATFORM_WINDOWS
+			_close(mFile);
+#else
+			::close(mFile);
+#endif
+		}
+	}
+
+#ifdef PLATFORM_WINDOWS
+	static void OnCrash(int signal)
+	{
+		auto& queue = LogQueue::Get();
+		queue.FlushFromSignal();
+
+		auto previous = queue.mPreviousHandlers[signal];
+		if (previous != SIG_DFL && previous != SIG_IGN && previous != SIG_ERR)
+		{
+			previous(signal);
+			return;
+		}
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+#else
+	static void OnCrash(int signal, siginfo_t* info, void* context)
+	{
+		auto& queue = LogQueue::Get();
+		queue.FlushFromSignal();
+
+		const auto& previous = queue.mPreviousActions[signal];
+		if (previous.sa_flags & SA_SIGINFO)
+		{
+			previous.sa_sigaction(signal, info, context);
+			return;
+		}
+		if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN)
+		{
+			previous.sa_handler(signal);
+			return;
+		}
+
+		// the signal is blocked while the handler runs, the default action takes it once this returns
+		sigaction(signal, &previous, nullptr);
+		raise(signal);
+	}
+#endif
+
+	void WriteToFile(const char* data, size_t size)
+	{
+		while (size > 0 && mFile != -1)
+		{
+#ifdef PLATFORM_WINDOWS
+			auto written = _write(mFile, data, static_cast<unsigned int>(size));
+#else
+			auto written = ::write(mFile, data, size);
+			if (written < 0 && errno == EINTR)
+			{
+				continue;
+			}
+#endif
+			if (written <= 0)
+			{
+				return;
+			}
+			data += written;
+			size -= written;
+		}
+	}
+
+	void WriterLoop()
+	{
+		TString batch;
+		batch.reserve(Capacity * 64);
+		while (true)
+		{
+			uint64_t drained = Drain(batch);
+			if (batch.empty() == false)
+			{
+				WriteToFile(batch.data(), batch.size());
+				batch.clear();
+			}
+
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWritten.store(mReadIndex, std::memory_order_release);
+			mFlushedCondition.notify_all();
+			if (drained > 0)
+			{
+				continue;
+			}
+
+			if (mStopping)
+			{
+				return;
+			}
+			mCondition.wait_for(lock, FlushInterval, [this]() { return mStopping || mFlushRequested; });
+			mFlushRequested = false;
+		}
+	}
+
+	// Formats every finished record into the batch, stops at the first one still being written
+	uint64_t Drain(TString& batch)
+	{
+		uint64_t drained = 0;
+		for (; drained < Capacity; drained++)
+		{
+			auto& slot = mSlots[mReadIndex % Capacity];
+			if (slot.sequence.load(std::memory_order_acquire) != mReadIndex + 1)
+			{
+				break;
+			}
+
+			const auto& record = slot.record;
+			batch += '[';
+			batch += FormatTime(record.time);
+			batch += "] ";
+			batch += Logger::LogLevelToString(static_cast<Logger::Level>(record.level));
+			batch += record.logger->GetName();
+			batch.append(record.message, record.length);
+			batch += '\n';
+
+			slot.sequence.store(mReadIndex + Capacity, std::memory_order_release);
+			mReadIndex++;
+		}
+		return drained;
+	}
+
+	// Records of the same second share the formatted time
+	TStringView FormatTime(int64_t time)
+	{
+		auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::duration(time)).count();
+		if (seconds != mFormattedSeconds)
+		{
+			auto currentTime = static_cast<std::time_t>(seconds);
+			std::strftime(mFormattedTime, sizeof(mFormattedTime), "%X", std::localtime(&currentTime));
+			mFormattedSeconds = seconds;
+		}
+		return mFormattedTime;
+	}
+
+	Scope<Slot[]> mSlots;
+
+	alignas(64) std::atomic<uint64_t> mWriteIndex = 0;
+
+	// only touched by the writer thread
+	alignas(64) uint64_t mReadIndex = 0;
+
+	int64_t mFormattedSeconds = -1;
+
+	char mFormattedTime[32] = {};
+
+	int mFile = -1;
+
+	std::thread mWriterThread;
+
+	std::mutex mMutex;
+
+	std::condition_variable mCondition;
+
+	std::condition_variable mFlushedCondition;
+
+	// read by a crash handler without the mutex
+	std::atomic<uint64_t> mWritten = 0;
+
+	std::atomic<bool> mCrashed = false;
+
+#ifdef PLATFORM_WINDOWS
+	void (*mPreviousHandlers[NSIG])(int) = {};
+#else
+	struct sigaction mPreviousActions[NSIG] = {};
+#endif
+
+	bool mFlushRequested = false;
+
+	bool mStopping = false;
+
+};
+
 Logger::Logger(const TString& name)
     : mName(name)
 {
 	mName.append(": ");
-    static std::once_flag flag;
-    std::call_once(flag, [this]()
-    {
-        mFileStream = CreateScope<std::ofstream>("Gleam.log", std::ofstream::out);
-    });
-    mInstanceCount++;
+
+	// constructed first, so the queue is destroyed after the last logger
+	LogQueue::Get();
 }
 
 Logger::~Logger()
 {
-    mInstanceCount--;
-    if (mInstanceCount == 0)
-    {
-        mFileStream.reset();
-    }
+	Flush();
 }
 
 const Logger& Logger::GetCoreLogger()
@@ -36,3 +397,28 @@ const Logger& Logger::GetClientLogger()
 	static Logger sLogger(Globals::ProjectName);
 	return sLogger;
 }
+
+void Logger::Flush()
+{
+	LogQueue::Get().Flush();
+}
+
+const TString& Logger::GetName() const
+{
+	return mName;
+}
+
+LogRecord& Logger::BeginRecord(Level lvl) const
+{
+	auto& record = LogQueue::Get().Claim();
+	record.time = std::chrono::system_clock::now().time_since_epoch().count();
+	record.logger = this;
+	record.level = static_cast<uint32_t>(lvl);
+	record.length = 0;
+	return record;
+}
+
+void Logger::EndRecord(LogRecord& record)
+{
+	LogQueue::Get().Commit(record);
+}
@@ -1,11 +1,36 @@
 #pragma once
 #define FMT_HEADER_ONLY
 #include <fmt/core.h>
-#include <fstream>
-#include <chrono>
+
+// Levels below this are compiled out of the log macros, release builds keep info and above
+#ifndef GLEAM_LOG_LEVEL
+	#ifdef GDEBUG
+		#define GLEAM_LOG_LEVEL 0
+	#else
+		#define GLEAM_LOG_LEVEL 1
+	#endif
+#endif
 
 namespace Gleam {
 
+class Logger;
+
+// Message formatted on the logging thread, the writer thread only adds the timestamp and level
+struct LogRecord
+{
+	static constexpr size_t MaxLength = 480; // longer messages are truncated
+
+	int64_t time;
+	const Logger* logger;
+	uint32_t length;
+	uint32_t level;
+	char message[MaxLength];
+};
+
+/*
+* Log calls format into a slot of a lock-free ring shared by every logger and return
+* A background thread drains the ring and writes the records to Gleam.log in batches
+*/
 class Logger final
 {
 public:
@@ -21,29 +46,36 @@ public:
     };
 
 	Logger(const TString& name);
+
+	// Flushes, the records in the ring still point to the logger
     ~Logger();
     
 	static const Logger& GetCoreLogger();
 
 	static const Logger& GetClientLogger();
 
+	// Blocks until everything logged before the call is written, also done on shutdown and on a crash
+	static void Flush();
+
 	template<typename ... Args>
 	void Log(Level lvl, const TStringView frmt, Args&& ... args) const
 	{
-		auto currentTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-		char formattedCurrentTime[32];
-		std::strftime(formattedCurrentTime, 32, "%X", std::localtime(&currentTime));
-
-		std::ostringstream ss;
-		ss << '[' << formattedCurrentTime << "] ";
-		ss << LogLevelToString(lvl) << mName << fmt::format(fmt::runtime(frmt), std::forward<Args>(args)...) << '\n';
-
-		*mFileStream << ss.str();
-		std::flush(*mFileStream);
+		auto& record = BeginRecord(lvl);
+		RecordScope scope(record);
+		try
+		{
+			auto result = fmt::format_to_n(record.message, LogRecord::MaxLength, fmt::runtime(frmt), std::forward<Args>(args)...);
+			record.length = static_cast<uint32_t>(std::min(result.size, LogRecord::MaxLength));
+		}
+		catch (const fmt::format_error& error)
+		{
+			auto result = fmt::format_to_n(record.message, LogRecord::MaxLength, "invalid log format \"{0}\": {1}", frmt, error.what());
+			record.length = static_cast<uint32_t>(std::min(result.size, LogRecord::MaxLength));
+		}
 	}
-    
-private:
 
+	const TString& GetName() const;
+    
 	static constexpr TStringView LogLevelToString(Level lvl)
 	{
 		switch (lvl)
@@ -55,24 +87,58 @@ private:
 			default: return "[undefined] ";
 		}
 	};
+
+private:
+
+	// Ends the record however the log call leaves, a slot that is never ended stalls the writer
+	class RecordScope
+	{
+	public:
+
+		RecordScope(LogRecord& record)
+			: mRecord(record)
+		{
+
+		}
+
+		~RecordScope()
+		{
+			EndRecord(mRecord);
+		}
+
+	private:
+
+		LogRecord& mRecord;
+
+	};
+
+	// Claims the next slot of the ring, it is not written out until it is ended
+	LogRecord& BeginRecord(Level lvl) const;
+
+	static void EndRecord(LogRecord& record);
     
     TString mName;
     
-    static inline Scope<std::ofstream> mFileStream = nullptr;
-    static inline uint32_t mInstanceCount = 0;
-    
 };
 
 } // namespace Gleam
 
 // Core log macros
+#if GLEAM_LOG_LEVEL <= 0
 #define GLEAM_CORE_TRACE(...) ::Gleam::Logger::GetCoreLogger().Log(::Gleam::Logger::Level::Trace, __VA_ARGS__)
+#else
+#define GLEAM_CORE_TRACE(...) ((void)0)
+#endif
 #define GLEAM_CORE_INFO(...) ::Gleam::Logger::GetCoreLogger().Log(::Gleam::Logger::Level::Info, __VA_ARGS__)
 #define GLEAM_CORE_WARN(...) ::Gleam::Logger::GetCoreLogger().Log(::Gleam::Logger::Level::Warn, __VA_ARGS__)
 #define GLEAM_CORE_ERROR(...) ::Gleam::Logger::GetCoreLogger().Log(::Gleam::Logger::Level::Error, __VA_ARGS__)
 
 // Client log macros
+#if GLEAM_LOG_LEVEL <= 0
 #define GLEAM_TRACE(...) ::Gleam::Logger::GetClientLogger().Log(::Gleam::Logger::Level::Trace, __VA_ARGS__)
+#else
+#define GLEAM_TRACE(...) ((void)0)
+#endif
 #define GLEAM_INFO(...) ::Gleam::Logger::GetClientLogger().Log(::Gleam::Logger::Level::Info, __VA_ARGS__)
 #define GLEAM_WARN(...) ::Gleam::Logger::GetClientLogger().Log(::Gleam::Logger::Level::Warn, __VA_ARGS__)
 #define GLEAM_ERROR(...) ::Gleam::Logger::GetClientLogger().Log(::Gleam::Logger::Level::Error, __VA_ARGS__)
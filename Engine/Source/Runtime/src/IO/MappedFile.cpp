@@ -0,0 +1,137 @@
+#include "gpch.h"
+#include "MappedFile.h"
+
+#ifndef PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Gleam;
+
+MappedFile::MappedFile(const Filesystem::Path& path)
+{
+	bool empty = false;
+#ifdef PLATFORM_WINDOWS
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		GLEAM_CORE_ERROR("File could not be mapped: {0}", path.string());
+		return;
+	}
+
+	LARGE_INTEGER size;
+	bool sized = GetFileSizeEx(file, &size);
+	empty = sized && size.QuadPart == 0;
+	if (sized && size.QuadPart > 0)
+	{
+		// the view keeps the mapping alive, both handles can be closed right away
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			mData = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			mSize = mData ? static_cast<size_t>(size.QuadPart) : 0;
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file == -1)
+	{
+		GLEAM_CORE_ERROR("File could not be mapped: {0}", path.string());
+		return;
+	}
+
+	struct stat status;
+	bool sized = fstat(file, &status) == 0;
+	empty = sized && status.st_size == 0;
+	if (sized && status.st_size > 0)
+	{
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED)
+		{
+			mData = static_cast<const uint8_t*>(data);
+			mSize = static_cast<size_t>(status.st_size);
+		}
+	}
+	close(file);
+#endif
+
+	// an empty file has nothing to map, the view is just empty
+	if (mData == nullptr && empty == false)
+	{
+		GLEAM_CORE_ERROR("File could not be mapped: {0}", path.string());
+	}
+}
+
+MappedFile::MappedFile(RefCounted<const void> owner, const uint8_t* data, size_t size)
+	: mData(data), mSize(size), mOwner(std::move(owner))
+{
+
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: mData(other.mData), mSize(other.mSize), mOwner(std::move(other.mOwner))
+{
+	other.mData = nullptr;
+	other.mSize = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Unmap();
+		mData = other.mData;
+		mSize = other.mSize;
+		mOwner = std::move(other.mOwner);
+		other.mData = nullptr;
+		other.mSize = 0;
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	Unmap();
+}
+
+void MappedFile::Unmap()
+{
+	if (mData == nullptr)
+	{
+		return;
+	}
+
+	if (mOwner)
+	{
+		mOwner.reset();
+	}
+	else
+	{
+#ifdef PLATFORM_WINDOWS
+		UnmapViewOfFile(mData);
+#else
+		munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+	}
+	mData = nullptr;
+	mSize = 0;
+}
+
+const uint8_t* MappedFile::GetData() const
+{
+	return mData;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return mSize;
+}
+
+bool MappedFile::IsValid() const
+{
+	return mData != nullptr;
+}
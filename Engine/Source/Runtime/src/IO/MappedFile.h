@@ -0,0 +1,47 @@
+#pragma once
+
+namespace Gleam {
+
+/*
+* Read only memory mapped view of a whole file, unmapped on destruction
+* Can also view memory kept alive by an owner, such as a file inside a mounted archive
+*/
+class MappedFile final
+{
+public:
+
+	MappedFile() = default;
+
+	MappedFile(const Filesystem::Path& path);
+
+	MappedFile(RefCounted<const void> owner, const uint8_t* data, size_t size);
+
+	MappedFile(MappedFile&& other) noexcept;
+
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile();
+
+	const uint8_t* GetData() const;
+
+	size_t GetSize() const;
+
+	bool IsValid() const;
+
+private:
+
+	void Unmap();
+
+	const uint8_t* mData = nullptr;
+
+	size_t mSize = 0;
+
+	RefCounted<const void> mOwner; // null when the view is a mapping of its own
+
+};
+
+} // namespace Gleam
@@ -0,0 +1,444 @@
+#include "gpch.h"
+#include "PakArchive.h"
+#include "AsyncIO.h"
+#include "Compression.h"
+#include "File.h"
+#include "Core/ThreadPool.h"
+
+using namespace Gleam;
+
+static bool IsGuidString(const TString& str)
+{
+	// XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX
+	if (str.length() != 36)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < str.length(); i++)
+	{
+		bool separator = i == 8 || i == 13 || i == 18 || i == 23;
+		if (separator ? str[i] != '-' : IsValidHexChar(str[i]) == false)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Orders entries by guid bytes, then by extension
+struct PakKeyOrder
+{
+	static int Compare(const TArray<uint8_t, 16>& lhsGuid, uint64_t lhsExtension, const TArray<uint8_t, 16>& rhsGuid, uint64_t rhsExtension)
+	{
+		int order = memcmp(lhsGuid.data(), rhsGuid.data(), lhsGuid.size());
+		if (order != 0)
+			return order;
+		return lhsExtension < rhsExtension ? -1 : lhsExtension > rhsExtension;
+	}
+
+	bool operator()(const PakEntry& lhs, const PakEntry& rhs) const
+	{
+		return Compare(lhs.guid, lhs.extension, rhs.guid, rhs.extension) < 0;
+	}
+
+	bool operator()(const PakEntry& entry, const Tuple<Guid, uint64_t>& key) const
+	{
+		return Compare(entry.guid, entry.extension, std::get<0>(key).GetBytes(), std::get<1>(key)) < 0;
+	}
+
+	bool operator()(const Tuple<Guid, uint64_t>& key, const PakEntry& entry) const
+	{
+		return Compare(std::get<0>(key).GetBytes(), std::get<1>(key), entry.guid, entry.extension) < 0;
+	}
+};
+
+static uint64_t GetBlockCount(const PakEntry& entry, uint32_t blockSize)
+{
+	return entry.compression == PakCompression::LZ4 ? (entry.size + blockSize - 1) / blockSize : 0;
+}
+
+// Shared by every mounted archive, loader threads decoding at the same time take turns on it
+static ThreadPool& GetDecodeThreads()
+{
+	static ThreadPool threads;
+	return threads;
+}
+
+Tuple<Guid, uint64_t> PakArchive::MakeKey(const Filesystem::Path& relativePath)
+{
+	auto extension = relativePath.extension().string();
+	uint64_t extensionHash = Hash64(extension.data(), extension.size());
+
+	auto stem = relativePath.stem().string();
+	if (IsGuidString(stem))
+	{
+		return { Guid(stem), extensionHash };
+	}
+
+	// indices and graphs are not named by a guid, their path stands in for one
+	auto path = relativePath.generic_string();
+	TArray<uint8_t, 16> bytes;
+	uint64_t low = Hash64(path.data(), path.size());
+	uint64_t high = Hash64(path.data(), path.size(), low);
+	memcpy(bytes.data(), &low, sizeof(uint64_t));
+	memcpy(bytes.data() + sizeof(uint64_t), &high, sizeof(uint64_t));
+	return { Guid(bytes), extensionHash };
+}
+
+PakArchive::PakArchive(const Filesystem::Path& path)
+	: mArchivePath(path), mFile(CreateRef<MappedFile>(path))
+{
+	if (mFile->IsValid() == false)
+	{
+		return;
+	}
+
+	const uint8_t* data = mFile->GetData();
+	size_t size = mFile->GetSize();
+	const auto* header = reinterpret_cast<const PakHeader*>(data);
+	if (size < sizeof(PakHeader) || header->magic != Magic || header->version != Version || header->blockSize == 0)
+	{
+		GLEAM_CORE_ERROR("Archive is not a pak of version {0}: {1}", Version, path.string());
+		return;
+	}
+
+	// a truncated archive is rejected here, so entries can be mapped without further checks
+	uint64_t entriesSize = uint64_t(header->entryCount) * sizeof(PakEntry);
+	uint64_t blocksSize = header->blockCount * sizeof(uint32_t);
+	if (header->tableOffset % alignof(PakEntry) != 0 || header->tableOffset > size ||
+		entriesSize + blocksSize + header->pathsSize > size - header->tableOffset)
+	{
+		GLEAM_CORE_ERROR("Archive table of contents is corrupted: {0}", path.string());
+		return;
+	}
+
+	const auto* entries = reinterpret_cast<const PakEntry*>(data + header->tableOffset);
+	const auto* blocks = reinterpret_cast<const uint32_t*>(data + header->tableOffset + entriesSize);
+	for (uint32_t i = 0; i < header->entryCount; i++)
+	{
+		const auto& entry = entries[i];
+		uint64_t blockCount = GetBlockCount(entry, header->blockSize);
+		uint64_t storedSize = entry.compression == PakCompression::LZ4 ? 0 : entry.size;
+		for (uint64_t block = 0; block < blockCount && entry.firstBlock + block < header->blockCount; block++)
+		{
+			storedSize += blocks[entry.firstBlock + block];
+		}
+
+		if (entry.offset > header->tableOffset || entry.storedSize > header->tableOffset - entry.offset || storedSize != entry.storedSize ||
+			entry.firstBlock + blockCount > header->blockCount || uint64_t(entry.pathOffset) + entry.pathLength > header->pathsSize)
+		{
+			GLEAM_CORE_ERROR("Archive entry {0} is corrupted: {1}", i, path.string());
+			return;
+		}
+	}
+
+	mHeader = header;
+	mEntries = entries;
+	mBlocks = blocks;
+	mPaths = reinterpret_cast<const char*>(blocks + header->blockCount);
+
+	// a new directory is linked into its parent, up to the first one that already existed
+	mDirectories.try_emplace(TString());
+	for (uint32_t i = 0; i < header->entryCount; i++)
+	{
+		auto file = GetPath(entries[i]);
+		size_t separator = file.rfind('/');
+		TString directory(separator == TStringView::npos ? TStringView() : file.substr(0, separator));
+
+		auto [it, inserted] = mDirectories.try_emplace(directory);
+		it->second.files.push_back(i);
+		while (inserted && directory.empty() == false)
+		{
+			separator = directory.rfind('/');
+			TString parent = separator == TString::npos ? TString() : directory.substr(0, separator);
+			TString name = directory.substr(separator == TString::npos ? 0 : separator + 1);
+
+			auto [parentIt, parentInserted] = mDirectories.try_emplace(parent);
+			parentIt->second.directories.push_back(std::move(name));
+			directory = std::move(parent);
+			inserted = parentInserted;
+		}
+	}
+}
+
+bool PakArchive::IsValid() const
+{
+	return mHeader != nullptr;
+}
+
+const PakEntry* PakArchive::Find(const Filesystem::Path& relativePath) const
+{
+	if (IsValid() == false)
+	{
+		return nullptr;
+	}
+
+	// the key narrows it down, the path settles files that share a guid in different directories
+	auto normalPath = relativePath.lexically_normal();
+	auto path = normalPath.generic_string();
+	auto [first, last] = std::equal_range(mEntries, mEntries + mHeader->entryCount, MakeKey(normalPath), PakKeyOrder());
+	for (auto it = first; it != last; ++it)
+	{
+		if (GetPath(*it) == path)
+		{
+			return it;
+		}
+	}
+	return nullptr;
+}
+
+const PakEntry* PakArchive::Find(const Guid& guid, TStringView extension) const
+{
+	if (IsValid() == false)
+	{
+		return nullptr;
+	}
+
+	Tuple<Guid, uint64_t> key = { guid, Hash64(extension.data(), extension.size()) };
+	auto it = std::lower_bound(mEntries, mEntries + mHeader->entryCount, key, PakKeyOrder());
+	return it != mEntries + mHeader->entryCount && PakKeyOrder()(key, *it) == false ? it : nullptr;
+}
+
+MappedFile PakArchive::Map(const PakEntry& entry) const
+{
+	const uint8_t* stored = mFile->GetData() + entry.offset;
+	if (entry.compression == PakCompression::None)
+	{
+		return MappedFile(mFile, stored, entry.size);
+	}
+
+	uint32_t index = static_cast<uint32_t>(&entry - mEntries);
+	{
+		std::lock_guard<std::mutex> lock(mDecodeMutex);
+		auto it = mDecoded.find(index);
+		if (it != mDecoded.end())
+		{
+			if (auto decoded = it->second.lock())
+			{
+				const uint8_t* data = decoded->GetData();
+				return MappedFile(std::move(decoded), data, entry.size);
+			}
+			mDecoded.erase(it);
+		}
+	}
+
+	uint32_t blockCount = static_cast<uint32_t>(GetBlockCount(entry, mHeader->blockSize));
+	TArray<uint64_t> blockOffsets(blockCount);
+	for (uint32_t i = 1; i < blockCount; i++)
+	{
+		blockOffsets[i] = blockOffsets[i - 1] + mBlocks[entry.firstBlock + i - 1];
+	}
+
+	auto buffer = CreateRef<IOBuffer>(entry.size);
+	std::atomic<bool> failed = false;
+	auto decode = [&](uint32_t i)
+	{
+		const uint8_t* src = stored + blockOffsets[i];
+		uint32_t srcSize = mBlocks[entry.firstBlock + i];
+		uint8_t* dst = buffer->GetData() + uint64_t(i) * mHeader->blockSize;
+		size_t dstSize = Math::Min(entry.size - uint64_t(i) * mHeader->blockSize, uint64_t(mHeader->blockSize));
+
+		// blocks that did not shrink are stored as they are
+		if (srcSize == dstSize)
+		{
+			memcpy(dst, src, dstSize);
+		}
+		else if (LZ4::Decompress(src, srcSize, dst, dstSize) == false)
+		{
+			failed = true;
+		}
+	};
+
+	if (blockCount > 1)
+	{
+		GetDecodeThreads().ParallelFor(blockCount, decode);
+	}
+	else if (blockCount == 1)
+	{
+		decode(0);
+	}
+
+	if (failed)
+	{
+		GLEAM_CORE_ERROR("Archive entry could not be decompressed: {0}", GetPath(entry));
+		return MappedFile();
+	}
+	{
+		std::lock_guard<std::mutex> lock(mDecodeMutex);
+		mDecoded[index] = buffer;
+		mRecentlyDecoded.push_back(buffer);
+		mRecentlyDecodedSize += buffer->GetCapacity();
+		while (mRecentlyDecodedSize > DecodeCacheSize && mRecentlyDecoded.size() > 1)
+		{
+			mRecentlyDecodedSize -= mRecentlyDecoded.front()->GetCapacity();
+			mRecentlyDecoded.pop_front();
+		}
+	}
+
+	const uint8_t* data = buffer->GetData();
+	return MappedFile(std::move(buffer), data, entry.size);
+}
+
+const PakDirectory* PakArchive::FindDirectory(TStringView relativePath) const
+{
+	if (relativePath == ".")
+	{
+		relativePath = TStringView();
+	}
+
+	auto it = mDirectories.find(TString(relativePath));
+	return it != mDirectories.end() ? &it->second : nullptr;
+}
+
+TStringView PakArchive::GetPath(const PakEntry& entry) const
+{
+	return TStringView(mPaths + entry.pathOffset, entry.pathLength);
+}
+
+uint32_t PakArchive::GetEntryCount() const
+{
+	return IsValid() ? mHeader->entryCount : 0;
+}
+
+const PakEntry& PakArchive::GetEntry(uint32_t index) const
+{
+	GLEAM_ASSERT(index < GetEntryCount(), "Archive entry index is out of range!");
+	return mEntries[index];
+}
+
+const Filesystem::Path& PakArchive::GetArchivePath() const
+{
+	return mArchivePath;
+}
+
+// PakWriter
+
+PakWriter::PakWriter(PakCompression compression)
+	: mCompression(compression)
+{
+
+}
+
+void PakWriter::Add(const Filesystem::Path& source, const Filesystem::Path& relativePath)
+{
+	mSources.push_back({ .source = source, .relativePath = relativePath.lexically_normal() });
+	mSize += Filesystem::FileSize(source);
+}
+
+uint64_t PakWriter::GetSize() const
+{
+	return mSize;
+}
+
+uint32_t PakWriter::GetFileCount() const
+{
+	return static_cast<uint32_t>(mSources.size());
+}
+
+bool PakWriter::Write(const Filesystem::Path& path, ThreadPool& threads) const
+{
+	auto accessor = Filesystem::WriteAccessor(path);
+	auto file = Filesystem::Create(path, FileType::Binary);
+	auto& stream = file.GetStream();
+
+	auto pad = [&stream](size_t alignment)
+	{
+		static const char zeros[PakArchive::Alignment] = {};
+		auto position = static_cast<size_t>(stream.tellp());
+		stream.write(zeros, (alignment - position % alignment) % alignment);
+	};
+
+	PakHeader header;
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(PakHeader));
+
+	TArray<PakEntry> entries;
+	TArray<uint32_t> blocks;
+	TString paths;
+	entries.reserve(mSources.size());
+	for (const auto& source : mSources)
+	{
+		// read straight from disk, a mounted archive must not stand in for the files it is rebuilt from
+		uint64_t size = Filesystem::FileSize(source.source);
+		MappedFile mapped = size > 0 ? MappedFile(source.source) : MappedFile();
+		if (size > 0 && mapped.IsValid() == false)
+		{
+			return false;
+		}
+
+		auto path = source.relativePath.generic_string();
+		auto [guid, extension] = PakArchive::MakeKey(source.relativePath);
+		auto& entry = entries.emplace_back();
+		entry.guid = guid.GetBytes();
+		entry.extension = extension;
+		entry.size = mapped.GetSize();
+		entry.modifiedTime = Filesystem::LastWriteTime(source.source);
+		entry.pathOffset = static_cast<uint32_t>(paths.size());
+		entry.pathLength = static_cast<uint16_t>(path.size());
+		paths += path;
+
+		pad(PakArchive::Alignment);
+		entry.offset = static_cast<uint64_t>(stream.tellp());
+
+		uint32_t blockCount = static_cast<uint32_t>((entry.size + PakArchive::BlockSize - 1) / PakArchive::BlockSize);
+		TArray<TArray<uint8_t>> compressed(mCompression == PakCompression::LZ4 ? blockCount : 0);
+		threads.ParallelFor(static_cast<uint32_t>(compressed.size()), [&](uint32_t i)
+		{
+			const uint8_t* src = mapped.GetData() + uint64_t(i) * PakArchive::BlockSize;
+			size_t srcSize = Math::Min(entry.size - uint64_t(i) * PakArchive::BlockSize, uint64_t(PakArchive::BlockSize));
+
+			// a block that does not shrink is kept as it is, the reader tells them apart by size
+			compressed[i].resize(LZ4::CompressBound(srcSize));
+			size_t size = LZ4::Compress(src, srcSize, compressed[i].data(), compressed[i].size());
+			if (size == 0 || size >= srcSize)
+			{
+				compressed[i].assign(src, src + srcSize);
+			}
+			else
+			{
+				compressed[i].resize(size);
+			}
+		});
+
+		uint64_t compressedSize = 0;
+		for (const auto& block : compressed)
+		{
+			compressedSize += block.size();
+		}
+
+		if (compressed.empty() || compressedSize >= entry.size)
+		{
+			entry.compression = PakCompression::None;
+			entry.storedSize = entry.size;
+			stream.write(reinterpret_cast<const char*>(mapped.GetData()), entry.size);
+			continue;
+		}
+
+		entry.compression = PakCompression::LZ4;
+		entry.storedSize = compressedSize;
+		entry.firstBlock = blocks.size();
+		for (const auto& block : compressed)
+		{
+			blocks.push_back(static_cast<uint32_t>(block.size()));
+			stream.write(reinterpret_cast<const char*>(block.data()), block.size());
+		}
+	}
+
+	std::sort(entries.begin(), entries.end(), PakKeyOrder());
+
+	pad(alignof(PakEntry));
+	header.magic = PakArchive::Magic;
+	header.version = PakArchive::Version;
+	header.entryCount = static_cast<uint32_t>(entries.size());
+	header.blockSize = PakArchive::BlockSize;
+	header.blockCount = blocks.size();
+	header.pathsSize = paths.size();
+	header.tableOffset = static_cast<uint64_t>(stream.tellp());
+	stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PakEntry));
+	stream.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(uint32_t));
+	stream.write(paths.data(), paths.size());
+
+	stream.seekp(0);
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(PakHeader));
+	return stream.good();
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include "MappedFile.h"
+
+#include <mutex>
+
+namespace Gleam {
+
+class IOBuffer;
+class ThreadPool;
+
+enum class PakCompression : uint8_t
+{
+	None,
+	LZ4
+};
+
+struct PakHeader
+{
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t entryCount = 0;
+	uint32_t blockSize = 0;
+	uint64_t blockCount = 0;
+	uint64_t pathsSize = 0;
+	uint64_t tableOffset = 0; // entries, then compressed block sizes, then paths
+};
+
+struct PakEntry
+{
+	TArray<uint8_t, 16> guid; // of the asset, or derived from the path for files that are not named by one
+	uint64_t extension = 0; // an asset and its sidecar share the guid, the extension tells them apart
+	uint64_t offset = 0;
+	uint64_t size = 0;
+	uint64_t storedSize = 0;
+	uint64_t modifiedTime = 0; // of the cooked file, so indices built from loose files stay valid
+	uint64_t firstBlock = 0;
+	uint32_t pathOffset = 0;
+	uint16_t pathLength = 0;
+	PakCompression compression = PakCompression::None;
+	uint8_t padding = 0;
+};
+static_assert(std::is_trivially_copyable_v<PakEntry> && sizeof(PakEntry) == 72);
+
+// Directories are not stored in an archive, they are collected from the entry paths when it is opened
+struct PakDirectory
+{
+	TArray<uint32_t> files; // indices of the entries directly in the directory
+	TArray<TString> directories; // names of the subdirectories
+};
+
+/*
+* Read only archive of cooked files, mapped once and looked up through a table sorted by guid and extension
+* Every file starts on a page boundary, stored files are handed out as views of the archive mapping
+* Compressed files are split into independent blocks that are decoded in parallel
+* Decoded files are shared while mapped, and the most recent ones are kept up to DecodeCacheSize after they are unmapped
+*/
+class PakArchive final
+{
+public:
+
+	GLEAM_NONCOPYABLE(PakArchive);
+
+	static constexpr uint32_t Magic = 0x4B415047; // GPAK
+
+	static constexpr uint32_t Version = 1;
+
+	static constexpr size_t Alignment = 4096;
+
+	static constexpr uint32_t BlockSize = 64 * 1024;
+
+	static constexpr size_t DecodeCacheSize = 32 * 1024 * 1024;
+
+	static constexpr TStringView Extension()
+	{
+		return ".pak";
+	}
+
+	// Key of a path relative to the mount point
+	static Tuple<Guid, uint64_t> MakeKey(const Filesystem::Path& relativePath);
+
+	PakArchive(const Filesystem::Path& path);
+
+	bool IsValid() const;
+
+	const PakEntry* Find(const Filesystem::Path& relativePath) const;
+
+	// Returns the first entry of the guid if it is not unique within the extension
+	const PakEntry* Find(const Guid& guid, TStringView extension) const;
+
+	// Read only view of the whole file, null if it cannot be decoded
+	MappedFile Map(const PakEntry& entry) const;
+
+	// Path relative to the mount point in generic form, empty or "." for the root, null if no file is under it
+	const PakDirectory* FindDirectory(TStringView relativePath) const;
+
+	TStringView GetPath(const PakEntry& entry) const;
+
+	uint32_t GetEntryCount() const;
+
+	const PakEntry& GetEntry(uint32_t index) const;
+
+	const Filesystem::Path& GetArchivePath() const;
+
+private:
+
+	Filesystem::Path mArchivePath;
+
+	RefCounted<MappedFile> mFile;
+
+	const PakHeader* mHeader = nullptr;
+
+	const PakEntry* mEntries = nullptr;
+
+	const uint32_t* mBlocks = nullptr;
+
+	const char* mPaths = nullptr;
+
+	HashMap<TString, PakDirectory> mDirectories;
+
+	mutable std::mutex mDecodeMutex;
+
+	// keyed by entry index, alive as long as a mapping of the entry is
+	mutable HashMap<uint32_t, WeakPtr<IOBuffer>> mDecoded;
+
+	// keeps the most recently decoded entries alive after they are unmapped
+	mutable Deque<RefCounted<IOBuffer>> mRecentlyDecoded;
+
+	mutable size_t mRecentlyDecodedSize = 0;
+
+};
+
+/*
+* Packs files into a PakArchive, the files are only read while the archive is written
+*/
+class PakWriter final
+{
+public:
+
+	PakWriter(PakCompression compression = PakCompression::LZ4);
+
+	// relativePath is what the file is found by once the archive is mounted
+	void Add(const Filesystem::Path& source, const Filesystem::Path& relativePath);
+
+	// Total size of the added files before compression
+	uint64_t GetSize() const;
+
+	uint32_t GetFileCount() const;
+
+	// Blocks of every file are compressed on the given threads
+	bool Write(const Filesystem::Path& path, ThreadPool& threads) const;
+
+private:
+
+	struct Source
+	{
+		Filesystem::Path source;
+		Filesystem::Path relativePath;
+	};
+
+	TArray<Source> mSources;
+
+	uint64_t mSize = 0;
+
+	PakCompression mCompression;
+
+};
+
+} // namespace Gleam
@@ -31,6 +31,51 @@ struct BoundingBox
         
     }
     
+    NO_DISCARD FORCE_INLINE constexpr BoundingBox Transform(const Float4x4& transform) const
+    {
+        const auto& m = transform.m;
+        Float3 center = (min + max) * 0.5f;
+        Float3 extent = (max - min) * 0.5f;
+        Float3 worldExtent
+        {
+            Math::Abs(m[0]) * extent.x + Math::Abs(m[4]) * extent.y + Math::Abs(m[8]) * extent.z,
+            Math::Abs(m[1]) * extent.x + Math::Abs(m[5]) * extent.y + Math::Abs(m[9]) * extent.z,
+            Math::Abs(m[2]) * extent.x + Math::Abs(m[6]) * extent.y + Math::Abs(m[10]) * extent.z
+        };
+        Float3 worldCenter = transform * center;
+        return BoundingBox(worldCenter - worldExtent, worldCenter + worldExtent);
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr BoundingBox Merge(const BoundingBox& other) const
+    {
+        return BoundingBox(Math::Min(min, other.min), Math::Max(max, other.max));
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr float SurfaceArea() const
+    {
+        Float3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr bool Contains(const BoundingBox& other) const
+    {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z
+            && max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr bool Intersects(const BoundingBox& other) const
+    {
+        return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z
+            && max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr bool Intersects(const BoundingSphere& sphere) const
+    {
+        Float3 closest = Math::Max(min, Math::Min(sphere.center, max));
+        Float3 offset = closest - sphere.center;
+        return Math::Dot(offset, offset) <= sphere.radius * sphere.radius;
+    }
+    
 };
 
 } // namespace Gleam
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace Gleam {
+
+struct BoundingSphere
+{
+    Float3 center = Float3::zero;
+    float radius = 0.0f;
+    
+    constexpr BoundingSphere() = default;
+    constexpr BoundingSphere(BoundingSphere&&) noexcept = default;
+    constexpr BoundingSphere(const BoundingSphere&) = default;
+    FORCE_INLINE constexpr BoundingSphere& operator=(BoundingSphere&&) noexcept = default;
+    FORCE_INLINE constexpr BoundingSphere& operator=(const BoundingSphere&) = default;
+    
+    constexpr BoundingSphere(const Float3& center, float radius)
+        : center(center), radius(radius)
+    {
+        
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr BoundingSphere Transform(const Float4x4& transform) const
+    {
+        float scaleX = Math::Dot(Float3(transform.m[0], transform.m[1], transform.m[2]), Float3(transform.m[0], transform.m[1], transform.m[2]));
+        float scaleY = Math::Dot(Float3(transform.m[4], transform.m[5], transform.m[6]), Float3(transform.m[4], transform.m[5], transform.m[6]));
+        float scaleZ = Math::Dot(Float3(transform.m[8], transform.m[9], transform.m[10]), Float3(transform.m[8], transform.m[9], transform.m[10]));
+        float maxScale = Math::Sqrt(Math::Max(scaleX, Math::Max(scaleY, scaleZ)));
+        return BoundingSphere(transform * center, radius * maxScale);
+    }
+    
+};
+
+} // namespace Gleam
+
+GLEAM_TYPE(Gleam::BoundingSphere, Guid("5E4DC1E6-8C9A-4D7C-BA07-8D3D63143FC3"))
+    GLEAM_FIELD(center, Serializable())
+    GLEAM_FIELD(radius, Serializable())
+GLEAM_END
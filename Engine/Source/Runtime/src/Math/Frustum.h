@@ -0,0 +1,79 @@
+#pragma once
+
+namespace Gleam {
+
+struct Frustum
+{
+    enum Plane
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        COUNT
+    };
+    
+    // xyz: inward facing unit normal, w: distance
+    TArray<Float4, Plane::COUNT> planes{};
+    
+    constexpr Frustum() = default;
+    constexpr Frustum(Frustum&&) noexcept = default;
+    constexpr Frustum(const Frustum&) = default;
+    FORCE_INLINE constexpr Frustum& operator=(Frustum&&) noexcept = default;
+    FORCE_INLINE constexpr Frustum& operator=(const Frustum&) = default;
+    
+    // Extracts the planes of a left handed view projection matrix with 0..1 depth range
+    constexpr Frustum(const Float4x4& viewProjection)
+    {
+        const auto& m = viewProjection.m;
+        Float4 column0(m[0], m[4], m[8], m[12]);
+        Float4 column1(m[1], m[5], m[9], m[13]);
+        Float4 column2(m[2], m[6], m[10], m[14]);
+        Float4 column3(m[3], m[7], m[11], m[15]);
+        
+        planes[Left] = column3 + column0;
+        planes[Right] = column3 - column0;
+        planes[Bottom] = column3 + column1;
+        planes[Top] = column3 - column1;
+        planes[Near] = column2;
+        planes[Far] = column3 - column2;
+        
+        for (auto& plane : planes)
+        {
+            float invLength = 1.0f / Math::Length(Float3(plane.x, plane.y, plane.z));
+            plane = plane * invLength;
+        }
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr bool Intersects(const BoundingSphere& sphere) const
+    {
+        for (const auto& plane : planes)
+        {
+            if (Math::Dot(Float3(plane.x, plane.y, plane.z), sphere.center) + plane.w < -sphere.radius)
+                return false;
+        }
+        return true;
+    }
+    
+    NO_DISCARD FORCE_INLINE constexpr bool Intersects(const BoundingBox& box) const
+    {
+        for (const auto& plane : planes)
+        {
+            Float3 positive
+            {
+                plane.x >= 0.0f ? box.max.x : box.min.x,
+                plane.y >= 0.0f ? box.max.y : box.min.y,
+                plane.z >= 0.0f ? box.max.z : box.min.z
+            };
+            
+            if (Math::Dot(Float3(plane.x, plane.y, plane.z), positive) + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+    
+};
+
+} // namespace Gleam
@@ -0,0 +1,59 @@
+#include "gpch.h"
+#include "ClusterCulling.h"
+
+using namespace Gleam;
+
+bool ClusterCulling::IsVisible(const MeshletDescriptor& meshlet, const Float4x4& transform, const Float4x4& inverseTransform, const Frustum& frustum, const Float3& eye, bool backfaceCulling)
+{
+    auto bounds = meshlet.bounds.Transform(transform);
+    if (!frustum.Intersects(bounds))
+        return false;
+    
+    if (!backfaceCulling || meshlet.coneCutoff >= 1.0f)
+        return true;
+    
+    // multiplying by the transposed inverse keeps the axis perpendicular to the surface under non-uniform scale
+    const auto& m = inverseTransform.m;
+    Float3 axis
+    {
+        meshlet.coneAxis.x * m[0] + meshlet.coneAxis.y * m[1] + meshlet.coneAxis.z * m[2],
+        meshlet.coneAxis.x * m[4] + meshlet.coneAxis.y * m[5] + meshlet.coneAxis.z * m[6],
+        meshlet.coneAxis.x * m[8] + meshlet.coneAxis.y * m[9] + meshlet.coneAxis.z * m[10]
+    };
+    axis = Math::Normalize(axis);
+    
+    Float3 view = bounds.center - eye;
+    return Math::Dot(view, axis) < meshlet.coneCutoff * Math::Length(view) + bounds.radius;
+}
+
+void ClusterCulling::Cull(const TArray<MeshletDescriptor>& meshlets, const SubmeshDescriptor& submesh, const Float4x4& transform, const Frustum& frustum, const Float3& eye, TArray<IndexRange>& ranges, bool backfaceCulling)
+{
+    if (submesh.meshletCount == 0)
+    {
+        ranges.push_back({ submesh.firstIndex, submesh.indexCount });
+        return;
+    }
+    
+    // only needed for the cone test, computed once for all meshlets of the submesh
+    Float4x4 inverseTransform = backfaceCulling ? Math::Inverse(transform) : Float4x4::identity;
+    
+    uint32_t rangeStart = static_cast<uint32_t>(ranges.size());
+    for (uint32_t i = submesh.firstMeshlet; i < submesh.firstMeshlet + submesh.meshletCount; ++i)
+    {
+        const auto& meshlet = meshlets[i];
+        if (!IsVisible(meshlet, transform, inverseTransform, frustum, eye, backfaceCulling))
+            continue;
+        
+        if (ranges.size() > rangeStart)
+        {
+            auto& last = ranges.back();
+            uint32_t lastIndex = last.firstIndex + last.indexCount;
+            if (meshlet.firstIndex >= lastIndex && meshlet.firstIndex - lastIndex <= MaxMergeGap)
+            {
+                last.indexCount = meshlet.firstIndex + meshlet.indexCount - last.firstIndex;
+                continue;
+            }
+        }
+        ranges.push_back({ meshlet.firstIndex, meshlet.indexCount });
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "MeshDescriptor.h"
+
+namespace Gleam {
+
+struct IndexRange
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+class ClusterCulling
+{
+public:
+    
+    // Gaps of at most this many culled indices are drawn anyway to keep the visible meshlets in a single draw
+    static constexpr uint32_t MaxMergeGap = MeshletDescriptor::MaxTriangleCount * 3;
+    
+    // Cone axes are normals, they are transformed by the inverse transpose, which is passed as the inverse of the transform
+    static bool IsVisible(const MeshletDescriptor& meshlet, const Float4x4& transform, const Float4x4& inverseTransform, const Frustum& frustum, const Float3& eye, bool backfaceCulling = true);
+    
+    // Appends the index ranges of visible meshlets, merging meshlets that are adjacent in the index buffer or separated by at most MaxMergeGap indices
+    // Submeshes without meshlets are emitted as a single range
+    static void Cull(const TArray<MeshletDescriptor>& meshlets, const SubmeshDescriptor& submesh, const Float4x4& transform, const Frustum& frustum, const Float3& eye, TArray<IndexRange>& ranges, bool backfaceCulling = true);
+    
+};
+
+} // namespace Gleam
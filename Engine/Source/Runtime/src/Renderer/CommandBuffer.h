@@ -3,6 +3,7 @@
 #include "Buffer.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "IndexType.h"
 #include "RenderGraph/RenderGraphResource.h"
 
 namespace Gleam {
@@ -12,22 +13,6 @@ struct PipelineStateDescriptor;
 
 class GraphicsDevice;
 
-enum class IndexType
-{
-    UINT16,
-    UINT32
-};
-
-static constexpr size_t SizeOfIndexType(IndexType indexType)
-{
-    switch (indexType)
-    {
-        case IndexType::UINT16: return sizeof(uint16_t);
-        case IndexType::UINT32: return sizeof(uint32_t);
-        default: return 0;
-    }
-}
-
 class CommandBuffer final
 {
 public:
@@ -85,6 +70,9 @@ public:
 
     void SetBufferData(const Buffer& buffer, const void* data, size_t size, size_t offset = 0) const;
 
+    // Uploads a tightly packed mip level, the staging memory is released with the frame
+    void SetTextureData(const Texture& texture, const void* data, size_t size, uint32_t mipLevel = 0) const;
+
     void Blit(const Texture& source, const Texture& destination) const;
 
     void Begin() const;
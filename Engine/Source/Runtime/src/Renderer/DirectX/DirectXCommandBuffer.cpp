@@ -238,6 +238,53 @@ void CommandBuffer::CopyBuffer(const NativeGraphicsHandle src, const NativeGraph
 	DirectXTransitionManager::TransitionLayout(mHandle->commandList, dstBuffer, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
 }
 
+void CommandBuffer::SetTextureData(const Texture& texture, const void* data, size_t size, uint32_t mipLevel) const
+{
+	auto dstTexture = static_cast<ID3D12Resource*>(texture.GetHandle());
+	auto resourceDesc = dstTexture->GetDesc();
+
+	// staging rows are padded to the pitch alignment of the copy engine
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {};
+	UINT rowCount = 0;
+	UINT64 rowSize = 0;
+	UINT64 stagingSize = 0;
+	static_cast<ID3D12Device10*>(mHandle->device->GetHandle())->GetCopyableFootprints(&resourceDesc, mipLevel, 1, 0, &footprint, &rowCount, &rowSize, &stagingSize);
+
+	HeapDescriptor heapDesc;
+	heapDesc.name = "CommandBuffer::TextureStagingHeap";
+	heapDesc.memoryType = MemoryType::CPU;
+	heapDesc.size = stagingSize;
+	Heap stagingHeap = mDevice->CreateHeap(heapDesc);
+
+	BufferDescriptor bufferDesc;
+	bufferDesc.name = "StagingBuffer";
+	bufferDesc.size = stagingSize;
+	Buffer stagingBuffer = stagingHeap.CreateBuffer(bufferDesc);
+
+	size_t srcRowPitch = Math::Min(static_cast<size_t>(rowSize), size / rowCount);
+	for (UINT row = 0; row < rowCount; ++row)
+	{
+		memcpy(static_cast<uint8_t*>(stagingBuffer.GetContents()) + row * footprint.Footprint.RowPitch, static_cast<const uint8_t*>(data) + row * srcRowPitch, srcRowPitch);
+	}
+
+	D3D12_TEXTURE_COPY_LOCATION dst{};
+	dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	dst.pResource = dstTexture;
+	dst.SubresourceIndex = mipLevel;
+
+	D3D12_TEXTURE_COPY_LOCATION src{};
+	src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+	src.pResource = static_cast<ID3D12Resource*>(stagingBuffer.GetHandle());
+	src.PlacedFootprint = footprint;
+
+	DirectXTransitionManager::TransitionLayout(mHandle->commandList, dstTexture, D3D12_RESOURCE_STATE_COPY_DEST);
+	mHandle->commandList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+	DirectXTransitionManager::TransitionLayout(mHandle->commandList, dstTexture, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
+
+	mDevice->ReleaseBuffer(stagingBuffer);
+	mDevice->ReleaseHeap(stagingHeap);
+}
+
 void CommandBuffer::Blit(const Texture& source, const Texture& destination) const
 {
     auto swapchainTarget = destination.IsValid() == false;
@@ -110,6 +110,15 @@ static constexpr TextureFormat DXGI_FORMATtoTextureFormat(DXGI_FORMAT format)
         case DXGI_FORMAT_D24_UNORM_S8_UINT: return TextureFormat::D24_UNorm_S8_UInt;
 		case DXGI_FORMAT_D32_FLOAT_S8X24_UINT: return TextureFormat::D32_SFloat_S8_UInt;
 
+		// Block compressed formats
+		case DXGI_FORMAT_BC1_UNORM: return TextureFormat::BC1_RGBA_UNorm;
+		case DXGI_FORMAT_BC1_UNORM_SRGB: return TextureFormat::BC1_RGBA_SRGB;
+		case DXGI_FORMAT_BC3_UNORM: return TextureFormat::BC3_RGBA_UNorm;
+		case DXGI_FORMAT_BC3_UNORM_SRGB: return TextureFormat::BC3_RGBA_SRGB;
+		case DXGI_FORMAT_BC5_UNORM: return TextureFormat::BC5_RG_UNorm;
+		case DXGI_FORMAT_BC7_UNORM: return TextureFormat::BC7_RGBA_UNorm;
+		case DXGI_FORMAT_BC7_UNORM_SRGB: return TextureFormat::BC7_RGBA_SRGB;
+
 		default: return TextureFormat::None;
 	}
 }
@@ -177,6 +186,15 @@ static constexpr DXGI_FORMAT TextureFormatToDXGI_FORMAT(TextureFormat format)
         case TextureFormat::D24_UNorm_S8_UInt: return DXGI_FORMAT_D24_UNORM_S8_UINT;
 		case TextureFormat::D32_SFloat_S8_UInt: return DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
 
+		// Block compressed formats
+		case TextureFormat::BC1_RGBA_UNorm: return DXGI_FORMAT_BC1_UNORM;
+		case TextureFormat::BC1_RGBA_SRGB: return DXGI_FORMAT_BC1_UNORM_SRGB;
+		case TextureFormat::BC3_RGBA_UNorm: return DXGI_FORMAT_BC3_UNORM;
+		case TextureFormat::BC3_RGBA_SRGB: return DXGI_FORMAT_BC3_UNORM_SRGB;
+		case TextureFormat::BC5_RG_UNorm: return DXGI_FORMAT_BC5_UNORM;
+		case TextureFormat::BC7_RGBA_UNorm: return DXGI_FORMAT_BC7_UNORM;
+		case TextureFormat::BC7_RGBA_SRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
+
 		default: return DXGI_FORMAT_UNKNOWN;
 	}
 }
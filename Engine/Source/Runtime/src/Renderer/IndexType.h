@@ -0,0 +1,23 @@
+#pragma once
+
+namespace Gleam {
+
+enum class IndexType
+{
+    UINT16,
+    UINT32
+};
+
+static constexpr size_t SizeOfIndexType(IndexType indexType)
+{
+    switch (indexType)
+    {
+        case IndexType::UINT16: return sizeof(uint16_t);
+        case IndexType::UINT32: return sizeof(uint32_t);
+        default: return 0;
+    }
+}
+
+} // namespace Gleam
+
+GLEAM_ENUM(Gleam::IndexType, Guid("3C1F7B52-9E4A-4D63-B0A8-6E2D5F1C8A47"))
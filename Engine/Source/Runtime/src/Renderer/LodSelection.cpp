@@ -0,0 +1,33 @@
+#include "gpch.h"
+#include "LodSelection.h"
+
+using namespace Gleam;
+
+float LodSelection::ScreenSize(const BoundingSphere& bounds, const Camera& camera, const Float3& eye)
+{
+    // both projections measure the diameter against the full view height, orthographicSize is the full height
+    float diameter = 2.0f * bounds.radius;
+    if (camera.projectionType == ProjectionType::Ortho)
+    {
+        return diameter / camera.orthographicSize;
+    }
+    
+    float distance = Math::Max(Math::Length(bounds.center - eye), camera.nearPlane);
+    float viewHeight = 2.0f * distance * Math::Tan(Math::Deg2Rad(camera.fov) / 2.0f);
+    return diameter / viewHeight;
+}
+
+uint32_t LodSelection::Select(const TArray<MeshLodDescriptor>& lods, const SubmeshDescriptor& submesh, float screenSize, uint32_t currentLod)
+{
+    uint32_t level = 0;
+    for (uint32_t i = 0; i < submesh.lodCount; ++i)
+    {
+        // levels at or below the current one are sticky, coarser ones have to be earned
+        float bias = i < currentLod ? 1.0f + Hysteresis : 1.0f - Hysteresis;
+        if (screenSize >= lods[submesh.firstLod + i].screenSize * bias)
+            break;
+        
+        level = i + 1;
+    }
+    return level;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "MeshDescriptor.h"
+
+namespace Gleam {
+
+struct Camera;
+
+class LodSelection
+{
+public:
+    
+    // relative band around each screen size threshold that has to be crossed before switching levels
+    static constexpr float Hysteresis = 0.1f;
+    
+    // Projected bounding sphere diameter as a fraction of the screen height
+    static float ScreenSize(const BoundingSphere& bounds, const Camera& camera, const Float3& eye);
+    
+    // Returns 0 for the full detail submesh, otherwise 1 + the index of the level relative to submesh.firstLod
+    static uint32_t Select(const TArray<MeshLodDescriptor>& lods, const SubmeshDescriptor& submesh, float screenSize, uint32_t currentLod);
+    
+};
+
+} // namespace Gleam
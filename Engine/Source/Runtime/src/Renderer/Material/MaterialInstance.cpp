@@ -25,6 +25,11 @@ void MaterialInstance::SetProperty(const TString& name, const MaterialPropertyVa
 	mPropertyValues[GetPropertyIndex(name)] = value;
 }
 
+const TArray<MaterialPropertyValue>& MaterialInstance::GetPropertyValues() const
+{
+	return mPropertyValues;
+}
+
 const IMaterial* MaterialInstance::GetBaseMaterial() const
 {
     return mBaseMaterial;
@@ -18,6 +18,9 @@ public:
     
     void SetProperty(const TString& name, const MaterialPropertyValue& value);
 
+    // Values in the order of the base material properties
+    const TArray<MaterialPropertyValue>& GetPropertyValues() const;
+
     const IMaterial* GetBaseMaterial() const;
     
     uint32_t GetUniqueId() const;
@@ -8,24 +8,19 @@ using namespace Gleam;
 
 void MaterialSystem::Initialize(Application* app)
 {
-	Filesystem::ForEach(Globals::ProjectContentDirectory, [&, this](const auto& entry)
+	auto assetManager = app->GetSubsystem<AssetManager>();
+	for (const auto& entry : assetManager->GetIndexedAssets<MaterialDescriptor>())
 	{
-		if (entry.extension() == ".asset")
+		auto ref = entry.asset;
+		// materials are created as they finish loading, GetMaterial loads the ones needed earlier in place
+		assetManager->LoadAsync<MaterialDescriptor>(ref, AssetLoadPriority::High, [this, ref](const RefCounted<const MaterialDescriptor>& descriptor)
 		{
-			auto file = Filesystem::Open(entry, FileType::Text);
-			auto accessor = Filesystem::ReadAccessor(entry);
-			auto serializer = JSONSerializer(file.GetStream());
-			auto header = serializer.ParseHeader();
-
-			if (header.guid == Reflection::GetClass<MaterialDescriptor>().Guid())
+			if (descriptor && mMaterials.find(ref) == mMaterials.end())
 			{
-				auto guid = Guid(entry.stem().string());
-				AssetReference ref = { .guid = guid };
-				auto descriptor = app->GetSubsystem<AssetManager>()->Get<MaterialDescriptor>(ref);
-				mMaterials.emplace_hint(mMaterials.end(), ref, CreateScope<Material>(descriptor));
+				mMaterials.emplace(ref, CreateScope<Material>(*descriptor));
 			}
-		}
-	}, true);
+		});
+	}
 }
 
 void MaterialSystem::Shutdown()
@@ -42,8 +37,8 @@ Material* MaterialSystem::GetMaterial(const AssetReference& ref)
 	auto it = mMaterials.find(ref);
 	if (it == mMaterials.end())
 	{
-		auto descriptor = Globals::GameInstance->GetSubsystem<AssetManager>()->Get<MaterialDescriptor>(ref);
-		it = mMaterials.emplace_hint(mMaterials.end(), ref, CreateScope<Material>(descriptor));
+		auto descriptor = Globals::GameInstance->GetSubsystem<AssetManager>()->Load<MaterialDescriptor>(ref);
+		it = mMaterials.emplace_hint(mMaterials.end(), ref, CreateScope<Material>(*descriptor));
 	}
 	return it->second.get();
 }
@@ -8,13 +8,19 @@
 using namespace Gleam;
 
 Mesh::Mesh(const MeshDescriptor& mesh)
-    : mSubmeshDescriptors(mesh.submeshes)
+    : Mesh(mesh, mesh.GetGeometry())
+{
+
+}
+
+Mesh::Mesh(const MeshDescriptor& mesh, const MeshGeometry& geometry)
+    : mSubmeshDescriptors(mesh.submeshes), mMeshletDescriptors(mesh.meshlets), mLodDescriptors(mesh.lods), mIndexType(geometry.indexType)
 {
     static auto renderSystem = Globals::Engine->GetSubsystem<RenderSystem>();
     
-    size_t positionSize = mesh.positions.size() * sizeof(Float3);
-    size_t interleavedSize = mesh.interleavedVertices.size() * sizeof(InterleavedMeshVertex);
-    size_t indexSize = mesh.indices.size() * sizeof(uint32_t);
+    size_t positionSize = geometry.positions.size_bytes();
+    size_t interleavedSize = geometry.interleavedVertices.size_bytes();
+    size_t indexSize = geometry.indices.size_bytes();
 
     HeapDescriptor heapDesc;
     heapDesc.name = mesh.name;
@@ -56,15 +62,15 @@ Mesh::Mesh(const MeshDescriptor& mesh)
         commandBuffer.Begin();
 
         size_t offset = 0;
-        commandBuffer.SetBufferData(stagingBuffer, mesh.positions.data(), positionSize, offset);
+        commandBuffer.SetBufferData(stagingBuffer, geometry.positions.data(), positionSize, offset);
         commandBuffer.CopyBuffer(stagingBuffer, mPositionBuffer, positionSize, offset, 0);
 
         offset += positionBufferSize;
-        commandBuffer.SetBufferData(stagingBuffer, mesh.interleavedVertices.data(), interleavedSize, offset);
+        commandBuffer.SetBufferData(stagingBuffer, geometry.interleavedVertices.data(), interleavedSize, offset);
         commandBuffer.CopyBuffer(stagingBuffer, mInterleavedBuffer, interleavedSize, offset, 0);
 
         offset += interleavedBufferSize;
-        commandBuffer.SetBufferData(stagingBuffer, mesh.indices.data(), indexSize, offset);
+        commandBuffer.SetBufferData(stagingBuffer, geometry.indices.data(), indexSize, offset);
         commandBuffer.CopyBuffer(stagingBuffer, mIndexBuffer, indexSize, offset, 0);
 
         commandBuffer.End();
@@ -100,6 +106,11 @@ const Buffer& Mesh::GetIndexBuffer() const
     return mIndexBuffer;
 }
 
+IndexType Mesh::GetIndexType() const
+{
+    return mIndexType;
+}
+
 uint32_t Mesh::GetSubmeshCount() const
 {
     return static_cast<uint32_t>(mSubmeshDescriptors.size());
@@ -109,3 +120,13 @@ const TArray<SubmeshDescriptor>& Mesh::GetSubmeshDescriptors() const
 {
     return mSubmeshDescriptors;
 }
+
+const TArray<MeshletDescriptor>& Mesh::GetMeshletDescriptors() const
+{
+    return mMeshletDescriptors;
+}
+
+const TArray<MeshLodDescriptor>& Mesh::GetLodDescriptors() const
+{
+    return mLodDescriptors;
+}
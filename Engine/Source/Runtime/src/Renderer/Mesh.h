@@ -12,6 +12,9 @@ public:
     virtual ~Mesh() = default;
     
     Mesh(const MeshDescriptor& mesh);
+
+    // streams are uploaded from the given geometry, e.g. spans into a mapped sidecar
+    Mesh(const MeshDescriptor& mesh, const MeshGeometry& geometry);
     
     void Dispose();
     
@@ -21,9 +24,15 @@ public:
     
     const Buffer& GetIndexBuffer() const;
 
+    IndexType GetIndexType() const;
+
     uint32_t GetSubmeshCount() const;
     
     const TArray<SubmeshDescriptor>& GetSubmeshDescriptors() const;
+
+    const TArray<MeshletDescriptor>& GetMeshletDescriptors() const;
+
+    const TArray<MeshLodDescriptor>& GetLodDescriptors() const;
     
 protected:
     
@@ -32,6 +41,9 @@ protected:
     Buffer mPositionBuffer;
     Buffer mInterleavedBuffer;
     TArray<SubmeshDescriptor> mSubmeshDescriptors;
+    TArray<MeshletDescriptor> mMeshletDescriptors;
+    TArray<MeshLodDescriptor> mLodDescriptors;
+    IndexType mIndexType = IndexType::UINT32;
 };
 
 } // namespace Gleam
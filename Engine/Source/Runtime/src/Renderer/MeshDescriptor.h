@@ -1,32 +1,227 @@
 #pragma once
 #include "Core/GUID.h"
+#include "IndexType.h"
+
+#include <span>
 
 namespace Gleam {
 
+struct MeshletDescriptor
+{
+    static constexpr uint32_t MaxVertexCount = 64;
+    static constexpr uint32_t MaxTriangleCount = 124;
+    
+    BoundingSphere bounds;
+    
+    // backfacing if Dot(center - eye, coneAxis) >= coneCutoff * Length(center - eye) + radius
+    Float3 coneAxis = Float3::zero;
+    float coneCutoff = 1.0f;
+    
+    // contiguous range in the mesh index buffer
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    
+    // submesh relative vertices and 3 local vertex ids per triangle for mesh shaders
+    uint32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t triangleOffset = 0;
+    uint32_t triangleCount = 0;
+};
+
+struct MeshLodDescriptor
+{
+    // contiguous range in the mesh index buffer, relative to submesh baseVertex
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    
+    // selected when the projected bounding sphere diameter falls below this fraction of the screen height
+    float screenSize = 0.0f;
+};
+
 struct SubmeshDescriptor
 {
     BoundingBox bounds;
     uint32_t baseVertex = 0;
     uint32_t firstIndex = 0;
     uint32_t indexCount = 0;
+    uint32_t firstMeshlet = 0;
+    uint32_t meshletCount = 0;
+    uint32_t firstLod = 0;
+    uint32_t lodCount = 0;
+};
+
+// byte range of one stream in the geometry sidecar of a baked mesh
+struct MeshBufferView
+{
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    uint32_t stride = 0;
+};
+
+struct MeshBufferViews
+{
+    MeshBufferView indices;
+    MeshBufferView positions;
+    MeshBufferView interleavedVertices;
+    MeshBufferView meshletVertices;
+    MeshBufferView meshletTriangles;
+};
+
+// non owning view of the vertex and index streams, either inline in the descriptor or in a mapped sidecar
+struct MeshGeometry
+{
+    IndexType indexType = IndexType::UINT32;
+    std::span<const uint8_t> indices;
+    std::span<const Float3> positions;
+    std::span<const InterleavedMeshVertex> interleavedVertices;
+    std::span<const uint32_t> meshletVertices;
+    std::span<const uint8_t> meshletTriangles;
+
+    uint32_t GetIndex(uint32_t i) const
+    {
+        if (indexType == IndexType::UINT16)
+            return reinterpret_cast<const uint16_t*>(indices.data())[i];
+        return reinterpret_cast<const uint32_t*>(indices.data())[i];
+    }
 };
 
+/*
+* Version 2 adds indexType and the sidecar buffer views
+* Indices are kept as 32-bit values in both versions, only baked sidecars and GPU buffers store them at indexType width
+*/
 struct MeshDescriptor
 {
     TString name;
+    IndexType indexType = IndexType::UINT32;
     TArray<uint32_t> indices;
     TArray<Float3> positions;
     TArray<InterleavedMeshVertex> interleavedVertices;
     TArray<SubmeshDescriptor> submeshes;
+    TArray<MeshLodDescriptor> lods;
+    TArray<MeshletDescriptor> meshlets;
+    TArray<uint32_t> meshletVertices;
+    TArray<uint8_t> meshletTriangles;
+
+    // baked meshes keep the streams above empty and point into the "<guid>.bin" sidecar instead
+    MeshBufferViews buffers;
+
+    bool HasSidecar() const
+    {
+        return buffers.positions.length > 0 && positions.empty();
+    }
+
+    // inline indices are always 32-bit, whatever the baked indexType is
+    MeshGeometry GetGeometry() const
+    {
+        return MeshGeometry{
+            .indexType = IndexType::UINT32,
+            .indices = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(indices.data()), indices.size() * sizeof(uint32_t)),
+            .positions = positions,
+            .interleavedVertices = interleavedVertices,
+            .meshletVertices = meshletVertices,
+            .meshletTriangles = meshletTriangles
+        };
+    }
+
+    MeshGeometry GetGeometry(const uint8_t* sidecar, size_t size) const
+    {
+        auto view = [&]<typename T>(const MeshBufferView& buffer, std::type_identity<T>)
+        {
+            if (sidecar == nullptr || buffer.offset > size || buffer.length > size - buffer.offset || buffer.length % sizeof(T) != 0)
+            {
+                GLEAM_CORE_ERROR("Mesh {0} buffer view is out of the sidecar range", name);
+                return std::span<const T>();
+            }
+            return std::span<const T>(reinterpret_cast<const T*>(sidecar + buffer.offset), buffer.length / sizeof(T));
+        };
+
+        return MeshGeometry{
+            .indexType = indexType,
+            .indices = view(buffers.indices, std::type_identity<uint8_t>()),
+            .positions = view(buffers.positions, std::type_identity<Float3>()),
+            .interleavedVertices = view(buffers.interleavedVertices, std::type_identity<InterleavedMeshVertex>()),
+            .meshletVertices = view(buffers.meshletVertices, std::type_identity<uint32_t>()),
+            .meshletTriangles = view(buffers.meshletTriangles, std::type_identity<uint8_t>())
+        };
+    }
+
+    // sidecar backed meshes count the baked index view, which is stored at indexType width
+    uint32_t GetIndexCount() const
+    {
+        if (HasSidecar())
+        {
+            return static_cast<uint32_t>(buffers.indices.length / SizeOfIndexType(indexType));
+        }
+        return static_cast<uint32_t>(indices.size());
+    }
+
+    // inline indices only, sidecar backed meshes read theirs through GetGeometry
+    uint32_t GetIndex(uint32_t i) const
+    {
+        return indices[i];
+    }
+
+    // indices are relative to submesh baseVertex, 0xFFFF is kept free as the strip restart value
+    void SetIndices(const TArray<uint32_t>& values)
+    {
+        uint32_t maxIndex = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+        indexType = maxIndex < 0xFFFF ? IndexType::UINT16 : IndexType::UINT32;
+        indices = values;
+    }
+
+    const TArray<uint32_t>& GetIndices() const
+    {
+        return indices;
+    }
+
+    // indices at indexType width, as they are baked into the sidecar
+    TArray<uint8_t> PackIndices() const
+    {
+        TArray<uint8_t> packed(indices.size() * SizeOfIndexType(indexType));
+        if (indexType == IndexType::UINT32)
+        {
+            std::copy_n(reinterpret_cast<const uint8_t*>(indices.data()), packed.size(), packed.data());
+            return packed;
+        }
+
+        auto dst = reinterpret_cast<uint16_t*>(packed.data());
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            dst[i] = static_cast<uint16_t>(indices[i]);
+        }
+        return packed;
+    }
 };
 
 } // namespace Gleam
 
+GLEAM_TYPE(Gleam::MeshletDescriptor, Guid("A51C56F1-DA2D-420A-83A3-CCB4A00182F9"))
+    GLEAM_FIELD(bounds, Serializable())
+    GLEAM_FIELD(coneAxis, Serializable())
+    GLEAM_FIELD(coneCutoff, Serializable())
+    GLEAM_FIELD(firstIndex, Serializable())
+    GLEAM_FIELD(indexCount, Serializable())
+    GLEAM_FIELD(vertexOffset, Serializable())
+    GLEAM_FIELD(vertexCount, Serializable())
+    GLEAM_FIELD(triangleOffset, Serializable())
+    GLEAM_FIELD(triangleCount, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(Gleam::MeshLodDescriptor, Guid("0DBB5C57-386E-4C82-B27C-1249412ED774"))
+    GLEAM_FIELD(firstIndex, Serializable())
+    GLEAM_FIELD(indexCount, Serializable())
+    GLEAM_FIELD(screenSize, Serializable())
+GLEAM_END
+
 GLEAM_TYPE(Gleam::SubmeshDescriptor, Guid("DD7E3A74-ADF4-45A9-8DFD-CA252EDC49A6"))
 	GLEAM_FIELD(bounds, Serializable())
     GLEAM_FIELD(baseVertex, Serializable())
     GLEAM_FIELD(firstIndex, Serializable())
     GLEAM_FIELD(indexCount, Serializable())
+    GLEAM_FIELD(firstMeshlet, Serializable())
+    GLEAM_FIELD(meshletCount, Serializable())
+    GLEAM_FIELD(firstLod, Serializable())
+    GLEAM_FIELD(lodCount, Serializable())
 GLEAM_END
 
 GLEAM_TYPE(Gleam::InterleavedMeshVertex, Guid("4AFE936A-550F-419C-A7F0-5ED38D9D1642"))
@@ -34,10 +229,30 @@ GLEAM_TYPE(Gleam::InterleavedMeshVertex, Guid("4AFE936A-550F-419C-A7F0-5ED38D9D1
     GLEAM_FIELD(texCoord, Serializable())
 GLEAM_END
 
-GLEAM_TYPE(Gleam::MeshDescriptor, Guid("59E4007E-F7D4-4107-A05F-E1121067DCD3"))
+GLEAM_TYPE(Gleam::MeshBufferView, Guid("6C0B3E1D-2F7A-4E49-9B8C-5D1A7E3F4C21"))
+    GLEAM_FIELD(offset, Serializable())
+    GLEAM_FIELD(length, Serializable())
+    GLEAM_FIELD(stride, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(Gleam::MeshBufferViews, Guid("B7E2F4A9-1C3D-4A8E-8F60-2E9D4B7C1A53"))
+    GLEAM_FIELD(indices, Serializable())
+    GLEAM_FIELD(positions, Serializable())
+    GLEAM_FIELD(interleavedVertices, Serializable())
+    GLEAM_FIELD(meshletVertices, Serializable())
+    GLEAM_FIELD(meshletTriangles, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(Gleam::MeshDescriptor, Guid("59E4007E-F7D4-4107-A05F-E1121067DCD3"), Version(2))
     GLEAM_FIELD(name, Serializable())
+    GLEAM_FIELD(indexType, Serializable())
     GLEAM_FIELD(indices, Serializable())
     GLEAM_FIELD(positions, Serializable())
     GLEAM_FIELD(interleavedVertices, Serializable())
     GLEAM_FIELD(submeshes, Serializable())
+    GLEAM_FIELD(lods, Serializable())
+    GLEAM_FIELD(meshlets, Serializable())
+    GLEAM_FIELD(meshletVertices, Serializable())
+    GLEAM_FIELD(meshletTriangles, Serializable())
+    GLEAM_FIELD(buffers, Serializable())
 GLEAM_END
@@ -235,6 +235,43 @@ void CommandBuffer::CopyBuffer(const NativeGraphicsHandle src, const NativeGraph
     [blitCommandEncoder endEncoding];
 }
 
+void CommandBuffer::SetTextureData(const Texture& texture, const void* data, size_t size, uint32_t mipLevel) const
+{
+    const auto& descriptor = texture.GetDescriptor();
+    uint32_t width = Math::Max(static_cast<uint32_t>(descriptor.size.width) >> mipLevel, 1u);
+    uint32_t height = Math::Max(static_cast<uint32_t>(descriptor.size.height) >> mipLevel, 1u);
+
+    HeapDescriptor heapDesc;
+    heapDesc.name = "CommandBuffer::TextureStagingHeap";
+    heapDesc.memoryType = MemoryType::CPU;
+    heapDesc.size = size;
+    Heap stagingHeap = mDevice->CreateHeap(heapDesc);
+
+    BufferDescriptor bufferDesc;
+    bufferDesc.name = "StagingBuffer";
+    bufferDesc.size = size;
+    Buffer stagingBuffer = stagingHeap.CreateBuffer(bufferDesc);
+    memcpy(stagingBuffer.GetContents(), data, size);
+
+    id<MTLBuffer> srcBuffer = stagingBuffer.GetHandle();
+    id<MTLTexture> dstTexture = texture.GetHandle();
+    id<MTLBlitCommandEncoder> blitCommandEncoder = [mHandle->commandBuffer blitCommandEncoder];
+    [blitCommandEncoder setLabel:TO_NSSTRING("CommandBuffer::SetTextureData")];
+    [blitCommandEncoder copyFromBuffer:srcBuffer
+                          sourceOffset:0
+                     sourceBytesPerRow:Utils::GetTextureRowPitch(descriptor.format, width)
+                   sourceBytesPerImage:Utils::GetTextureDataSize(descriptor.format, width, height)
+                            sourceSize:MTLSizeMake(width, height, 1)
+                             toTexture:dstTexture
+                      destinationSlice:0
+                      destinationLevel:mipLevel
+                     destinationOrigin:MTLOriginMake(0, 0, 0)];
+    [blitCommandEncoder endEncoding];
+
+    mDevice->ReleaseBuffer(stagingBuffer);
+    mDevice->ReleaseHeap(stagingHeap);
+}
+
 void CommandBuffer::Blit(const Texture& source, const Texture& destination) const
 {
     id<MTLTexture> srcTexture = source.GetHandle();
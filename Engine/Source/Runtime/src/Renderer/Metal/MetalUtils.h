@@ -78,6 +78,17 @@ static constexpr TextureFormat MTLPixelFormatToTextureFormat(MTLPixelFormat form
 #endif
         case MTLPixelFormatDepth32Float_Stencil8: return TextureFormat::D32_SFloat_S8_UInt;
 
+        // Block compressed formats
+#ifdef PLATFORM_MACOS
+        case MTLPixelFormatBC1_RGBA: return TextureFormat::BC1_RGBA_UNorm;
+        case MTLPixelFormatBC1_RGBA_sRGB: return TextureFormat::BC1_RGBA_SRGB;
+        case MTLPixelFormatBC3_RGBA: return TextureFormat::BC3_RGBA_UNorm;
+        case MTLPixelFormatBC3_RGBA_sRGB: return TextureFormat::BC3_RGBA_SRGB;
+        case MTLPixelFormatBC5_RGUnorm: return TextureFormat::BC5_RG_UNorm;
+        case MTLPixelFormatBC7_RGBAUnorm: return TextureFormat::BC7_RGBA_UNorm;
+        case MTLPixelFormatBC7_RGBAUnorm_sRGB: return TextureFormat::BC7_RGBA_SRGB;
+#endif
+
         default: return TextureFormat::None;
     }
 }
@@ -149,6 +160,17 @@ static constexpr MTLPixelFormat TextureFormatToMTLPixelFormat(TextureFormat form
 #endif
         case TextureFormat::D32_SFloat_S8_UInt: return MTLPixelFormatDepth32Float_Stencil8;
 
+        // Block compressed formats
+#ifdef PLATFORM_MACOS
+        case TextureFormat::BC1_RGBA_UNorm: return MTLPixelFormatBC1_RGBA;
+        case TextureFormat::BC1_RGBA_SRGB: return MTLPixelFormatBC1_RGBA_sRGB;
+        case TextureFormat::BC3_RGBA_UNorm: return MTLPixelFormatBC3_RGBA;
+        case TextureFormat::BC3_RGBA_SRGB: return MTLPixelFormatBC3_RGBA_sRGB;
+        case TextureFormat::BC5_RG_UNorm: return MTLPixelFormatBC5_RGUnorm;
+        case TextureFormat::BC7_RGBA_UNorm: return MTLPixelFormatBC7_RGBAUnorm;
+        case TextureFormat::BC7_RGBA_SRGB: return MTLPixelFormatBC7_RGBAUnorm_sRGB;
+#endif
+
         default: return MTLPixelFormatInvalid;
     }
 }
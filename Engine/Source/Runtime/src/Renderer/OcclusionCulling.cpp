@@ -0,0 +1,316 @@
+#include "gpch.h"
+#include "OcclusionCulling.h"
+#include "MeshDescriptor.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace Gleam;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float MinClipW = 1e-4f;
+
+double ElapsedMilliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+FORCE_INLINE Float3 ToScreen(const Float4& clip)
+{
+    float invW = 1.0f / clip.w;
+    return Float3
+    {
+        (clip.x * invW * 0.5f + 0.5f) * OcclusionCulling::Width,
+        (0.5f - clip.y * invW * 0.5f) * OcclusionCulling::Height,
+        clip.z * invW
+    };
+}
+
+} // namespace
+
+OccluderGeometry OccluderGeometry::Create(const MeshDescriptor& mesh, const MeshGeometry& geometry)
+{
+    OccluderGeometry occluder;
+    HashMap<uint32_t, uint32_t> remap;
+    for (const auto& submesh : mesh.submeshes)
+    {
+        uint32_t firstIndex = submesh.firstIndex;
+        uint32_t indexCount = submesh.indexCount;
+        if (submesh.lodCount > 0)
+        {
+            const auto& lod = mesh.lods[submesh.firstLod + submesh.lodCount - 1];
+            firstIndex = lod.firstIndex;
+            indexCount = lod.indexCount;
+        }
+
+        for (uint32_t i = firstIndex; i < firstIndex + indexCount; i++)
+        {
+            uint32_t vertex = submesh.baseVertex + geometry.GetIndex(i);
+            auto [it, inserted] = remap.try_emplace(vertex, static_cast<uint32_t>(occluder.positions.size()));
+            if (inserted)
+            {
+                occluder.positions.push_back(geometry.positions[vertex]);
+            }
+            occluder.indices.push_back(it->second);
+        }
+    }
+    return occluder;
+}
+
+OcclusionCulling::OcclusionCulling()
+    : mDepthBuffer(Width * Height, 1.0f), mTileMaxDepth(TileCountX * TileCountY, 1.0f)
+{
+
+}
+
+void OcclusionCulling::Begin(const Float4x4& viewProjection)
+{
+    mViewProjection = viewProjection;
+    mStatistics = OcclusionCullingStatistics();
+    std::fill(mDepthBuffer.begin(), mDepthBuffer.end(), 1.0f);
+    std::fill(mTileMaxDepth.begin(), mTileMaxDepth.end(), 1.0f);
+}
+
+void OcclusionCulling::RenderOccluder(const OccluderGeometry& occluder, const Float4x4& transform)
+{
+    auto start = Clock::now();
+    auto modelViewProjection = mViewProjection * transform;
+
+    TArray<Float4> clipPositions(occluder.positions.size());
+    for (uint32_t i = 0; i < occluder.positions.size(); ++i)
+    {
+        clipPositions[i] = modelViewProjection * Float4(occluder.positions[i], 1.0f);
+    }
+
+    for (uint32_t i = 0; i < occluder.indices.size(); i += 3)
+    {
+        RasterizeTriangle(clipPositions[occluder.indices[i]], clipPositions[occluder.indices[i + 1]], clipPositions[occluder.indices[i + 2]]);
+    }
+
+    mStatistics.occluderCount++;
+    mStatistics.occluderTriangleCount += static_cast<uint32_t>(occluder.indices.size() / 3);
+    mStatistics.rasterizationTime += ElapsedMilliseconds(start);
+}
+
+void OcclusionCulling::End()
+{
+    auto start = Clock::now();
+    for (uint32_t tileY = 0; tileY < TileCountY; ++tileY)
+    {
+        for (uint32_t tileX = 0; tileX < TileCountX; ++tileX)
+        {
+            const float* row = &mDepthBuffer[tileY * TileHeight * Width + tileX * TileWidth];
+        #if defined(__AVX2__)
+            __m256 maxDepth = _mm256_loadu_ps(row);
+            for (uint32_t y = 1; y < TileHeight; ++y)
+            {
+                maxDepth = _mm256_max_ps(maxDepth, _mm256_loadu_ps(row + y * Width));
+            }
+            __m128 max4 = _mm_max_ps(_mm256_castps256_ps128(maxDepth), _mm256_extractf128_ps(maxDepth, 1));
+            max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+            max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, 1));
+            mTileMaxDepth[tileY * TileCountX + tileX] = _mm_cvtss_f32(max4);
+        #else
+            float maxDepth = 0.0f;
+            for (uint32_t y = 0; y < TileHeight; ++y)
+            {
+                for (uint32_t x = 0; x < TileWidth; ++x)
+                {
+                    maxDepth = Math::Max(maxDepth, row[y * Width + x]);
+                }
+            }
+            mTileMaxDepth[tileY * TileCountX + tileX] = maxDepth;
+        #endif
+        }
+    }
+    mStatistics.rasterizationTime += ElapsedMilliseconds(start);
+}
+
+bool OcclusionCulling::IsVisible(const BoundingBox& bounds, const Float4x4& transform)
+{
+    auto start = Clock::now();
+    mStatistics.testedCount++;
+
+    auto modelViewProjection = mViewProjection * transform;
+
+    float minX = Math::Infinity, minY = Math::Infinity, minDepth = Math::Infinity;
+    float maxX = Math::NegativeInfinity, maxY = Math::NegativeInfinity;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        Float3 corner
+        {
+            (i & 1) ? bounds.max.x : bounds.min.x,
+            (i & 2) ? bounds.max.y : bounds.min.y,
+            (i & 4) ? bounds.max.z : bounds.min.z
+        };
+
+        auto clip = modelViewProjection * Float4(corner, 1.0f);
+
+        // boxes crossing the near plane are always visible
+        if (clip.w <= MinClipW)
+        {
+            mStatistics.testTime += ElapsedMilliseconds(start);
+            return true;
+        }
+
+        auto screen = ToScreen(clip);
+        minX = Math::Min(minX, screen.x);
+        minY = Math::Min(minY, screen.y);
+        maxX = Math::Max(maxX, screen.x);
+        maxY = Math::Max(maxY, screen.y);
+        minDepth = Math::Min(minDepth, screen.z);
+    }
+
+    int32_t x0 = Math::Max(static_cast<int32_t>(Math::Floor(minX)), 0);
+    int32_t y0 = Math::Max(static_cast<int32_t>(Math::Floor(minY)), 0);
+    int32_t x1 = Math::Min(static_cast<int32_t>(Math::Floor(maxX)), static_cast<int32_t>(Width) - 1);
+    int32_t y1 = Math::Min(static_cast<int32_t>(Math::Floor(maxY)), static_cast<int32_t>(Height) - 1);
+
+    bool visible = false;
+    if (x0 > x1 || y0 > y1)
+    {
+        // off screen boxes are left to frustum culling
+        visible = true;
+    }
+    else
+    {
+        // coarse test against the tile hierarchy, only tiles that fail it are tested per pixel
+        for (int32_t tileY = y0 / TileHeight; tileY <= y1 / static_cast<int32_t>(TileHeight) && !visible; ++tileY)
+        {
+            for (int32_t tileX = x0 / TileWidth; tileX <= x1 / static_cast<int32_t>(TileWidth) && !visible; ++tileX)
+            {
+                if (mTileMaxDepth[tileY * TileCountX + tileX] < minDepth)
+                    continue;
+
+                int32_t px0 = Math::Max(x0, tileX * static_cast<int32_t>(TileWidth));
+                int32_t px1 = Math::Min(x1, (tileX + 1) * static_cast<int32_t>(TileWidth) - 1);
+                int32_t py0 = Math::Max(y0, tileY * static_cast<int32_t>(TileHeight));
+                int32_t py1 = Math::Min(y1, (tileY + 1) * static_cast<int32_t>(TileHeight) - 1);
+                for (int32_t y = py0; y <= py1 && !visible; ++y)
+                {
+                    for (int32_t x = px0; x <= px1; ++x)
+                    {
+                        if (mDepthBuffer[y * Width + x] >= minDepth)
+                        {
+                            visible = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (!visible)
+    {
+        mStatistics.occludedCount++;
+    }
+    mStatistics.testTime += ElapsedMilliseconds(start);
+    return visible;
+}
+
+const OcclusionCullingStatistics& OcclusionCulling::GetStatistics() const
+{
+    return mStatistics;
+}
+
+void OcclusionCulling::RasterizeTriangle(const Float4& c0, const Float4& c1, const Float4& c2)
+{
+    // near plane clipping is skipped, dropping an occluder triangle is always conservative
+    if (c0.w <= MinClipW || c1.w <= MinClipW || c2.w <= MinClipW)
+        return;
+
+    auto v0 = ToScreen(c0);
+    auto v1 = ToScreen(c1);
+    auto v2 = ToScreen(c2);
+
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (Math::Abs(area) <= Math::Epsilon)
+        return;
+
+    // occluders are rasterized double sided, flip to a consistent winding
+    if (area < 0.0f)
+    {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    int32_t minX = Math::Max(static_cast<int32_t>(Math::Floor(Math::Min(v0.x, Math::Min(v1.x, v2.x)))), 0);
+    int32_t minY = Math::Max(static_cast<int32_t>(Math::Floor(Math::Min(v0.y, Math::Min(v1.y, v2.y)))), 0);
+    int32_t maxX = Math::Min(static_cast<int32_t>(Math::Floor(Math::Max(v0.x, Math::Max(v1.x, v2.x)))), static_cast<int32_t>(Width) - 1);
+    int32_t maxY = Math::Min(static_cast<int32_t>(Math::Floor(Math::Max(v0.y, Math::Max(v1.y, v2.y)))), static_cast<int32_t>(Height) - 1);
+    if (minX > maxX || minY > maxY)
+        return;
+
+    // edge functions E(x, y) = a * x + b * y + c, positive inside
+    float a0 = v1.y - v2.y, b0 = v2.x - v1.x, c0e = v1.x * v2.y - v2.x * v1.y;
+    float a1 = v2.y - v0.y, b1 = v0.x - v2.x, c1e = v2.x * v0.y - v0.x * v2.y;
+    float a2 = v0.y - v1.y, b2 = v1.x - v0.x, c2e = v0.x * v1.y - v1.x * v0.y;
+
+    // screen space depth plane z = zx * x + zy * y + zc
+    float invArea = 1.0f / area;
+    float zx = (a0 * v0.z + a1 * v1.z + a2 * v2.z) * invArea;
+    float zy = (b0 * v0.z + b1 * v1.z + b2 * v2.z) * invArea;
+    float zc = (c0e * v0.z + c1e * v1.z + c2e * v2.z) * invArea;
+
+    // rows are processed in 8 pixel spans aligned to the buffer, lanes outside the triangle are masked out
+    int32_t spanStart = minX & ~7;
+
+#if defined(__AVX2__)
+    const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    const __m256 a0v = _mm256_set1_ps(a0), a1v = _mm256_set1_ps(a1), a2v = _mm256_set1_ps(a2);
+    const __m256 zxv = _mm256_set1_ps(zx);
+    for (int32_t y = minY; y <= maxY; ++y)
+    {
+        float py = static_cast<float>(y) + 0.5f;
+        __m256 rowE0 = _mm256_set1_ps(b0 * py + c0e);
+        __m256 rowE1 = _mm256_set1_ps(b1 * py + c1e);
+        __m256 rowE2 = _mm256_set1_ps(b2 * py + c2e);
+        __m256 rowZ = _mm256_set1_ps(zy * py + zc);
+
+        float* row = &mDepthBuffer[y * Width];
+        for (int32_t x = spanStart; x <= maxX; x += 8)
+        {
+            __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+            __m256 e0 = _mm256_fmadd_ps(a0v, px, rowE0);
+            __m256 e1 = _mm256_fmadd_ps(a1v, px, rowE1);
+            __m256 e2 = _mm256_fmadd_ps(a2v, px, rowE2);
+
+            // sign bit of any edge set means outside
+            __m256 outside = _mm256_or_ps(_mm256_or_ps(e0, e1), e2);
+            if (_mm256_movemask_ps(outside) == 0xFF)
+                continue;
+
+            __m256 depth = _mm256_fmadd_ps(zxv, px, rowZ);
+            __m256 current = _mm256_loadu_ps(row + x);
+            __m256 result = _mm256_blendv_ps(_mm256_min_ps(current, depth), current, outside);
+            _mm256_storeu_ps(row + x, result);
+        }
+    }
+#else
+    for (int32_t y = minY; y <= maxY; ++y)
+    {
+        float py = static_cast<float>(y) + 0.5f;
+        float* row = &mDepthBuffer[y * Width];
+        for (int32_t x = spanStart; x <= maxX; x += 8)
+        {
+            for (int32_t lane = 0; lane < 8; ++lane)
+            {
+                float px = static_cast<float>(x + lane) + 0.5f;
+                float e0 = a0 * px + b0 * py + c0e;
+                float e1 = a1 * px + b1 * py + c1e;
+                float e2 = a2 * px + b2 * py + c2e;
+                if (std::signbit(e0) || std::signbit(e1) || std::signbit(e2))
+                    continue;
+
+                float depth = zx * px + zy * py + zc;
+                row[x + lane] = Math::Min(row[x + lane], depth);
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+namespace Gleam {
+
+struct MeshDescriptor;
+struct MeshGeometry;
+
+struct OccluderGeometry
+{
+    TArray<Float3> positions;
+    TArray<uint32_t> indices;
+
+    // Compacts the coarsest LOD of every submesh into a standalone mesh
+    static OccluderGeometry Create(const MeshDescriptor& mesh, const MeshGeometry& geometry);
+};
+
+struct OcclusionCullingStatistics
+{
+    uint32_t occluderCount = 0;
+    uint32_t occluderTriangleCount = 0;
+    uint32_t testedCount = 0;
+    uint32_t occludedCount = 0;
+    double rasterizationTime = 0.0; // milliseconds
+    double testTime = 0.0; // milliseconds
+};
+
+/*
+* Software occlusion culling against a low resolution depth buffer that stores one depth per pixel
+* Occluders are rasterized in 8 pixel spans (AVX2 when available), pixels outside the triangle keep their depth
+* and the per tile maximum depth is kept as a hierarchical level for conservative box tests
+*/
+class OcclusionCulling
+{
+public:
+
+    static constexpr uint32_t Width = 256;
+    static constexpr uint32_t Height = 128;
+    static constexpr uint32_t TileWidth = 8;
+    static constexpr uint32_t TileHeight = 8;
+    static constexpr uint32_t TileCountX = Width / TileWidth;
+    static constexpr uint32_t TileCountY = Height / TileHeight;
+
+    OcclusionCulling();
+
+    void Begin(const Float4x4& viewProjection);
+
+    void RenderOccluder(const OccluderGeometry& occluder, const Float4x4& transform);
+
+    // Builds the hierarchical depth, has to be called after every occluder is rendered
+    void End();
+
+    bool IsVisible(const BoundingBox& bounds, const Float4x4& transform);
+
+    const OcclusionCullingStatistics& GetStatistics() const;
+
+private:
+
+    void RasterizeTriangle(const Float4& v0, const Float4& v1, const Float4& v2);
+
+    Float4x4 mViewProjection = Float4x4::identity;
+
+    TArray<float> mDepthBuffer;
+    TArray<float> mTileMaxDepth;
+
+    OcclusionCullingStatistics mStatistics;
+
+};
+
+} // namespace Gleam
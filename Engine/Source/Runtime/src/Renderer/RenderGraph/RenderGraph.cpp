@@ -44,6 +44,8 @@ RenderGraph::~RenderGraph()
 
 void RenderGraph::Compile()
 {
+    GLEAM_PROFILE_SCOPE("RenderGraph::Compile");
+
     // Setup resource dependency
     for (auto pass : mPassNodes)
     {
@@ -148,6 +150,8 @@ void RenderGraph::Compile()
 
 void RenderGraph::Execute(const CommandBuffer* cmd)
 {
+    GLEAM_PROFILE_SCOPE("RenderGraph::Execute");
+
     Heap heap;
     if (mHeapSize > 0)
     {
@@ -156,6 +160,8 @@ void RenderGraph::Execute(const CommandBuffer* cmd)
 
     for (auto pass : mPassNodes)
     {
+        GLEAM_PROFILE_SCOPE(pass->name);
+
         // Allocate buffers
         for (uint32_t i = 0; i < pass->bufferCreates.size(); i++)
         {
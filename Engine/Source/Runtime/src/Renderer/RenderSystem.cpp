@@ -78,17 +78,7 @@ void RenderSystem::Render(const World* world)
             {
 				const auto& cameraComponent = camera->GetComponent<Camera>();
                 cameraData.viewMatrix = Float4x4::LookTo(camera->GetWorldPosition(), camera->ForwardVector(), camera->UpVector());
-
-				if (cameraComponent.projectionType == ProjectionType::Perspective)
-				{
-					cameraData.projectionMatrix = Float4x4::Perspective(cameraComponent.fov, cameraComponent.aspectRatio, cameraComponent.nearPlane, cameraComponent.farPlane);
-				}
-				else
-				{
-					float width = cameraComponent.orthographicSize * cameraComponent.aspectRatio;
-					float height = cameraComponent.orthographicSize;
-					cameraData.projectionMatrix = Float4x4::Ortho(width, height, cameraComponent.nearPlane, cameraComponent.farPlane);
-				}
+				cameraData.projectionMatrix = cameraComponent.GetProjectionMatrix();
 
                 cameraData.viewProjectionMatrix = cameraData.projectionMatrix * cameraData.viewMatrix;
                 cameraData.invViewMatrix = Math::Inverse(cameraData.viewMatrix);
@@ -143,7 +143,7 @@ void DebugRenderer::RenderMeshes(const CommandBuffer* cmd, const BufferHandle& c
 			uniforms.baseVertex = submesh.baseVertex;
 			uniforms.color = debugMesh.color;
 			cmd->SetPushConstant(uniforms);
-			cmd->DrawIndexed(debugMesh.mesh->GetIndexBuffer(), IndexType::UINT32, submesh.indexCount, 1, submesh.firstIndex);
+			cmd->DrawIndexed(debugMesh.mesh->GetIndexBuffer(), debugMesh.mesh->GetIndexType(), submesh.indexCount, 1, submesh.firstIndex);
 		}
 	}
 }
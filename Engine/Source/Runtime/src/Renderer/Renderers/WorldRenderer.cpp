@@ -103,6 +103,21 @@ void WorldRenderer::AddRenderPasses(RenderGraph& graph, RenderGraphBlackboard& b
                 );
             #endif
 
+                for (const auto& texture : batch.textures)
+                {
+                    if (texture.IsValid() == false)
+                        continue;
+                #ifdef USE_METAL_RENDERER
+                    [cmd->GetActiveRenderPass() useResource:texture.GetHandle() usage : MTLResourceUsageRead stages : MTLRenderStageFragment];
+                #elif defined(USE_DIRECTX_RENDERER)
+                    DirectXTransitionManager::TransitionLayout(
+                        static_cast<ID3D12GraphicsCommandList7*>(cmd->GetHandle()),
+                        static_cast<ID3D12Resource*>(texture.GetHandle()),
+                        D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE
+                    );
+                #endif
+                }
+
                 MeshPassResources resources;
                 resources.cameraBuffer = passData.cameraBuffer;
                 resources.positionBuffer = positionBuffer.GetResourceView();
@@ -111,8 +126,16 @@ void WorldRenderer::AddRenderPasses(RenderGraph& graph, RenderGraphBlackboard& b
 				resources.materialID = batch.material.GetUniqueId();
 				resources.modelMatrix = batch.transform;
 				resources.baseVertex = batch.submesh.baseVertex;
+				for (uint32_t i = 0; i < MAX_MATERIAL_TEXTURES; ++i)
+				{
+					bool resident = i < batch.textures.size() && batch.textures[i].IsValid();
+					resources.textures[i] = resident ? batch.textures[i].GetResourceView() : InvalidResourceIndex;
+				}
                 cmd->SetConstantBuffer(resources, 0);
-				cmd->DrawIndexed(batch.mesh.GetIndexBuffer(), IndexType::UINT32, batch.submesh.indexCount, 1, batch.submesh.firstIndex);
+				for (const auto& range : batch.drawRanges)
+				{
+					cmd->DrawIndexed(batch.mesh.GetIndexBuffer(), batch.mesh.GetIndexType(), range.indexCount, 1, range.firstIndex);
+				}
             }
         });
     });
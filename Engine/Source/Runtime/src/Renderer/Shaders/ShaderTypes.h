@@ -28,6 +28,9 @@ struct DebugShaderResources
 	ConstantBufferView cameraBuffer;
 };
 
+// Texture2D material properties beyond this count are not bound
+#define MAX_MATERIAL_TEXTURES 4
+
 struct MeshPassResources
 {
 	ConstantBufferView cameraBuffer;
@@ -35,6 +38,9 @@ struct MeshPassResources
 	BufferResourceView interleavedBuffer;
     BufferResourceView materialBuffer;
 
+	// in the order of the Texture2D properties of the material, invalid until the texture is resident
+	Texture2DResourceView<float4> textures[MAX_MATERIAL_TEXTURES];
+
 	float4x4 modelMatrix;
 
 	uint32_t baseVertex;
@@ -8,6 +8,8 @@
 #pragma once
 #include "TextureFormat.h"
 
+#include <span>
+
 namespace Gleam {
 
 enum class TextureDimension
@@ -31,6 +33,13 @@ enum TextureUsageFlag
 };
 typedef uint32_t TextureUsageFlagBits;
 
+// byte range of a mip level in the texture sidecar
+struct TextureMipView
+{
+    uint64_t offset = 0;
+    uint64_t length = 0;
+};
+
 struct TextureDescriptor
 {
     TString name;
@@ -41,6 +50,23 @@ struct TextureDescriptor
     uint32_t sampleCount = 1;
     bool useMipMap = false;
     TArray<uint8_t> pixels;
+    TArray<TextureMipView> mips; // imported textures keep every level in the sidecar instead of pixels
+
+    bool HasSidecar() const
+    {
+        return mips.empty() == false && pixels.empty();
+    }
+
+    // Level data inside the mapped sidecar, empty if the view is out of range
+    std::span<const uint8_t> GetMip(uint32_t level, const uint8_t* sidecar, size_t size) const
+    {
+        if (level >= mips.size() || sidecar == nullptr || mips[level].offset > size || mips[level].length > size - mips[level].offset)
+        {
+            GLEAM_CORE_ERROR("Texture {0} mip {1} is out of the sidecar range", name, level);
+            return {};
+        }
+        return std::span<const uint8_t>(sidecar + mips[level].offset, mips[level].length);
+    }
     
     bool operator==(const TextureDescriptor& other) const
     {
@@ -95,7 +121,11 @@ struct std::hash<Gleam::TextureDescriptor>
 GLEAM_ENUM(Gleam::TextureUsage, Guid("7EFFFEDD-F5B2-443B-9888-49C88D41779B"))
 GLEAM_ENUM(Gleam::TextureDimension, Guid("7A1CDA2E-8B61-4558-9255-B919E70E92F7"))
 GLEAM_ENUM(Gleam::TextureUsageFlag, Guid("86B2EAED-95E1-4FAD-927E-E744324A42A0"))
-GLEAM_TYPE(Gleam::TextureDescriptor, Guid("5B36D630-8A7E-47BE-A9F0-1702AB9F9C8C"))
+GLEAM_TYPE(Gleam::TextureMipView, Guid("3D8A5C2E-9F41-4B7D-8E26-1A7C4F0B9D53"))
+    GLEAM_FIELD(offset, Serializable())
+    GLEAM_FIELD(length, Serializable())
+GLEAM_END
+GLEAM_TYPE(Gleam::TextureDescriptor, Guid("5B36D630-8A7E-47BE-A9F0-1702AB9F9C8C"), Version(2))
     GLEAM_FIELD(name, Serializable())
 	GLEAM_FIELD(size, Serializable())
 	GLEAM_FIELD(format, Serializable())
@@ -104,4 +134,5 @@ GLEAM_TYPE(Gleam::TextureDescriptor, Guid("5B36D630-8A7E-47BE-A9F0-1702AB9F9C8C"
 	GLEAM_FIELD(sampleCount, Serializable())
 	GLEAM_FIELD(useMipMap, Serializable())
     GLEAM_FIELD(pixels, Serializable())
+    GLEAM_FIELD(mips, Serializable())
 GLEAM_END
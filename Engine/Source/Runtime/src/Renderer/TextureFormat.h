@@ -63,7 +63,16 @@ enum class TextureFormat
     D16_UNorm,
     D32_SFloat,
     D24_UNorm_S8_UInt,
-    D32_SFloat_S8_UInt
+    D32_SFloat_S8_UInt,
+
+    // Block compressed formats, 4x4 pixels per block
+    BC1_RGBA_UNorm,
+    BC1_RGBA_SRGB,
+    BC3_RGBA_UNorm,
+    BC3_RGBA_SRGB,
+    BC5_RG_UNorm,
+    BC7_RGBA_UNorm,
+    BC7_RGBA_SRGB
 };
 
 namespace Utils {
@@ -194,6 +203,56 @@ static constexpr bool IsColorFormat(TextureFormat format)
 	}
 }
 
+static constexpr bool IsBlockCompressedFormat(TextureFormat format)
+{
+	switch (format)
+	{
+		case TextureFormat::BC1_RGBA_UNorm:
+		case TextureFormat::BC1_RGBA_SRGB:
+		case TextureFormat::BC3_RGBA_UNorm:
+		case TextureFormat::BC3_RGBA_SRGB:
+		case TextureFormat::BC5_RG_UNorm:
+		case TextureFormat::BC7_RGBA_UNorm:
+		case TextureFormat::BC7_RGBA_SRGB: return true;
+		default: return false;
+	}
+}
+
+static constexpr size_t GetTextureFormatBlockSizeInBytes(TextureFormat format)
+{
+	switch (format)
+	{
+		case TextureFormat::BC1_RGBA_UNorm:
+		case TextureFormat::BC1_RGBA_SRGB: return 8;
+		case TextureFormat::BC3_RGBA_UNorm:
+		case TextureFormat::BC3_RGBA_SRGB:
+		case TextureFormat::BC5_RG_UNorm:
+		case TextureFormat::BC7_RGBA_UNorm:
+		case TextureFormat::BC7_RGBA_SRGB: return 16;
+		default: return 0;
+	}
+}
+
+// Size of a tightly packed mip level, block compressed formats round up to whole blocks
+static constexpr size_t GetTextureDataSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+	if (IsBlockCompressedFormat(format))
+	{
+		return GetTextureFormatBlockSizeInBytes(format) * ((width + 3) / 4) * ((height + 3) / 4);
+	}
+	return GetTextureFormatSizeInBytes(format) * width * height;
+}
+
+// Bytes between two rows of pixels, a row of 4x4 blocks for block compressed formats
+static constexpr size_t GetTextureRowPitch(TextureFormat format, uint32_t width)
+{
+	if (IsBlockCompressedFormat(format))
+	{
+		return GetTextureFormatBlockSizeInBytes(format) * ((width + 3) / 4);
+	}
+	return GetTextureFormatSizeInBytes(format) * width;
+}
+
 static constexpr bool IsDepthStencilFormat(TextureFormat format)
 {
 	switch (format)
@@ -0,0 +1,380 @@
+#include "gpch.h"
+#include "TextureStreamer.h"
+
+#include "Core/Engine.h"
+#include "Core/Globals.h"
+#include "Core/Application.h"
+#include "Renderer/RenderSystem.h"
+#include "Assets/AssetManager.h"
+
+using namespace Gleam;
+
+void TextureStreamer::Initialize(Application* app)
+{
+	mLoadThreads = CreateScope<ThreadPool>(2);
+	mUploadCommandBuffer = CreateScope<CommandBuffer>(Globals::Engine->GetSubsystem<RenderSystem>()->GetDevice());
+}
+
+void TextureStreamer::Shutdown()
+{
+	// joining the streaming threads first, nothing is pushed to the completed loads afterwards
+	mLoadThreads.reset();
+	mCompletedLoads.clear();
+
+	auto device = Globals::Engine->GetSubsystem<RenderSystem>()->GetDevice();
+	mUploadCommandBuffer->WaitUntilCompleted();
+	mUploadCommandBuffer.reset();
+
+	for (auto& [ref, texture] : mTextures)
+	{
+		if (texture.texture.IsValid())
+		{
+			device->ReleaseTexture(texture.texture);
+		}
+	}
+	mTextures.clear();
+}
+
+void TextureStreamer::Request(const AssetReference& ref, float screenSize)
+{
+	if (ref.guid == Guid::InvalidGuid())
+	{
+		return;
+	}
+
+	auto [it, inserted] = mTextures.try_emplace(ref);
+	if (inserted)
+	{
+		auto assetManager = Globals::GameInstance->GetSubsystem<AssetManager>();
+		assetManager->LoadAsync<TextureDescriptor>(ref, AssetLoadPriority::Normal, [this, ref](const RefCounted<const TextureDescriptor>& descriptor)
+		{
+			auto it = mTextures.find(ref);
+			if (it == mTextures.end())
+			{
+				return;
+			}
+
+			auto& texture = it->second;
+			if (descriptor == nullptr)
+			{
+				texture.failed = true;
+				return;
+			}
+
+			texture.descriptor = descriptor;
+			texture.mipCount = descriptor->HasSidecar() ? static_cast<uint32_t>(descriptor->mips.size()) : 1;
+
+			uint32_t size = static_cast<uint32_t>(Math::Max(descriptor->size.width, descriptor->size.height));
+			while (texture.minMip + 1 < texture.mipCount && (size >> texture.minMip) > MinResidentSize)
+			{
+				texture.minMip++;
+			}
+		});
+	}
+
+	// the largest renderer of the frame decides, sizes of older frames are dropped
+	auto& texture = it->second;
+	if (texture.lastRequestFrame != mFrameIndex)
+	{
+		texture.lastRequestFrame = mFrameIndex;
+		texture.screenSize = 0.0f;
+	}
+	texture.screenSize = Math::Max(texture.screenSize, screenSize);
+}
+
+void TextureStreamer::Update()
+{
+	// finished tails share one command buffer, the previous one has had a whole frame to complete
+	bool recording = false;
+	size_t uploaded = 0;
+	while (uploaded < mUploadBudget)
+	{
+		MipTailLoad load;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mCompletedLoads.empty())
+				break;
+
+			load = std::move(mCompletedLoads.front());
+			mCompletedLoads.pop_front();
+		}
+
+		auto it = mTextures.find(load.ref);
+		if (it == mTextures.end())
+			continue;
+
+		if (recording == false)
+		{
+			mUploadCommandBuffer->WaitUntilCompleted();
+			mUploadCommandBuffer->Begin();
+			recording = true;
+		}
+
+		for (const auto& level : load.levels)
+		{
+			uploaded += level.size();
+		}
+		Upload(load, it->second);
+	}
+
+	if (recording)
+	{
+		mUploadCommandBuffer->End();
+		mUploadCommandBuffer->Commit();
+	}
+
+	UpdateDesiredMips();
+	FitBudget();
+
+	// textures with nothing resident get their smallest tail first, then evictions free memory before loads claim it
+	struct Candidate
+	{
+		const AssetReference* ref;
+		StreamedTexture* texture;
+		uint32_t firstMip;
+		uint32_t order;
+	};
+	TArray<Candidate> candidates;
+	uint32_t pendingLoads = 0;
+	for (auto& [ref, texture] : mTextures)
+	{
+		if (texture.loading)
+		{
+			pendingLoads++;
+			continue;
+		}
+
+		if (texture.descriptor == nullptr || texture.failed || texture.desiredMip == texture.residentMip)
+			continue;
+
+		if (texture.residentMip == NotResident)
+		{
+			candidates.push_back({ .ref = &ref, .texture = &texture, .firstMip = texture.minMip, .order = 0 });
+		}
+		else
+		{
+			uint32_t order = texture.desiredMip > texture.residentMip ? 1 : 2;
+			candidates.push_back({ .ref = &ref, .texture = &texture, .firstMip = texture.desiredMip, .order = order });
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& left, const Candidate& right)
+	{
+		if (left.order != right.order)
+			return left.order < right.order;
+		return left.texture->screenSize > right.texture->screenSize;
+	});
+
+	for (const auto& candidate : candidates)
+	{
+		if (pendingLoads >= MaxPendingLoads)
+			break;
+
+		StartLoad(*candidate.ref, *candidate.texture, candidate.firstMip);
+		pendingLoads++;
+	}
+
+	mStats.textures = static_cast<uint32_t>(mTextures.size());
+	mStats.pendingLoads = pendingLoads;
+	mStats.residentBytes = 0;
+	for (const auto& [ref, texture] : mTextures)
+	{
+		mStats.residentBytes += GetTailSize(texture, texture.residentMip);
+	}
+	mFrameIndex++;
+}
+
+Texture TextureStreamer::GetTexture(const AssetReference& ref) const
+{
+	auto it = mTextures.find(ref);
+	return it != mTextures.end() ? it->second.texture : Texture();
+}
+
+uint32_t TextureStreamer::GetResidentMip(const AssetReference& ref) const
+{
+	auto it = mTextures.find(ref);
+	return it != mTextures.end() ? it->second.residentMip : NotResident;
+}
+
+void TextureStreamer::SetBudget(size_t bytes)
+{
+	mStats.budget = bytes;
+}
+
+void TextureStreamer::SetUploadBudget(size_t bytes)
+{
+	mUploadBudget = bytes;
+}
+
+const TextureStreamingStats& TextureStreamer::GetStats() const
+{
+	return mStats;
+}
+
+void TextureStreamer::StartLoad(const AssetReference& ref, StreamedTexture& texture, uint32_t firstMip)
+{
+	texture.loading = true;
+
+	// opening and mapping the sidecar is file system work as well, none of it happens on the main thread
+	auto descriptor = texture.descriptor;
+	uint32_t mipCount = texture.mipCount;
+	mLoadThreads->Submit([this, ref, firstMip, mipCount, descriptor]()
+	{
+		MappedFile sidecar;
+		if (descriptor->HasSidecar())
+		{
+			sidecar = Globals::GameInstance->GetSubsystem<AssetManager>()->MapSidecar(ref);
+		}
+
+		MipTailLoad load = { .ref = ref, .firstMip = firstMip };
+		load.levels.reserve(mipCount - firstMip);
+		for (uint32_t level = firstMip; level < mipCount; ++level)
+		{
+			if (descriptor->HasSidecar())
+			{
+				auto data = descriptor->GetMip(level, sidecar.GetData(), sidecar.GetSize());
+				load.levels.emplace_back(data.begin(), data.end());
+			}
+			else
+			{
+				load.levels.push_back(descriptor->pixels);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCompletedLoads.push_back(std::move(load));
+	});
+}
+
+void TextureStreamer::Upload(MipTailLoad& load, StreamedTexture& texture)
+{
+	texture.loading = false;
+
+	const auto& source = *texture.descriptor;
+	for (const auto& level : load.levels)
+	{
+		if (level.empty())
+		{
+			GLEAM_CORE_ERROR("Texture {0} mip tail could not be read, streaming is disabled for it", source.name);
+			texture.failed = true;
+			return;
+		}
+	}
+
+	// every tail is its own texture, the first resident mip becomes level 0
+	TextureDescriptor descriptor;
+	descriptor.name = source.name;
+	descriptor.format = source.format;
+	descriptor.dimension = source.dimension;
+	descriptor.size = Size(static_cast<float>(Math::Max(static_cast<uint32_t>(source.size.width) >> load.firstMip, 1u)),
+						   static_cast<float>(Math::Max(static_cast<uint32_t>(source.size.height) >> load.firstMip, 1u)));
+	descriptor.useMipMap = load.levels.size() > 1;
+
+	auto device = Globals::Engine->GetSubsystem<RenderSystem>()->GetDevice();
+	auto streamed = device->CreateTexture(descriptor);
+	for (uint32_t i = 0; i < load.levels.size(); ++i)
+	{
+		mUploadCommandBuffer->SetTextureData(streamed, load.levels[i].data(), load.levels[i].size(), i);
+	}
+
+	// frames in flight may still sample the previous tail, the device pools it until they complete
+	if (texture.texture.IsValid())
+	{
+		device->ReleaseTexture(texture.texture);
+	}
+
+	if (texture.residentMip != NotResident && load.firstMip > texture.residentMip)
+	{
+		mStats.evictions++;
+	}
+	else
+	{
+		mStats.loads++;
+	}
+	texture.texture = streamed;
+	texture.residentMip = load.firstMip;
+}
+
+void TextureStreamer::UpdateDesiredMips()
+{
+	float screenHeight = Globals::Engine->GetSubsystem<RenderSystem>()->GetDevice()->GetDrawableSize().height;
+	for (auto& [ref, texture] : mTextures)
+	{
+		if (texture.descriptor == nullptr || texture.failed)
+			continue;
+
+		texture.desiredMip = texture.minMip;
+		if (texture.screenSize <= 0.0f || mFrameIndex - texture.lastRequestFrame > EvictionDelay)
+			continue;
+
+		// one texel per pixel, assuming the texture spans its renderer once
+		float texels = Math::Max(texture.descriptor->size.width, texture.descriptor->size.height);
+		float pixels = Math::Max(texture.screenSize * screenHeight, 1.0f);
+		float mip = Math::Floor(Math::Log2(Math::Max(texels / pixels, 1.0f)));
+		texture.desiredMip = Math::Min(static_cast<uint32_t>(mip), texture.minMip);
+	}
+}
+
+void TextureStreamer::FitBudget()
+{
+	TArray<StreamedTexture*> textures;
+	size_t total = 0;
+	for (auto& [ref, texture] : mTextures)
+	{
+		if (texture.descriptor == nullptr || texture.failed)
+			continue;
+
+		total += GetTailSize(texture, texture.desiredMip);
+		textures.push_back(&texture);
+	}
+	mStats.desiredBytes = total;
+
+	if (total <= mStats.budget)
+	{
+		return;
+	}
+
+	// one mip at a time across the least visible textures, so that the loss is spread instead of hitting a single texture
+	std::sort(textures.begin(), textures.end(), [](const StreamedTexture* left, const StreamedTexture* right)
+	{
+		return left->screenSize < right->screenSize;
+	});
+
+	bool dropped = true;
+	while (total > mStats.budget && dropped)
+	{
+		dropped = false;
+		for (auto texture : textures)
+		{
+			if (total <= mStats.budget)
+				break;
+
+			if (texture->desiredMip >= texture->minMip)
+				continue;
+
+			total -= GetTailSize(*texture, texture->desiredMip) - GetTailSize(*texture, texture->desiredMip + 1);
+			texture->desiredMip++;
+			dropped = true;
+		}
+	}
+}
+
+size_t TextureStreamer::GetTailSize(const StreamedTexture& texture, uint32_t firstMip) const
+{
+	if (texture.descriptor == nullptr || firstMip >= texture.mipCount)
+	{
+		return 0;
+	}
+
+	if (texture.descriptor->HasSidecar() == false)
+	{
+		return texture.descriptor->pixels.size();
+	}
+
+	size_t size = 0;
+	for (uint32_t level = firstMip; level < texture.mipCount; ++level)
+	{
+		size += texture.descriptor->mips[level].length;
+	}
+	return size;
+}
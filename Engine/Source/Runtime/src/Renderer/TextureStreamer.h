@@ -0,0 +1,117 @@
+#pragma once
+#include "Core/Subsystem.h"
+#include "Core/ThreadPool.h"
+#include "Assets/AssetReference.h"
+#include "CommandBuffer.h"
+
+#include <mutex>
+
+namespace Gleam {
+
+struct TextureStreamingStats
+{
+	uint32_t textures = 0;
+	uint32_t pendingLoads = 0;
+	uint64_t loads = 0;
+	uint64_t evictions = 0;
+	size_t residentBytes = 0;
+	size_t desiredBytes = 0; // every texture at the mip its renderers ask for, before the budget is applied
+	size_t budget = 512 * 1024 * 1024;
+};
+
+/*
+* Keeps a mip tail of every texture drawn by a MeshRenderer resident on the GPU
+* The first resident mip follows the on screen size of the renderers using the texture
+* Tails are read from the texture sidecar on the streaming threads and uploaded on the main thread
+* When the desired mips do not fit the budget, the least visible textures give up their most detailed mip first
+*/
+class TextureStreamer final : public GameInstanceSubsystem
+{
+public:
+
+	static constexpr uint32_t NotResident = std::numeric_limits<uint32_t>::max();
+
+	// mips of this size and below stay resident for every known texture, so nothing is drawn without data
+	static constexpr uint32_t MinResidentSize = 64;
+
+	// frames a texture keeps its detailed mips after its renderers stop drawing it
+	static constexpr uint32_t EvictionDelay = 60;
+
+	static constexpr uint32_t MaxPendingLoads = 8;
+
+	virtual void Initialize(Application* app) override;
+
+	virtual void Shutdown() override;
+
+	// Marks the texture as drawn this frame, screenSize is the fraction of the screen height its renderer covers
+	void Request(const AssetReference& ref, float screenSize);
+
+	// Uploads finished tails, updates the desired mips from this frame's requests and starts new loads
+	void Update();
+
+	// Invalid until the first mip tail of the texture is uploaded, batches bind whichever tail this returns for the frame
+	Texture GetTexture(const AssetReference& ref) const;
+
+	// Index of the most detailed resident mip, NotResident until the first tail is uploaded
+	uint32_t GetResidentMip(const AssetReference& ref) const;
+
+	void SetBudget(size_t bytes);
+
+	// Bytes uploaded per frame, a single tail larger than this still goes through on its own
+	void SetUploadBudget(size_t bytes);
+
+	const TextureStreamingStats& GetStats() const;
+
+private:
+
+	struct StreamedTexture
+	{
+		RefCounted<const TextureDescriptor> descriptor;
+		Texture texture;
+		uint32_t mipCount = 0;
+		uint32_t minMip = 0; // first mip of the tail that is always resident
+		uint32_t residentMip = NotResident;
+		uint32_t desiredMip = 0;
+		uint32_t lastRequestFrame = 0;
+		float screenSize = 0.0f;
+		bool loading = false;
+		bool failed = false;
+	};
+
+	struct MipTailLoad
+	{
+		AssetReference ref;
+		uint32_t firstMip = 0;
+		TArray<TArray<uint8_t>> levels;
+	};
+
+	void StartLoad(const AssetReference& ref, StreamedTexture& texture, uint32_t firstMip);
+
+	void Upload(MipTailLoad& load, StreamedTexture& texture);
+
+	void UpdateDesiredMips();
+
+	void FitBudget();
+
+	size_t GetTailSize(const StreamedTexture& texture, uint32_t firstMip) const;
+
+	HashMap<AssetReference, StreamedTexture> mTextures;
+
+	Scope<ThreadPool> mLoadThreads;
+
+	Scope<CommandBuffer> mUploadCommandBuffer;
+
+	std::mutex mMutex;
+
+	// filled by the streaming threads, drained on the main thread
+	Deque<MipTailLoad> mCompletedLoads;
+
+	TextureStreamingStats mStats;
+
+	size_t mUploadBudget = 32 * 1024 * 1024;
+
+	uint32_t mFrameIndex = 0;
+
+};
+
+} // namespace Gleam
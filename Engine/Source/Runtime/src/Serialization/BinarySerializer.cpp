@@ -0,0 +1,893 @@
+#include "gpch.h"
+#include "BinarySerializer.h"
+
+using namespace Gleam;
+
+static constexpr uint64_t HashOffsetBasis = 14695981039346656037ull;
+static constexpr uint64_t HashPrime = 1099511628211ull;
+
+// FNV-1a, schema hashes are stored in files so they have to be stable across builds
+static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = HashOffsetBasis)
+{
+	const auto bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= HashPrime;
+	}
+	return hash;
+}
+
+static uint64_t HashString(const TStringView str, uint64_t hash = HashOffsetBasis)
+{
+	return HashBytes(str.data(), str.size(), hash);
+}
+
+template<typename T>
+static uint64_t HashValue(const T& value, uint64_t hash = HashOffsetBasis)
+{
+	return HashBytes(&value, sizeof(T), hash);
+}
+
+static bool IsTrivial(const BinarySchemaType& type)
+{
+	return type.flags & BinarySchemaType::Trivial;
+}
+
+static void WriteBytes(TArray<uint8_t>& out, const void* data, size_t size)
+{
+	const auto bytes = static_cast<const uint8_t*>(data);
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+static void CollectFields(const Reflection::ClassDescription& classDesc, TArray<const Reflection::FieldDescription*>& fields)
+{
+	for (const auto& baseClass : classDesc.ResolveBaseClasses())
+	{
+		CollectFields(baseClass, fields);
+	}
+
+	for (const auto& field : classDesc.ResolveFields())
+	{
+		if (field.HasAttribute<Reflection::Attribute::Serializable>())
+		{
+			fields.push_back(&field);
+		}
+	}
+}
+
+struct BinaryCursor
+{
+	const uint8_t* cursor;
+	const uint8_t* end;
+	bool valid = true;
+	uint32_t depth = 0;
+
+	bool Skip(size_t size)
+	{
+		if (valid == false || size > static_cast<size_t>(end - cursor))
+		{
+			valid = false;
+			return false;
+		}
+		cursor += size;
+		return true;
+	}
+
+	bool Read(void* data, size_t size)
+	{
+		const uint8_t* src = cursor;
+		if (Skip(size) == false)
+		{
+			return false;
+		}
+		memcpy(data, src, size);
+		return true;
+	}
+
+	template<typename T>
+	T Read()
+	{
+		T value{};
+		Read(&value, sizeof(T));
+		return value;
+	}
+
+	TStringView ReadString()
+	{
+		uint32_t length = Read<uint32_t>();
+		const char* characters = reinterpret_cast<const char*>(cursor);
+		if (Skip(length) == false)
+		{
+			return TStringView();
+		}
+		return TStringView(characters, length);
+	}
+};
+
+/*
+* Schemas are read from the file and vectors may legitimately contain their own type,
+* so nesting is capped instead of trusting the type graph to end
+*/
+struct BinaryNestingScope
+{
+	static constexpr uint32_t MaxDepth = 64;
+
+	BinaryCursor& cursor;
+
+	BinaryNestingScope(BinaryCursor& cursor)
+		: cursor(cursor)
+	{
+		if (++cursor.depth > MaxDepth)
+		{
+			cursor.valid = false;
+		}
+	}
+
+	~BinaryNestingScope()
+	{
+		cursor.depth--;
+	}
+};
+
+struct BinarySchemaView
+{
+	const BinarySchemaType* types;
+	const BinarySchemaField* fields;
+};
+
+#pragma region mark Schema
+uint32_t BinarySchema::PushType(BinaryTypeKind kind, uint32_t flags, size_t size)
+{
+	BinarySchemaType type;
+	type.kind = kind;
+	type.flags = flags;
+	type.size = (flags & BinarySchemaType::Trivial) ? static_cast<uint32_t>(size) : 0;
+	type.hash = HashValue(kind);
+	types.push_back(type);
+	memorySizes.push_back(size);
+	return static_cast<uint32_t>(types.size() - 1);
+}
+
+uint32_t BinarySchema::AddPrimitive(Reflection::PrimitiveType primitive, size_t size)
+{
+	auto it = mPrimitiveIndices.find(primitive);
+	if (it != mPrimitiveIndices.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = PushType(BinaryTypeKind::Primitive, BinarySchemaType::Trivial, size);
+	types[index].hash = HashValue(primitive, types[index].hash);
+	mPrimitiveIndices[primitive] = index;
+	return index;
+}
+
+uint32_t BinarySchema::AddEnum(size_t hash, size_t size)
+{
+	auto it = mTypeIndices.find(hash);
+	if (it != mTypeIndices.end())
+	{
+		return it->second;
+	}
+
+	const auto& enumDesc = Reflection::GetEnum(hash);
+	uint32_t index = PushType(BinaryTypeKind::Enum, BinarySchemaType::Trivial, size);
+	types[index].hash = HashString(enumDesc.ResolveName(), HashValue(types[index].size, types[index].hash));
+	mTypeIndices[hash] = index;
+	return index;
+}
+
+uint32_t BinarySchema::AddArray(size_t hash)
+{
+	auto it = mTypeIndices.find(hash);
+	if (it != mTypeIndices.end())
+	{
+		return it->second;
+	}
+
+	const auto& arrayDesc = Reflection::GetArray(hash);
+	uint32_t index = PushType(BinaryTypeKind::Array, 0, arrayDesc.GetSize());
+	mTypeIndices[hash] = index;
+
+	uint32_t element = AddElement(arrayDesc);
+	uint32_t count = static_cast<uint32_t>(arrayDesc.GetSize() / arrayDesc.GetStride());
+
+	auto& type = types[index];
+	type.element = element;
+	type.count = count;
+	type.hash = HashValue(count, HashValue(types[element].hash, type.hash));
+	if (IsTrivial(types[element]) && size_t(types[element].size) * count == arrayDesc.GetSize())
+	{
+		type.flags |= BinarySchemaType::Trivial;
+		type.size = static_cast<uint32_t>(arrayDesc.GetSize());
+	}
+	return index;
+}
+
+uint32_t BinarySchema::AddElement(const Reflection::ArrayDescription& arrayDesc)
+{
+	switch (arrayDesc.ElementType())
+	{
+		case Reflection::FieldType::Primitive:
+			return AddPrimitive(Reflection::Database::GetPrimitiveType(arrayDesc.ElementHash()), arrayDesc.GetStride());
+		case Reflection::FieldType::Enum:
+			return AddEnum(arrayDesc.ElementHash(), arrayDesc.GetStride());
+		case Reflection::FieldType::Array:
+			return AddArray(arrayDesc.ElementHash());
+		case Reflection::FieldType::Class:
+			return AddClass(Reflection::GetClass(arrayDesc.ElementHash()), arrayDesc.ElementHash());
+		default:
+			GLEAM_ASSERT(false, "BinarySerializer: Unknown element kind");
+			return PushType(BinaryTypeKind::Raw, BinarySchemaType::Trivial, 0);
+	}
+}
+
+uint32_t BinarySchema::AddClass(const Reflection::ClassDescription& classDesc)
+{
+	return AddClass(classDesc, Reflection::Database::GetTypeHash(classDesc.ResolveName()));
+}
+
+uint32_t BinarySchema::AddClass(const Reflection::ClassDescription& classDesc, size_t hash)
+{
+	auto it = mTypeIndices.find(hash);
+	if (it != mTypeIndices.end())
+	{
+		return it->second;
+	}
+
+	const auto name = classDesc.ResolveName();
+	if (name == Reflection::GetClass<TArray<uint8_t>>().ResolveName())
+	{
+		uint32_t index = PushType(BinaryTypeKind::Vector, 0, classDesc.GetSize());
+		mTypeIndices[hash] = index;
+
+		uint32_t element = AddElement(Reflection::GetArray(classDesc.ContainerHash()));
+		types[index].element = element;
+		types[index].hash = HashValue(types[element].hash, types[index].hash);
+		return index;
+	}
+
+	BinaryTypeKind leafKind = BinaryTypeKind::Class;
+	if (name == Reflection::GetClass<Guid>().ResolveName())
+	{
+		leafKind = BinaryTypeKind::Guid;
+	}
+	else if (name == Reflection::GetClass<TString>().ResolveName())
+	{
+		leafKind = BinaryTypeKind::String;
+	}
+	else if (name == Reflection::GetClass<Filesystem::Path>().ResolveName())
+	{
+		leafKind = BinaryTypeKind::Path;
+	}
+	else if (classDesc.ResolveFields().empty() && classDesc.ResolveBaseClasses().empty())
+	{
+		// types without reflected fields (e.g. std::array) are stored as they are laid out in memory
+		leafKind = BinaryTypeKind::Raw;
+	}
+
+	if (leafKind != BinaryTypeKind::Class)
+	{
+		uint32_t flags = leafKind == BinaryTypeKind::Raw ? BinarySchemaType::Trivial : 0;
+		uint32_t index = PushType(leafKind, flags, classDesc.GetSize());
+		if (leafKind == BinaryTypeKind::Raw)
+		{
+			types[index].hash = HashString(name, HashValue(types[index].size, types[index].hash));
+		}
+		mTypeIndices[hash] = index;
+		return index;
+	}
+
+	uint32_t index = PushType(BinaryTypeKind::Class, 0, classDesc.GetSize());
+	mTypeIndices[hash] = index;
+
+	TArray<const Reflection::FieldDescription*> fieldDescs;
+	CollectFields(classDesc, fieldDescs);
+
+	TArray<BinarySchemaField> classFields;
+	TArray<size_t> classFieldOffsets;
+	classFields.reserve(fieldDescs.size());
+	classFieldOffsets.reserve(fieldDescs.size());
+
+	bool trivial = not fieldDescs.empty();
+	size_t packedSize = 0;
+	for (const auto field : fieldDescs)
+	{
+		uint32_t fieldType = 0;
+		size_t fieldOffset = 0;
+		switch (field->GetType())
+		{
+			case Reflection::FieldType::Primitive:
+			{
+				const auto& primitiveField = field->GetField<Reflection::PrimitiveField>();
+				fieldType = AddPrimitive(primitiveField.primitive, primitiveField.size);
+				fieldOffset = primitiveField.offset;
+				break;
+			}
+			case Reflection::FieldType::Enum:
+			{
+				const auto& enumField = field->GetField<Reflection::EnumField>();
+				fieldType = AddEnum(enumField.hash, enumField.size);
+				fieldOffset = enumField.offset;
+				break;
+			}
+			case Reflection::FieldType::Array:
+			{
+				const auto& arrayField = field->GetField<Reflection::ArrayField>();
+				fieldType = AddArray(arrayField.hash);
+				fieldOffset = arrayField.offset;
+				break;
+			}
+			case Reflection::FieldType::Class:
+			{
+				const auto& classField = field->GetField<Reflection::ClassField>();
+				fieldType = AddClass(Reflection::GetClass(classField.hash), classField.hash);
+				fieldOffset = classField.offset;
+				break;
+			}
+			default:
+				continue;
+		}
+
+		// fields have to follow each other without padding for the memory layout to be the encoding
+		trivial = trivial && IsTrivial(types[fieldType]) && fieldOffset == packedSize;
+		packedSize = fieldOffset + memorySizes[fieldType];
+
+		classFields.push_back({ .nameHash = HashString(field->ResolveName()), .type = fieldType });
+		classFieldOffsets.push_back(fieldOffset);
+	}
+	trivial = trivial && packedSize == classDesc.GetSize();
+
+	auto& type = types[index];
+	type.firstField = static_cast<uint32_t>(fields.size());
+	type.fieldCount = static_cast<uint32_t>(classFields.size());
+	type.hash = HashString(name, type.hash);
+	for (const auto& field : classFields)
+	{
+		type.hash = HashValue(types[field.type].hash, HashValue(field.nameHash, type.hash));
+	}
+	if (trivial)
+	{
+		type.flags |= BinarySchemaType::Trivial;
+		type.size = static_cast<uint32_t>(classDesc.GetSize());
+	}
+
+	fields.insert(fields.end(), classFields.begin(), classFields.end());
+	fieldOffsets.insert(fieldOffsets.end(), classFieldOffsets.begin(), classFieldOffsets.end());
+	return index;
+}
+#pragma endregion Schema
+
+#pragma region mark Encode
+static void EncodeValue(const BinarySchema& schema, uint32_t typeIndex, const void* obj, TArray<uint8_t>& out);
+
+static void EncodeElements(const BinarySchema& schema, uint32_t elementIndex, const void* obj, size_t count, TArray<uint8_t>& out)
+{
+	const auto& element = schema.types[elementIndex];
+	if (IsTrivial(element))
+	{
+		WriteBytes(out, obj, count * element.size);
+		return;
+	}
+
+	const size_t stride = schema.memorySizes[elementIndex];
+	for (size_t i = 0; i < count; i++)
+	{
+		EncodeValue(schema, elementIndex, OffsetPointer(obj, i * stride), out);
+	}
+}
+
+static void EncodeString(const TStringView str, TArray<uint8_t>& out)
+{
+	uint32_t length = static_cast<uint32_t>(str.length());
+	WriteBytes(out, &length, sizeof(uint32_t));
+	WriteBytes(out, str.data(), length);
+}
+
+static void EncodeValue(const BinarySchema& schema, uint32_t typeIndex, const void* obj, TArray<uint8_t>& out)
+{
+	const auto& type = schema.types[typeIndex];
+	if (IsTrivial(type))
+	{
+		WriteBytes(out, obj, type.size);
+		return;
+	}
+
+	switch (type.kind)
+	{
+		case BinaryTypeKind::Guid:
+		{
+			WriteBytes(out, Reflection::Get<Guid>(obj).GetBytes().data(), 16);
+			break;
+		}
+		case BinaryTypeKind::String:
+		{
+			EncodeString(Reflection::Get<TString>(obj), out);
+			break;
+		}
+		case BinaryTypeKind::Path:
+		{
+			EncodeString(Reflection::Get<Filesystem::Path>(obj).string(), out);
+			break;
+		}
+		case BinaryTypeKind::Array:
+		{
+			EncodeElements(schema, type.element, obj, type.count, out);
+			break;
+		}
+		case BinaryTypeKind::Vector:
+		{
+			const auto& arr = Reflection::Get<TArray<uint8_t>>(obj);
+			uint32_t count = static_cast<uint32_t>(arr.size() / schema.memorySizes[type.element]);
+			WriteBytes(out, &count, sizeof(uint32_t));
+			EncodeElements(schema, type.element, arr.data(), count, out);
+			break;
+		}
+		case BinaryTypeKind::Class:
+		{
+			for (uint32_t i = type.firstField; i < type.firstField + type.fieldCount; i++)
+			{
+				EncodeValue(schema, schema.fields[i].type, OffsetPointer(obj, schema.fieldOffsets[i]), out);
+			}
+			break;
+		}
+		default:
+		{
+			GLEAM_ASSERT(false, "BinarySerializer: Unknown type kind");
+			break;
+		}
+	}
+}
+#pragma endregion Encode
+
+#pragma region mark Decode
+// Decodes a value written with the same schema as the running one
+static void DecodeValue(const BinarySchema& schema, uint32_t typeIndex, BinaryCursor& cursor, void* obj);
+
+static void DecodeElements(const BinarySchema& schema, uint32_t elementIndex, BinaryCursor& cursor, void* obj, size_t count)
+{
+	const auto& element = schema.types[elementIndex];
+	if (IsTrivial(element))
+	{
+		cursor.Read(obj, count * element.size);
+		return;
+	}
+
+	const size_t stride = schema.memorySizes[elementIndex];
+	for (size_t i = 0; i < count && cursor.valid; i++)
+	{
+		DecodeValue(schema, elementIndex, cursor, OffsetPointer(obj, i * stride));
+	}
+}
+
+static bool ResizeVector(BinaryCursor& cursor, uint32_t count, size_t stride, void* obj)
+{
+	// every element takes at least a byte, a larger count can only come from corrupted data
+	if (count > static_cast<size_t>(cursor.end - cursor.cursor))
+	{
+		cursor.valid = false;
+		return false;
+	}
+	auto& arr = Reflection::Get<TArray<uint8_t>>(obj);
+	arr.resize(count * stride);
+	return true;
+}
+
+static void DecodeValue(const BinarySchema& schema, uint32_t typeIndex, BinaryCursor& cursor, void* obj)
+{
+	BinaryNestingScope scope(cursor);
+	if (cursor.valid == false)
+	{
+		return;
+	}
+
+	const auto& type = schema.types[typeIndex];
+	if (IsTrivial(type))
+	{
+		cursor.Read(obj, type.size);
+		return;
+	}
+
+	switch (type.kind)
+	{
+		case BinaryTypeKind::Guid:
+		{
+			TArray<uint8_t, 16> bytes{};
+			if (cursor.Read(bytes.data(), bytes.size()))
+			{
+				Reflection::Get<Guid>(obj) = Guid(bytes);
+			}
+			break;
+		}
+		case BinaryTypeKind::String:
+		{
+			Reflection::Get<TString>(obj) = TString(cursor.ReadString());
+			break;
+		}
+		case BinaryTypeKind::Path:
+		{
+			Reflection::Get<Filesystem::Path>(obj) = Filesystem::Path(cursor.ReadString());
+			break;
+		}
+		case BinaryTypeKind::Array:
+		{
+			DecodeElements(schema, type.element, cursor, obj, type.count);
+			break;
+		}
+		case BinaryTypeKind::Vector:
+		{
+			uint32_t count = cursor.Read<uint32_t>();
+			if (ResizeVector(cursor, count, schema.memorySizes[type.element], obj))
+			{
+				DecodeElements(schema, type.element, cursor, Reflection::Get<TArray<uint8_t>>(obj).data(), count);
+			}
+			break;
+		}
+		case BinaryTypeKind::Class:
+		{
+			for (uint32_t i = type.firstField; i < type.firstField + type.fieldCount && cursor.valid; i++)
+			{
+				DecodeValue(schema, schema.fields[i].type, cursor, OffsetPointer(obj, schema.fieldOffsets[i]));
+			}
+			break;
+		}
+		default:
+		{
+			GLEAM_ASSERT(false, "BinarySerializer: Unknown type kind");
+			break;
+		}
+	}
+}
+
+static void SkipValue(const BinarySchemaView& file, uint32_t typeIndex, BinaryCursor& cursor)
+{
+	BinaryNestingScope scope(cursor);
+	if (cursor.valid == false)
+	{
+		return;
+	}
+
+	const auto& type = file.types[typeIndex];
+	if (IsTrivial(type))
+	{
+		cursor.Skip(type.size);
+		return;
+	}
+
+	switch (type.kind)
+	{
+		case BinaryTypeKind::Guid:
+		{
+			cursor.Skip(16);
+			break;
+		}
+		case BinaryTypeKind::String:
+		case BinaryTypeKind::Path:
+		{
+			cursor.ReadString();
+			break;
+		}
+		case BinaryTypeKind::Array:
+		case BinaryTypeKind::Vector:
+		{
+			uint32_t count = type.kind == BinaryTypeKind::Array ? type.count : cursor.Read<uint32_t>();
+			const auto& element = file.types[type.element];
+			if (IsTrivial(element))
+			{
+				cursor.Skip(size_t(count) * element.size);
+				break;
+			}
+			for (uint32_t i = 0; i < count && cursor.valid; i++)
+			{
+				SkipValue(file, type.element, cursor);
+			}
+			break;
+		}
+		case BinaryTypeKind::Class:
+		{
+			for (uint32_t i = type.firstField; i < type.firstField + type.fieldCount && cursor.valid; i++)
+			{
+				SkipValue(file, file.fields[i].type, cursor);
+			}
+			break;
+		}
+		default:
+		{
+			cursor.valid = false;
+			break;
+		}
+	}
+}
+
+// Decodes a value written with an older or newer schema, fields are matched by name
+static void DecodeValue(const BinarySchemaView& file, uint32_t fileIndex, const BinarySchema& schema, uint32_t typeIndex, BinaryCursor& cursor, void* obj)
+{
+	BinaryNestingScope scope(cursor);
+	if (cursor.valid == false)
+	{
+		return;
+	}
+
+	const auto& fileType = file.types[fileIndex];
+	const auto& type = schema.types[typeIndex];
+	if (fileType.kind != type.kind)
+	{
+		SkipValue(file, fileIndex, cursor);
+		return;
+	}
+
+	if (fileType.hash == type.hash)
+	{
+		DecodeValue(schema, typeIndex, cursor, obj);
+		return;
+	}
+
+	switch (type.kind)
+	{
+		case BinaryTypeKind::Array:
+		{
+			const size_t stride = schema.memorySizes[type.element];
+			for (uint32_t i = 0; i < fileType.count && cursor.valid; i++)
+			{
+				if (i < type.count)
+				{
+					DecodeValue(file, fileType.element, schema, type.element, cursor, OffsetPointer(obj, i * stride));
+				}
+				else
+				{
+					SkipValue(file, fileType.element, cursor);
+				}
+			}
+			break;
+		}
+		case BinaryTypeKind::Vector:
+		{
+			uint32_t count = cursor.Read<uint32_t>();
+			const size_t stride = schema.memorySizes[type.element];
+			if (ResizeVector(cursor, count, stride, obj))
+			{
+				auto data = Reflection::Get<TArray<uint8_t>>(obj).data();
+				for (uint32_t i = 0; i < count && cursor.valid; i++)
+				{
+					DecodeValue(file, fileType.element, schema, type.element, cursor, OffsetPointer(data, i * stride));
+				}
+			}
+			break;
+		}
+		case BinaryTypeKind::Class:
+		{
+			for (uint32_t i = fileType.firstField; i < fileType.firstField + fileType.fieldCount && cursor.valid; i++)
+			{
+				const auto& fileField = file.fields[i];
+
+				uint32_t match = type.firstField + type.fieldCount;
+				for (uint32_t j = type.firstField; j < type.firstField + type.fieldCount; j++)
+				{
+					if (schema.fields[j].nameHash == fileField.nameHash)
+					{
+						match = j;
+						break;
+					}
+				}
+
+				if (match < type.firstField + type.fieldCount)
+				{
+					DecodeValue(file, fileField.type, schema, schema.fields[match].type, cursor, OffsetPointer(obj, schema.fieldOffsets[match]));
+				}
+				else
+				{
+					SkipValue(file, fileField.type, cursor);
+				}
+			}
+			break;
+		}
+		default:
+		{
+			// primitives and enums whose type changed are left at their defaults
+			SkipValue(file, fileIndex, cursor);
+			break;
+		}
+	}
+}
+#pragma endregion Decode
+
+#pragma region mark BinaryWriter
+void BinaryWriter::Write(const void* obj, const Reflection::ClassDescription& classDesc)
+{
+	uint32_t typeIndex = mSchema.AddClass(classDesc);
+	if (mHeader.objectCount == 0)
+	{
+		mHeader.typeGuid = classDesc.Guid().GetBytes();
+		mHeader.schemaHash = mSchema.types[typeIndex].hash;
+		if (classDesc.HasAttribute<Reflection::Attribute::Version>())
+		{
+			mHeader.version = classDesc.GetAttribute<Reflection::Attribute::Version>().version;
+		}
+	}
+	mHeader.objectCount++;
+
+	WriteBytes(mPayload, &typeIndex, sizeof(uint32_t));
+	EncodeValue(mSchema, typeIndex, obj, mPayload);
+}
+
+void BinaryWriter::Finish(TArray<uint8_t>& out) const
+{
+	BinaryHeader header = mHeader;
+	header.typeCount = static_cast<uint32_t>(mSchema.types.size());
+	header.fieldCount = static_cast<uint32_t>(mSchema.fields.size());
+	header.payloadOffset = sizeof(BinaryHeader) + header.typeCount * sizeof(BinarySchemaType) + header.fieldCount * sizeof(BinarySchemaField);
+	header.payloadSize = mPayload.size();
+
+	out.reserve(out.size() + header.payloadOffset + header.payloadSize);
+	WriteBytes(out, &header, sizeof(BinaryHeader));
+	WriteBytes(out, mSchema.types.data(), mSchema.types.size() * sizeof(BinarySchemaType));
+	WriteBytes(out, mSchema.fields.data(), mSchema.fields.size() * sizeof(BinarySchemaField));
+	WriteBytes(out, mPayload.data(), mPayload.size());
+}
+#pragma endregion BinaryWriter
+
+#pragma region mark BinaryReader
+BinaryReader::BinaryReader(const uint8_t* data, size_t size)
+	: mData(data)
+{
+	if (BinarySerializer::IsBinary(data, size) == false)
+	{
+		return;
+	}
+
+	memcpy(&mHeader, data, sizeof(BinaryHeader));
+	if (mHeader.formatVersion != BinaryHeader::CurrentVersion)
+	{
+		GLEAM_CORE_ERROR("BinarySerializer: Format version {0} is not supported, expected {1}", mHeader.formatVersion, BinaryHeader::CurrentVersion);
+		return;
+	}
+
+	const size_t tablesEnd = sizeof(BinaryHeader) + size_t(mHeader.typeCount) * sizeof(BinarySchemaType) + size_t(mHeader.fieldCount) * sizeof(BinarySchemaField);
+	if (tablesEnd > mHeader.payloadOffset || mHeader.payloadOffset > size || mHeader.payloadSize > size - mHeader.payloadOffset)
+	{
+		GLEAM_CORE_ERROR("BinarySerializer: Data is truncated");
+		return;
+	}
+
+	mTypes = reinterpret_cast<const BinarySchemaType*>(data + sizeof(BinaryHeader));
+	mFields = reinterpret_cast<const BinarySchemaField*>(data + sizeof(BinaryHeader) + mHeader.typeCount * sizeof(BinarySchemaType));
+
+	// indices are trusted while decoding, validate them once
+	for (uint32_t i = 0; i < mHeader.typeCount; i++)
+	{
+		const auto& type = mTypes[i];
+		if (type.element >= mHeader.typeCount || size_t(type.firstField) + type.fieldCount > mHeader.fieldCount)
+		{
+			GLEAM_CORE_ERROR("BinarySerializer: Schema table is corrupted");
+			return;
+		}
+	}
+	for (uint32_t i = 0; i < mHeader.fieldCount; i++)
+	{
+		if (mFields[i].type >= mHeader.typeCount)
+		{
+			GLEAM_CORE_ERROR("BinarySerializer: Schema table is corrupted");
+			return;
+		}
+	}
+
+	mCursor = data + mHeader.payloadOffset;
+	mEnd = mCursor + mHeader.payloadSize;
+	mValid = true;
+}
+
+bool BinaryReader::IsValid() const
+{
+	return mValid;
+}
+
+const BinaryHeader& BinaryReader::GetHeader() const
+{
+	return mHeader;
+}
+
+bool BinaryReader::Read(const Reflection::ClassDescription& classDesc, void* obj)
+{
+	if (mValid == false)
+	{
+		return false;
+	}
+
+	BinaryCursor cursor{ .cursor = mCursor, .end = mEnd };
+	uint32_t fileIndex = cursor.Read<uint32_t>();
+	if (cursor.valid == false || fileIndex >= mHeader.typeCount)
+	{
+		GLEAM_CORE_ERROR("BinarySerializer: No object left to read for {0}", classDesc.ResolveName());
+		mValid = false;
+		return false;
+	}
+
+	// fields are matched by name across versions, but data written by a newer version may mean something else
+	if (classDesc.Guid().GetBytes() == mHeader.typeGuid && classDesc.HasAttribute<Reflection::Attribute::Version>())
+	{
+		uint32_t version = classDesc.GetAttribute<Reflection::Attribute::Version>().version;
+		if (mHeader.version > version)
+		{
+			GLEAM_CORE_ERROR("BinarySerializer: {0} version {1} is newer than the supported version {2}", classDesc.ResolveName(), mHeader.version, version);
+			mValid = false;
+			return false;
+		}
+	}
+
+	auto [it, inserted] = mSchemaIndices.try_emplace(&classDesc, 0);
+	if (inserted)
+	{
+		it->second = mSchema.AddClass(classDesc);
+	}
+
+	BinarySchemaView file{ .types = mTypes, .fields = mFields };
+	DecodeValue(file, fileIndex, mSchema, it->second, cursor, obj);
+
+	mCursor = cursor.cursor;
+	mValid = cursor.valid;
+	if (mValid == false)
+	{
+		GLEAM_CORE_ERROR("BinarySerializer: Data of {0} is truncated", classDesc.ResolveName());
+	}
+	return mValid;
+}
+#pragma endregion BinaryReader
+
+#pragma region mark BinarySerializer
+BinaryHeader BinarySerializer::ParseHeader()
+{
+	BinaryHeader header;
+	mStream.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader));
+	if (mStream.gcount() != sizeof(BinaryHeader))
+	{
+		header = BinaryHeader();
+		header.magic = 0;
+	}
+	return header;
+}
+
+void BinarySerializer::Serialize(const void* obj, const Reflection::ClassDescription& classDesc)
+{
+	BinaryWriter writer;
+	writer.Write(obj, classDesc);
+
+	TArray<uint8_t> data;
+	writer.Finish(data);
+	mStream.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+bool BinarySerializer::Deserialize(const Reflection::ClassDescription& classDesc, void* obj)
+{
+	auto begin = mStream.tellg();
+	mStream.seekg(0, std::ios::end);
+	auto end = mStream.tellg();
+	mStream.seekg(begin);
+
+	TArray<uint8_t> data(static_cast<size_t>(end - begin));
+	mStream.read(reinterpret_cast<char*>(data.data()), data.size());
+	return Deserialize(data.data(), data.size(), classDesc, obj);
+}
+
+bool BinarySerializer::Deserialize(const uint8_t* data, size_t size, const Reflection::ClassDescription& classDesc, void* obj)
+{
+	BinaryReader reader(data, size);
+	if (reader.IsValid() == false)
+	{
+		GLEAM_CORE_ERROR("BinarySerializer: Data is not a valid binary blob for {0}", classDesc.ResolveName());
+		return false;
+	}
+	return reader.Read(classDesc, obj);
+}
+
+bool BinarySerializer::IsBinary(const uint8_t* data, size_t size)
+{
+	uint32_t magic = 0;
+	if (data == nullptr || size < sizeof(BinaryHeader))
+	{
+		return false;
+	}
+	memcpy(&magic, data, sizeof(uint32_t));
+	return magic == BinaryHeader::Magic;
+}
+#pragma endregion BinarySerializer
@@ -2,22 +2,179 @@
 
 namespace Gleam {
 
+/*
+* Layout of a reflection driven binary blob, every table is 8 byte aligned
+*
+*   BinaryHeader
+*   type table   : BinarySchemaType[typeCount]
+*   field table  : BinarySchemaField[fieldCount]
+*   payload      : uint32_t type index followed by the encoded value, for every written object
+*
+* Trivially copyable types (primitives, enums and classes whose serializable fields cover their memory without gaps)
+* are stored as they are laid out in memory, arrays of them are copied in bulk.
+* Types whose schema hash differs from the running reflection data are decoded field by field,
+* matching fields by name hash so that added and removed fields are tolerated
+*/
+struct BinaryHeader
+{
+	static constexpr uint32_t Magic = 0x4E494247; // GBIN
+	static constexpr uint32_t CurrentVersion = 1;
+
+	uint32_t magic = Magic;
+	uint32_t formatVersion = CurrentVersion;
+	uint32_t version = 0;
+	uint32_t typeCount = 0;
+	uint32_t fieldCount = 0;
+	uint32_t objectCount = 0;
+	uint64_t schemaHash = 0;
+	uint64_t payloadOffset = 0;
+	uint64_t payloadSize = 0;
+	TArray<uint8_t, 16> typeGuid{};
+};
+
+enum class BinaryTypeKind : uint32_t
+{
+	Primitive,
+	Enum,
+	Raw,
+	Guid,
+	String,
+	Path,
+	Array,
+	Vector,
+	Class
+};
+
+struct BinarySchemaType
+{
+	static constexpr uint32_t Trivial = 1 << 0;
+
+	uint64_t hash = 0;
+	BinaryTypeKind kind = BinaryTypeKind::Raw;
+	uint32_t flags = 0;
+	uint32_t size = 0; // encoded size of trivially copyable types
+	uint32_t count = 0; // element count of fixed arrays
+	uint32_t element = 0; // element type of arrays and vectors
+	uint32_t firstField = 0;
+	uint32_t fieldCount = 0;
+	uint32_t reserved = 0;
+};
+
+struct BinarySchemaField
+{
+	uint64_t nameHash = 0;
+	uint32_t type = 0;
+	uint32_t reserved = 0;
+};
+
+/*
+* Type and field tables compiled from the reflection database
+* Memory layout of the running types is kept alongside, it is not written to the blob
+*/
+class BinarySchema
+{
+public:
+
+	uint32_t AddClass(const Reflection::ClassDescription& classDesc);
+
+	uint32_t AddClass(const Reflection::ClassDescription& classDesc, size_t hash);
+
+	TArray<BinarySchemaType> types;
+
+	TArray<BinarySchemaField> fields;
+
+	TArray<size_t> memorySizes;
+
+	TArray<size_t> fieldOffsets;
+
+private:
+
+	uint32_t AddPrimitive(Reflection::PrimitiveType type, size_t size);
+
+	uint32_t AddEnum(size_t hash, size_t size);
+
+	uint32_t AddArray(size_t hash);
+
+	uint32_t AddElement(const Reflection::ArrayDescription& arrayDesc);
+
+	uint32_t PushType(BinaryTypeKind kind, uint32_t flags, size_t size);
+
+	HashMap<size_t, uint32_t> mTypeIndices;
+
+	HashMap<Reflection::PrimitiveType, uint32_t, EnumClassHash> mPrimitiveIndices;
+
+};
+
+// Encodes any number of objects into one blob sharing a single schema
+class BinaryWriter final
+{
+public:
+
+	void Write(const void* obj, const Reflection::ClassDescription& classDesc);
+
+	void Finish(TArray<uint8_t>& out) const;
+
+private:
+
+	BinarySchema mSchema;
+
+	TArray<uint8_t> mPayload;
+
+	BinaryHeader mHeader;
+
+};
+
+// Decodes the objects of a blob in the order they were written, the data has to outlive the reader
+class BinaryReader final
+{
+public:
+
+	BinaryReader(const uint8_t* data, size_t size);
+
+	bool IsValid() const;
+
+	const BinaryHeader& GetHeader() const;
+
+	bool Read(const Reflection::ClassDescription& classDesc, void* obj);
+
+private:
+
+	const uint8_t* mData = nullptr;
+
+	const uint8_t* mCursor = nullptr;
+
+	const uint8_t* mEnd = nullptr;
+
+	const BinarySchemaType* mTypes = nullptr;
+
+	const BinarySchemaField* mFields = nullptr;
+
+	BinaryHeader mHeader;
+
+	BinarySchema mSchema;
+
+	HashMap<const Reflection::ClassDescription*, uint32_t> mSchemaIndices;
+
+	bool mValid = false;
+
+};
+
 class BinarySerializer final
 {
 public:
-    
+
     BinarySerializer(FileStream& stream)
         : mStream(stream)
     {
-        
+
     }
-    
+
     template<typename T>
     void Serialize(const TArray<T>& object)
     {
         mStream.write(reinterpret_cast<const char*>(object.data()), sizeof(T) * object.size());
     }
-    
+
     template<typename K, typename V>
     void Serialize(const HashMap<K, V>& object)
     {
@@ -27,7 +184,7 @@ public:
             mStream.write(reinterpret_cast<const char*>(&value), sizeof(V));
         }
     }
-    
+
     template<typename T>
     TArray<T> Deserialize(size_t size)
     {
@@ -38,7 +195,7 @@ public:
         }
         return object;
     }
-    
+
     template<typename K, typename V>
     HashMap<K, V> Deserialize(size_t size)
     {
@@ -54,11 +211,37 @@ public:
         }
         return object;
     }
-    
+
+	template<typename T>
+	void Serialize(const T& object)
+	{
+		const auto& classDesc = Reflection::GetClass<T>();
+		Serialize(&object, classDesc);
+	}
+
+	template<typename T>
+	T Deserialize()
+	{
+		T object{};
+		const auto& classDesc = Reflection::GetClass<T>();
+		Deserialize(classDesc, &object);
+		return object;
+	}
+
+	BinaryHeader ParseHeader();
+
+	void Serialize(const void* obj, const Reflection::ClassDescription& classDesc);
+
+	bool Deserialize(const Reflection::ClassDescription& classDesc, void* obj);
+
+	static bool Deserialize(const uint8_t* data, size_t size, const Reflection::ClassDescription& classDesc, void* obj);
+
+	static bool IsBinary(const uint8_t* data, size_t size);
+
 private:
-    
+
 	FileStream& mStream;
-    
+
 };
 
 } // namespace Gleam
@@ -1,18 +1,30 @@
 #include "gpch.h"
 #include "JSONSerializer.h"
 #include "JSONInternal.h"
+#include "JSONStream.h"
+#include "IO/MappedFile.h"
 
 using namespace Gleam;
 
 struct JSONSerializer::Impl
 {
-	FileStream& stream;
+	FileStream* stream = nullptr;
+
+	// set when reading from memory, the serializer can only deserialize then
+	const char* data = nullptr;
+	size_t size = 0;
     
     Impl(FileStream& stream)
-		: stream(stream)
+		: stream(&stream)
     {
         
     }
+
+	Impl(const char* data, size_t size)
+		: data(data), size(size)
+	{
+
+	}
     
 #pragma region mark SerializeForwardDecl
 
@@ -113,6 +125,12 @@ JSONSerializer::JSONSerializer(FileStream& stream)
     
 }
 
+JSONSerializer::JSONSerializer(const MappedFile& file)
+	: mHandle(new Impl(reinterpret_cast<const char*>(file.GetData()), file.GetSize()))
+{
+
+}
+
 JSONSerializer::~JSONSerializer()
 {
     if (mHandle)
@@ -299,43 +317,14 @@ void JSONSerializer::Shutdown()
 
 JSONHeader JSONSerializer::ParseHeader()
 {
-	rapidjson::IStreamWrapper ss(mHandle->stream);
-	rapidjson::Document document(rapidjson::kObjectType);
-	document.ParseStream(ss);
-
-	JSONHeader header;
-	header.guid = TString(document["TypeGuid"].GetString());
-	header.name = TString(document["TypeName"].GetString());
-	
-	TString kind = document["Kind"].GetString();
-	if (kind == "Primitive")
-	{
-		header.kind = Reflection::FieldType::Primitive;
-	}
-	else if (kind == "Array")
-	{
-		header.kind = Reflection::FieldType::Array;
-	}
-	else if (kind == "Class")
-	{
-		header.kind = Reflection::FieldType::Class;
-	}
-	else if (kind == "Enum")
-	{
-		header.kind = Reflection::FieldType::Enum;
-	}
-	else
-	{
-		header.kind = Reflection::FieldType::Invalid;
-	}
-
-	constexpr auto version = Reflection::Attribute::Version::description;
-	if (document.HasMember(version.tag))
+	if (mHandle->stream == nullptr)
 	{
-		header.version = document[version.tag].Get<uint32_t>();
+		JSONHeaderReader reader(mHandle->data, mHandle->size);
+		return reader.Read();
 	}
 
-	return header;
+	JSONHeaderReader reader(*mHandle->stream);
+	return reader.Read();
 }
 
 void JSONSerializer::Serialize(const void* obj, const Reflection::ClassDescription& classDesc)
@@ -344,7 +333,8 @@ void JSONSerializer::Serialize(const void* obj, const Reflection::ClassDescripti
 	rapidjson::Node root(document, document.GetAllocator());
 	Serialize(obj, classDesc, root);
 	
-    rapidjson::OStreamWrapper ss(mHandle->stream);
+	GLEAM_ASSERT(mHandle->stream, "JSONSerializer: Mapped files are read only");
+    rapidjson::OStreamWrapper ss(*mHandle->stream);
     rapidjson::PrettyWriter writer(ss);
     writer.SetFormatOptions(rapidjson::PrettyFormatOptions::kFormatSingleLineArray);
     writer.SetMaxDecimalPlaces(6);
@@ -363,8 +353,15 @@ void JSONSerializer::Serialize(const void* obj, const Reflection::ClassDescripti
 void JSONSerializer::Deserialize(const Reflection::ClassDescription& classDesc, void* obj)
 {
 	rapidjson::Document document(rapidjson::kObjectType);
-    rapidjson::IStreamWrapper ss(mHandle->stream);
-	document.ParseStream(ss);
+	if (mHandle->stream == nullptr)
+	{
+		document.Parse(mHandle->data, mHandle->size);
+	}
+	else
+	{
+		rapidjson::IStreamWrapper ss(*mHandle->stream);
+		document.ParseStream(ss);
+	}
 
 	rapidjson::ConstNode root(document);
 	Deserialize(classDesc, obj, root);
@@ -378,6 +375,25 @@ void JSONSerializer::Deserialize(const Reflection::ClassDescription& classDesc,
 	}
 }
 
+void JSONSerializer::SerializeStreaming(const void* obj, const Reflection::ClassDescription& classDesc)
+{
+	GLEAM_ASSERT(mHandle->stream, "JSONSerializer: Mapped files are read only");
+	JSONStreamWriter writer(*mHandle->stream);
+	writer.Write(obj, classDesc);
+}
+
+bool JSONSerializer::DeserializeStreaming(const Reflection::ClassDescription& classDesc, void* obj)
+{
+	if (mHandle->stream == nullptr)
+	{
+		JSONStreamReader reader(mHandle->data, mHandle->size);
+		return reader.Read(classDesc, obj);
+	}
+
+	JSONStreamReader reader(*mHandle->stream);
+	return reader.Read(classDesc, obj);
+}
+
 bool JSONSerializer::TryCustomObjectSerializer(const void* obj,
 											   const TStringView fieldName,
 											   const Reflection::ClassDescription& classDesc,
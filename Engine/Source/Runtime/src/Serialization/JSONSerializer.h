@@ -8,6 +8,8 @@ struct ConstNode;
 
 namespace Gleam {
 
+class MappedFile;
+
 struct JSONHeader
 {
 	Reflection::FieldType kind = Reflection::FieldType::Invalid;
@@ -23,6 +25,9 @@ public:
     JSONSerializer() = default;
     
     JSONSerializer(FileStream& stream);
+
+	// Parses straight from the mapped memory, the file has to outlive the serializer
+	JSONSerializer(const MappedFile& file);
     
     ~JSONSerializer();
     
@@ -64,6 +69,24 @@ public:
 		return object;
 	}
 
+	// Streaming paths write and read through the SAX interfaces without building a document,
+	// use them for assets with large arrays
+	template<typename T>
+	void SerializeStreaming(const T& object)
+	{
+		const auto& classDesc = Reflection::GetClass<T>();
+		SerializeStreaming(&object, classDesc);
+	}
+
+	template<typename T>
+	T DeserializeStreaming()
+	{
+		T object{};
+		const auto& classDesc = Reflection::GetClass<T>();
+		DeserializeStreaming(classDesc, &object);
+		return object;
+	}
+
     void Serialize(const void* obj, const Reflection::ClassDescription& classDesc);
 
 	void Serialize(const void* obj, const Reflection::ClassDescription& classDesc, rapidjson::Node& root);
@@ -71,6 +94,10 @@ public:
 	void Deserialize(const Reflection::ClassDescription& classDesc, void* obj);
 
 	void Deserialize(const Reflection::ClassDescription& classDesc, void* obj, const rapidjson::ConstNode& root);
+
+	void SerializeStreaming(const void* obj, const Reflection::ClassDescription& classDesc);
+
+	bool DeserializeStreaming(const Reflection::ClassDescription& classDesc, void* obj);
     
     static bool TryCustomObjectSerializer(const void* obj,
                                           const TStringView fieldName,
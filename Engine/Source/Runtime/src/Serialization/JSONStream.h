@@ -0,0 +1,1177 @@
+#pragma once
+#include "JSONInternal.h"
+
+#include <rapidjson/reader.h>
+#include <rapidjson/error/en.h>
+
+/*
+* SAX counterparts of the document based JSONSerializer paths
+* Objects are written and read while walking their class descriptions,
+* no intermediate document is built so memory stays constant regardless of array sizes.
+* The produced layout is the same as the document serializer's
+*/
+
+namespace Gleam {
+
+class JSONOutputStream
+{
+public:
+
+	using Ch = char;
+
+	static constexpr size_t BufferSize = 64 * 1024;
+
+	JSONOutputStream(std::ostream& stream)
+		: mStream(stream), mBuffer(BufferSize)
+	{
+
+	}
+
+	void Put(Ch c)
+	{
+		if (mCount == BufferSize)
+		{
+			Flush();
+		}
+		mBuffer[mCount++] = c;
+	}
+
+	void Flush()
+	{
+		mStream.write(mBuffer.data(), mCount);
+		mCount = 0;
+	}
+
+private:
+
+	std::ostream& mStream;
+	TArray<char> mBuffer;
+	size_t mCount = 0;
+
+};
+
+class JSONInputStream
+{
+public:
+
+	using Ch = char;
+
+	static constexpr size_t BufferSize = 64 * 1024;
+
+	// The stream is read only, memory backed input is mapped read only and stream backed input is refilled in place
+	static constexpr unsigned ParseFlags = rapidjson::kParseDefaultFlags;
+	static_assert((ParseFlags & rapidjson::kParseInsituFlag) == 0, "JSONInputStream can not be parsed in situ");
+
+	JSONInputStream(std::istream& stream)
+		: mStream(&stream), mBuffer(BufferSize), mData(mBuffer.data())
+	{
+
+	}
+
+	// Reads straight from memory that outlives the stream, nothing is copied
+	JSONInputStream(const char* data, size_t size)
+		: mData(data), mCount(size)
+	{
+
+	}
+
+	Ch Peek()
+	{
+		if (mCurrent == mCount)
+		{
+			Refill();
+		}
+		return mCurrent < mCount ? mData[mCurrent] : '\0';
+	}
+
+	Ch Take()
+	{
+		Ch c = Peek();
+		if (mCurrent < mCount)
+		{
+			mCurrent++;
+		}
+		return c;
+	}
+
+	size_t Tell() const
+	{
+		return mConsumed + mCurrent;
+	}
+
+	template<typename Handler>
+	rapidjson::ParseResult Parse(Handler& handler)
+	{
+		rapidjson::Reader reader;
+		return reader.Parse<ParseFlags>(*this, handler);
+	}
+
+	// rapidjson only calls the output interface from its in situ branch, which ParseFlags rules out
+	Ch* PutBegin() { GLEAM_ASSERT(false, "JSONInputStream is read only!"); return nullptr; }
+	void Put(Ch) { GLEAM_ASSERT(false, "JSONInputStream is read only!"); }
+	void Flush() { GLEAM_ASSERT(false, "JSONInputStream is read only!"); }
+	size_t PutEnd(Ch*) { GLEAM_ASSERT(false, "JSONInputStream is read only!"); return 0; }
+
+private:
+
+	void Refill()
+	{
+		if (mStream == nullptr)
+		{
+			return;
+		}
+
+		mConsumed += mCount;
+		mCurrent = 0;
+		mCount = 0;
+		if (*mStream)
+		{
+			mStream->read(mBuffer.data(), BufferSize);
+			mCount = static_cast<size_t>(mStream->gcount());
+		}
+	}
+
+	std::istream* mStream = nullptr;
+	TArray<char> mBuffer;
+	const char* mData = nullptr;
+	size_t mConsumed = 0;
+	size_t mCurrent = 0;
+	size_t mCount = 0;
+
+};
+
+template<typename Fn>
+static void VisitPrimitive(Reflection::PrimitiveType type, Fn&& fn)
+{
+	switch (type)
+	{
+		case Reflection::PrimitiveType::Bool: fn(std::type_identity<bool>()); break;
+		case Reflection::PrimitiveType::WChar: fn(std::type_identity<wchar_t>()); break;
+		case Reflection::PrimitiveType::Char: fn(std::type_identity<char>()); break;
+		case Reflection::PrimitiveType::Int8: fn(std::type_identity<int8_t>()); break;
+		case Reflection::PrimitiveType::Int16: fn(std::type_identity<int16_t>()); break;
+		case Reflection::PrimitiveType::Int32: fn(std::type_identity<int32_t>()); break;
+		case Reflection::PrimitiveType::Int64: fn(std::type_identity<int64_t>()); break;
+		case Reflection::PrimitiveType::UInt8: fn(std::type_identity<uint8_t>()); break;
+		case Reflection::PrimitiveType::UInt16: fn(std::type_identity<uint16_t>()); break;
+		case Reflection::PrimitiveType::UInt32: fn(std::type_identity<uint32_t>()); break;
+		case Reflection::PrimitiveType::UInt64: fn(std::type_identity<uint64_t>()); break;
+		case Reflection::PrimitiveType::Float: fn(std::type_identity<float>()); break;
+		case Reflection::PrimitiveType::Double: fn(std::type_identity<double>()); break;
+		default: GLEAM_ASSERT(false, "JSONSerializer: Unknown primitive type"); break;
+	}
+}
+
+// Serializable fields of a class flattened with its base classes, in serialization order
+class JSONFieldCache
+{
+public:
+
+	using FieldList = TArray<const Reflection::FieldDescription*>;
+
+	const FieldList& Get(const Reflection::ClassDescription& classDesc)
+	{
+		auto it = mFields.find(&classDesc);
+		if (it != mFields.end())
+		{
+			return it->second;
+		}
+
+		auto& fields = mFields[&classDesc];
+		Collect(classDesc, fields);
+		return fields;
+	}
+
+private:
+
+	static void Collect(const Reflection::ClassDescription& classDesc, FieldList& fields)
+	{
+		for (const auto& baseClass : classDesc.ResolveBaseClasses())
+		{
+			Collect(baseClass, fields);
+		}
+
+		for (const auto& field : classDesc.ResolveFields())
+		{
+			if (field.HasAttribute<Reflection::Attribute::Serializable>())
+			{
+				fields.push_back(&field);
+			}
+		}
+	}
+
+	HashMap<const Reflection::ClassDescription*, FieldList> mFields;
+
+};
+
+class JSONStreamWriter
+{
+public:
+
+	JSONStreamWriter(std::ostream& stream)
+		: mStream(stream), mWriter(mStream)
+	{
+		mWriter.SetFormatOptions(rapidjson::PrettyFormatOptions::kFormatSingleLineArray);
+		mWriter.SetMaxDecimalPlaces(6);
+		mWriter.SetIndent('\t', 1);
+	}
+
+	void Write(const void* obj, const Reflection::ClassDescription& classDesc)
+	{
+		WriteClassObject(obj, "", classDesc);
+		mStream.Flush();
+	}
+
+private:
+
+#pragma region mark Headers
+	void WriteString(const TStringView str)
+	{
+		mWriter.String(str.data(), static_cast<rapidjson::SizeType>(str.length()));
+	}
+
+	void WriteFieldName(const TStringView fieldName)
+	{
+		if (not fieldName.empty())
+		{
+			mWriter.Key("FieldName");
+			WriteString(fieldName);
+		}
+	}
+
+	template<typename Desc>
+	void WriteVersion(const Desc& desc)
+	{
+		if (desc.template HasAttribute<Reflection::Attribute::Version>())
+		{
+			const auto& attr = desc.template GetAttribute<Reflection::Attribute::Version>();
+			mWriter.Key(Reflection::Attribute::Version::description.tag);
+			mWriter.Uint(attr.version);
+		}
+	}
+
+	void WritePrimitiveHeader(Reflection::PrimitiveType type, const TStringView fieldName)
+	{
+		mWriter.Key("Kind");
+		mWriter.String("Primitive");
+		mWriter.Key("TypeName");
+		WriteString(Reflection::Database::GetPrimitiveName(type));
+		WriteFieldName(fieldName);
+	}
+
+	template<typename Desc>
+	void WriteTypeHeader(const char* kind, const Desc& desc, const TStringView fieldName)
+	{
+		mWriter.Key("Kind");
+		mWriter.String(kind);
+		mWriter.Key("TypeGuid");
+		WriteString(desc.Guid().ToString());
+		mWriter.Key("TypeName");
+		WriteString(desc.ResolveName());
+		WriteFieldName(fieldName);
+		WriteVersion(desc);
+	}
+
+	void WriteArrayHeader(const Reflection::ArrayDescription& arrayDesc, const TStringView fieldName)
+	{
+		mWriter.Key("Kind");
+		switch (arrayDesc.ElementType())
+		{
+			case Reflection::FieldType::Primitive:
+			{
+				mWriter.String("Primitive");
+				break;
+			}
+			case Reflection::FieldType::Array:
+			{
+				mWriter.String("Array");
+				break;
+			}
+			case Reflection::FieldType::Class:
+			{
+				const auto& classDesc = Reflection::Database::GetClass(arrayDesc.ElementHash());
+				mWriter.String("Class");
+				mWriter.Key("TypeGuid");
+				WriteString(classDesc.Guid().ToString());
+				break;
+			}
+			case Reflection::FieldType::Enum:
+			{
+				const auto& enumDesc = Reflection::Database::GetEnum(arrayDesc.ElementHash());
+				mWriter.String("Enum");
+				mWriter.Key("TypeGuid");
+				WriteString(enumDesc.Guid().ToString());
+				WriteVersion(enumDesc);
+				break;
+			}
+			default:
+			{
+				mWriter.String("Invalid");
+				break;
+			}
+		}
+		mWriter.Key("TypeName");
+		WriteString(arrayDesc.ResolveName());
+		WriteFieldName(fieldName);
+	}
+#pragma endregion Headers
+
+#pragma region mark Values
+	template<typename T>
+	void WriteNumber(T value)
+	{
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			mWriter.Bool(value);
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			mWriter.Double(static_cast<double>(value));
+		}
+		else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, wchar_t>)
+		{
+			mWriter.Uint(static_cast<unsigned int>(value));
+		}
+		else if constexpr (std::is_signed_v<T>)
+		{
+			mWriter.Int64(static_cast<int64_t>(value));
+		}
+		else
+		{
+			mWriter.Uint64(static_cast<uint64_t>(value));
+		}
+	}
+
+	void WritePrimitive(const void* obj, Reflection::PrimitiveType type)
+	{
+		VisitPrimitive(type, [&](auto tag)
+		{
+			using T = typename decltype(tag)::type;
+			WriteNumber(Reflection::Get<T>(obj));
+		});
+	}
+
+	void WriteEnum(const void* obj, size_t size)
+	{
+		GLEAM_ASSERT(size <= sizeof(int64_t), "JSONSerializer: Enum is larger than 8 bytes");
+		int64_t value = 0;
+		memcpy(&value, obj, size);
+		mWriter.Int64(value);
+	}
+
+	// Custom types are written as a single string value
+	bool WriteCustomValue(const void* obj, const TStringView typeName)
+	{
+		if (typeName == mGuidName)
+		{
+			WriteString(Reflection::Get<Guid>(obj).ToString());
+			return true;
+		}
+		if (typeName == mStringName)
+		{
+			WriteString(Reflection::Get<TString>(obj));
+			return true;
+		}
+		if (typeName == mPathName)
+		{
+			WriteString(Reflection::Get<Filesystem::Path>(obj).string());
+			return true;
+		}
+		return false;
+	}
+
+	static Reflection::ArrayDescription ResolveContainer(const void* obj, const Reflection::ClassDescription& classDesc)
+	{
+		const auto& arr = Reflection::Get<TArray<uint8_t>>(obj);
+		const auto& arrDesc = Reflection::GetArray(classDesc.ContainerHash());
+		return Reflection::ArrayDescription(arrDesc.ResolveName(), arrDesc.ElementType(), arrDesc.ElementHash(), arr.size(), arrDesc.GetStride());
+	}
+
+	// Elements are written as dense arrays, primitives take a single branch for the whole array
+	void WriteElements(const void* obj, const Reflection::ArrayDescription& arrayDesc)
+	{
+		const size_t size = arrayDesc.GetSize();
+		const size_t stride = arrayDesc.GetStride();
+		switch (arrayDesc.ElementType())
+		{
+			case Reflection::FieldType::Primitive:
+			{
+				auto primitiveType = Reflection::Database::GetPrimitiveType(arrayDesc.ElementHash());
+				VisitPrimitive(primitiveType, [&](auto tag)
+				{
+					using T = typename decltype(tag)::type;
+					for (size_t offset = 0; offset < size; offset += stride)
+					{
+						WriteNumber(Reflection::Get<T>(OffsetPointer(obj, offset)));
+					}
+				});
+				break;
+			}
+			case Reflection::FieldType::Array:
+			{
+				const auto& innerDesc = Reflection::GetArray(arrayDesc.ElementHash());
+				for (size_t offset = 0; offset < size; offset += stride)
+				{
+					mWriter.StartArray();
+					WriteElements(OffsetPointer(obj, offset), innerDesc);
+					mWriter.EndArray();
+				}
+				break;
+			}
+			case Reflection::FieldType::Class:
+			{
+				const auto& classDesc = Reflection::Database::GetClass(arrayDesc.ElementHash());
+				for (size_t offset = 0; offset < size; offset += stride)
+				{
+					WriteClassValue(OffsetPointer(obj, offset), classDesc);
+				}
+				break;
+			}
+			case Reflection::FieldType::Enum:
+			{
+				const auto& enumDesc = Reflection::Database::GetEnum(arrayDesc.ElementHash());
+				for (size_t offset = 0; offset < size; offset += stride)
+				{
+					WriteEnum(OffsetPointer(obj, offset), enumDesc.GetSize());
+				}
+				break;
+			}
+			default:
+			{
+				GLEAM_ASSERT(false, "JSONSerializer: Unknown object kind");
+				break;
+			}
+		}
+	}
+
+	// Class elements are written as arrays of their field values
+	void WriteClassValue(const void* obj, const Reflection::ClassDescription& classDesc)
+	{
+		const auto typeName = classDesc.ResolveName();
+		if (WriteCustomValue(obj, typeName))
+		{
+			return;
+		}
+
+		if (typeName == mVectorName)
+		{
+			mWriter.StartArray();
+			WriteElements(Reflection::Get<TArray<uint8_t>>(obj).data(), ResolveContainer(obj, classDesc));
+			mWriter.EndArray();
+			return;
+		}
+
+		mWriter.StartArray();
+		for (const auto field : mFieldCache.Get(classDesc))
+		{
+			switch (field->GetType())
+			{
+				case Reflection::FieldType::Class:
+				{
+					const auto& classField = field->GetField<Reflection::ClassField>();
+					WriteClassValue(OffsetPointer(obj, classField.offset), Reflection::GetClass(classField.hash));
+					break;
+				}
+				case Reflection::FieldType::Array:
+				{
+					const auto& arrayField = field->GetField<Reflection::ArrayField>();
+					mWriter.StartArray();
+					WriteElements(OffsetPointer(obj, arrayField.offset), Reflection::GetArray(arrayField.hash));
+					mWriter.EndArray();
+					break;
+				}
+				case Reflection::FieldType::Enum:
+				{
+					const auto& enumField = field->GetField<Reflection::EnumField>();
+					WriteEnum(OffsetPointer(obj, enumField.offset), enumField.size);
+					break;
+				}
+				case Reflection::FieldType::Primitive:
+				{
+					const auto& primitiveField = field->GetField<Reflection::PrimitiveField>();
+					WritePrimitive(OffsetPointer(obj, primitiveField.offset), primitiveField.primitive);
+					break;
+				}
+				default:
+				{
+					GLEAM_ASSERT(false, "JSONSerializer: Unknown object kind");
+					mWriter.Null();
+					break;
+				}
+			}
+		}
+		mWriter.EndArray();
+	}
+#pragma endregion Values
+
+#pragma region mark Objects
+	void WriteArrayObject(const void* obj, const TStringView fieldName, const Reflection::ArrayDescription& arrayDesc)
+	{
+		mWriter.StartObject();
+		if (arrayDesc.GetSize() > 0)
+		{
+			WriteArrayHeader(arrayDesc, fieldName);
+			mWriter.Key("Elements");
+			mWriter.StartArray();
+			WriteElements(obj, arrayDesc);
+			mWriter.EndArray();
+		}
+		mWriter.EndObject();
+	}
+
+	void WriteClassObject(const void* obj, const TStringView fieldName, const Reflection::ClassDescription& classDesc)
+	{
+		const auto typeName = classDesc.ResolveName();
+		if (typeName == mVectorName)
+		{
+			WriteArrayObject(Reflection::Get<TArray<uint8_t>>(obj).data(), fieldName, ResolveContainer(obj, classDesc));
+			return;
+		}
+
+		mWriter.StartObject();
+		if (typeName == mGuidName ||
+			typeName == mStringName ||
+			typeName == mPathName)
+		{
+			WriteTypeHeader("Class", classDesc, fieldName);
+			mWriter.Key("Value");
+			WriteCustomValue(obj, typeName);
+		}
+		else if (const auto& fields = mFieldCache.Get(classDesc); not fields.empty())
+		{
+			WriteTypeHeader("Class", classDesc, fieldName);
+			mWriter.Key("Fields");
+			mWriter.StartArray();
+			for (const auto field : fields)
+			{
+				WriteFieldObject(obj, *field);
+			}
+			mWriter.EndArray();
+		}
+		mWriter.EndObject();
+	}
+
+	void WriteFieldObject(const void* obj, const Reflection::FieldDescription& field)
+	{
+		switch (field.GetType())
+		{
+			case Reflection::FieldType::Class:
+			{
+				const auto& classField = field.GetField<Reflection::ClassField>();
+				WriteClassObject(OffsetPointer(obj, classField.offset), field.ResolveName(), Reflection::GetClass(classField.hash));
+				break;
+			}
+			case Reflection::FieldType::Array:
+			{
+				const auto& arrayField = field.GetField<Reflection::ArrayField>();
+				WriteArrayObject(OffsetPointer(obj, arrayField.offset), field.ResolveName(), Reflection::GetArray(arrayField.hash));
+				break;
+			}
+			case Reflection::FieldType::Enum:
+			{
+				const auto& enumField = field.GetField<Reflection::EnumField>();
+				mWriter.StartObject();
+				WriteTypeHeader("Enum", Reflection::GetEnum(enumField.hash), field.ResolveName());
+				mWriter.Key("Value");
+				WriteEnum(OffsetPointer(obj, enumField.offset), enumField.size);
+				mWriter.EndObject();
+				break;
+			}
+			case Reflection::FieldType::Primitive:
+			{
+				const auto& primitiveField = field.GetField<Reflection::PrimitiveField>();
+				mWriter.StartObject();
+				WritePrimitiveHeader(primitiveField.primitive, field.ResolveName());
+				mWriter.Key("Value");
+				WritePrimitive(OffsetPointer(obj, primitiveField.offset), primitiveField.primitive);
+				mWriter.EndObject();
+				break;
+			}
+			default:
+			{
+				GLEAM_ASSERT(false, "JSONSerializer: Unknown object kind");
+				mWriter.StartObject();
+				mWriter.EndObject();
+				break;
+			}
+		}
+	}
+#pragma endregion Objects
+
+	JSONOutputStream mStream;
+	rapidjson::PrettyWriter<JSONOutputStream> mWriter;
+	JSONFieldCache mFieldCache;
+
+	const TStringView mVectorName = Reflection::GetClass<TArray<uint8_t>>().ResolveName();
+	const TStringView mGuidName = Reflection::GetClass<Guid>().ResolveName();
+	const TStringView mStringName = Reflection::GetClass<TString>().ResolveName();
+	const TStringView mPathName = Reflection::GetClass<Filesystem::Path>().ResolveName();
+
+};
+
+/*
+* SAX handler that writes values straight into the destination objects
+* Field objects are matched by their "FieldName", positional class values follow the flattened field order
+*/
+class JSONStreamReader
+{
+public:
+
+	JSONStreamReader(std::istream& stream)
+		: mStream(stream)
+	{
+
+	}
+
+	JSONStreamReader(const char* data, size_t size)
+		: mStream(data, size)
+	{
+
+	}
+
+	bool Read(const Reflection::ClassDescription& classDesc, void* obj)
+	{
+		mStack.clear();
+		mMismatchCount = 0;
+		mRoot = ResolveClass(classDesc, obj);
+
+		auto result = mStream.Parse(*this);
+		if (mMismatchCount > 1)
+		{
+			GLEAM_CORE_WARN("JSONSerializer: {0} values of {1} did not match their field types", mMismatchCount, classDesc.ResolveName());
+		}
+
+		if (result.IsError())
+		{
+			GLEAM_CORE_ERROR("JSONSerializer: {0} at offset {1}", rapidjson::GetParseError_En(result.Code()), result.Offset());
+			return false;
+		}
+		return true;
+	}
+
+#pragma region mark Handler
+	bool Null() { NextTarget(); return true; }
+	bool Bool(bool value) { Store(NextTarget(), value); return true; }
+	bool Int(int value) { Store(NextTarget(), value); return true; }
+	bool Uint(unsigned value) { Store(NextTarget(), value); return true; }
+	bool Int64(int64_t value) { Store(NextTarget(), value); return true; }
+	bool Uint64(uint64_t value) { Store(NextTarget(), value); return true; }
+	bool Double(double value) { Store(NextTarget(), value); return true; }
+	bool RawNumber(const char*, rapidjson::SizeType, bool) { NextTarget(); return true; }
+
+	bool String(const char* str, rapidjson::SizeType length, bool)
+	{
+		if (not mStack.empty() && mStack.back().type == Frame::Type::Object && mStack.back().key == MemberKey::FieldName)
+		{
+			BindField(mStack.back(), TStringView(str, length));
+			return true;
+		}
+
+		auto target = NextTarget();
+		switch (target.kind)
+		{
+			case Target::Kind::Guid:
+				Reflection::Get<Guid>(target.ptr) = Guid(TString(str, length));
+				break;
+			case Target::Kind::String:
+				Reflection::Get<TString>(target.ptr) = TString(str, length);
+				break;
+			case Target::Kind::Path:
+				Reflection::Get<Filesystem::Path>(target.ptr) = TString(str, length);
+				break;
+			case Target::Kind::None:
+				break;
+			default:
+				Mismatch("String");
+				break;
+		}
+		return true;
+	}
+
+	bool Key(const char* str, rapidjson::SizeType length, bool)
+	{
+		auto& frame = mStack.back();
+		if (frame.type != Frame::Type::Object)
+		{
+			return true;
+		}
+
+		const auto key = TStringView(str, length);
+		if (key == "FieldName") frame.key = MemberKey::FieldName;
+		else if (key == "Value") frame.key = MemberKey::Value;
+		else if (key == "Fields") frame.key = MemberKey::Fields;
+		else if (key == "Elements") frame.key = MemberKey::Elements;
+		else frame.key = MemberKey::Other;
+		return true;
+	}
+
+	bool StartObject()
+	{
+		if (mStack.empty())
+		{
+			mStack.push_back(Frame{ .type = Frame::Type::Object, .target = mRoot });
+			return true;
+		}
+
+		auto& top = mStack.back();
+		if (top.type == Frame::Type::Skip)
+		{
+			top.depth++;
+			return true;
+		}
+
+		// field objects bind their target once the field name is read
+		if (top.type == Frame::Type::Fields)
+		{
+			auto frame = Frame{ .type = Frame::Type::Object, .fields = top.fields, .obj = top.obj };
+			mStack.push_back(frame);
+			return true;
+		}
+
+		auto target = NextTarget();
+		if (target.kind == Target::Kind::None)
+		{
+			mStack.push_back(Frame{ .type = Frame::Type::Skip });
+			return true;
+		}
+		mStack.push_back(Frame{ .type = Frame::Type::Object, .target = target });
+		return true;
+	}
+
+	bool EndObject(rapidjson::SizeType)
+	{
+		return End();
+	}
+
+	bool StartArray()
+	{
+		if (mStack.empty())
+		{
+			mStack.push_back(Frame{ .type = Frame::Type::Skip });
+			return true;
+		}
+
+		auto& top = mStack.back();
+		if (top.type == Frame::Type::Skip)
+		{
+			top.depth++;
+			return true;
+		}
+
+		if (top.type == Frame::Type::Object)
+		{
+			if (top.key == MemberKey::Fields && top.target.kind == Target::Kind::Class)
+			{
+				auto frame = Frame{ .type = Frame::Type::Fields, .fields = &mFieldCache.Get(*top.target.classDesc), .obj = top.target.ptr };
+				mStack.push_back(frame);
+			}
+			else if (top.key == MemberKey::Elements || top.key == MemberKey::Value)
+			{
+				BeginArray(top.target);
+			}
+			else
+			{
+				mStack.push_back(Frame{ .type = Frame::Type::Skip });
+			}
+			return true;
+		}
+
+		BeginArray(NextTarget());
+		return true;
+	}
+
+	bool EndArray(rapidjson::SizeType)
+	{
+		return End();
+	}
+#pragma endregion Handler
+
+private:
+
+	enum class MemberKey
+	{
+		None,
+		FieldName,
+		Value,
+		Fields,
+		Elements,
+		Other
+	};
+
+	struct Target
+	{
+		enum class Kind
+		{
+			None,
+			Primitive,
+			Enum,
+			Class,
+			Array,
+			Vector,
+			Guid,
+			String,
+			Path
+		};
+
+		Kind kind = Kind::None;
+		void* ptr = nullptr;
+		Reflection::PrimitiveType primitive = Reflection::PrimitiveType::Invalid;
+		size_t size = 0;
+		const Reflection::ClassDescription* classDesc = nullptr;
+		const Reflection::ArrayDescription* arrayDesc = nullptr;
+	};
+
+	struct Frame
+	{
+		enum class Type
+		{
+			Object,
+			Fields,
+			Values,
+			Elements,
+			Skip
+		};
+
+		Type type = Type::Skip;
+		Target target;
+		Target element;
+		MemberKey key = MemberKey::None;
+		const JSONFieldCache::FieldList* fields = nullptr;
+		void* obj = nullptr;
+		size_t index = 0;
+		uint32_t depth = 1;
+	};
+
+	Target ResolveClass(const Reflection::ClassDescription& classDesc, void* obj) const
+	{
+		Target target{ .ptr = obj, .classDesc = &classDesc };
+
+		const auto typeName = classDesc.ResolveName();
+		if (typeName == mVectorName)
+		{
+			target.kind = Target::Kind::Vector;
+			target.arrayDesc = &Reflection::GetArray(classDesc.ContainerHash());
+		}
+		else if (typeName == mGuidName)
+		{
+			target.kind = Target::Kind::Guid;
+		}
+		else if (typeName == mStringName)
+		{
+			target.kind = Target::Kind::String;
+		}
+		else if (typeName == mPathName)
+		{
+			target.kind = Target::Kind::Path;
+		}
+		else
+		{
+			target.kind = Target::Kind::Class;
+		}
+		return target;
+	}
+
+	Target ResolveField(const Reflection::FieldDescription& field, void* obj) const
+	{
+		switch (field.GetType())
+		{
+			case Reflection::FieldType::Primitive:
+			{
+				const auto& primitiveField = field.GetField<Reflection::PrimitiveField>();
+				return Target{ .kind = Target::Kind::Primitive, .ptr = OffsetPointer(obj, primitiveField.offset), .primitive = primitiveField.primitive };
+			}
+			case Reflection::FieldType::Enum:
+			{
+				const auto& enumField = field.GetField<Reflection::EnumField>();
+				return Target{ .kind = Target::Kind::Enum, .ptr = OffsetPointer(obj, enumField.offset), .size = enumField.size };
+			}
+			case Reflection::FieldType::Array:
+			{
+				const auto& arrayField = field.GetField<Reflection::ArrayField>();
+				return Target{ .kind = Target::Kind::Array, .ptr = OffsetPointer(obj, arrayField.offset), .arrayDesc = &Reflection::GetArray(arrayField.hash) };
+			}
+			case Reflection::FieldType::Class:
+			{
+				const auto& classField = field.GetField<Reflection::ClassField>();
+				return ResolveClass(Reflection::GetClass(classField.hash), OffsetPointer(obj, classField.offset));
+			}
+			default:
+			{
+				return Target();
+			}
+		}
+	}
+
+	// Resolved once per array, elements only rebase the pointer
+	Target ResolveElement(const Reflection::ArrayDescription& arrayDesc) const
+	{
+		switch (arrayDesc.ElementType())
+		{
+			case Reflection::FieldType::Primitive:
+				return Target{ .kind = Target::Kind::Primitive, .primitive = Reflection::Database::GetPrimitiveType(arrayDesc.ElementHash()) };
+			case Reflection::FieldType::Enum:
+				return Target{ .kind = Target::Kind::Enum, .size = Reflection::GetEnum(arrayDesc.ElementHash()).GetSize() };
+			case Reflection::FieldType::Array:
+				return Target{ .kind = Target::Kind::Array, .arrayDesc = &Reflection::GetArray(arrayDesc.ElementHash()) };
+			case Reflection::FieldType::Class:
+				return ResolveClass(Reflection::GetClass(arrayDesc.ElementHash()), nullptr);
+			default:
+				return Target();
+		}
+	}
+
+	void BindField(Frame& frame, const TStringView fieldName)
+	{
+		if (frame.fields == nullptr)
+		{
+			return;
+		}
+
+		for (const auto field : *frame.fields)
+		{
+			if (field->ResolveName() == fieldName)
+			{
+				frame.target = ResolveField(*field, frame.obj);
+				return;
+			}
+		}
+	}
+
+	Target NextElement(Frame& frame)
+	{
+		const size_t stride = frame.target.arrayDesc->GetStride();
+		const size_t offset = frame.index++ * stride;
+
+		void* data = frame.target.ptr;
+		if (frame.target.kind == Target::Kind::Vector)
+		{
+			auto& arr = Reflection::Get<TArray<uint8_t>>(frame.target.ptr);
+			arr.resize(offset + stride);
+			data = arr.data();
+		}
+		else if (offset + stride > frame.target.arrayDesc->GetSize())
+		{
+			Mismatch("Array element past the end of a fixed size array");
+			return Target();
+		}
+
+		auto target = frame.element;
+		target.ptr = OffsetPointer(data, offset);
+		return target;
+	}
+
+	// Target of the next value in the current container
+	Target NextTarget()
+	{
+		if (mStack.empty())
+		{
+			return Target();
+		}
+
+		auto& frame = mStack.back();
+		switch (frame.type)
+		{
+			case Frame::Type::Object:
+			{
+				return frame.key == MemberKey::Value ? frame.target : Target();
+			}
+			case Frame::Type::Values:
+			{
+				size_t index = frame.index++;
+				return index < frame.fields->size() ? ResolveField(*(*frame.fields)[index], frame.obj) : Target();
+			}
+			case Frame::Type::Elements:
+			{
+				return NextElement(frame);
+			}
+			default:
+			{
+				return Target();
+			}
+		}
+	}
+
+	void BeginArray(const Target& target)
+	{
+		switch (target.kind)
+		{
+			case Target::Kind::Class:
+			{
+				auto frame = Frame{ .type = Frame::Type::Values, .fields = &mFieldCache.Get(*target.classDesc), .obj = target.ptr };
+				mStack.push_back(frame);
+				break;
+			}
+			case Target::Kind::Vector:
+			{
+				Reflection::Get<TArray<uint8_t>>(target.ptr).clear();
+				mStack.push_back(Frame{ .type = Frame::Type::Elements, .target = target, .element = ResolveElement(*target.arrayDesc) });
+				break;
+			}
+			case Target::Kind::Array:
+			{
+				mStack.push_back(Frame{ .type = Frame::Type::Elements, .target = target, .element = ResolveElement(*target.arrayDesc) });
+				break;
+			}
+			default:
+			{
+				if (target.kind != Target::Kind::None)
+				{
+					Mismatch("Array");
+				}
+				mStack.push_back(Frame{ .type = Frame::Type::Skip });
+				break;
+			}
+		}
+	}
+
+	// Mismatched values are skipped, the first one is logged with its position and the rest are counted
+	void Mismatch(const char* value)
+	{
+		if (mMismatchCount++ == 0)
+		{
+			GLEAM_CORE_WARN("JSONSerializer: {0} does not match the field type at offset {1}", value, mStream.Tell());
+		}
+	}
+
+	bool End()
+	{
+		auto& top = mStack.back();
+		if (top.type == Frame::Type::Skip && --top.depth > 0)
+		{
+			return true;
+		}
+		mStack.pop_back();
+		return true;
+	}
+
+	template<typename T>
+	void Store(const Target& target, T value)
+	{
+		if (target.kind == Target::Kind::Primitive)
+		{
+			VisitPrimitive(target.primitive, [&](auto tag)
+			{
+				using U = typename decltype(tag)::type;
+				Reflection::Get<U>(target.ptr) = static_cast<U>(value);
+			});
+		}
+		else if (target.kind == Target::Kind::Enum)
+		{
+			auto enumValue = static_cast<int64_t>(value);
+			memcpy(target.ptr, &enumValue, Math::Min(target.size, sizeof(int64_t)));
+		}
+		else if (target.kind != Target::Kind::None)
+		{
+			Mismatch(std::is_same<T, bool>::value ? "Bool" : "Number");
+		}
+	}
+
+	JSONInputStream mStream;
+	JSONFieldCache mFieldCache;
+	TArray<Frame> mStack;
+	Target mRoot;
+	uint32_t mMismatchCount = 0;
+
+	const TStringView mVectorName = Reflection::GetClass<TArray<uint8_t>>().ResolveName();
+	const TStringView mGuidName = Reflection::GetClass<Guid>().ResolveName();
+	const TStringView mStringName = Reflection::GetClass<TString>().ResolveName();
+	const TStringView mPathName = Reflection::GetClass<Filesystem::Path>().ResolveName();
+
+};
+
+// Reads the root header and stops before the payload is parsed
+class JSONHeaderReader
+{
+public:
+
+	JSONHeaderReader(std::istream& stream)
+		: mStream(stream)
+	{
+
+	}
+
+	JSONHeaderReader(const char* data, size_t size)
+		: mStream(data, size)
+	{
+
+	}
+
+	JSONHeader Read()
+	{
+		mStream.Parse(*this);
+		return mHeader;
+	}
+
+#pragma region mark Handler
+	bool Null() { return true; }
+	bool Bool(bool) { return true; }
+	bool Int(int) { return true; }
+	bool Int64(int64_t) { return true; }
+	bool Uint64(uint64_t) { return true; }
+	bool Double(double) { return true; }
+	bool RawNumber(const char*, rapidjson::SizeType, bool) { return true; }
+
+	bool Uint(unsigned value)
+	{
+		if (mDepth == 1 && mKey == Reflection::Attribute::Version::description.tag)
+		{
+			mHeader.version = value;
+		}
+		return true;
+	}
+
+	bool String(const char* str, rapidjson::SizeType length, bool)
+	{
+		if (mDepth != 1)
+		{
+			return true;
+		}
+
+		const auto value = TStringView(str, length);
+		if (mKey == "TypeGuid")
+		{
+			mHeader.guid = TString(value);
+		}
+		else if (mKey == "TypeName")
+		{
+			mHeader.name = TString(value);
+		}
+		else if (mKey == "Kind")
+		{
+			if (value == "Primitive") mHeader.kind = Reflection::FieldType::Primitive;
+			else if (value == "Array") mHeader.kind = Reflection::FieldType::Array;
+			else if (value == "Class") mHeader.kind = Reflection::FieldType::Class;
+			else if (value == "Enum") mHeader.kind = Reflection::FieldType::Enum;
+			else mHeader.kind = Reflection::FieldType::Invalid;
+		}
+		return true;
+	}
+
+	bool Key(const char* str, rapidjson::SizeType length, bool)
+	{
+		if (mDepth != 1)
+		{
+			return true;
+		}
+
+		// header members always precede the payload, terminate the parse once it begins
+		mKey = TString(str, length);
+		return mKey != "Value" && mKey != "Fields" && mKey != "Elements";
+	}
+
+	bool StartObject() { mDepth++; return true; }
+	bool EndObject(rapidjson::SizeType) { mDepth--; return true; }
+	bool StartArray() { mDepth++; return true; }
+	bool EndArray(rapidjson::SizeType) { mDepth--; return true; }
+#pragma endregion Handler
+
+private:
+
+	JSONInputStream mStream;
+	JSONHeader mHeader;
+	TString mKey;
+	uint32_t mDepth = 0;
+
+};
+
+} // namespace Gleam
@@ -0,0 +1,61 @@
+#pragma once
+
+namespace Gleam {
+
+/*
+* Layout of a binary .gworld, every offset is from the start of the file and 8 byte aligned
+*
+*   BinaryWorldHeader
+*   string table     : uint32_t offsets[stringCount], null terminated characters
+*   entity table     : BinaryWorldEntity[entityCount]
+*   parent table     : BinaryWorldParent[parentCount]
+*   column table     : BinaryWorldColumn[columnCount]
+*   column payloads  : uint32_t entities[count], BinarySerializer blob of the components
+*
+* Every column carries its own schema, so components whose fields changed since the world was
+* saved are still loaded field by field and unchanged ones are copied as they are laid out in memory
+*/
+struct BinaryWorldHeader
+{
+	static constexpr uint32_t Magic = 0x444C5747; // GWLD
+	static constexpr uint32_t CurrentVersion = 2;
+
+	uint32_t magic = Magic;
+	uint32_t version = CurrentVersion;
+	uint32_t name = 0;
+	uint32_t stringCount = 0;
+	uint32_t entityCount = 0;
+	uint32_t parentCount = 0;
+	uint32_t columnCount = 0;
+	uint32_t reserved = 0;
+	uint64_t stringTableOffset = 0;
+	uint64_t entityTableOffset = 0;
+	uint64_t parentTableOffset = 0;
+	uint64_t columnTableOffset = 0;
+};
+
+struct BinaryWorldEntity
+{
+	TArray<uint8_t, 16> guid;
+	Float3 position;
+	Quaternion rotation;
+	Float3 scale;
+	uint32_t active;
+};
+
+struct BinaryWorldParent
+{
+	uint32_t entity;
+	uint32_t parent;
+};
+
+struct BinaryWorldColumn
+{
+	uint32_t typeName;
+	uint32_t count;
+	uint64_t entitiesOffset;
+	uint64_t dataOffset;
+	uint64_t dataSize;
+};
+
+} // namespace Gleam
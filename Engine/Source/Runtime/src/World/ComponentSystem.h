@@ -25,6 +25,11 @@ protected:
 
 	virtual void OnDestroy(EntityManager& entityManager) {};
 
+private:
+
+	// type name of the system, labels its updates in profiles
+	TStringView mName;
+
 };
 
 } // namespace Gleam
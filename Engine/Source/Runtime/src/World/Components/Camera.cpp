@@ -25,3 +25,15 @@ void Camera::SetViewport(float width, float height)
     aspectRatio = width / height;
     orthographicSize = height;
 }
+
+Float4x4 Camera::GetProjectionMatrix() const
+{
+	if (projectionType == ProjectionType::Perspective)
+	{
+		return Float4x4::Perspective(fov, aspectRatio, nearPlane, farPlane);
+	}
+
+	float width = orthographicSize * aspectRatio;
+	float height = orthographicSize;
+	return Float4x4::Ortho(width, height, nearPlane, farPlane);
+}
@@ -32,6 +32,8 @@ struct Camera
     void SetViewport(const Size& size);
 
     void SetViewport(float width, float height);
+
+    Float4x4 GetProjectionMatrix() const;
 };
 
 } // namespace Gleam
@@ -11,39 +11,177 @@
 
 using namespace Gleam;
 
-MeshRenderer::MeshRenderer(const AssetReference& mesh, const TArray<AssetReference>& materials)
-	: mMesh(Globals::GameInstance->GetSubsystem<AssetManager>()->Get<MeshDescriptor>(mesh))
+struct MeshRenderer::Resources
+{
+	Scope<Mesh> mesh;
+	RefCounted<const MeshDescriptor> meshDescriptor;
+	TArray<RefCounted<const MaterialInstanceDescriptor>> materialDescriptors;
+	TArray<MaterialInstance> materials;
+	RefCounted<const OccluderGeometry> occluderGeometry;
+	uint32_t pendingCount = 0;
+	bool occluder = false;
+	bool failed = false;
+
+	void OnLoaded();
+
+	void OnFailed();
+};
+
+// Streams are read from the mapped sidecar when the mesh was baked with one, it stays mapped while fn runs
+template<typename Fn>
+static void VisitGeometry(const AssetReference& ref, const MeshDescriptor& descriptor, Fn&& fn)
+{
+	if (descriptor.HasSidecar() == false)
+	{
+		fn(descriptor.GetGeometry());
+		return;
+	}
+
+	auto sidecar = Globals::GameInstance->GetSubsystem<AssetManager>()->MapSidecar(ref);
+	fn(descriptor.GetGeometry(sidecar.GetData(), sidecar.GetSize()));
+}
+
+// Material instances are created in submesh order once every descriptor has arrived
+void MeshRenderer::Resources::OnLoaded()
 {
-	GLEAM_ASSERT(mMesh.GetSubmeshCount() == materials.size(), "MeshRenderer is missing material for one or more submeshes");
+	if (--pendingCount > 0 || failed)
+	{
+		return;
+	}
+
+	GLEAM_ASSERT(mesh->GetSubmeshCount() == materialDescriptors.size(), "MeshRenderer is missing material for one or more submeshes");
 	auto materialSystem = Globals::GameInstance->GetSubsystem<MaterialSystem>();
 
-	mMaterials.reserve(materials.size());
-	for (const auto& material : materials)
+	materials.reserve(materialDescriptors.size());
+	for (const auto& descriptor : materialDescriptors)
 	{
-		auto descriptor = Globals::GameInstance->GetSubsystem<AssetManager>()->Get<MaterialInstanceDescriptor>(material);
-		auto baseMaterial = materialSystem->GetMaterial(descriptor.material);
-		mMaterials.emplace_back(baseMaterial->CreateInstance());
+		auto baseMaterial = materialSystem->GetMaterial(descriptor->material);
+		auto& instance = materials.emplace_back(baseMaterial->CreateInstance());
+		for (const auto& property : descriptor->properties)
+		{
+			instance.SetProperty(property.name, property.value);
+		}
 	}
+	materialDescriptors.clear();
+}
+
+// Loads that are still pending keep counting down, the renderer just never becomes ready
+void MeshRenderer::Resources::OnFailed()
+{
+	failed = true;
+	--pendingCount;
+	materialDescriptors.clear();
+}
+
+MeshRenderer::MeshRenderer(const AssetReference& mesh, const TArray<AssetReference>& materials)
+	: mResources(CreateRef<Resources>()), mMeshAsset(mesh)
+{
+	auto assetManager = Globals::GameInstance->GetSubsystem<AssetManager>();
+	mResources->pendingCount = static_cast<uint32_t>(materials.size()) + 1;
+	mResources->materialDescriptors.resize(materials.size());
+
+	// callbacks run on the main thread, where the GPU buffers of the mesh are created
+	assetManager->LoadAsync<MeshDescriptor>(mesh, AssetLoadPriority::Normal, [resources = mResources, mesh](const RefCounted<const MeshDescriptor>& descriptor)
+	{
+		if (descriptor == nullptr)
+		{
+			GLEAM_CORE_ERROR("MeshRenderer could not load mesh: {0}", mesh.guid.ToString());
+			resources->OnFailed();
+			return;
+		}
+
+		resources->meshDescriptor = descriptor;
+		VisitGeometry(mesh, *descriptor, [&](const MeshGeometry& geometry)
+		{
+			resources->mesh = CreateScope<Mesh>(*descriptor, geometry);
+			if (resources->occluder)
+			{
+				resources->occluderGeometry = CreateRef<OccluderGeometry>(OccluderGeometry::Create(*descriptor, geometry));
+			}
+		});
+		resources->OnLoaded();
+	});
+
+	for (uint32_t i = 0; i < materials.size(); ++i)
+	{
+		assetManager->LoadAsync<MaterialInstanceDescriptor>(materials[i], AssetLoadPriority::Normal, [resources = mResources, i, material = materials[i]](const RefCounted<const MaterialInstanceDescriptor>& descriptor)
+		{
+			if (descriptor == nullptr)
+			{
+				GLEAM_CORE_ERROR("MeshRenderer could not load material: {0}", material.guid.ToString());
+				resources->OnFailed();
+				return;
+			}
+
+			if (resources->failed == false)
+			{
+				resources->materialDescriptors[i] = descriptor;
+			}
+			resources->OnLoaded();
+		});
+	}
+}
+
+bool MeshRenderer::IsReady() const
+{
+	return mResources->pendingCount == 0 && mResources->failed == false;
+}
+
+bool MeshRenderer::HasFailed() const
+{
+	return mResources->failed;
 }
 
 void MeshRenderer::SetMaterial(const MaterialInstance& material, uint32_t index)
 {
-    GLEAM_ASSERT(mMaterials.size() > index, "Material index out of range.");
-    mMaterials[index] = material;
+    GLEAM_ASSERT(mResources->materials.size() > index, "Material index out of range.");
+    mResources->materials[index] = material;
 }
 
 const MaterialInstance& MeshRenderer::GetMaterial(uint32_t index) const
 {
-    GLEAM_ASSERT(mMaterials.size() > index, "Material index out of range.");
-    return mMaterials[index];
+    GLEAM_ASSERT(mResources->materials.size() > index, "Material index out of range.");
+    return mResources->materials[index];
 }
 
 const TArray<MaterialInstance>& MeshRenderer::GetMaterials() const
 {
-	return mMaterials;
+	return mResources->materials;
 }
 
 const Mesh& MeshRenderer::GetMesh() const
 {
-    return mMesh;
+    GLEAM_ASSERT(IsReady(), "MeshRenderer is still loading.");
+    return *mResources->mesh;
+}
+
+void MeshRenderer::SetOccluder(bool occluder)
+{
+    mResources->occluder = occluder;
+    if (occluder == false)
+    {
+        mResources->occluderGeometry.reset();
+        return;
+    }
+
+    // built together with the mesh when it is still loading
+    if (mResources->occluderGeometry || mResources->meshDescriptor == nullptr)
+        return;
+
+    const auto& descriptor = *mResources->meshDescriptor;
+    VisitGeometry(mMeshAsset, descriptor, [&](const MeshGeometry& geometry)
+    {
+        mResources->occluderGeometry = CreateRef<OccluderGeometry>(OccluderGeometry::Create(descriptor, geometry));
+    });
+}
+
+bool MeshRenderer::IsOccluder() const
+{
+    return mResources->occluderGeometry != nullptr;
+}
+
+const OccluderGeometry& MeshRenderer::GetOccluderGeometry() const
+{
+    GLEAM_ASSERT(mResources->occluderGeometry, "MeshRenderer is not an occluder.");
+    return *mResources->occluderGeometry;
 }
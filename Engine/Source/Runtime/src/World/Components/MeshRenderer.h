@@ -1,6 +1,8 @@
 #pragma once
 #include "Renderer/Mesh.h"
+#include "Renderer/OcclusionCulling.h"
 #include "Renderer/Material/MaterialInstance.h"
+#include "Assets/AssetReference.h"
 
 namespace Gleam {
 
@@ -10,6 +12,18 @@ public:
 
     MeshRenderer(const AssetReference& mesh, const TArray<AssetReference>& materials);
 
+    // copies would share the loaded resources and their materials, the registry only needs to move the component
+    MeshRenderer(const MeshRenderer&) = delete;
+    MeshRenderer& operator=(const MeshRenderer&) = delete;
+    MeshRenderer(MeshRenderer&&) = default;
+    MeshRenderer& operator=(MeshRenderer&&) = default;
+
+    // the mesh and materials are loaded in the background, until they all arrive there is nothing to draw
+    bool IsReady() const;
+
+    // the mesh or one of the materials could not be loaded, the renderer is never drawn
+    bool HasFailed() const;
+
     void SetMaterial(const MaterialInstance& material, uint32_t index);
 
 	const MaterialInstance& GetMaterial(uint32_t index) const;
@@ -17,12 +31,23 @@ public:
     const TArray<MaterialInstance>& GetMaterials() const;
 
     const Mesh& GetMesh() const;
+
+    // occluders are rasterized into the occlusion buffer and never culled themselves
+    // their CPU geometry is only built when the flag is set
+    void SetOccluder(bool occluder);
+
+    bool IsOccluder() const;
+
+    const OccluderGeometry& GetOccluderGeometry() const;
     
 private:
-    
-    Mesh mMesh;
-    
-    TArray<MaterialInstance> mMaterials;
+
+    // shared with the load callbacks, the registry may move the component before they run
+    struct Resources;
+
+    RefCounted<Resources> mResources;
+
+    AssetReference mMeshAsset;
     
 };
 
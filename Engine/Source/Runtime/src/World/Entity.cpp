@@ -14,6 +14,7 @@ void Entity::SetParent(const EntityHandle parent)
 	}
 
 	mParent = parent;
+	MarkTransformChanged();
 
 	// Add entity to the parent's children
 	if (parent != InvalidEntity)
@@ -41,6 +42,19 @@ void Entity::UpdateTransform() const
 	}
 }
 
+void Entity::MarkTransformChanged()
+{
+	auto changes = mRegistry ? mRegistry->ctx().find<TransformChanges>() : nullptr;
+	if (changes == nullptr)
+		return;
+
+	changes->entities.insert(mHandle);
+	for (auto child : mChildren)
+	{
+		mRegistry->get<Entity>(child).MarkTransformChanged();
+	}
+}
+
 bool Entity::RequiresTransformUpdate() const
 {
 	if (HasParent())
@@ -53,6 +67,7 @@ bool Entity::RequiresTransformUpdate() const
 
 void Entity::Translate(const Float3& translation)
 {
+	MarkTransformChanged();
 	mLocalTransform.position += translation;
 	mGlobalTransform.position += translation;
 
@@ -77,6 +92,7 @@ void Entity::Translate(const Float3& translation)
 void Entity::Rotate(const Quaternion& rotation)
 {
 	mIsTransformDirty = true;
+	MarkTransformChanged();
 	mLocalTransform.rotation *= rotation;
 	mGlobalTransform.rotation *= rotation;
 
@@ -100,6 +116,7 @@ void Entity::Rotate(float xAngle, float yAngle, float zAngle)
 void Entity::Scale(const Float3& scale)
 {
 	mIsTransformDirty = true;
+	MarkTransformChanged();
 	mLocalTransform.scale *= scale;
 	mGlobalTransform.scale *= scale;
 
@@ -117,6 +134,7 @@ void Entity::Scale(float scale)
 
 void Entity::SetTranslation(const Float3& translation)
 {
+	MarkTransformChanged();
 	mGlobalTransform.position = mGlobalTransform.position - mLocalTransform.position + translation;
 	mLocalTransform.position = translation;
 
@@ -141,6 +159,7 @@ void Entity::SetTranslation(const Float3& translation)
 void Entity::SetRotation(const Quaternion& rotation)
 {
 	mIsTransformDirty = true;
+	MarkTransformChanged();
 	mLocalTransform.rotation = rotation;
 
 	if (HasParent())
@@ -163,6 +182,7 @@ void Entity::SetRotation(const Quaternion& rotation)
 void Entity::SetScale(const Float3& scale)
 {
 	mIsTransformDirty = true;
+	MarkTransformChanged();
 	mLocalTransform.scale = scale;
 
 	if (HasParent())
@@ -10,6 +10,12 @@ static constexpr EntityHandle InvalidEntity = entt::null;
 template<typename ... Excludes>
 using Exclude = entt::exclude_t<Excludes...>;
 
+// Entities whose world transform or active state changed, kept in the registry context until the world subsystems have ticked
+struct TransformChanges
+{
+	HashSet<EntityHandle> entities;
+};
+
 class Entity
 {
 public:
@@ -39,6 +45,7 @@ public:
 	void SetActive(bool active)
 	{
 		mActive = active;
+		MarkTransformChanged();
 	}
 
 	bool IsValid() const
@@ -187,6 +194,9 @@ private:
 	void UpdateTransform() const;
 
 	bool RequiresTransformUpdate() const;
+
+	// Records the entity and its descendants in TransformChanges
+	void MarkTransformChanged();
     
     bool mActive = true;
 
@@ -80,6 +80,20 @@ public:
         return entity;
 	}
 
+	TArray<EntityHandle> CreateEntities(const TArray<Guid>& guids)
+	{
+		TArray<EntityHandle> handles(guids.size());
+		mRegistry.create(handles.begin(), handles.end());
+		mRegistry.storage<Entity>().reserve(mRegistry.storage<Entity>().size() + guids.size());
+		mHandles.reserve(mHandles.size() + guids.size());
+		for (size_t i = 0; i < guids.size(); i++)
+		{
+			mRegistry.emplace<Entity>(handles[i], handles[i], &mRegistry, guids[i]);
+			mHandles[guids[i]] = handles[i];
+		}
+		return handles;
+	}
+
 	template<typename ... Types>
 	Entity& CreateEntity(const Guid& guid, Types&& ... components)
 	{
@@ -105,6 +119,31 @@ public:
 		mRegistry.destroy(entities.begin(), entities.end());
 	}
     
+	bool IsValid(EntityHandle entity) const
+	{
+		return mRegistry.valid(entity);
+	}
+
+	// Candidate is called with the registry and the entity when a T component is added or about to be removed
+	template<typename T, auto Candidate, typename Receiver>
+	void ConnectOnAdd(Receiver& receiver)
+	{
+		mRegistry.on_construct<T>().template connect<Candidate>(receiver);
+	}
+
+	template<typename T, auto Candidate, typename Receiver>
+	void ConnectOnRemove(Receiver& receiver)
+	{
+		mRegistry.on_destroy<T>().template connect<Candidate>(receiver);
+	}
+
+	template<typename T, typename Receiver>
+	void Disconnect(Receiver& receiver)
+	{
+		mRegistry.on_construct<T>().disconnect(receiver);
+		mRegistry.on_destroy<T>().disconnect(receiver);
+	}
+
     template<typename T, typename ... Args>
     void SetSingletonComponent(Args&&... args)
     {
@@ -164,6 +203,25 @@ public:
         return mRegistry.get<T>(entity);
     }
 
+	// Adds a default constructed component of a reflected type to every entity at once
+	void InsertComponents(size_t typeHash, const TArray<EntityHandle>& entities)
+	{
+		auto meta = entt::resolve(static_cast<uint32_t>(typeHash));
+		auto func = meta.func("InsertComponents"_hs);
+		GLEAM_ASSERT(func, "Component type is not registered to the scripting system!");
+		func.invoke({}, &mRegistry, entities.data(), entities.size());
+	}
+
+	void* GetComponent(EntityHandle entity, size_t typeHash)
+	{
+		auto storage = mRegistry.storage(static_cast<uint32_t>(typeHash));
+		if (storage && storage->contains(entity))
+		{
+			return storage->value(entity);
+		}
+		return nullptr;
+	}
+
 	EntityHandle GetEntity(const EntityReference& ref) const
 	{
 		auto it = mHandles.find(ref.guid);
@@ -23,7 +23,8 @@ public:
 				.type(entt::type_hash<T>::value())
 				.template func<&AddComponent<T>, entt::as_ref_t>("AddComponent"_hs)
 				.template func<&RemoveComponent<T>>("RemoveComponent"_hs)
-				.template func<&HasComponent<T>>("HasComponent"_hs);
+				.template func<&HasComponent<T>>("HasComponent"_hs)
+				.template func<&InsertComponents<T>>("InsertComponents"_hs);
 		}
 	}
 
@@ -47,6 +48,13 @@ private:
 		return entity.get().HasComponent<T>();
 	}
 
+	// default constructs the component for every entity in one storage operation
+	template<typename T>
+	static void InsertComponents(entt::registry* registry, const EntityHandle* entities, size_t count)
+	{
+		registry->insert<T>(entities, entities + count);
+	}
+
 };
 
 } // namespace Gleam
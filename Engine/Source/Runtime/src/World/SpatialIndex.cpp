@@ -0,0 +1,154 @@
+#include "gpch.h"
+#include "SpatialIndex.h"
+
+#include "World.h"
+#include "Renderer/Mesh.h"
+
+using namespace Gleam;
+
+static BoundingBox CalculateWorldBounds(const Mesh& mesh, const Float4x4& transform)
+{
+	const auto& submeshes = mesh.GetSubmeshDescriptors();
+	BoundingBox bounds = submeshes[0].bounds;
+	for (uint32_t i = 1; i < submeshes.size(); i++)
+	{
+		bounds = bounds.Merge(submeshes[i].bounds);
+	}
+	return bounds.Transform(transform);
+}
+
+void SpatialIndex::Initialize(World* world)
+{
+	mWorld = world;
+	auto& entityManager = mWorld->GetEntityManager();
+	entityManager.ConnectOnAdd<MeshRenderer, &SpatialIndex::OnMeshRendererAdded>(*this);
+	entityManager.ConnectOnRemove<MeshRenderer, &SpatialIndex::OnMeshRendererRemoved>(*this);
+}
+
+void SpatialIndex::Shutdown()
+{
+	mWorld->GetEntityManager().Disconnect<MeshRenderer>(*this);
+	mTree.Clear();
+	mProxies.clear();
+	mLoading.clear();
+}
+
+void SpatialIndex::Tick()
+{
+	auto& entityManager = mWorld->GetEntityManager();
+	const auto& changes = entityManager.GetSingletonComponent<TransformChanges>();
+
+	uint32_t insertedCount = 0;
+	for (auto it = mLoading.begin(); it != mLoading.end();)
+	{
+		it = UpdateProxy(*it, insertedCount) ? mLoading.erase(it) : std::next(it);
+	}
+
+	for (auto handle : changes.entities)
+	{
+		if (UpdateProxy(handle, insertedCount) == false)
+		{
+			mLoading.insert(handle);
+		}
+	}
+
+	// incremental insertion builds a poor hierarchy for bulk loads such as a world being opened
+	if (insertedCount >= RebuildThreshold && insertedCount * 2 >= mTree.GetProxyCount())
+	{
+		mTree.Rebuild();
+	}
+}
+
+bool SpatialIndex::UpdateProxy(EntityHandle handle, uint32_t& insertedCount)
+{
+	auto& entityManager = mWorld->GetEntityManager();
+
+	// destroyed entities and ones without a MeshRenderer have already been removed
+	if (!entityManager.IsValid(handle) || !entityManager.HasComponent<MeshRenderer>(handle))
+		return true;
+
+	const auto& entity = entityManager.GetComponent<Entity>(handle);
+	auto it = mProxies.find(handle);
+	if (!entity.IsActive())
+	{
+		if (it != mProxies.end())
+		{
+			mTree.DestroyProxy(it->second);
+			mProxies.erase(it);
+		}
+		return true;
+	}
+
+	// a renderer whose load failed is never drawn, there is nothing left to wait for
+	const auto& meshRenderer = entityManager.GetComponent<MeshRenderer>(handle);
+	if (meshRenderer.HasFailed())
+		return true;
+
+	if (meshRenderer.IsReady() == false)
+		return false;
+
+	auto bounds = CalculateWorldBounds(meshRenderer.GetMesh(), entity.GetWorldTransform());
+	if (it != mProxies.end())
+	{
+		mTree.MoveProxy(it->second, bounds);
+	}
+	else
+	{
+		mProxies.emplace(handle, mTree.CreateProxy(bounds, handle));
+		insertedCount++;
+	}
+	return true;
+}
+
+void SpatialIndex::OnMeshRendererAdded(entt::registry& registry, EntityHandle entity)
+{
+	// indexed on the next tick, together with the transform it ends up with this frame
+	registry.ctx().get<TransformChanges>().entities.insert(entity);
+}
+
+void SpatialIndex::OnMeshRendererRemoved(entt::registry& registry, EntityHandle entity)
+{
+	mLoading.erase(entity);
+	if (auto it = mProxies.find(entity); it != mProxies.end())
+	{
+		mTree.DestroyProxy(it->second);
+		mProxies.erase(it);
+	}
+}
+
+EntityHandle SpatialIndex::Raycast(const Float3& origin, const Float3& direction, float maxDistance) const
+{
+	EntityHandle nearest = InvalidEntity;
+	mTree.Raycast(origin, Math::Normalize(direction), maxDistance, [&](EntityHandle entity, float distance)
+	{
+		nearest = entity;
+		return distance;
+	});
+	return nearest;
+}
+
+TArray<EntityHandle> SpatialIndex::Query(const Frustum& frustum) const
+{
+	TArray<EntityHandle> entities;
+	mTree.Query(frustum, [&](EntityHandle entity) { entities.push_back(entity); });
+	return entities;
+}
+
+TArray<EntityHandle> SpatialIndex::Query(const BoundingSphere& sphere) const
+{
+	TArray<EntityHandle> entities;
+	mTree.Query(sphere, [&](EntityHandle entity) { entities.push_back(entity); });
+	return entities;
+}
+
+TArray<EntityHandle> SpatialIndex::Query(const BoundingBox& bounds) const
+{
+	TArray<EntityHandle> entities;
+	mTree.Query(bounds, [&](EntityHandle entity) { entities.push_back(entity); });
+	return entities;
+}
+
+uint32_t SpatialIndex::GetEntryCount() const
+{
+	return mTree.GetProxyCount();
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "WorldSubsystem.h"
+#include "Container/DynamicAABBTree.h"
+
+namespace Gleam {
+
+class World;
+
+/*
+* Keeps a dynamic AABB tree over the world bounds of active MeshRenderer entities
+* Only entries listed in TransformChanges are refit, MeshRenderer additions and removals arrive through registry signals
+* Renderers whose mesh is still loading are retried every tick until it arrives
+*/
+class SpatialIndex final : public TickableWorldSubsystem
+{
+public:
+
+	// Inserting at least this many entries in one tick, and half of the tree, rebuilds it top down instead
+	static constexpr uint32_t RebuildThreshold = 64;
+
+	virtual void Initialize(World* world) override;
+
+	virtual void Shutdown() override;
+
+	virtual void Tick() override;
+
+	// Nearest entity whose bounds the ray enters, InvalidEntity if nothing is hit
+	EntityHandle Raycast(const Float3& origin, const Float3& direction, float maxDistance = Math::Infinity) const;
+
+	TArray<EntityHandle> Query(const Frustum& frustum) const;
+
+	TArray<EntityHandle> Query(const BoundingSphere& sphere) const;
+
+	TArray<EntityHandle> Query(const BoundingBox& bounds) const;
+
+	uint32_t GetEntryCount() const;
+
+private:
+
+	// false while the mesh of the entity is still loading
+	bool UpdateProxy(EntityHandle handle, uint32_t& insertedCount);
+
+	void OnMeshRendererAdded(entt::registry& registry, EntityHandle entity);
+
+	void OnMeshRendererRemoved(entt::registry& registry, EntityHandle entity);
+
+	World* mWorld = nullptr;
+
+	DynamicAABBTree<EntityHandle> mTree;
+
+	HashMap<EntityHandle, int32_t> mProxies;
+
+	HashSet<EntityHandle> mLoading;
+
+};
+
+} // namespace Gleam
@@ -3,22 +3,106 @@
 
 #include "World/World.h"
 #include "Renderer/Mesh.h"
+#include "Renderer/LodSelection.h"
+#include "Renderer/TextureStreamer.h"
 #include "Renderer/Material/Material.h"
 #include "Renderer/Material/MaterialInstance.h"
+#include "Core/Globals.h"
+#include "Core/Application.h"
 
 using namespace Gleam;
 
 void RenderSceneProxy::OnUpdate(EntityManager& entityManager)
 {
+    GLEAM_PROFILE_SCOPE("RenderSceneProxy::OnUpdate");
+
+    // update active camera
+    mActiveCamera = nullptr;
+    entityManager.ForEach<Entity, Camera>([&](const Entity& entity, const Camera& component)
+    {
+        if (entity.IsActive())
+        {
+            mActiveCamera = &entity;
+        }
+    });
+
+    Frustum frustum;
+    Float3 eye = Float3::zero;
+    const Camera* camera = nullptr;
+    if (mActiveCamera)
+    {
+        camera = &mActiveCamera->GetComponent<Camera>();
+        auto viewMatrix = Float4x4::LookTo(mActiveCamera->GetWorldPosition(), mActiveCamera->ForwardVector(), mActiveCamera->UpVector());
+        auto viewProjection = camera->GetProjectionMatrix() * viewMatrix;
+        frustum = Frustum(viewProjection);
+        eye = mActiveCamera->GetWorldPosition();
+
+        // rasterize occluders before testing anything against them
+        mOcclusionCulling.Begin(viewProjection);
+        entityManager.ForEach<Entity, MeshRenderer>([&](const Entity& entity, const MeshRenderer& meshRenderer)
+        {
+            if (meshRenderer.IsOccluder())
+            {
+                mOcclusionCulling.RenderOccluder(meshRenderer.GetOccluderGeometry(), entity.GetWorldTransform());
+            }
+        });
+        mOcclusionCulling.End();
+    }
+
+    // textures of visible batches are streamed at the size their renderer covers on screen
+    auto textureStreamer = Globals::GameInstance->GetSubsystem<TextureStreamer>();
+    auto requestTextures = [textureStreamer](const MaterialInstance& material, float screenSize)
+    {
+        const auto& properties = material.GetProperties();
+        const auto& values = material.GetPropertyValues();
+        for (uint32_t i = 0; i < properties.size(); ++i)
+        {
+            if (properties[i].type == MaterialPropertyType::Texture2D)
+            {
+                textureStreamer->Request(values[i].texture, screenSize);
+            }
+        }
+    };
+
+    // batches draw with whichever tail is resident this frame
+    auto resolveTextures = [textureStreamer](MeshBatch& batch)
+    {
+        const auto& properties = batch.material.GetProperties();
+        const auto& values = batch.material.GetPropertyValues();
+        for (uint32_t i = 0; i < properties.size(); ++i)
+        {
+            if (properties[i].type == MaterialPropertyType::Texture2D)
+            {
+                batch.textures.push_back(textureStreamer->GetTexture(values[i].texture));
+            }
+        }
+    };
+
     // update static batches
     mStaticBatches.clear();
-    entityManager.ForEach<Entity, MeshRenderer>([this](const Entity& entity, const MeshRenderer& meshRenderer)
+    mFrame++;
+    size_t renderedEntities = 0;
+    entityManager.ForEach<Entity, MeshRenderer>([&](const Entity& entity, const MeshRenderer& meshRenderer)
     {
+        // drawn from the frame its mesh and materials have arrived
+        if (meshRenderer.IsReady() == false)
+            return;
+
         GLEAM_ASSERT(meshRenderer.GetMesh().GetSubmeshCount() > 0);
 		GLEAM_ASSERT(meshRenderer.GetMaterials().size() == meshRenderer.GetMesh().GetSubmeshCount());
 
 		const auto& materials = meshRenderer.GetMaterials();
 		const auto& submeshes = meshRenderer.GetMesh().GetSubmeshDescriptors();
+		const auto& meshlets = meshRenderer.GetMesh().GetMeshletDescriptors();
+		const auto& lods = meshRenderer.GetMesh().GetLodDescriptors();
+
+		auto& lodState = mLodLevels[entity];
+		lodState.frame = mFrame;
+		renderedEntities++;
+
+		auto& levels = lodState.levels;
+		levels.resize(meshRenderer.GetMesh().GetSubmeshCount(), 0);
+
 		for (uint32_t i = 0; i < meshRenderer.GetMesh().GetSubmeshCount(); ++i)
 		{
 			MeshBatch batch = {
@@ -28,20 +112,51 @@ void RenderSceneProxy::OnUpdate(EntityManager& entityManager)
 				.material = materials[i]
 			};
 
+			if (camera)
+			{
+				const auto& bounds = batch.submesh.bounds;
+				auto sphere = BoundingSphere((bounds.min + bounds.max) * 0.5f, Math::Length(bounds.max - bounds.min) * 0.5f).Transform(batch.transform);
+				float screenSize = LodSelection::ScreenSize(sphere, *camera, eye);
+				levels[i] = LodSelection::Select(lods, batch.submesh, screenSize, levels[i]);
+
+				if (levels[i] == 0)
+				{
+					bool backfaceCulling = camera->projectionType == ProjectionType::Perspective;
+					ClusterCulling::Cull(meshlets, batch.submesh, batch.transform, frustum, eye, batch.drawRanges, backfaceCulling);
+				}
+				else if (frustum.Intersects(sphere))
+				{
+					const auto& lod = lods[batch.submesh.firstLod + levels[i] - 1];
+					batch.drawRanges.push_back({ lod.firstIndex, lod.indexCount });
+				}
+
+				if (batch.drawRanges.empty())
+					continue;
+
+				if (!meshRenderer.IsOccluder() && !mOcclusionCulling.IsVisible(bounds, batch.transform))
+					continue;
+
+				requestTextures(batch.material, screenSize);
+			}
+			else
+			{
+				batch.drawRanges.push_back({ batch.submesh.firstIndex, batch.submesh.indexCount });
+			}
+
+			resolveTextures(batch);
 			const auto& baseMaterial = static_cast<const Material*>(batch.material.GetBaseMaterial());
 			mStaticBatches[baseMaterial].emplace_back(batch);
 		}
     });
-    
-    // update active camera
-    mActiveCamera = nullptr;
-    entityManager.ForEach<Entity, Camera>([&](const Entity& entity, const Camera& component)
+
+    // forget entities that are gone, only when there are any
+    if (mLodLevels.size() > renderedEntities)
     {
-        if (entity.IsActive())
+        std::erase_if(mLodLevels, [this](const auto& entry)
         {
-            mActiveCamera = &entity;
-        }
-    });
+            return entry.second.frame != mFrame;
+        });
+    }
 }
 
 void RenderSceneProxy::ForEach(BatchFn&& fn) const
@@ -56,3 +171,8 @@ const Entity* RenderSceneProxy::GetActiveCamera() const
 {
     return mActiveCamera;
 }
+
+const OcclusionCullingStatistics& RenderSceneProxy::GetOcclusionStatistics() const
+{
+    return mOcclusionCulling.GetStatistics();
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include "World/ComponentSystem.h"
+#include "Renderer/ClusterCulling.h"
+#include "Renderer/OcclusionCulling.h"
+#include "Renderer/Texture.h"
 
 namespace Gleam {
 
@@ -14,6 +17,8 @@ struct MeshBatch
     Float4x4 transform;
 	SubmeshDescriptor submesh;
     MaterialInstance material;
+    TArray<IndexRange> drawRanges;
+    TArray<Texture> textures; // resident tails of the Texture2D properties of the material, in property order
 };
 
 class RenderSceneProxy : public ComponentSystem
@@ -27,11 +32,24 @@ public:
     
     const Entity* GetActiveCamera() const;
 
+    const OcclusionCullingStatistics& GetOcclusionStatistics() const;
+
 private:
     
     const Entity* mActiveCamera = nullptr;
     
     HashMap<const Material*, TArray<MeshBatch>> mStaticBatches;
+
+    // selected LOD per submesh, kept across frames for hysteresis
+    struct LodState
+    {
+        TArray<uint32_t> levels;
+        uint64_t frame = 0;
+    };
+    HashMap<EntityHandle, LodState> mLodLevels;
+    uint64_t mFrame = 0;
+
+    OcclusionCulling mOcclusionCulling;
     
 };
 
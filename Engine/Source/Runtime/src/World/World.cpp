@@ -1,26 +1,90 @@
 #include "gpch.h"
 #include "World.h"
+#include "SpatialIndex.h"
+#include "BinaryWorldFormat.h"
+#include "IO/MappedFile.h"
 #include "Systems/RenderSceneProxy.h"
 #include "Serialization/JSONInternal.h"
 #include "Serialization/JSONSerializer.h"
+#include "Serialization/BinarySerializer.h"
 
 using namespace Gleam;
 
+struct BinaryStringTable
+{
+	TArray<TString> strings;
+	HashMap<TString, uint32_t> indices;
+
+	uint32_t Add(const TStringView str)
+	{
+		auto [it, inserted] = indices.try_emplace(TString(str), static_cast<uint32_t>(strings.size()));
+		if (inserted)
+		{
+			strings.emplace_back(str);
+		}
+		return it->second;
+	}
+};
+
+struct BinaryStringView
+{
+	const uint32_t* offsets;
+	const char* characters;
+	size_t size; // bytes from the first character to the end of the file
+	uint32_t count;
+
+	bool Get(uint32_t index, TStringView& str) const
+	{
+		if (index >= count || offsets[index] >= size)
+		{
+			return false;
+		}
+
+		// the terminator has to be inside the file, an unterminated string would read past it
+		const char* first = characters + offsets[index];
+		const void* last = memchr(first, '\0', size - offsets[index]);
+		if (last == nullptr)
+		{
+			return false;
+		}
+		str = TStringView(first, static_cast<const char*>(last) - first);
+		return true;
+	}
+};
+
+// Overflow safe check that count elements of stride bytes at offset are inside the file
+static bool IsTableInBounds(uint64_t offset, uint64_t count, size_t stride, size_t size)
+{
+	return offset % 8 == 0 && offset <= size && count <= (size - offset) / stride;
+}
+
+static void WriteBytes(TArray<uint8_t>& out, const void* data, size_t size)
+{
+	const auto bytes = static_cast<const uint8_t*>(data);
+	out.insert(out.end(), bytes, bytes + size);
+}
+
 World::World(const TString& name)
 	: mName(name)
 {
 	Time::Reset();
+	mEntityManager.SetSingletonComponent<TransformChanges>();
+	AddSubsystem<SpatialIndex>();
 	AddSystem<RenderSceneProxy>();
 }
 
 void World::Update()
 {
+	GLEAM_PROFILE_SCOPE("World::Update");
 	Time::Step();
 
 	for (auto subsystem : mTickableSubsystems)
 	{
 		subsystem->Tick();
 	}
+
+	// every subsystem has seen the changes, the ones made by systems below are picked up next frame
+	mEntityManager.GetSingletonComponent<TransformChanges>().entities.clear();
 	
 	bool fixedUpdate = Time::fixedTime <= (Time::elapsedTime - Time::fixedDeltaTime);
 	if (fixedUpdate)
@@ -30,6 +94,7 @@ void World::Update()
 		{
 			if (system->Enabled)
 			{
+				GLEAM_PROFILE_SCOPE(system->mName);
 				system->OnFixedUpdate(mEntityManager);
 			}
 		}
@@ -39,6 +104,7 @@ void World::Update()
 	{
 		if (system->Enabled)
 		{
+			GLEAM_PROFILE_SCOPE(system->mName);
 			system->OnUpdate(mEntityManager);
 		}
 	}
@@ -107,11 +173,10 @@ void World::Serialize(FileStream& stream)
 	document.Accept(writer);
 }
 
-void World::Deserialize(FileStream& stream)
+void World::Deserialize(const MappedFile& file)
 {
 	rapidjson::Document root(rapidjson::kObjectType);
-	rapidjson::IStreamWrapper ss(stream);
-	root.ParseStream(ss);
+	root.Parse(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
 
 	mName = TString(root["Name"].GetString());
 
@@ -132,7 +197,7 @@ void World::Deserialize(FileStream& stream)
 		const auto& transformObject = entityObject["Transform"];
 		rapidjson::ConstNode transformNode(transformObject);
 		{
-			JSONSerializer serializer(stream);
+			JSONSerializer serializer(file);
 			auto transform = serializer.Deserialize<Transform>(transformNode);
 
 			entity.SetTranslation(transform.position);
@@ -151,8 +216,9 @@ void World::Deserialize(FileStream& stream)
 			auto component = func.invoke({}, Ref(entity));
 			GLEAM_ASSERT(component, "Entity component could not deserialize");
 
-			JSONSerializer serializer(stream);
-			serializer.Deserialize(classDesc, component.data());
+			// components are nodes of the world document, same as they are written
+			JSONSerializer serializer(file);
+			serializer.Deserialize(classDesc, component.data(), rapidjson::ConstNode(componentObject));
 		}
 	}
 
@@ -164,4 +230,312 @@ void World::Deserialize(FileStream& stream)
 			entity->SetParent(parent);
 		}
 	}
-}
\ No newline at end of file
+}
+
+void World::SerializeBinary(FileStream& stream)
+{
+	BinaryStringTable strings;
+	BinaryWorldHeader header;
+	header.name = strings.Add(mName);
+
+	TArray<BinaryWorldEntity> entities;
+	HashMap<EntityHandle, uint32_t> entityIndices;
+	mEntityManager.ForEach([&](EntityHandle handle)
+	{
+		const auto& entity = mEntityManager.GetComponent<Entity>(handle);
+		const auto& transform = entity.GetLocalTransform();
+
+		entityIndices[handle] = static_cast<uint32_t>(entities.size());
+		entities.push_back({
+			.guid = entity.GetGuid().GetBytes(),
+			.position = transform.position,
+			.rotation = transform.rotation,
+			.scale = transform.scale,
+			.active = entity.IsActive() ? 1u : 0u
+		});
+	});
+
+	struct ColumnData
+	{
+		uint32_t typeName;
+		TArray<uint32_t> entities;
+		BinaryWriter writer;
+	};
+	TArray<ColumnData> columns;
+	HashMap<TStringView, uint32_t> columnIndices;
+
+	TArray<BinaryWorldParent> parents;
+	mEntityManager.ForEach([&](EntityHandle handle)
+	{
+		uint32_t entityIndex = entityIndices[handle];
+		const auto& entity = mEntityManager.GetComponent<Entity>(handle);
+		if (entity.HasParent())
+		{
+			parents.push_back({ entityIndex, entityIndices[entity.GetParent()] });
+		}
+
+		mEntityManager.Visit(handle, [&](const void* component, const Reflection::ClassDescription& classDesc)
+		{
+			if (classDesc.HasAttribute<Reflection::Attribute::EntityComponent>())
+			{
+				auto [it, inserted] = columnIndices.try_emplace(classDesc.ResolveName(), static_cast<uint32_t>(columns.size()));
+				if (inserted)
+				{
+					columns.push_back({ .typeName = strings.Add(classDesc.ResolveName()) });
+				}
+
+				auto& column = columns[it->second];
+				column.entities.push_back(entityIndex);
+				column.writer.Write(component, classDesc);
+			}
+		});
+	});
+
+	header.stringCount = static_cast<uint32_t>(strings.strings.size());
+	header.entityCount = static_cast<uint32_t>(entities.size());
+	header.parentCount = static_cast<uint32_t>(parents.size());
+	header.columnCount = static_cast<uint32_t>(columns.size());
+
+	TArray<uint8_t> file(sizeof(BinaryWorldHeader));
+	auto align = [&]()
+	{
+		file.resize(Utils::AlignUp(file.size(), 8));
+		return file.size();
+	};
+
+	header.stringTableOffset = align();
+	uint32_t characterOffset = 0;
+	for (const auto& str : strings.strings)
+	{
+		WriteBytes(file, &characterOffset, sizeof(uint32_t));
+		characterOffset += static_cast<uint32_t>(str.size()) + 1;
+	}
+	for (const auto& str : strings.strings)
+	{
+		WriteBytes(file, str.c_str(), str.size() + 1);
+	}
+
+	header.entityTableOffset = align();
+	WriteBytes(file, entities.data(), entities.size() * sizeof(BinaryWorldEntity));
+
+	header.parentTableOffset = align();
+	WriteBytes(file, parents.data(), parents.size() * sizeof(BinaryWorldParent));
+
+	header.columnTableOffset = align();
+	file.resize(file.size() + columns.size() * sizeof(BinaryWorldColumn));
+	for (uint32_t i = 0; i < columns.size(); i++)
+	{
+		BinaryWorldColumn column;
+		column.typeName = columns[i].typeName;
+		column.count = static_cast<uint32_t>(columns[i].entities.size());
+		column.entitiesOffset = align();
+		WriteBytes(file, columns[i].entities.data(), columns[i].entities.size() * sizeof(uint32_t));
+		column.dataOffset = align();
+		columns[i].writer.Finish(file);
+		column.dataSize = file.size() - column.dataOffset;
+		memcpy(file.data() + header.columnTableOffset + i * sizeof(BinaryWorldColumn), &column, sizeof(BinaryWorldColumn));
+	}
+	memcpy(file.data(), &header, sizeof(BinaryWorldHeader));
+
+	stream.write(reinterpret_cast<const char*>(file.data()), file.size());
+}
+
+bool World::DeserializeBinary(const uint8_t* data, size_t size)
+{
+	if (IsBinary(data, size) == false)
+	{
+		GLEAM_CORE_ERROR("World data is not in binary world format");
+		return false;
+	}
+
+	BinaryWorldHeader header;
+	memcpy(&header, data, sizeof(BinaryWorldHeader));
+	if (header.version != BinaryWorldHeader::CurrentVersion)
+	{
+		GLEAM_CORE_ERROR("Binary world version {0} is not supported, expected {1}", header.version, BinaryWorldHeader::CurrentVersion);
+		return false;
+	}
+
+	if (IsTableInBounds(header.stringTableOffset, header.stringCount, sizeof(uint32_t), size) == false ||
+		IsTableInBounds(header.entityTableOffset, header.entityCount, sizeof(BinaryWorldEntity), size) == false ||
+		IsTableInBounds(header.parentTableOffset, header.parentCount, sizeof(BinaryWorldParent), size) == false ||
+		IsTableInBounds(header.columnTableOffset, header.columnCount, sizeof(BinaryWorldColumn), size) == false)
+	{
+		GLEAM_CORE_ERROR("Binary world data is truncated");
+		return false;
+	}
+
+	size_t charactersOffset = header.stringTableOffset + header.stringCount * sizeof(uint32_t);
+	BinaryStringView strings
+	{
+		.offsets = reinterpret_cast<const uint32_t*>(data + header.stringTableOffset),
+		.characters = reinterpret_cast<const char*>(data + charactersOffset),
+		.size = size - charactersOffset,
+		.count = header.stringCount
+	};
+
+	TStringView name;
+	if (strings.Get(header.name, name) == false)
+	{
+		GLEAM_CORE_ERROR("Binary world name is not in the string table");
+		return false;
+	}
+
+	// an entity has at most one parent and the parent chains end at a root, SetParent and the transform walk assume both
+	constexpr uint32_t NoParent = ~0u;
+	TArray<uint32_t> parents(header.entityCount, NoParent);
+	const auto parentTable = reinterpret_cast<const BinaryWorldParent*>(data + header.parentTableOffset);
+	for (uint32_t i = 0; i < header.parentCount; i++)
+	{
+		const auto& parent = parentTable[i];
+		if (parent.entity >= header.entityCount || parent.parent >= header.entityCount || parent.entity == parent.parent)
+		{
+			GLEAM_CORE_ERROR("Binary world parent {0} references an invalid entity", i);
+			return false;
+		}
+
+		if (parents[parent.entity] != NoParent)
+		{
+			GLEAM_CORE_ERROR("Binary world entity {0} has more than one parent", parent.entity);
+			return false;
+		}
+		parents[parent.entity] = parent.parent;
+	}
+
+	// every chain is walked once, reaching an entity stamped by the current walk closes a cycle
+	TArray<uint32_t> walkStamps(header.entityCount, 0);
+	for (uint32_t i = 0; i < header.entityCount; i++)
+	{
+		for (uint32_t index = i; index != NoParent && walkStamps[index] == 0; index = parents[index])
+		{
+			walkStamps[index] = i + 1;
+			if (parents[index] != NoParent && walkStamps[parents[index]] == i + 1)
+			{
+				GLEAM_CORE_ERROR("Binary world entity {0} is its own ancestor", index);
+				return false;
+			}
+		}
+	}
+
+	// everything is validated before the first entity is created, a corrupt file leaves the world untouched
+	struct ColumnType
+	{
+		size_t hash;
+		const Reflection::ClassDescription* classDesc;
+	};
+	TArray<ColumnType> columnTypes(header.columnCount);
+	TArray<uint32_t> columnStamps(header.entityCount, 0);
+
+	const auto columnTable = reinterpret_cast<const BinaryWorldColumn*>(data + header.columnTableOffset);
+	for (uint32_t i = 0; i < header.columnCount; i++)
+	{
+		const auto& column = columnTable[i];
+		TStringView typeName;
+		if (strings.Get(column.typeName, typeName) == false)
+		{
+			GLEAM_CORE_ERROR("Binary world column {0} type name is not in the string table", i);
+			return false;
+		}
+
+		auto typeHash = Reflection::Database::GetTypeHash(typeName);
+		if (typeHash == 0 || !entt::resolve(static_cast<uint32_t>(typeHash)).func("InsertComponents"_hs))
+		{
+			GLEAM_CORE_ERROR("Binary world column {0} is not a registered component type", typeName);
+			return false;
+		}
+		columnTypes[i] = { typeHash, &Reflection::GetClass(typeHash) };
+
+		if (IsTableInBounds(column.entitiesOffset, column.count, sizeof(uint32_t), size) == false ||
+			column.dataOffset > size || column.dataSize > size - column.dataOffset)
+		{
+			GLEAM_CORE_ERROR("Binary world column {0} is truncated", typeName);
+			return false;
+		}
+
+		// an entity appears at most once per column, entt can not insert a component twice
+		const auto entityIndices = reinterpret_cast<const uint32_t*>(data + column.entitiesOffset);
+		for (uint32_t j = 0; j < column.count; j++)
+		{
+			uint32_t index = entityIndices[j];
+			if (index >= header.entityCount || columnStamps[index] == i + 1)
+			{
+				GLEAM_CORE_ERROR("Binary world column {0} references an invalid entity", typeName);
+				return false;
+			}
+			columnStamps[index] = i + 1;
+		}
+	}
+	mName = TString(name);
+
+	const auto entityTable = reinterpret_cast<const BinaryWorldEntity*>(data + header.entityTableOffset);
+	TArray<Guid> guids;
+	guids.reserve(header.entityCount);
+	for (uint32_t i = 0; i < header.entityCount; i++)
+	{
+		guids.emplace_back(entityTable[i].guid);
+	}
+
+	auto handles = mEntityManager.CreateEntities(guids);
+	for (uint32_t i = 0; i < header.entityCount; i++)
+	{
+		auto& entity = mEntityManager.GetComponent<Entity>(handles[i]);
+		entity.SetActive(entityTable[i].active != 0);
+		entity.SetTranslation(entityTable[i].position);
+		entity.SetRotation(entityTable[i].rotation);
+		entity.SetScale(entityTable[i].scale);
+	}
+
+	for (uint32_t i = 0; i < header.parentCount; i++)
+	{
+		auto& entity = mEntityManager.GetComponent<Entity>(handles[parentTable[i].entity]);
+		entity.SetParent(handles[parentTable[i].parent]);
+	}
+
+	bool result = true;
+	for (uint32_t i = 0; i < header.columnCount; i++)
+	{
+		const auto& column = columnTable[i];
+		const auto& [typeHash, classDesc] = columnTypes[i];
+
+		const auto entityIndices = reinterpret_cast<const uint32_t*>(data + column.entitiesOffset);
+		TArray<EntityHandle> entities(column.count);
+		for (uint32_t j = 0; j < column.count; j++)
+		{
+			entities[j] = handles[entityIndices[j]];
+		}
+
+		// one storage insertion per type, then fill the fields in place
+		mEntityManager.InsertComponents(typeHash, entities);
+
+		BinaryReader reader(data + column.dataOffset, column.dataSize);
+		if (reader.IsValid() == false)
+		{
+			GLEAM_CORE_ERROR("Binary world column {0} could not be read", classDesc->ResolveName());
+			result = false;
+			continue;
+		}
+
+		for (auto entity : entities)
+		{
+			void* component = mEntityManager.GetComponent(entity, typeHash);
+			if (reader.Read(*classDesc, component) == false)
+			{
+				GLEAM_CORE_ERROR("Binary world column {0} is corrupt", classDesc->ResolveName());
+				result = false;
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+bool World::IsBinary(const uint8_t* data, size_t size)
+{
+	uint32_t magic = 0;
+	if (data == nullptr || size < sizeof(BinaryWorldHeader))
+	{
+		return false;
+	}
+	memcpy(&magic, data, sizeof(uint32_t));
+	return magic == BinaryWorldHeader::Magic;
+}
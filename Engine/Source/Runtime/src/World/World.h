@@ -4,6 +4,12 @@
 
 namespace Gleam {
 
+enum class WorldFormat
+{
+	JSON,
+	Binary
+};
+
 template <typename T>
 concept ComponentSystemType = std::is_base_of<ComponentSystem, T>::value;
 
@@ -25,7 +31,13 @@ public:
 
 	void Serialize(FileStream& stream);
 
-	void Deserialize(FileStream& stream);
+	void Deserialize(const MappedFile& file);
+
+	void SerializeBinary(FileStream& stream);
+
+	bool DeserializeBinary(const uint8_t* data, size_t size);
+
+	static bool IsBinary(const uint8_t* data, size_t size);
 
 	template<WorldSystemType T, class...Args>
 	T* AddSubsystem(Args&&... args)
@@ -73,6 +85,7 @@ public:
     {
         GLEAM_ASSERT(!HasSystem<T>(), "World already has the system!");
         T* system = mSystems.emplace<T>(std::forward<Args>(args)...);
+		system->mName = entt::type_id<T>().name();
 		system->OnCreate(mEntityManager);
 		return system;
     }
@@ -3,11 +3,15 @@
 #include "Core/Engine.h"
 #include "Core/Globals.h"
 #include "IO/FileWatcher.h"
+#include "IO/MappedFile.h"
+#include "Assets/AssetManager.h"
 
 using namespace Gleam;
 
 void WorldManager::Initialize(Application* app)
 {
+	mApp = app;
+
 	Filesystem::ForEach(Globals::ProjectContentDirectory, [this](const auto& entry)
 	{
 		if (entry.extension() == World::Extension())
@@ -58,21 +62,71 @@ void WorldManager::OpenWorld(uint32_t buildIndex)
 void WorldManager::LoadWorld(uint32_t buildIndex)
 {
 	const auto& worldRef = mWorldsInBuild[buildIndex];
+	if (mLoadedWorlds.try_emplace(worldRef, CreateScope<World>()).second == false)
+	{
+		return;
+	}
+
+	// the world opens empty and is filled in once everything it references is loaded, so its components never wait on a load
 	auto worldFile = Globals::ProjectContentDirectory/mWorldPaths[worldRef];
-	auto file = Filesystem::Open(worldFile, FileType::Text);
+	mApp->GetSubsystem<AssetManager>()->Preload({ worldRef }, [this, worldRef, worldFile]()
+	{
+		auto it = mLoadedWorlds.find(worldRef);
+		if (it == mLoadedWorlds.end())
+		{
+			return;
+		}
 
-	auto world = CreateScope<World>();
-	world->Deserialize(file.GetStream());
-	mLoadedWorlds.emplace(worldRef, std::move(world));
+		auto world = it->second.get();
+		auto mappedFile = Filesystem::Map(worldFile);
+		if (World::IsBinary(mappedFile.GetData(), mappedFile.GetSize()))
+		{
+			if (world->DeserializeBinary(mappedFile.GetData(), mappedFile.GetSize()) == false)
+			{
+				// a partially read world would reference entities that do not exist, leave it empty instead
+				GLEAM_CORE_ERROR("World {0} could not be loaded", worldFile.string());
+				auto& entityManager = world->GetEntityManager();
+				TArray<EntityHandle> entities;
+				entityManager.ForEach([&](EntityHandle handle) { entities.push_back(handle); });
+				entityManager.DestroyEntity(entities);
+			}
+		}
+		else
+		{
+			world->Deserialize(mappedFile);
+		}
+	});
 }
 
-void WorldManager::SaveWorld()
+void WorldManager::SaveWorld(WorldFormat format)
 {
 	const auto& worldRef = mWorldsInBuild[mActiveWorld];
 	auto worldFile = Globals::ProjectContentDirectory / mWorldPaths[worldRef];
-	auto file = Filesystem::Create(worldFile, FileType::Text);
 	auto world = mLoadedWorlds[worldRef].get();
-	world->Serialize(file.GetStream());
+	if (format == WorldFormat::Binary)
+	{
+		auto file = Filesystem::Create(worldFile, FileType::Binary);
+		world->SerializeBinary(file.GetStream());
+	}
+	else
+	{
+		auto file = Filesystem::Create(worldFile, FileType::Text);
+		world->Serialize(file.GetStream());
+	}
+
+	TArray<AssetReference> references;
+	auto& entityManager = world->GetEntityManager();
+	entityManager.ForEach([&](EntityHandle handle)
+	{
+		entityManager.Visit(handle, [&](const void* component, const Reflection::ClassDescription& classDesc)
+		{
+			if (classDesc.HasAttribute<Reflection::Attribute::EntityComponent>())
+			{
+				AssetDependencyGraph::CollectReferences(component, classDesc, references);
+			}
+		});
+	});
+	mApp->GetSubsystem<AssetManager>()->SetDependencies(worldRef, references);
 }
 
 World* WorldManager::GetActiveWorld()
@@ -18,9 +18,11 @@ public:
 
 	void OpenWorld(uint32_t buildIndex);
 
+	// The world is available right away and filled in on the main thread once its assets are loaded
 	void LoadWorld(uint32_t buildIndex);
 
-	void SaveWorld();
+	// JSON is kept as the default since it diffs, the cooker converts worlds to binary for cooked builds to load memory mapped
+	void SaveWorld(WorldFormat format = WorldFormat::JSON);
 
 	World* GetActiveWorld();
 
@@ -58,6 +58,8 @@
 #include "IO/Filesystem.h"
 #include "IO/FileDialog.h"
 
+#include "Core/Profiler.h"
+
 #include "Reflection/TypeTraits.h"
 #include "Reflection/Attribute.h"
 #include "Reflection/Meta.h"
@@ -74,7 +76,9 @@
 #include "Math/Float4x4.h"
 #include "Math/Size.h"
 #include "Math/Rect.h"
+#include "Math/BoundingSphere.h"
 #include "Math/BoundingBox.h"
+#include "Math/Frustum.h"
 
 #include "Core/Events/ApplicationEvent.h"
 #include "Core/Events/RendererEvent.h"
@@ -0,0 +1,130 @@
+#pragma once
+#include <random>
+#include <chrono>
+
+#include "IO/AsyncIO.h"
+
+namespace AsyncIOTests {
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Files of random sizes up to maxSize, the contents are returned for validation
+static Gleam::TArray<Gleam::TArray<char>> CreateFiles(const Gleam::Filesystem::Path& directory, uint32_t count, uint32_t maxSize)
+{
+	std::mt19937 rng(13);
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	Gleam::TArray<Gleam::TArray<char>> contents(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		contents[i].resize(1 + rng() % maxSize);
+		for (auto& c : contents[i])
+		{
+			c = static_cast<char>(rng());
+		}
+		std::ofstream stream(directory / (std::to_string(i) + ".asset"), std::ios::binary);
+		stream.write(contents[i].data(), contents[i].size());
+	}
+	return contents;
+}
+
+static Gleam::TArray<Gleam::AsyncReadRequest> CreateRequests(const Gleam::Filesystem::Path& directory, uint32_t count)
+{
+	Gleam::TArray<Gleam::AsyncReadRequest> requests(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		requests[i].path = directory / (std::to_string(i) + ".asset");
+	}
+	return requests;
+}
+
+} // namespace AsyncIOTests
+
+TEST(AsyncIO, ReadsMatchFileContents)
+{
+	using namespace Gleam;
+	constexpr uint32_t FileCount = 64;
+	auto directory = std::filesystem::temp_directory_path() / "GleamAsyncIOTests";
+	auto contents = AsyncIOTests::CreateFiles(directory, FileCount, 64 * 1024);
+
+	for (bool directIO : { false, true })
+	{
+		AsyncIO io(16, directIO);
+		auto requests = AsyncIOTests::CreateRequests(directory, FileCount);
+
+		// an unaligned range and a missing file
+		requests.push_back({ .path = directory / "0.asset", .offset = 7, .size = 100 });
+		requests.push_back({ .path = directory / "missing.asset" });
+
+		std::mutex mutex;
+		TArray<AsyncReadResult> results(requests.size());
+		io.Read(std::move(requests), [&](AsyncReadResult&& result)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			results[result.index] = std::move(result);
+		});
+		io.Wait();
+
+		for (uint32_t i = 0; i < FileCount; i++)
+		{
+			ASSERT_TRUE(results[i].success) << "file " << i;
+			ASSERT_EQ(results[i].size, contents[i].size()) << "file " << i;
+			EXPECT_EQ(memcmp(results[i].data, contents[i].data(), contents[i].size()), 0) << "file " << i;
+			EXPECT_EQ(reinterpret_cast<uintptr_t>(results[i].buffer.GetData()) % AsyncIO::Alignment, 0u);
+		}
+
+		const auto& range = results[FileCount];
+		size_t rangeSize = std::min<size_t>(100, contents[0].size() > 7 ? contents[0].size() - 7 : 0);
+		ASSERT_TRUE(range.success);
+		ASSERT_EQ(range.size, rangeSize);
+		EXPECT_EQ(memcmp(range.data, contents[0].data() + 7, rangeSize), 0);
+
+		EXPECT_FALSE(results[FileCount + 1].success);
+	}
+	std::filesystem::remove_all(directory);
+}
+
+TEST(AsyncIO, DISABLED_Benchmark10kFiles)
+{
+	using namespace Gleam;
+	constexpr uint32_t FileCount = 10000;
+	auto directory = std::filesystem::temp_directory_path() / "GleamAsyncIOBenchmark";
+	AsyncIOTests::CreateFiles(directory, FileCount, 64 * 1024);
+
+	// the files were just written, both paths read them from the page cache
+	size_t streamBytes = 0;
+	auto start = AsyncIOTests::Clock::now();
+	for (const auto& request : AsyncIOTests::CreateRequests(directory, FileCount))
+	{
+		std::fstream stream(request.path, std::ios::in | std::ios::binary);
+		TString data(Filesystem::FileSize(request.path), '\0');
+		stream.read(data.data(), data.size());
+		streamBytes += static_cast<size_t>(stream.gcount());
+	}
+	double streamTime = AsyncIOTests::ElapsedMilliseconds(start);
+
+	std::atomic<size_t> asyncBytes = 0;
+	std::atomic<uint32_t> failed = 0;
+	AsyncIO io;
+	start = AsyncIOTests::Clock::now();
+	io.Read(AsyncIOTests::CreateRequests(directory, FileCount), [&](AsyncReadResult&& result)
+	{
+		asyncBytes += result.size;
+		failed += result.success ? 0 : 1;
+	});
+	io.Wait();
+	double asyncTime = AsyncIOTests::ElapsedMilliseconds(start);
+
+	std::cout << "10k files (" << streamBytes / (1024 * 1024) << " MB): fstream " << streamTime << " ms, "
+		<< (io.IsKernelBacked() ? "io_uring " : "thread pool ") << asyncTime << " ms at queue depth " << io.GetQueueDepth() << std::endl;
+
+	EXPECT_EQ(failed.load(), 0u);
+	EXPECT_EQ(asyncBytes.load(), streamBytes);
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "Renderer/ClusterCulling.h"
+#include "Renderer/OcclusionCulling.h"
+#include "Renderer/LodSelection.h"
+
+namespace CullingTests {
+
+// Flat meshlet through the origin, every triangle facing the same way
+static Gleam::MeshletDescriptor CreatePlanarMeshlet(const Gleam::Float3& normal, uint32_t firstIndex, uint32_t indexCount)
+{
+	Gleam::MeshletDescriptor meshlet;
+	meshlet.bounds = Gleam::BoundingSphere(Gleam::Float3::zero, 0.1f);
+	meshlet.coneAxis = Gleam::Math::Normalize(normal);
+	meshlet.coneCutoff = 0.0f;
+	meshlet.firstIndex = firstIndex;
+	meshlet.indexCount = indexCount;
+	return meshlet;
+}
+
+// Screen aligned quad over [minX, maxX] x [minY, maxY] in clip space at the given depth
+static Gleam::OccluderGeometry CreateQuadOccluder(float minX, float minY, float maxX, float maxY, float depth)
+{
+	Gleam::OccluderGeometry occluder;
+	occluder.positions = { { minX, minY, depth }, { maxX, minY, depth }, { maxX, maxY, depth }, { minX, maxY, depth } };
+	occluder.indices = { 0, 1, 2, 0, 2, 3 };
+	return occluder;
+}
+
+} // namespace CullingTests
+
+TEST(ClusterCulling, ConeCullsBackfacingMeshlets)
+{
+	using namespace Gleam;
+	Frustum frustum; // planes without normals reject nothing
+	auto meshlet = CullingTests::CreatePlanarMeshlet(Float3(0.0f, 1.0f, 0.0f), 0, 3);
+
+	EXPECT_TRUE(ClusterCulling::IsVisible(meshlet, Float4x4::identity, Float4x4::identity, frustum, Float3(0.0f, 10.0f, 0.0f)));
+	EXPECT_FALSE(ClusterCulling::IsVisible(meshlet, Float4x4::identity, Float4x4::identity, frustum, Float3(0.0f, -10.0f, 0.0f)));
+	EXPECT_TRUE(ClusterCulling::IsVisible(meshlet, Float4x4::identity, Float4x4::identity, frustum, Float3(0.0f, -10.0f, 0.0f), false));
+
+	// a cone as wide as a hemisphere can not be culled
+	meshlet.coneCutoff = 1.0f;
+	EXPECT_TRUE(ClusterCulling::IsVisible(meshlet, Float4x4::identity, Float4x4::identity, frustum, Float3(0.0f, -10.0f, 0.0f)));
+}
+
+TEST(ClusterCulling, ConeFollowsNonUniformScale)
+{
+	using namespace Gleam;
+	Frustum frustum;
+
+	// the plane x + y = 0 scaled by 4 along x becomes x / 4 + y = 0 with normal (1, 4, 0)
+	auto meshlet = CullingTests::CreatePlanarMeshlet(Float3(1.0f, 1.0f, 0.0f), 0, 3);
+	auto transform = Float4x4::Scale(Float3(4.0f, 1.0f, 1.0f));
+	auto inverseTransform = Math::Inverse(transform);
+
+	// behind the scaled plane, but in front of the plane with the axis scaled like a position
+	EXPECT_FALSE(ClusterCulling::IsVisible(meshlet, transform, inverseTransform, frustum, Float3(5.0f, -10.0f, 0.0f)));
+	EXPECT_TRUE(ClusterCulling::IsVisible(meshlet, transform, inverseTransform, frustum, Float3(-5.0f, 10.0f, 0.0f)));
+}
+
+TEST(ClusterCulling, MergesVisibleRanges)
+{
+	using namespace Gleam;
+	Frustum frustum;
+	constexpr uint32_t IndexCount = MeshletDescriptor::MaxTriangleCount * 3;
+
+	TArray<MeshletDescriptor> meshlets;
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		meshlets.push_back(CullingTests::CreatePlanarMeshlet(Float3(0.0f, 1.0f, 0.0f), i * IndexCount, IndexCount));
+	}
+	// a single culled meshlet is bridged, two in a row split the draw
+	meshlets[1].coneAxis = Float3(0.0f, -1.0f, 0.0f);
+	meshlets[3].coneAxis = Float3(0.0f, -1.0f, 0.0f);
+	meshlets[4].coneAxis = Float3(0.0f, -1.0f, 0.0f);
+
+	SubmeshDescriptor submesh;
+	submesh.indexCount = IndexCount * 6;
+	submesh.meshletCount = 6;
+
+	TArray<IndexRange> ranges;
+	ClusterCulling::Cull(meshlets, submesh, Float4x4::identity, frustum, Float3(0.0f, 10.0f, 0.0f), ranges);
+	ASSERT_EQ(ranges.size(), 2u);
+	EXPECT_EQ(ranges[0].firstIndex, 0u);
+	EXPECT_EQ(ranges[0].indexCount, IndexCount * 3);
+	EXPECT_EQ(ranges[1].firstIndex, IndexCount * 5);
+	EXPECT_EQ(ranges[1].indexCount, IndexCount);
+
+	ranges.clear();
+	ClusterCulling::Cull(meshlets, submesh, Float4x4::identity, frustum, Float3(0.0f, 10.0f, 0.0f), ranges, false);
+	ASSERT_EQ(ranges.size(), 1u);
+	EXPECT_EQ(ranges[0].indexCount, IndexCount * 6);
+}
+
+TEST(OcclusionCulling, BoxesBehindOccluderAreCulled)
+{
+	using namespace Gleam;
+	OcclusionCulling culling;
+
+	// identity view projection, positions are already in clip space
+	culling.Begin(Float4x4::identity);
+	culling.RenderOccluder(CullingTests::CreateQuadOccluder(-1.0f, -1.0f, 0.0f, 1.0f, 0.5f), Float4x4::identity);
+	culling.End();
+
+	EXPECT_FALSE(culling.IsVisible(BoundingBox(Float3(-0.8f, -0.5f, 0.6f), Float3(-0.2f, 0.5f, 0.9f)), Float4x4::identity));
+	EXPECT_TRUE(culling.IsVisible(BoundingBox(Float3(-0.8f, -0.5f, 0.1f), Float3(-0.2f, 0.5f, 0.4f)), Float4x4::identity));
+
+	// partially outside the occluder in x
+	EXPECT_TRUE(culling.IsVisible(BoundingBox(Float3(-0.5f, -0.5f, 0.6f), Float3(0.5f, 0.5f, 0.9f)), Float4x4::identity));
+
+	// the box transform moves it from behind the occluder into the uncovered half
+	EXPECT_TRUE(culling.IsVisible(BoundingBox(Float3(-0.8f, -0.5f, 0.6f), Float3(-0.2f, 0.5f, 0.9f)), Float4x4::Translate(Float3(1.0f, 0.0f, 0.0f))));
+
+	const auto& stats = culling.GetStatistics();
+	EXPECT_EQ(stats.occluderCount, 1u);
+	EXPECT_EQ(stats.occluderTriangleCount, 2u);
+	EXPECT_EQ(stats.testedCount, 4u);
+	EXPECT_EQ(stats.occludedCount, 1u);
+}
+
+TEST(OcclusionCulling, OccluderWindingAndDepthTest)
+{
+	using namespace Gleam;
+	OcclusionCulling culling;
+	culling.Begin(Float4x4::identity);
+
+	// clockwise in screen space, occluders are double sided
+	auto occluder = CullingTests::CreateQuadOccluder(-1.0f, -1.0f, 1.0f, 1.0f, 0.7f);
+	occluder.indices = { 0, 2, 1, 0, 3, 2 };
+	culling.RenderOccluder(occluder, Float4x4::identity);
+
+	// the nearest occluder wins
+	culling.RenderOccluder(CullingTests::CreateQuadOccluder(-1.0f, -1.0f, 1.0f, 1.0f, 0.3f), Float4x4::identity);
+	culling.End();
+
+	EXPECT_FALSE(culling.IsVisible(BoundingBox(Float3(-0.9f, -0.9f, 0.4f), Float3(0.9f, 0.9f, 0.6f)), Float4x4::identity));
+	EXPECT_TRUE(culling.IsVisible(BoundingBox(Float3(-0.9f, -0.9f, 0.2f), Float3(0.9f, 0.9f, 0.6f)), Float4x4::identity));
+
+	// a new frame starts with an empty depth buffer
+	culling.Begin(Float4x4::identity);
+	culling.End();
+	EXPECT_TRUE(culling.IsVisible(BoundingBox(Float3(-0.9f, -0.9f, 0.4f), Float3(0.9f, 0.9f, 0.6f)), Float4x4::identity));
+	EXPECT_EQ(culling.GetStatistics().testedCount, 1u);
+}
+
+TEST(OcclusionCulling, OccluderUsesCoarsestLod)
+{
+	using namespace Gleam;
+	MeshDescriptor mesh;
+	mesh.positions = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.5f, 0.5f, 0.0f } };
+
+	// full detail fan around the center vertex, followed by a two triangle LOD
+	mesh.SetIndices({ 0, 1, 4, 1, 2, 4, 2, 3, 4, 3, 0, 4, 0, 1, 2, 0, 2, 3 });
+	SubmeshDescriptor submesh;
+	submesh.indexCount = 12;
+	submesh.lodCount = 1;
+	mesh.submeshes.push_back(submesh);
+	mesh.lods.push_back({ .firstIndex = 12, .indexCount = 6 });
+
+	auto occluder = OccluderGeometry::Create(mesh, mesh.GetGeometry());
+	EXPECT_EQ(occluder.indices, TArray<uint32_t>({ 0, 1, 2, 0, 2, 3 }));
+	ASSERT_EQ(occluder.positions.size(), 4u);
+	EXPECT_EQ(occluder.positions[2], Float3(1.0f, 1.0f, 0.0f));
+}
+
+TEST(LodSelection, ScreenSizeMatchesAcrossProjections)
+{
+	using namespace Gleam;
+	BoundingSphere bounds(Float3(0.0f, 0.0f, 10.0f), 1.0f);
+
+	// the sphere covers the same part of the screen in both projections, the projection matrices agree
+	Camera perspective(800.0f, 600.0f, ProjectionType::Perspective);
+	Camera ortho(800.0f, 600.0f, ProjectionType::Ortho);
+	ortho.orthographicSize = 2.0f * 10.0f * Math::Tan(Math::Deg2Rad(perspective.fov) / 2.0f);
+
+	auto projectedHeight = [&](const Camera& camera)
+	{
+		auto top = camera.GetProjectionMatrix() * Float4(0.0f, 1.0f, 10.0f, 1.0f);
+		return top.y / top.w;
+	};
+	EXPECT_NEAR(projectedHeight(perspective), projectedHeight(ortho), 1e-4f);
+
+	float perspectiveSize = LodSelection::ScreenSize(bounds, perspective, Float3::zero);
+	float orthoSize = LodSelection::ScreenSize(bounds, ortho, Float3::zero);
+	EXPECT_NEAR(perspectiveSize, orthoSize, 1e-4f);
+
+	// the radius over the half height of clip space is the diameter over the full height
+	EXPECT_NEAR(perspectiveSize, projectedHeight(perspective), 1e-4f);
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <chrono>
+#include <thread>
+
+#include "IO/FileWatcher.h"
+
+// the platform watchers report moves differently, these follow the inotify watcher
+#ifdef PLATFORM_LINUX
+
+namespace FileWatcherTests {
+
+using Clock = std::chrono::steady_clock;
+
+// Collects the last event of every path, handlers run on the watch thread
+class EventRecorder
+{
+public:
+
+	Gleam::FileWatchHandler GetHandler()
+	{
+		return [this](const Gleam::Filesystem::Path& path, Gleam::FileWatchEvent event)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mEvents[path.lexically_normal()] = event;
+		};
+	}
+
+	// Events are debounced, so this waits until the path reports the event or the timeout passes
+	bool WaitFor(const Gleam::Filesystem::Path& path, Gleam::FileWatchEvent event)
+	{
+		auto deadline = Clock::now() + std::chrono::seconds(2);
+		while (Clock::now() < deadline)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				auto it = mEvents.find(path.lexically_normal());
+				if (it != mEvents.end() && it->second == event)
+				{
+					return true;
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return false;
+	}
+
+private:
+
+	std::mutex mMutex;
+
+	Gleam::HashMap<Gleam::Filesystem::Path, Gleam::FileWatchEvent> mEvents;
+
+};
+
+static Gleam::Filesystem::Path CreateEmptyDirectory(const Gleam::TString& name)
+{
+	auto dir = std::filesystem::temp_directory_path() / "GleamFileWatcherTests" / name;
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	return dir;
+}
+
+static void WriteFile(const Gleam::Filesystem::Path& path)
+{
+	std::ofstream stream(path);
+	stream << "FileWatcherTests";
+}
+
+} // namespace FileWatcherTests
+
+TEST(FileWatcher, MovesInsideTheTreeAreRenames)
+{
+	using namespace Gleam;
+	auto root = FileWatcherTests::CreateEmptyDirectory("Renames");
+	std::filesystem::create_directories(root / "Sub");
+	FileWatcherTests::WriteFile(root / "A.txt");
+
+	FileWatcherTests::EventRecorder recorder;
+	FileWatcher watcher;
+	watcher.AddWatch(root, recorder.GetHandler());
+
+	std::filesystem::rename(root / "A.txt", root / "Sub" / "B.txt");
+	EXPECT_TRUE(recorder.WaitFor(root / "A.txt", FileWatchEvent::Renamed));
+	EXPECT_TRUE(recorder.WaitFor(root / "Sub" / "B.txt", FileWatchEvent::Renamed));
+
+	// the move away has no pair, it is a removal once the pair interval passes
+	auto outside = FileWatcherTests::CreateEmptyDirectory("RenamesOutside");
+	std::filesystem::rename(root / "Sub" / "B.txt", outside / "B.txt");
+	EXPECT_TRUE(recorder.WaitFor(root / "Sub" / "B.txt", FileWatchEvent::Removed));
+
+	watcher.Shutdown();
+	std::filesystem::remove_all(root);
+	std::filesystem::remove_all(outside);
+}
+
+TEST(FileWatcher, NewDirectoriesReportTheirContents)
+{
+	using namespace Gleam;
+	auto root = FileWatcherTests::CreateEmptyDirectory("NewDirectories");
+
+	// populated before it enters the tree, no event inside it is ever seen by a watch
+	auto outside = FileWatcherTests::CreateEmptyDirectory("NewDirectoriesOutside");
+	std::filesystem::create_directories(outside / "Moved" / "Nested");
+	FileWatcherTests::WriteFile(outside / "Moved" / "A.txt");
+	FileWatcherTests::WriteFile(outside / "Moved" / "Nested" / "B.txt");
+
+	FileWatcherTests::EventRecorder recorder;
+	FileWatcher watcher;
+	watcher.AddWatch(root, recorder.GetHandler());
+
+	std::filesystem::rename(outside / "Moved", root / "Moved");
+	EXPECT_TRUE(recorder.WaitFor(root / "Moved", FileWatchEvent::Added));
+	EXPECT_TRUE(recorder.WaitFor(root / "Moved" / "A.txt", FileWatchEvent::Added));
+	EXPECT_TRUE(recorder.WaitFor(root / "Moved" / "Nested" / "B.txt", FileWatchEvent::Added));
+
+	// files written right after the directory is created may land before its watch does
+	std::filesystem::create_directories(root / "Created" / "Nested");
+	FileWatcherTests::WriteFile(root / "Created" / "Nested" / "C.txt");
+	EXPECT_TRUE(recorder.WaitFor(root / "Created" / "Nested" / "C.txt", FileWatchEvent::Added));
+
+	// the new directories are watched as well
+	FileWatcherTests::WriteFile(root / "Moved" / "Nested" / "D.txt");
+	EXPECT_TRUE(recorder.WaitFor(root / "Moved" / "Nested" / "D.txt", FileWatchEvent::Added));
+
+	watcher.Shutdown();
+	std::filesystem::remove_all(root);
+	std::filesystem::remove_all(outside);
+}
+
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+#include <random>
+#include <chrono>
+#include <thread>
+
+namespace FilesystemTests {
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static Gleam::Filesystem::Path AccessorPath(uint32_t index)
+{
+	return std::filesystem::temp_directory_path() / "GleamAccessorTests" / (std::to_string(index) + ".asset");
+}
+
+} // namespace FilesystemTests
+
+TEST(FileAccessor, ReadersShareTheFile)
+{
+	using namespace Gleam;
+	auto path = FilesystemTests::AccessorPath(0);
+
+	// every reader waits inside its accessor for the others, exclusive reads would never get there
+	constexpr uint32_t ReaderCount = 4;
+	std::atomic<uint32_t> inside = 0;
+	std::atomic<uint32_t> met = 0;
+	TArray<std::thread> readers;
+	for (uint32_t i = 0; i < ReaderCount; i++)
+	{
+		readers.emplace_back([&]()
+		{
+			auto accessor = Filesystem::ReadAccessor(path);
+			inside++;
+			auto deadline = FilesystemTests::Clock::now() + std::chrono::seconds(2);
+			while (inside < ReaderCount && FilesystemTests::Clock::now() < deadline)
+			{
+				std::this_thread::yield();
+			}
+			met += inside == ReaderCount;
+		});
+	}
+
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+	EXPECT_EQ(met.load(), ReaderCount);
+}
+
+TEST(FileAccessor, ContentionStress)
+{
+	using namespace Gleam;
+	constexpr uint32_t ThreadCount = 8;
+	constexpr uint32_t PathCount = 256;
+	constexpr uint32_t IterationCount = 50000;
+
+	TArray<Filesystem::Path> paths(PathCount);
+	for (uint32_t i = 0; i < PathCount; i++)
+	{
+		paths[i] = FilesystemTests::AccessorPath(i);
+	}
+
+	// writers of a file must find it empty, readers must never find a writer
+	TArray<std::atomic<int32_t>> readers(PathCount);
+	TArray<std::atomic<int32_t>> writers(PathCount);
+	std::atomic<uint32_t> violations = 0;
+
+	auto start = FilesystemTests::Clock::now();
+	TArray<std::thread> threads;
+	for (uint32_t t = 0; t < ThreadCount; t++)
+	{
+		threads.emplace_back([&, t]()
+		{
+			std::mt19937 rng(t);
+			for (uint32_t i = 0; i < IterationCount; i++)
+			{
+				// a few hot files take most of the traffic, as a burst of loads of shared textures would
+				uint32_t index = rng() % 4 == 0 ? rng() % PathCount : rng() % 4;
+				if (rng() % 16 == 0)
+				{
+					auto accessor = Filesystem::WriteAccessor(paths[index]);
+					violations += ++writers[index] != 1 || readers[index] != 0;
+					std::this_thread::yield();
+					--writers[index];
+				}
+				else
+				{
+					auto accessor = Filesystem::ReadAccessor(paths[index]);
+					++readers[index];
+					violations += writers[index] != 0;
+					--readers[index];
+				}
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::cout << "FileAccessor stress: " << ThreadCount * IterationCount << " accesses over " << ThreadCount << " threads in "
+		<< FilesystemTests::ElapsedMilliseconds(start) << " ms" << std::endl;
+
+	EXPECT_EQ(violations.load(), 0u);
+}
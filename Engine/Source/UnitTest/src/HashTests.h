@@ -0,0 +1,30 @@
+#pragma once
+#include "Container/Hash.h"
+
+TEST(Hash64, MatchesReferenceVectors)
+{
+	using namespace Gleam;
+	EXPECT_EQ(Hash64("", 0), 0xef46db3751d8e999ull);
+	EXPECT_EQ(Hash64("a", 1), 0xd24ec4f1a98c6e5bull);
+	EXPECT_EQ(Hash64("abc", 3), 0x44bc2cf5ad770999ull);
+}
+
+TEST(Hash64, CoversEveryByte)
+{
+	using namespace Gleam;
+	// long enough to take the 32 byte stripe loop and every tail path
+	TArray<uint8_t> data(103);
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		data[i] = static_cast<uint8_t>(i * 31);
+	}
+
+	const uint64_t reference = Hash64(data.data(), data.size());
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		data[i] ^= 1;
+		EXPECT_NE(Hash64(data.data(), data.size()), reference) << "byte " << i;
+		data[i] ^= 1;
+	}
+	EXPECT_NE(Hash64(data.data(), data.size(), 1), reference);
+}
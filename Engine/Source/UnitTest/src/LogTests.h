@@ -0,0 +1,91 @@
+#pragma once
+#include <chrono>
+#include <thread>
+
+namespace LogTests {
+
+using Clock = std::chrono::steady_clock;
+
+static Gleam::TArray<Gleam::TString> ReadLines(const Gleam::TString& marker)
+{
+	Gleam::TArray<Gleam::TString> lines;
+	std::ifstream stream("Gleam.log");
+	for (Gleam::TString line; std::getline(stream, line);)
+	{
+		if (line.find(marker) != Gleam::TString::npos)
+		{
+			lines.push_back(line);
+		}
+	}
+	return lines;
+}
+
+} // namespace LogTests
+
+TEST(Logger, ConcurrentRecordsAreWrittenInOrder)
+{
+	using namespace Gleam;
+	constexpr uint32_t ThreadCount = 4;
+	constexpr uint32_t MessageCount = 20000; // several times the ring, producers have to wait for the writer
+
+	TArray<std::thread> threads;
+	for (uint32_t t = 0; t < ThreadCount; t++)
+	{
+		threads.emplace_back([t]()
+		{
+			for (uint32_t i = 0; i < MessageCount; i++)
+			{
+				GLEAM_CORE_INFO("LogTests.Concurrent {0} {1}", t, i);
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	Logger::Flush();
+
+	// each thread's records keep their order, whatever the interleaving
+	TArray<uint32_t> next(ThreadCount, 0);
+	uint32_t outOfOrder = 0;
+	auto lines = LogTests::ReadLines("LogTests.Concurrent");
+	for (const auto& line : lines)
+	{
+		uint32_t t = 0, i = 0;
+		std::istringstream(line.substr(line.find("LogTests.Concurrent") + 20)) >> t >> i;
+		outOfOrder += t >= ThreadCount || next[t] != i;
+		next[t] = i + 1;
+	}
+	EXPECT_EQ(lines.size(), ThreadCount * MessageCount);
+	EXPECT_EQ(outOfOrder, 0u);
+}
+
+TEST(Logger, TruncatesLongMessages)
+{
+	using namespace Gleam;
+	GLEAM_CORE_WARN("LogTests.Truncated {0}", TString(4 * LogRecord::MaxLength, 'x'));
+	Logger::Flush();
+
+	auto lines = LogTests::ReadLines("LogTests.Truncated");
+	ASSERT_EQ(lines.size(), 1u);
+	EXPECT_LT(lines[0].size(), 2 * LogRecord::MaxLength);
+}
+
+TEST(Logger, DISABLED_BenchmarkLogCall)
+{
+	using namespace Gleam;
+	constexpr uint32_t MessageCount = 2000; // fits in the ring, so the writer never holds a call back
+
+	Logger::Flush();
+	auto start = LogTests::Clock::now();
+	for (uint32_t i = 0; i < MessageCount; i++)
+	{
+		GLEAM_CORE_INFO("LogTests.Benchmark {0} of {1}: {2}", i, MessageCount, 0.5f * i);
+	}
+	auto elapsed = std::chrono::duration<double, std::nano>(LogTests::Clock::now() - start).count();
+	Logger::Flush();
+
+	std::cout << "Log call: " << elapsed / MessageCount << " ns" << std::endl;
+	EXPECT_EQ(LogTests::ReadLines("LogTests.Benchmark").size(), MessageCount);
+}
@@ -2,6 +2,18 @@
 
 #include "Gleam.h"
 #include "MathTests.h"
+#include "SpatialTests.h"
+#include "HashTests.h"
+#include "AsyncIOTests.h"
+#include "FilesystemTests.h"
+#include "FileWatcherTests.h"
+#include "PakTests.h"
+#include "LogTests.h"
+#include "ProfilerTests.h"
+#include "SerializationTests.h"
+#include "MeshOptimizerTests.h"
+#include "TextureCompressorTests.h"
+#include "CullingTests.h"
 
 int main(int argc, char* argv[])
 {
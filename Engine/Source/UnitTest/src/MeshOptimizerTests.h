@@ -0,0 +1,241 @@
+#pragma once
+#include <random>
+
+#include "EAssets/MeshOptimizer.h"
+
+namespace MeshOptimizerTests {
+
+// Unwelded grid of quads in the XY plane, every triangle has its own three vertices
+static GEditor::RawMesh CreateGrid(uint32_t size, bool shuffle)
+{
+	GEditor::RawMesh mesh;
+	mesh.name = "Grid";
+
+	Gleam::TArray<Gleam::TArray<Gleam::Float3, 3>> triangles;
+	for (uint32_t y = 0; y < size; y++)
+	{
+		for (uint32_t x = 0; x < size; x++)
+		{
+			Gleam::Float3 p00(float(x), float(y), 0.0f), p10(float(x + 1), float(y), 0.0f);
+			Gleam::Float3 p01(float(x), float(y + 1), 0.0f), p11(float(x + 1), float(y + 1), 0.0f);
+			triangles.push_back({ p00, p10, p11 });
+			triangles.push_back({ p00, p11, p01 });
+		}
+	}
+
+	if (shuffle)
+	{
+		std::mt19937 rng(7);
+		std::shuffle(triangles.begin(), triangles.end(), rng);
+	}
+
+	for (const auto& triangle : triangles)
+	{
+		for (const auto& position : triangle)
+		{
+			mesh.indices.push_back(static_cast<uint32_t>(mesh.positions.size()));
+			mesh.positions.push_back(position);
+			mesh.normals.push_back(Gleam::Float3(0.0f, 0.0f, 1.0f));
+			mesh.texCoords.push_back(Gleam::Float2(position.x, position.y));
+		}
+	}
+	return mesh;
+}
+
+// Triangles as sorted position triples, so that meshes can be compared regardless of vertex and triangle order
+static Gleam::TArray<Gleam::TArray<float, 9>> SortedTriangles(const GEditor::RawMesh& mesh)
+{
+	Gleam::TArray<Gleam::TArray<float, 9>> triangles;
+	for (size_t i = 0; i < mesh.indices.size(); i += 3)
+	{
+		Gleam::TArray<Gleam::TArray<float, 3>, 3> corners;
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			const auto& p = mesh.positions[mesh.indices[i + c]];
+			corners[c] = { p.x, p.y, p.z };
+		}
+		std::sort(corners.begin(), corners.end());
+
+		Gleam::TArray<float, 9> triangle;
+		for (uint32_t c = 0; c < 9; c++)
+		{
+			triangle[c] = corners[c / 3][c % 3];
+		}
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+// Welded grid in the XY plane with z = height(x, y) as a single submesh
+template<typename HeightFn>
+static Gleam::MeshDescriptor CreateGridDescriptor(uint32_t size, HeightFn&& height)
+{
+	Gleam::MeshDescriptor mesh;
+	for (uint32_t y = 0; y <= size; y++)
+	{
+		for (uint32_t x = 0; x <= size; x++)
+		{
+			mesh.positions.push_back(Gleam::Float3(float(x), float(y), height(float(x), float(y))));
+			mesh.interleavedVertices.push_back({ Gleam::Float3(0.0f, 0.0f, 1.0f), Gleam::Float2(float(x), float(y)) });
+		}
+	}
+
+	Gleam::TArray<uint32_t> indices;
+	for (uint32_t y = 0; y < size; y++)
+	{
+		for (uint32_t x = 0; x < size; x++)
+		{
+			uint32_t v00 = y * (size + 1) + x, v10 = v00 + 1;
+			uint32_t v01 = v00 + size + 1, v11 = v01 + 1;
+			indices.insert(indices.end(), { v00, v10, v11, v00, v11, v01 });
+		}
+	}
+	mesh.SetIndices(indices);
+
+	Gleam::SubmeshDescriptor submesh;
+	submesh.indexCount = static_cast<uint32_t>(indices.size());
+	submesh.bounds = Gleam::BoundingBox(Gleam::Math::Infinity, Gleam::Math::NegativeInfinity);
+	for (const auto& position : mesh.positions)
+	{
+		submesh.bounds.min = Gleam::Math::Min(submesh.bounds.min, position);
+		submesh.bounds.max = Gleam::Math::Max(submesh.bounds.max, position);
+	}
+	mesh.submeshes.push_back(submesh);
+	return mesh;
+}
+
+} // namespace MeshOptimizerTests
+
+TEST(MeshOptimizer, WeldMergesIdenticalVertices)
+{
+	constexpr uint32_t Size = 8;
+	auto mesh = MeshOptimizerTests::CreateGrid(Size, false);
+	GEditor::MeshOptimizer::WeldVertices(mesh);
+
+	EXPECT_EQ(mesh.positions.size(), (Size + 1) * (Size + 1));
+	EXPECT_EQ(mesh.indices.size(), Size * Size * 6);
+}
+
+TEST(MeshOptimizer, OptimizeImprovesACMR)
+{
+	auto mesh = MeshOptimizerTests::CreateGrid(32, true);
+	auto triangles = MeshOptimizerTests::SortedTriangles(mesh);
+
+	// the unwelded source misses on every vertex, so weld first to measure the triangle order alone
+	auto shuffled = mesh;
+	GEditor::MeshOptimizer::WeldVertices(shuffled);
+	auto before = GEditor::MeshOptimizer::AnalyzeVertexCache(shuffled.indices, static_cast<uint32_t>(shuffled.positions.size()));
+
+	GEditor::MeshOptimizer::Optimize(mesh);
+	auto after = GEditor::MeshOptimizer::AnalyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.positions.size()));
+
+	// a shuffled grid transforms most vertices of every triangle again, a cache ordered one about one per triangle
+	EXPECT_GT(before.acmr, 1.5f);
+	EXPECT_LT(after.acmr, 1.0f);
+	EXPECT_LT(after.atvr, 1.5f);
+	EXPECT_EQ(MeshOptimizerTests::SortedTriangles(mesh), triangles);
+}
+
+TEST(MeshOptimizer, SimplifyFlatGridWithoutError)
+{
+	constexpr uint32_t Size = 16;
+	auto mesh = MeshOptimizerTests::CreateGridDescriptor(Size, [](float, float) { return 0.0f; });
+
+	float error = -1.0f;
+	auto simplified = GEditor::MeshOptimizer::Simplify(mesh.GetIndices(), mesh.positions, mesh.interleavedVertices, Size * Size * 6 / 4, &error);
+	EXPECT_LE(simplified.size(), Size * Size * 6 / 2);
+	EXPECT_NEAR(error, 0.0f, 1e-3f);
+
+	// border vertices are locked, the outline of the grid survives
+	Gleam::HashSet<uint32_t> referenced(simplified.begin(), simplified.end());
+	for (uint32_t i = 0; i <= Size; i++)
+	{
+		EXPECT_TRUE(referenced.contains(i));
+		EXPECT_TRUE(referenced.contains(Size * (Size + 1) + i));
+	}
+}
+
+TEST(MeshOptimizer, SimplifyLocksOnlyAttributeSeams)
+{
+	constexpr uint32_t Size = 16;
+	constexpr uint32_t SeamX = Size / 2;
+
+	// split the grid along x = SeamX, the right half gets its own copies of the seam vertices
+	auto splitGrid = [&](bool sameAttributes)
+	{
+		auto mesh = MeshOptimizerTests::CreateGridDescriptor(Size, [](float, float) { return 0.0f; });
+		Gleam::HashMap<uint32_t, uint32_t> copies;
+		for (uint32_t y = 0; y <= Size; y++)
+		{
+			uint32_t v = y * (Size + 1) + SeamX;
+			copies[v] = static_cast<uint32_t>(mesh.positions.size());
+			mesh.positions.push_back(mesh.positions[v]);
+			mesh.interleavedVertices.push_back(mesh.interleavedVertices[v]);
+			if (!sameAttributes)
+			{
+				mesh.interleavedVertices.back().texCoord.x += 1.0f;
+			}
+		}
+
+		auto indices = mesh.GetIndices();
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			bool right = mesh.positions[indices[i]].x + mesh.positions[indices[i + 1]].x + mesh.positions[indices[i + 2]].x > SeamX * 3.0f;
+			for (uint32_t k = 0; right && k < 3; k++)
+			{
+				if (auto it = copies.find(indices[i + k]); it != copies.end())
+				{
+					indices[i + k] = it->second;
+				}
+			}
+		}
+		mesh.SetIndices(indices);
+		return mesh;
+	};
+
+	auto interiorSeamPositions = [&](const Gleam::MeshDescriptor& mesh, const Gleam::TArray<uint32_t>& indices)
+	{
+		Gleam::HashSet<uint32_t> rows;
+		for (uint32_t index : indices)
+		{
+			const auto& position = mesh.positions[index];
+			if (position.x == float(SeamX) && position.y > 0.0f && position.y < float(Size))
+			{
+				rows.insert(static_cast<uint32_t>(position.y));
+			}
+		}
+		return rows.size();
+	};
+
+	auto seam = splitGrid(false);
+	auto simplified = GEditor::MeshOptimizer::Simplify(seam.GetIndices(), seam.positions, seam.interleavedVertices, 6);
+	EXPECT_EQ(interiorSeamPositions(seam, simplified), Size - 1);
+
+	// identical copies are no seam, they collapse like the rest of the grid
+	auto duplicates = splitGrid(true);
+	simplified = GEditor::MeshOptimizer::Simplify(duplicates.GetIndices(), duplicates.positions, duplicates.interleavedVertices, 6);
+	EXPECT_LT(interiorSeamPositions(duplicates, simplified), Size - 1);
+}
+
+TEST(MeshOptimizer, LodScreenSizesFollowError)
+{
+	constexpr uint32_t Size = 32;
+	auto flat = MeshOptimizerTests::CreateGridDescriptor(Size, [](float, float) { return 0.0f; });
+	GEditor::MeshOptimizer::GenerateLods(flat, 3);
+	ASSERT_GT(flat.lods.size(), 0u);
+	for (const auto& lod : flat.lods)
+	{
+		EXPECT_EQ(lod.screenSize, 1.0f);
+	}
+
+	auto bumpy = MeshOptimizerTests::CreateGridDescriptor(Size, [](float x, float y) { return Gleam::Math::Sin(x * 0.7f) * Gleam::Math::Cos(y * 0.4f); });
+	GEditor::MeshOptimizer::GenerateLods(bumpy, 3);
+	ASSERT_GT(bumpy.lods.size(), 1u);
+	EXPECT_LT(bumpy.lods[0].screenSize, 1.0f);
+	for (size_t i = 1; i < bumpy.lods.size(); i++)
+	{
+		EXPECT_LT(bumpy.lods[i].indexCount, bumpy.lods[i - 1].indexCount);
+		EXPECT_LE(bumpy.lods[i].screenSize, bumpy.lods[i - 1].screenSize);
+	}
+}
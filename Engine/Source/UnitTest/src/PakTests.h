@@ -0,0 +1,186 @@
+#pragma once
+#include <random>
+#include <chrono>
+
+#include "IO/Compression.h"
+#include "IO/PakArchive.h"
+
+namespace PakTests {
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Words drawn from a small vocabulary compress about as well as baked JSON does
+static Gleam::TArray<uint8_t> CreateText(size_t size, uint32_t seed)
+{
+	static const char* words[] = { "\"position\": ", "\"normal\": ", "[0.0, 1.0, 0.5], ", "\"guid\": ", "{ ", " }\n", "\"name\": \"Mesh\", " };
+	std::mt19937 rng(seed);
+	Gleam::TArray<uint8_t> text;
+	while (text.size() < size)
+	{
+		const char* word = words[rng() % std::size(words)];
+		text.insert(text.end(), word, word + strlen(word));
+	}
+	text.resize(size);
+	return text;
+}
+
+static Gleam::TArray<uint8_t> CreateNoise(size_t size, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	Gleam::TArray<uint8_t> noise(size);
+	for (auto& byte : noise)
+	{
+		byte = static_cast<uint8_t>(rng());
+	}
+	return noise;
+}
+
+static void WriteFile(const Gleam::Filesystem::Path& path, const Gleam::TArray<uint8_t>& contents)
+{
+	std::filesystem::create_directories(path.parent_path());
+	std::ofstream stream(path, std::ios::binary);
+	stream.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+}
+
+static bool Matches(const Gleam::MappedFile& file, const Gleam::TArray<uint8_t>& contents)
+{
+	return file.GetSize() == contents.size() && std::equal(contents.begin(), contents.end(), file.GetData());
+}
+
+} // namespace PakTests
+
+TEST(LZ4, RoundTrip)
+{
+	using namespace Gleam;
+	for (size_t size : { 0, 1, 12, 13, 100, 4096, 65536 })
+	{
+		for (const auto& input : { PakTests::CreateText(size, 1), PakTests::CreateNoise(size, 2), TArray<uint8_t>(size, 7) })
+		{
+			TArray<uint8_t> compressed(LZ4::CompressBound(size));
+			size_t compressedSize = LZ4::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+			ASSERT_GT(compressedSize, 0u) << "size " << size;
+
+			TArray<uint8_t> output(size);
+			ASSERT_TRUE(LZ4::Decompress(compressed.data(), compressedSize, output.data(), output.size())) << "size " << size;
+			EXPECT_EQ(output, input) << "size " << size;
+		}
+	}
+}
+
+TEST(LZ4, RejectsMalformedInput)
+{
+	using namespace Gleam;
+	auto input = PakTests::CreateText(65536, 3);
+	TArray<uint8_t> compressed(LZ4::CompressBound(input.size()));
+	size_t compressedSize = LZ4::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+	ASSERT_LT(compressedSize, input.size() / 2);
+
+	TArray<uint8_t> output(input.size());
+	EXPECT_FALSE(LZ4::Decompress(compressed.data(), compressedSize / 2, output.data(), output.size()));
+	EXPECT_FALSE(LZ4::Decompress(compressed.data(), compressedSize, output.data(), output.size() - 1));
+
+	// offsets pointing before the start of the output
+	std::mt19937 rng(4);
+	for (uint32_t i = 0; i < 1000; i++)
+	{
+		auto corrupted = TArray<uint8_t>(compressed.begin(), compressed.begin() + compressedSize);
+		corrupted[rng() % corrupted.size()] = static_cast<uint8_t>(rng());
+		LZ4::Decompress(corrupted.data(), corrupted.size(), output.data(), output.size());
+	}
+}
+
+TEST(PakArchive, MountedFilesMatchTheirSources)
+{
+	using namespace Gleam;
+	auto directory = std::filesystem::temp_directory_path() / "GleamPakTests";
+	auto content = directory / "Content";
+	auto mountPoint = directory / "Mounted";
+	std::filesystem::remove_all(directory);
+
+	// an asset with its sidecar, one spanning many blocks, incompressible data and files not named by a guid
+	auto guid = TString("5F2B8C14-7A3E-4D91-B6E0-9C4D1F8A2E73");
+	HashMap<Filesystem::Path, TArray<uint8_t>> files = {
+		{ guid + ".asset", PakTests::CreateText(3000, 5) },
+		{ guid + ".bin", PakTests::CreateText(4 * 1024 * 1024 + 17, 6) },
+		{ "Textures/9B4E2F61-3C8A-4D17-A5E9-6F0D8C2B7A34.bin", PakTests::CreateNoise(300 * 1024, 7) },
+		{ "Textures/Empty.asset", TArray<uint8_t>() },
+		{ "Assets.index", PakTests::CreateText(100, 8) }
+	};
+
+	PakWriter writer;
+	for (const auto& [path, contents] : files)
+	{
+		PakTests::WriteFile(content / path, contents);
+		writer.Add(content / path, path);
+	}
+
+	ThreadPool threads;
+	auto archivePath = directory / "Content_0.pak";
+	ASSERT_TRUE(writer.Write(archivePath, threads));
+
+	PakArchive archive(archivePath);
+	ASSERT_TRUE(archive.IsValid());
+	ASSERT_EQ(archive.GetEntryCount(), files.size());
+	for (const auto& [path, contents] : files)
+	{
+		const auto* entry = archive.Find(path);
+		ASSERT_NE(entry, nullptr) << path;
+		EXPECT_EQ(entry->offset % PakArchive::Alignment, 0u) << path;
+		EXPECT_TRUE(PakTests::Matches(archive.Map(*entry), contents)) << path;
+	}
+	EXPECT_EQ(archive.Find(Guid(guid), Asset::sidecarExtension()), archive.Find(guid + ".bin"));
+	EXPECT_EQ(archive.Find("Textures/Missing.asset"), nullptr);
+
+	// the entries mapped above are cached, a second archive decodes from scratch
+	PakArchive timed(archivePath);
+	auto start = PakTests::Clock::now();
+	auto decoded = timed.Map(*timed.Find(guid + ".bin"));
+	std::cout << "Pak: " << writer.GetSize() / 1024 << " KB packed into " << Filesystem::FileSize(archivePath) / 1024
+		<< " KB, 4 MB entry decoded in " << PakTests::ElapsedMilliseconds(start) << " ms" << std::endl;
+
+	// a decoded entry is shared with later maps instead of being decoded again
+	EXPECT_EQ(timed.Map(*timed.Find(guid + ".bin")).GetData(), decoded.GetData());
+
+	ASSERT_NE(archive.FindDirectory("Textures"), nullptr);
+	EXPECT_EQ(archive.FindDirectory("Textures")->files.size(), 2u);
+	EXPECT_EQ(archive.FindDirectory(".")->directories, TArray<TString>({ "Textures" }));
+	EXPECT_EQ(archive.FindDirectory("Meshes"), nullptr);
+
+	// the mount point does not exist on disk, everything under it comes from the archive
+	ASSERT_TRUE(Filesystem::Mount(archivePath, mountPoint));
+	EXPECT_TRUE(Filesystem::Exists(mountPoint / (guid + ".asset")));
+	EXPECT_TRUE(Filesystem::IsDirectory(mountPoint / "Textures"));
+	EXPECT_EQ(Filesystem::FileSize(mountPoint / "Assets.index"), files["Assets.index"].size());
+	EXPECT_EQ(Filesystem::LastWriteTime(mountPoint / "Assets.index"), Filesystem::LastWriteTime(content / "Assets.index"));
+	EXPECT_TRUE(PakTests::Matches(Filesystem::Map(mountPoint / (guid + ".bin")), files[guid + ".bin"]));
+	auto noise = Filesystem::Map(mountPoint / "Textures/9B4E2F61-3C8A-4D17-A5E9-6F0D8C2B7A34.bin");
+
+	uint32_t visited = 0;
+	Filesystem::ForEach(mountPoint, [&](const Filesystem::Path& path)
+	{
+		visited++;
+		EXPECT_NE(files.find(Filesystem::Relative(path, mountPoint)), files.end()) << path;
+	}, true);
+	EXPECT_EQ(visited, files.size());
+
+	// without recursion a directory is visited in place of its files
+	visited = 0;
+	Filesystem::ForEach(mountPoint, [&](const Filesystem::Path& path)
+	{
+		visited++;
+	}, false);
+	EXPECT_EQ(visited, 4u);
+	EXPECT_FALSE(Filesystem::IsDirectory(mountPoint / "Meshes"));
+
+	Filesystem::Unmount(archivePath);
+	EXPECT_FALSE(Filesystem::Exists(mountPoint / (guid + ".asset")));
+
+	// views handed out before the unmount keep the archive mapped
+	EXPECT_TRUE(PakTests::Matches(noise, files["Textures/9B4E2F61-3C8A-4D17-A5E9-6F0D8C2B7A34.bin"]));
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <chrono>
+#include <thread>
+
+namespace ProfilerTests {
+
+using Clock = std::chrono::steady_clock;
+
+static uint32_t CountOccurrences(const Gleam::TString& text, const Gleam::TString& pattern)
+{
+	uint32_t count = 0;
+	for (size_t pos = text.find(pattern); pos != Gleam::TString::npos; pos = text.find(pattern, pos + pattern.size()))
+	{
+		count++;
+	}
+	return count;
+}
+
+static Gleam::TString ReadFile(const Gleam::Filesystem::Path& path)
+{
+	std::ifstream stream(path);
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+	return buffer.str();
+}
+
+} // namespace ProfilerTests
+
+TEST(Profiler, CapturesRequestedFrames)
+{
+	using namespace Gleam;
+	constexpr uint32_t CaptureFrames = 3;
+	auto path = Filesystem::Path("ProfilerTests.trace.json");
+	Filesystem::Remove(path);
+
+	GLEAM_PROFILE_SCOPE("ProfilerTests.BeforeCapture");
+	Profiler::Capture(CaptureFrames, path);
+	Profiler::EndFrame();
+	EXPECT_TRUE(Profiler::IsCapturing());
+
+	// the frame that ends the capture writes it, the ones after it are not recorded
+	for (uint32_t frame = 0; frame < CaptureFrames + 2; frame++)
+	{
+		{
+			GLEAM_PROFILE_SCOPE("ProfilerTests.Frame");
+			std::thread worker([]()
+			{
+				Profiler::SetThreadName("ProfilerTests \"Worker\"");
+				GLEAM_PROFILE_SCOPE(TString("ProfilerTests.") + "Task");
+			});
+			worker.join();
+		}
+		Profiler::EndFrame();
+	}
+	EXPECT_FALSE(Profiler::IsCapturing());
+
+	auto trace = ProfilerTests::ReadFile(path);
+	EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+	EXPECT_EQ(ProfilerTests::CountOccurrences(trace, "\"name\":\"ProfilerTests.Frame\""), CaptureFrames);
+	EXPECT_EQ(ProfilerTests::CountOccurrences(trace, "\"name\":\"ProfilerTests.Task\""), CaptureFrames);
+	EXPECT_EQ(ProfilerTests::CountOccurrences(trace, "ProfilerTests \\\"Worker\\\""), CaptureFrames);
+	EXPECT_EQ(ProfilerTests::CountOccurrences(trace, "ProfilerTests.BeforeCapture"), 0u);
+	Filesystem::Remove(path);
+}
+
+TEST(Profiler, DISABLED_BenchmarkScope)
+{
+	using namespace Gleam;
+	constexpr uint32_t ScopeCount = 100000;
+	auto path = Filesystem::Path("ProfilerTests.Benchmark.trace.json");
+
+	auto measure = [&]()
+	{
+		auto start = ProfilerTests::Clock::now();
+		for (uint32_t i = 0; i < ScopeCount; i++)
+		{
+			GLEAM_PROFILE_SCOPE("ProfilerTests.Benchmark");
+		}
+		return std::chrono::duration<double, std::nano>(ProfilerTests::Clock::now() - start).count() / ScopeCount;
+	};
+
+	auto idle = measure();
+	Profiler::Capture(1, path);
+	Profiler::EndFrame();
+	auto capturing = measure();
+	Profiler::EndFrame();
+
+	std::cout << "Profile scope: " << idle << " ns idle, " << capturing << " ns capturing" << std::endl;
+	EXPECT_EQ(ProfilerTests::CountOccurrences(ProfilerTests::ReadFile(path), "\"name\":\"ProfilerTests.Benchmark\""), ScopeCount);
+	Filesystem::Remove(path);
+}
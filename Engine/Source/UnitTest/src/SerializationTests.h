@@ -0,0 +1,417 @@
+#pragma once
+#include <chrono>
+
+namespace SerializationTests {
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static Gleam::Filesystem::Path WriteText(const Gleam::TString& filename, const Gleam::TString& text)
+{
+	auto path = std::filesystem::temp_directory_path() / filename;
+	std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+	return path;
+}
+
+template<typename T>
+static T ReadJSON(const Gleam::Filesystem::Path& path)
+{
+	Gleam::FileStream stream(path, std::ios::in);
+	return Gleam::JSONSerializer(stream).DeserializeStreaming<T>();
+}
+
+template<typename T>
+static void WriteJSON(const Gleam::Filesystem::Path& path, const T& object)
+{
+	Gleam::FileStream stream(path, std::ios::out | std::ios::trunc);
+	Gleam::JSONSerializer(stream).SerializeStreaming(object);
+}
+
+// Mesh asset as written before indexType existed, indices are 32-bit values without a version
+static constexpr const char* LegacyMeshDescriptor = R"({
+	"Kind": "Class",
+	"TypeGuid": "59E4007E-F7D4-4107-A05F-E1121067DCD3",
+	"TypeName": "Gleam::MeshDescriptor",
+	"Fields": [
+		{ "Kind": "Class", "TypeName": "std::string", "FieldName": "name", "Value": "Legacy" },
+		{ "Kind": "Primitive", "TypeName": "std::vector<uint32_t>", "FieldName": "indices", "Elements": [0, 1, 2, 2, 1, 300, 70000, 1, 2] },
+		{ "Kind": "Class", "TypeName": "std::vector<Gleam::Float3>", "FieldName": "positions", "Elements": [[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0]] }
+	]
+})";
+
+// Same asset with a number where the name string belongs and a string among the indices
+static constexpr const char* MismatchedMeshDescriptor = R"({
+	"Kind": "Class",
+	"TypeGuid": "59E4007E-F7D4-4107-A05F-E1121067DCD3",
+	"TypeName": "Gleam::MeshDescriptor",
+	"Fields": [
+		{ "Kind": "Class", "TypeName": "std::string", "FieldName": "name", "Value": 42 },
+		{ "Kind": "Primitive", "TypeName": "std::vector<uint32_t>", "FieldName": "indices", "Elements": [0, "1", 2] },
+		{ "Kind": "Class", "TypeName": "std::vector<Gleam::Float3>", "FieldName": "positions", "Elements": [[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 1.0, 0.0]] }
+	]
+})";
+
+// Grid of size * size quads with 32-bit indices
+static Gleam::MeshDescriptor CreateLargeMesh(uint32_t size)
+{
+	Gleam::MeshDescriptor mesh;
+	mesh.name = "Large";
+	for (uint32_t y = 0; y <= size; y++)
+	{
+		for (uint32_t x = 0; x <= size; x++)
+		{
+			mesh.positions.push_back(Gleam::Float3(float(x), float(y), 0.0f));
+		}
+	}
+
+	Gleam::TArray<uint32_t> indices;
+	indices.reserve(size * size * 6);
+	for (uint32_t y = 0; y < size; y++)
+	{
+		for (uint32_t x = 0; x < size; x++)
+		{
+			uint32_t v00 = y * (size + 1) + x, v10 = v00 + 1;
+			uint32_t v01 = v00 + size + 1, v11 = v01 + 1;
+			indices.insert(indices.end(), { v00, v10, v11, v00, v11, v01 });
+		}
+	}
+	mesh.SetIndices(indices);
+	return mesh;
+}
+
+template<typename T>
+static Gleam::TArray<uint8_t> WriteBinary(const T& object)
+{
+	Gleam::BinaryWriter writer;
+	writer.Write(&object, Gleam::Reflection::GetClass<T>());
+
+	Gleam::TArray<uint8_t> data;
+	writer.Finish(data);
+	return data;
+}
+
+template<typename T>
+static bool ReadBinary(const Gleam::TArray<uint8_t>& data, T& object, size_t size = SIZE_MAX)
+{
+	return Gleam::BinarySerializer::Deserialize(data.data(), Gleam::Math::Min(size, data.size()), Gleam::Reflection::GetClass<T>(), &object);
+}
+
+// The revisions of Record below are different types, the reader matches their fields by name the same way it does for an evolved type
+struct Record
+{
+	int32_t id = 0;
+	float weight = 0.0f;
+	Gleam::TString name;
+	Gleam::TArray<uint32_t> values;
+};
+
+struct RecordAdded
+{
+	int32_t id = 0;
+	float weight = 0.0f;
+	Gleam::TString name;
+	Gleam::TArray<uint32_t> values;
+	uint32_t flags = 7;
+};
+
+struct RecordRemoved
+{
+	int32_t id = 0;
+	Gleam::TString name;
+};
+
+struct RecordReordered
+{
+	Gleam::TArray<uint32_t> values;
+	Gleam::TString name;
+	float weight = 0.0f;
+	int32_t id = 0;
+};
+
+struct RecordRetyped
+{
+	float id = -1.0f;
+	float weight = 0.0f;
+	Gleam::TString name;
+	Gleam::TString values = "unset";
+};
+
+// Two versions of one type, they share the guid
+struct RecordVersion1
+{
+	int32_t id = 0;
+};
+
+struct RecordVersion2
+{
+	int32_t id = 0;
+};
+
+static Record CreateRecord()
+{
+	return Record{ .id = 42, .weight = 1.5f, .name = "Record", .values = { 1, 2, 3 } };
+}
+
+} // namespace SerializationTests
+
+GLEAM_TYPE(SerializationTests::Record, Guid("3C9A5E17-6B2D-4F80-A1E4-7D58C2B9F031"))
+	GLEAM_FIELD(id, Serializable())
+	GLEAM_FIELD(weight, Serializable())
+	GLEAM_FIELD(name, Serializable())
+	GLEAM_FIELD(values, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(SerializationTests::RecordAdded, Guid("8E41B2D6-0C7F-4A95-B3E8-1F6D9A27C450"))
+	GLEAM_FIELD(id, Serializable())
+	GLEAM_FIELD(weight, Serializable())
+	GLEAM_FIELD(name, Serializable())
+	GLEAM_FIELD(values, Serializable())
+	GLEAM_FIELD(flags, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(SerializationTests::RecordRemoved, Guid("D27F6C03-9A1E-4B58-8C4D-5E0B3F17A692"))
+	GLEAM_FIELD(id, Serializable())
+	GLEAM_FIELD(name, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(SerializationTests::RecordReordered, Guid("5B0E8F29-D4A6-4C13-9E72-A83C1D6F0B47"))
+	GLEAM_FIELD(values, Serializable())
+	GLEAM_FIELD(name, Serializable())
+	GLEAM_FIELD(weight, Serializable())
+	GLEAM_FIELD(id, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(SerializationTests::RecordRetyped, Guid("F64A1C92-3E7B-4D05-A8F1-2C9E5B70D318"))
+	GLEAM_FIELD(id, Serializable())
+	GLEAM_FIELD(weight, Serializable())
+	GLEAM_FIELD(name, Serializable())
+	GLEAM_FIELD(values, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(SerializationTests::RecordVersion1, Guid("19C7E3A5-B08D-4F62-9D14-6A2F8E0C5B73"), Version(1))
+	GLEAM_FIELD(id, Serializable())
+GLEAM_END
+
+GLEAM_TYPE(SerializationTests::RecordVersion2, Guid("19C7E3A5-B08D-4F62-9D14-6A2F8E0C5B73"), Version(2))
+	GLEAM_FIELD(id, Serializable())
+GLEAM_END
+
+TEST(Serialization, LegacyMeshIndicesLoadAsValues)
+{
+	using namespace Gleam;
+	auto path = SerializationTests::WriteText("SerializationTests.Legacy.asset", SerializationTests::LegacyMeshDescriptor);
+	auto mesh = SerializationTests::ReadJSON<MeshDescriptor>(path);
+	std::filesystem::remove(path);
+
+	EXPECT_EQ(mesh.name, "Legacy");
+	EXPECT_EQ(mesh.indexType, IndexType::UINT32);
+	EXPECT_EQ(mesh.GetIndices(), TArray<uint32_t>({ 0, 1, 2, 2, 1, 300, 70000, 1, 2 }));
+	EXPECT_EQ(mesh.positions.size(), 3u);
+}
+
+TEST(Serialization, MeshIndicesRoundTripAtBakedWidth)
+{
+	using namespace Gleam;
+	MeshDescriptor mesh;
+	mesh.name = "Quad";
+	mesh.SetIndices({ 0, 1, 2, 2, 1, 300 });
+	EXPECT_EQ(mesh.indexType, IndexType::UINT16);
+	EXPECT_EQ(mesh.PackIndices().size(), 6 * sizeof(uint16_t));
+
+	auto path = std::filesystem::temp_directory_path() / "SerializationTests.Quad.asset";
+	SerializationTests::WriteJSON(path, mesh);
+	auto loaded = SerializationTests::ReadJSON<MeshDescriptor>(path);
+	std::filesystem::remove(path);
+
+	EXPECT_EQ(loaded.indexType, IndexType::UINT16);
+	EXPECT_EQ(loaded.GetIndices(), mesh.GetIndices());
+}
+
+TEST(Serialization, MismatchedValuesAreSkipped)
+{
+	using namespace Gleam;
+	auto path = SerializationTests::WriteText("SerializationTests.Mismatched.asset", SerializationTests::MismatchedMeshDescriptor);
+	auto mesh = SerializationTests::ReadJSON<MeshDescriptor>(path);
+	std::filesystem::remove(path);
+
+	// the string element still takes its slot, the values after it stay in place
+	EXPECT_EQ(mesh.name, "");
+	EXPECT_EQ(mesh.GetIndices(), TArray<uint32_t>({ 0, 0, 2 }));
+	EXPECT_EQ(mesh.positions.size(), 3u);
+}
+
+TEST(Serialization, DISABLED_Benchmark1MTriangleMesh)
+{
+	using namespace Gleam;
+	auto mesh = SerializationTests::CreateLargeMesh(708); // 1,002,528 triangles
+	auto path = std::filesystem::temp_directory_path() / "SerializationTests.Large.asset";
+
+	auto start = SerializationTests::Clock::now();
+	{
+		FileStream stream(path, std::ios::out | std::ios::trunc);
+		JSONSerializer(stream).Serialize(mesh);
+	}
+	double documentWrite = SerializationTests::ElapsedMilliseconds(start);
+
+	start = SerializationTests::Clock::now();
+	MeshDescriptor documentMesh;
+	{
+		FileStream stream(path, std::ios::in);
+		documentMesh = JSONSerializer(stream).Deserialize<MeshDescriptor>();
+	}
+	double documentRead = SerializationTests::ElapsedMilliseconds(start);
+
+	start = SerializationTests::Clock::now();
+	SerializationTests::WriteJSON(path, mesh);
+	double streamingWrite = SerializationTests::ElapsedMilliseconds(start);
+	auto fileSize = std::filesystem::file_size(path);
+
+	start = SerializationTests::Clock::now();
+	auto streamingMesh = SerializationTests::ReadJSON<MeshDescriptor>(path);
+	double streamingRead = SerializationTests::ElapsedMilliseconds(start);
+	std::filesystem::remove(path);
+
+	std::cout << "1M triangle mesh (" << fileSize / (1024 * 1024) << " MB): document write " << documentWrite << " ms, read " << documentRead
+		<< " ms, streaming write " << streamingWrite << " ms, read " << streamingRead << " ms" << std::endl;
+	EXPECT_EQ(documentMesh.GetIndices(), mesh.GetIndices());
+	EXPECT_EQ(streamingMesh.GetIndices(), mesh.GetIndices());
+	EXPECT_EQ(streamingMesh.positions.size(), mesh.positions.size());
+}
+
+TEST(Serialization, BinaryRoundTrip)
+{
+	using namespace SerializationTests;
+	auto data = WriteBinary(CreateRecord());
+
+	Record record;
+	ASSERT_TRUE(ReadBinary(data, record));
+	EXPECT_EQ(record.id, 42);
+	EXPECT_EQ(record.weight, 1.5f);
+	EXPECT_EQ(record.name, "Record");
+	EXPECT_EQ(record.values, Gleam::TArray<uint32_t>({ 1, 2, 3 }));
+}
+
+TEST(Serialization, BinarySchemaEvolution)
+{
+	using namespace SerializationTests;
+	auto data = WriteBinary(CreateRecord());
+
+	// added fields keep their defaults
+	RecordAdded added;
+	ASSERT_TRUE(ReadBinary(data, added));
+	EXPECT_EQ(added.id, 42);
+	EXPECT_EQ(added.values, Gleam::TArray<uint32_t>({ 1, 2, 3 }));
+	EXPECT_EQ(added.flags, 7u);
+
+	// removed fields are skipped, the ones after them still line up
+	RecordRemoved removed;
+	ASSERT_TRUE(ReadBinary(data, removed));
+	EXPECT_EQ(removed.id, 42);
+	EXPECT_EQ(removed.name, "Record");
+
+	RecordReordered reordered;
+	ASSERT_TRUE(ReadBinary(data, reordered));
+	EXPECT_EQ(reordered.id, 42);
+	EXPECT_EQ(reordered.weight, 1.5f);
+	EXPECT_EQ(reordered.name, "Record");
+	EXPECT_EQ(reordered.values, Gleam::TArray<uint32_t>({ 1, 2, 3 }));
+
+	// fields whose type changed are left at their defaults
+	RecordRetyped retyped;
+	ASSERT_TRUE(ReadBinary(data, retyped));
+	EXPECT_EQ(retyped.id, -1.0f);
+	EXPECT_EQ(retyped.values, "unset");
+	EXPECT_EQ(retyped.weight, 1.5f);
+	EXPECT_EQ(retyped.name, "Record");
+
+	// and written back the other way
+	Record record;
+	ASSERT_TRUE(ReadBinary(WriteBinary(reordered), record));
+	EXPECT_EQ(record.id, 42);
+	EXPECT_EQ(record.values, Gleam::TArray<uint32_t>({ 1, 2, 3 }));
+}
+
+TEST(Serialization, BinaryRejectsNewerVersion)
+{
+	using namespace SerializationTests;
+	RecordVersion2 newer;
+	EXPECT_TRUE(ReadBinary(WriteBinary(RecordVersion1{ .id = 5 }), newer));
+	EXPECT_EQ(newer.id, 5);
+
+	RecordVersion1 older;
+	EXPECT_FALSE(ReadBinary(WriteBinary(RecordVersion2{ .id = 5 }), older));
+	EXPECT_EQ(older.id, 0);
+}
+
+TEST(Serialization, BinaryRejectsTruncatedData)
+{
+	using namespace SerializationTests;
+	auto data = WriteBinary(CreateRecord());
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		Record record;
+		EXPECT_FALSE(ReadBinary(data, record, size)) << size;
+	}
+
+	// tables intact, but the payload ends inside the values
+	Gleam::BinaryHeader header;
+	memcpy(&header, data.data(), sizeof(Gleam::BinaryHeader));
+	header.payloadSize -= sizeof(uint32_t);
+	memcpy(data.data(), &header, sizeof(Gleam::BinaryHeader));
+
+	Record record;
+	EXPECT_FALSE(ReadBinary(data, record));
+}
+
+TEST(Serialization, BinaryRejectsSchemaCycles)
+{
+	using namespace SerializationTests;
+	auto data = WriteBinary(CreateRecord());
+
+	Gleam::BinaryHeader header;
+	memcpy(&header, data.data(), sizeof(Gleam::BinaryHeader));
+
+	uint32_t root = 0;
+	memcpy(&root, data.data() + header.payloadOffset, sizeof(uint32_t));
+
+	// the first field of the root class becomes the class itself, the changed hash forces the field by field path
+	auto types = reinterpret_cast<Gleam::BinarySchemaType*>(data.data() + sizeof(Gleam::BinaryHeader));
+	auto fields = reinterpret_cast<Gleam::BinarySchemaField*>(data.data() + sizeof(Gleam::BinaryHeader) + header.typeCount * sizeof(Gleam::BinarySchemaType));
+	fields[types[root].firstField].type = root;
+	types[root].hash ^= 1;
+
+	Record record;
+	EXPECT_FALSE(ReadBinary(data, record));
+}
+
+TEST(Serialization, DISABLED_BenchmarkJSONVersusBinary)
+{
+	using namespace Gleam;
+	auto mesh = SerializationTests::CreateLargeMesh(708);
+	auto path = std::filesystem::temp_directory_path() / "SerializationTests.Binary.asset";
+	SerializationTests::WriteJSON(path, mesh);
+	auto jsonSize = std::filesystem::file_size(path);
+
+	auto start = SerializationTests::Clock::now();
+	auto jsonMesh = SerializationTests::ReadJSON<MeshDescriptor>(path);
+	double jsonRead = SerializationTests::ElapsedMilliseconds(start);
+	std::filesystem::remove(path);
+
+	start = SerializationTests::Clock::now();
+	auto data = SerializationTests::WriteBinary(mesh);
+	double binaryWrite = SerializationTests::ElapsedMilliseconds(start);
+
+	start = SerializationTests::Clock::now();
+	MeshDescriptor binaryMesh;
+	EXPECT_TRUE(SerializationTests::ReadBinary(data, binaryMesh));
+	double binaryRead = SerializationTests::ElapsedMilliseconds(start);
+
+	std::cout << "1M triangle mesh: JSON " << jsonSize / (1024 * 1024) << " MB read in " << jsonRead << " ms, binary "
+		<< data.size() / (1024 * 1024) << " MB written in " << binaryWrite << " ms, read in " << binaryRead << " ms" << std::endl;
+	EXPECT_EQ(binaryMesh.GetIndices(), jsonMesh.GetIndices());
+	EXPECT_EQ(binaryMesh.positions.size(), jsonMesh.positions.size());
+}
@@ -0,0 +1,239 @@
+#pragma once
+#include <random>
+#include <chrono>
+
+#include "Container/DynamicAABBTree.h"
+
+namespace SpatialTests {
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static Gleam::BoundingBox RandomBox(std::mt19937& rng, float worldSize, float maxSize)
+{
+	std::uniform_real_distribution<float> position(-worldSize, worldSize);
+	std::uniform_real_distribution<float> size(0.1f, maxSize);
+	Gleam::Float3 min(position(rng), position(rng), position(rng));
+	return Gleam::BoundingBox(min, min + Gleam::Float3(size(rng), size(rng), size(rng)));
+}
+
+} // namespace SpatialTests
+
+TEST(DynamicAABBTree, QueriesMatchBruteForce)
+{
+	using namespace Gleam;
+	std::mt19937 rng(42);
+
+	DynamicAABBTree<uint32_t> tree;
+	TArray<BoundingBox> boxes;
+	TArray<int32_t> proxies;
+	for (uint32_t i = 0; i < 2000; i++)
+	{
+		boxes.push_back(SpatialTests::RandomBox(rng, 100.0f, 5.0f));
+		proxies.push_back(tree.CreateProxy(boxes.back(), i));
+	}
+
+	// move half of them, destroy a tenth
+	for (uint32_t i = 0; i < 2000; i += 2)
+	{
+		boxes[i] = SpatialTests::RandomBox(rng, 100.0f, 5.0f);
+		tree.MoveProxy(proxies[i], boxes[i]);
+	}
+	HashSet<uint32_t> destroyed;
+	for (uint32_t i = 0; i < 2000; i += 10)
+	{
+		tree.DestroyProxy(proxies[i]);
+		destroyed.insert(i);
+	}
+
+	for (uint32_t query = 0; query < 100; query++)
+	{
+		auto bounds = SpatialTests::RandomBox(rng, 100.0f, 30.0f);
+		BoundingSphere sphere((bounds.min + bounds.max) * 0.5f, 15.0f);
+
+		HashSet<uint32_t> boxHits, sphereHits;
+		tree.Query(bounds, [&](uint32_t i) { boxHits.insert(i); });
+		tree.Query(sphere, [&](uint32_t i) { sphereHits.insert(i); });
+
+		for (uint32_t i = 0; i < boxes.size(); i++)
+		{
+			bool alive = !destroyed.contains(i);
+			EXPECT_EQ(alive && boxes[i].Intersects(bounds), boxHits.contains(i));
+			EXPECT_EQ(alive && boxes[i].Intersects(sphere), sphereHits.contains(i));
+		}
+	}
+
+	// nearest hit along a ray has to match a linear scan over every box
+	for (uint32_t query = 0; query < 100; query++)
+	{
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		Float3 origin(unit(rng) * 150.0f, unit(rng) * 150.0f, unit(rng) * 150.0f);
+		Float3 direction = Math::Normalize(Float3(unit(rng), unit(rng), unit(rng)) - origin / 150.0f);
+
+		float nearest = Math::Infinity;
+		tree.Raycast(origin, direction, Math::Infinity, [&](uint32_t, float distance)
+		{
+			nearest = Math::Min(nearest, distance);
+			return nearest;
+		});
+
+		float expected = Math::Infinity;
+		for (uint32_t i = 0; i < boxes.size(); i++)
+		{
+			if (destroyed.contains(i))
+				continue;
+
+			Float3 t0 = (boxes[i].min - origin) / direction;
+			Float3 t1 = (boxes[i].max - origin) / direction;
+			Float3 tMin = Math::Min(t0, t1);
+			Float3 tMax = Math::Max(t0, t1);
+			float entry = Math::Max(Math::Max(tMin.x, tMin.y), Math::Max(tMin.z, 0.0f));
+			float exit = Math::Min(Math::Min(tMax.x, tMax.y), tMax.z);
+			if (entry <= exit)
+			{
+				expected = Math::Min(expected, entry);
+			}
+		}
+		EXPECT_FLOAT_EQ(expected, nearest);
+	}
+}
+
+TEST(DynamicAABBTree, FrustumQueryMatchesBruteForce)
+{
+	using namespace Gleam;
+	std::mt19937 rng(5);
+
+	DynamicAABBTree<uint32_t> tree;
+	TArray<BoundingBox> boxes;
+	for (uint32_t i = 0; i < 2000; i++)
+	{
+		boxes.push_back(SpatialTests::RandomBox(rng, 100.0f, 5.0f));
+		tree.CreateProxy(boxes.back(), i);
+	}
+	boxes.push_back(BoundingBox(Float3(-1.0f), Float3(1.0f)));
+	tree.CreateProxy(boxes.back(), 2000);
+	boxes.push_back(BoundingBox(Float3(-1.0f, -1.0f, -202.0f), Float3(1.0f, 1.0f, -200.0f)));
+	tree.CreateProxy(boxes.back(), 2001);
+
+	// camera behind the boxes looking down +z, the same matrices RenderSceneProxy culls with
+	auto viewProjection = Float4x4::Perspective(60.0f, 16.0f / 9.0f, 0.1f, 200.0f) * Float4x4::LookTo(Float3(0.0f, 0.0f, -150.0f), Float3(0.0f, 0.0f, 1.0f), Float3(0.0f, 1.0f, 0.0f));
+	Frustum frustum(viewProjection);
+
+	HashSet<uint32_t> hits;
+	tree.Query(frustum, [&](uint32_t i) { hits.insert(i); });
+	EXPECT_TRUE(hits.contains(2000));
+	EXPECT_FALSE(hits.contains(2001));
+	EXPECT_GT(hits.size(), 1u);
+	EXPECT_LT(hits.size(), boxes.size() - 1);
+
+	for (uint32_t i = 0; i < boxes.size(); i++)
+	{
+		EXPECT_EQ(frustum.Intersects(boxes[i]), hits.contains(i));
+	}
+
+	// the rebuilt hierarchy answers the same
+	HashSet<uint32_t> rebuiltHits;
+	tree.Rebuild();
+	tree.Query(frustum, [&](uint32_t i) { rebuiltHits.insert(i); });
+	EXPECT_EQ(hits, rebuiltHits);
+}
+
+TEST(DynamicAABBTree, DISABLED_Benchmark100kDynamic)
+{
+	using namespace Gleam;
+	constexpr uint32_t EntryCount = 100000;
+	constexpr uint32_t FrameCount = 60;
+	std::mt19937 rng(7);
+
+	DynamicAABBTree<uint32_t> tree;
+	TArray<BoundingBox> boxes(EntryCount);
+	TArray<Float3> velocities(EntryCount);
+	TArray<int32_t> proxies(EntryCount);
+
+	std::uniform_real_distribution<float> speed(-0.05f, 0.05f);
+	auto start = SpatialTests::Clock::now();
+	for (uint32_t i = 0; i < EntryCount; i++)
+	{
+		boxes[i] = SpatialTests::RandomBox(rng, 500.0f, 4.0f);
+		velocities[i] = Float3(speed(rng), speed(rng), speed(rng));
+		proxies[i] = tree.CreateProxy(boxes[i], i);
+	}
+	double insertTime = SpatialTests::ElapsedMilliseconds(start);
+
+	uint32_t reinsertCount = 0;
+	start = SpatialTests::Clock::now();
+	for (uint32_t frame = 0; frame < FrameCount; frame++)
+	{
+		for (uint32_t i = 0; i < EntryCount; i++)
+		{
+			boxes[i] = BoundingBox(boxes[i].min + velocities[i], boxes[i].max + velocities[i]);
+			reinsertCount += tree.MoveProxy(proxies[i], boxes[i]);
+		}
+	}
+	double updateTime = SpatialTests::ElapsedMilliseconds(start) / FrameCount;
+
+	uint32_t hitCount = 0;
+	start = SpatialTests::Clock::now();
+	for (uint32_t query = 0; query < 10000; query++)
+	{
+		tree.Query(SpatialTests::RandomBox(rng, 500.0f, 20.0f), [&](uint32_t) { hitCount++; });
+	}
+	double queryTime = SpatialTests::ElapsedMilliseconds(start);
+
+	std::cout << "100k dynamic: insert " << insertTime << " ms, update " << updateTime << " ms/frame ("
+		<< reinsertCount / FrameCount << " reinserts/frame), 10k box queries " << queryTime << " ms ("
+		<< hitCount << " hits), height " << tree.GetHeight() << ", area ratio " << tree.GetAreaRatio() << std::endl;
+
+	EXPECT_EQ(tree.GetProxyCount(), EntryCount);
+}
+
+TEST(DynamicAABBTree, DISABLED_Benchmark1MStatic)
+{
+	using namespace Gleam;
+	constexpr uint32_t EntryCount = 1000000;
+	std::mt19937 rng(11);
+
+	DynamicAABBTree<uint32_t> tree;
+	auto start = SpatialTests::Clock::now();
+	for (uint32_t i = 0; i < EntryCount; i++)
+	{
+		tree.CreateProxy(SpatialTests::RandomBox(rng, 2000.0f, 4.0f), i);
+	}
+	double insertTime = SpatialTests::ElapsedMilliseconds(start);
+	float insertAreaRatio = tree.GetAreaRatio();
+
+	start = SpatialTests::Clock::now();
+	tree.Rebuild();
+	double rebuildTime = SpatialTests::ElapsedMilliseconds(start);
+
+	uint32_t hitCount = 0;
+	start = SpatialTests::Clock::now();
+	for (uint32_t query = 0; query < 10000; query++)
+	{
+		tree.Query(SpatialTests::RandomBox(rng, 2000.0f, 40.0f), [&](uint32_t) { hitCount++; });
+	}
+	double queryTime = SpatialTests::ElapsedMilliseconds(start);
+
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	uint32_t rayHitCount = 0;
+	start = SpatialTests::Clock::now();
+	for (uint32_t query = 0; query < 10000; query++)
+	{
+		Float3 origin(unit(rng) * 2000.0f, unit(rng) * 2000.0f, unit(rng) * 2000.0f);
+		Float3 direction = Math::Normalize(Float3(unit(rng), unit(rng), unit(rng)));
+		bool hit = false;
+		tree.Raycast(origin, direction, Math::Infinity, [&](uint32_t, float distance) { hit = true; return distance; });
+		rayHitCount += hit;
+	}
+	double raycastTime = SpatialTests::ElapsedMilliseconds(start);
+
+	std::cout << "1M static: insert " << insertTime << " ms (area ratio " << insertAreaRatio << "), rebuild " << rebuildTime
+		<< " ms (area ratio " << tree.GetAreaRatio() << "), 10k box queries " << queryTime << " ms (" << hitCount
+		<< " hits), 10k raycasts " << raycastTime << " ms (" << rayHitCount << " hits)" << std::endl;
+
+	EXPECT_EQ(tree.GetProxyCount(), EntryCount);
+}
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "EAssets/TextureCompressor.h"
+
+namespace TextureCompressorTests {
+
+// Reads the bits of a block from the least significant bit of the first byte on
+class BitReader
+{
+public:
+
+	BitReader(const uint8_t* data)
+		: mData(data)
+	{
+
+	}
+
+	uint32_t Read(uint32_t bitCount)
+	{
+		uint32_t value = 0;
+		for (uint32_t i = 0; i < bitCount; ++i, ++mPosition)
+		{
+			value |= static_cast<uint32_t>((mData[mPosition >> 3] >> (mPosition & 7)) & 1) << i;
+		}
+		return value;
+	}
+
+private:
+
+	const uint8_t* mData;
+
+	uint32_t mPosition = 0;
+
+};
+
+static void UnpackRGB565(uint16_t packed, int32_t (&color)[3])
+{
+	int32_t r = (packed >> 11) & 31;
+	int32_t g = (packed >> 5) & 63;
+	int32_t b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+// Reference decoders following the block layouts of the D3D specification, output is 16 RGBA pixels in row order
+static void DecodeBC1Block(const uint8_t* block, uint8_t* pixels)
+{
+	uint16_t color0, color1;
+	uint32_t indices;
+	memcpy(&color0, block, sizeof(uint16_t));
+	memcpy(&color1, block + 2, sizeof(uint16_t));
+	memcpy(&indices, block + 4, sizeof(uint32_t));
+
+	int32_t palette[4][4];
+	int32_t endpoint0[3], endpoint1[3];
+	UnpackRGB565(color0, endpoint0);
+	UnpackRGB565(color1, endpoint1);
+	for (uint32_t c = 0; c < 3; ++c)
+	{
+		palette[0][c] = endpoint0[c];
+		palette[1][c] = endpoint1[c];
+		palette[2][c] = color0 > color1 ? (2 * endpoint0[c] + endpoint1[c]) / 3 : (endpoint0[c] + endpoint1[c]) / 2;
+		palette[3][c] = color0 > color1 ? (endpoint0[c] + 2 * endpoint1[c]) / 3 : 0;
+	}
+	palette[0][3] = palette[1][3] = palette[2][3] = 255;
+	palette[3][3] = color0 > color1 ? 255 : 0;
+
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			pixels[i * 4 + c] = static_cast<uint8_t>(palette[(indices >> (i * 2)) & 3][c]);
+		}
+	}
+}
+
+// Writes the decoded channel into every fourth byte of the pixels
+static void DecodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* pixels)
+{
+	int32_t palette[8];
+	palette[0] = block[0];
+	palette[1] = block[1];
+	if (palette[0] > palette[1])
+	{
+		for (int32_t i = 2; i < 8; ++i)
+		{
+			palette[i] = ((8 - i) * palette[0] + (i - 1) * palette[1]) / 7;
+		}
+	}
+	else
+	{
+		for (int32_t i = 2; i < 6; ++i)
+		{
+			palette[i] = ((6 - i) * palette[0] + (i - 1) * palette[1]) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	uint64_t indices = 0;
+	memcpy(&indices, block + 2, 6);
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		pixels[i * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+	}
+}
+
+// Only mode 6 is decoded, false for blocks of any other mode
+static bool DecodeBC7Block(const uint8_t* block, uint8_t* pixels)
+{
+	static constexpr int32_t Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	BitReader reader(block);
+	if (reader.Read(7) != 1 << 6)
+	{
+		return false;
+	}
+
+	int32_t endpoints[2][4];
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		endpoints[0][c] = static_cast<int32_t>(reader.Read(7));
+		endpoints[1][c] = static_cast<int32_t>(reader.Read(7));
+	}
+	for (uint32_t e = 0; e < 2; ++e)
+	{
+		int32_t pbit = static_cast<int32_t>(reader.Read(1));
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			endpoints[e][c] = (endpoints[e][c] << 1) | pbit;
+		}
+	}
+
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		uint32_t index = reader.Read(i == 0 ? 3 : 4);
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			pixels[i * 4 + c] = static_cast<uint8_t>(((64 - Weights[index]) * endpoints[0][c] + Weights[index] * endpoints[1][c] + 32) >> 6);
+		}
+	}
+	return true;
+}
+
+// Largest difference of any channel among the first channelCount channels
+static int32_t MaxError(const uint8_t* expected, const uint8_t* actual, uint32_t channelCount)
+{
+	int32_t error = 0;
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		for (uint32_t c = 0; c < channelCount; ++c)
+		{
+			error = std::max(error, std::abs(expected[i * 4 + c] - actual[i * 4 + c]));
+		}
+	}
+	return error;
+}
+
+static Gleam::TArray<uint8_t> CreateSolidBlock(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	Gleam::TArray<uint8_t> block(64);
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		block[i * 4 + 0] = r;
+		block[i * 4 + 1] = g;
+		block[i * 4 + 2] = b;
+		block[i * 4 + 3] = a;
+	}
+	return block;
+}
+
+// Every channel ramps along x, the pixels lie on a single line through RGBA that a one subset BC7 mode can fit
+static Gleam::TArray<uint8_t> CreateGradientBlock()
+{
+	Gleam::TArray<uint8_t> block(64);
+	for (uint32_t y = 0; y < 4; ++y)
+	{
+		for (uint32_t x = 0; x < 4; ++x)
+		{
+			uint8_t* pixel = block.data() + (y * 4 + x) * 4;
+			pixel[0] = static_cast<uint8_t>(40 + x * 50);
+			pixel[1] = static_cast<uint8_t>(200 - x * 40);
+			pixel[2] = static_cast<uint8_t>(60 + x * 20);
+			pixel[3] = static_cast<uint8_t>(255 - x * 60);
+		}
+	}
+	return block;
+}
+
+} // namespace TextureCompressorTests
+
+TEST(TextureCompressor, BC1SolidBlockIsExact)
+{
+	using namespace GEditor;
+	auto block = TextureCompressorTests::CreateSolidBlock(255, 0, 255, 255);
+
+	uint8_t encoded[8];
+	TextureCompressor::EncodeBC1Block(block.data(), encoded);
+
+	// magenta is exact in 565, both endpoints are the color and every index selects the first one
+	EXPECT_EQ(encoded[0] | encoded[1] << 8, 0xF81F);
+	EXPECT_EQ(encoded[2] | encoded[3] << 8, 0xF81F);
+	EXPECT_EQ(encoded[4] | encoded[5] | encoded[6] | encoded[7], 0);
+
+	uint8_t decoded[64];
+	TextureCompressorTests::DecodeBC1Block(encoded, decoded);
+	EXPECT_EQ(TextureCompressorTests::MaxError(block.data(), decoded, 4), 0);
+}
+
+TEST(TextureCompressor, BC1GradientRoundTrip)
+{
+	using namespace GEditor;
+	auto block = TextureCompressorTests::CreateGradientBlock();
+
+	uint8_t encoded[8];
+	TextureCompressor::EncodeBC1Block(block.data(), encoded);
+
+	// four color mode, so that BC3 decodes its color block the same way
+	uint16_t color0 = encoded[0] | encoded[1] << 8;
+	uint16_t color1 = encoded[2] | encoded[3] << 8;
+	EXPECT_GT(color0, color1);
+
+	// four evenly spaced columns fit the four palette entries up to the 565 quantization
+	uint8_t decoded[64];
+	TextureCompressorTests::DecodeBC1Block(encoded, decoded);
+	EXPECT_LE(TextureCompressorTests::MaxError(block.data(), decoded, 3), 8);
+}
+
+TEST(TextureCompressor, BC4KnownBlock)
+{
+	using namespace GEditor;
+	auto block = TextureCompressorTests::CreateSolidBlock(0, 0, 0, 0);
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		block[i * 4] = static_cast<uint8_t>(10 + i * 7);
+	}
+
+	uint8_t encoded[8];
+	TextureCompressor::EncodeBC4Block(block.data(), 0, encoded);
+
+	// eight value mode with the extremes of the block as endpoints, the first pixel is the minimum
+	EXPECT_EQ(encoded[0], 115);
+	EXPECT_EQ(encoded[1], 10);
+	EXPECT_EQ(encoded[2] & 7, 1);
+
+	uint8_t decoded[64] = {};
+	TextureCompressorTests::DecodeBC4Block(encoded, 0, decoded);
+	EXPECT_LE(TextureCompressorTests::MaxError(block.data(), decoded, 1), 8);
+
+	// a constant channel decodes exactly, whatever mode the equal endpoints select
+	auto solid = TextureCompressorTests::CreateSolidBlock(0, 0, 0, 77);
+	TextureCompressor::EncodeBC4Block(solid.data(), 3, encoded);
+	TextureCompressorTests::DecodeBC4Block(encoded, 3, decoded);
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		EXPECT_EQ(decoded[i * 4 + 3], 77);
+	}
+}
+
+TEST(TextureCompressor, BC7RoundTrip)
+{
+	using namespace GEditor;
+	uint8_t encoded[16];
+	uint8_t decoded[64];
+
+	auto solid = TextureCompressorTests::CreateSolidBlock(12, 140, 201, 99);
+	TextureCompressor::EncodeBC7Block(solid.data(), encoded);
+	EXPECT_EQ(encoded[0], 1 << 6);
+	ASSERT_TRUE(TextureCompressorTests::DecodeBC7Block(encoded, decoded));
+	EXPECT_LE(TextureCompressorTests::MaxError(solid.data(), decoded, 4), 1);
+
+	auto gradient = TextureCompressorTests::CreateGradientBlock();
+	TextureCompressor::EncodeBC7Block(gradient.data(), encoded);
+	ASSERT_TRUE(TextureCompressorTests::DecodeBC7Block(encoded, decoded));
+	EXPECT_LE(TextureCompressorTests::MaxError(gradient.data(), decoded, 4), 12);
+}
+
+TEST(TextureCompressor, CompressRepeatsEdgePixels)
+{
+	using namespace Gleam;
+	using namespace GEditor;
+	ThreadPool threadPool(2);
+
+	// 6x5 image, the second column and row of blocks is padded from the last column and row
+	TextureImage image{ .width = 6, .height = 5 };
+	image.pixels.resize(image.width * image.height * 4);
+	for (uint32_t y = 0; y < image.height; ++y)
+	{
+		for (uint32_t x = 0; x < image.width; ++x)
+		{
+			uint8_t* pixel = image.pixels.data() + (y * image.width + x) * 4;
+			pixel[0] = x < 4 ? 0 : 255;
+			pixel[1] = y < 4 ? 0 : 255;
+			pixel[2] = 0;
+			pixel[3] = 255;
+		}
+	}
+
+	auto compressed = TextureCompressor::Compress(image, TextureCompression::BC1, threadPool);
+	ASSERT_EQ(compressed.size(), TextureCompressor::GetCompressedSize(image.width, image.height, TextureCompression::BC1));
+	ASSERT_EQ(compressed.size(), 4u * 8u);
+
+	uint8_t decoded[64];
+	TextureCompressorTests::DecodeBC1Block(compressed.data() + 3 * 8, decoded);
+	auto expected = TextureCompressorTests::CreateSolidBlock(255, 255, 0, 255);
+	EXPECT_EQ(TextureCompressorTests::MaxError(expected.data(), decoded, 4), 0);
+}